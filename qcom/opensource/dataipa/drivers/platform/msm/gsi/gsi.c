@@ -1139,6 +1139,11 @@ static irqreturn_t gsi_msi_isr(int irq, void *ctxt)
 			break;
 	}
 
+	if (msi == gsi_ctx->msi.num || !test_bit(msi, gsi_ctx->msi.used)) {
+		GSIERR("spurious msi irq %d\n", irq);
+		return IRQ_HANDLED;
+	}
+
 	evt = gsi_ctx->msi.evt[msi];
 	evt_ctxt = &gsi_ctx->evtr[evt];
 
@@ -2172,6 +2177,7 @@ static int __gsi_pair_msi(struct gsi_evt_ctx *ctx,
 	props->intvec = gsi_ctx->msi.msg[msi].data;
 	props->msi_addr = (uint64_t)gsi_ctx->msi.msg[msi].address_hi << 32 |
 			(uint64_t)gsi_ctx->msi.msg[msi].address_lo;
+	props->msi_irq = gsi_ctx->msi.irq[msi];
 
 	GSIDBG("props->intvec = %d, props->msi_addr = %lu\n", props->intvec, props->msi_addr);
 
@@ -2413,9 +2419,16 @@ int gsi_dealloc_evt_ring(unsigned long evt_ring_hdl)
 		ctx->props.intr == GSI_INTR_MSI) {
 		GSIERR("Interrupt dereg for msi_irq = %d\n", ctx->props.msi_irq);
 
+		/* freed while polling, leave the MSI usable for the next ring */
+		if (ctx->msi_irq_off) {
+			ctx->msi_irq_off = false;
+			enable_irq(ctx->props.msi_irq);
+		}
+
 		for (msi = 0; msi < gsi_ctx->msi.num; msi++) {
 			if (gsi_ctx->msi.msg[msi].data == ctx->props.intvec) {
 				mutex_lock(&gsi_ctx->mlock);
+				irq_set_affinity_hint(gsi_ctx->msi.irq[msi], NULL);
 				clear_bit(msi, gsi_ctx->msi.used);
 				gsi_ctx->msi.evt[msi] = 0;
 				clear_bit(evt_ring_hdl, &gsi_ctx->msi.mask);
@@ -4541,6 +4554,10 @@ int gsi_config_channel_mode(unsigned long chan_hdl, enum gsi_chan_mode mode)
 				gsihal_get_ch_reg_idx(ctx->evtr->id),
 				gsihal_get_ch_reg_mask(ctx->evtr->id),
 				0);
+			} else if (!ctx->evtr->msi_irq_off) {
+				/* IEOB stays unmasked for MSI, mask the MSI */
+				disable_irq_nosync(ctx->evtr->props.msi_irq);
+				ctx->evtr->msi_irq_off = true;
 			}
 		}
 		else {
@@ -4591,6 +4608,9 @@ int gsi_config_channel_mode(unsigned long chan_hdl, enum gsi_chan_mode mode)
 				gsihal_get_ch_reg_idx(ctx->evtr->id),
 				gsihal_get_ch_reg_mask(ctx->evtr->id),
 				~0);
+			} else if (ctx->evtr->msi_irq_off) {
+				ctx->evtr->msi_irq_off = false;
+				enable_irq(ctx->evtr->props.msi_irq);
 			}
 		}
 		else {
@@ -5609,6 +5629,72 @@ int gsi_query_msi_addr(unsigned long chan_hdl, phys_addr_t *addr)
 }
 EXPORT_SYMBOL(gsi_query_msi_addr);
 
+int gsi_set_evt_ring_msi_affinity(unsigned long evt_ring_hdl, int cpu)
+{
+	struct gsi_evt_ctx *ctx;
+	u32 msi;
+	int res;
+
+	if (!gsi_ctx) {
+		pr_err("%s:%d gsi context not allocated\n", __func__, __LINE__);
+		return -GSI_STATUS_NODEV;
+	}
+
+	if (evt_ring_hdl >= gsi_ctx->max_ev ||
+		evt_ring_hdl >= GSI_EVT_RING_MAX ||
+		cpu >= (int)nr_cpu_ids) {
+		GSIERR("bad params evt_ring_hdl=%lu cpu=%d\n",
+			evt_ring_hdl, cpu);
+		return -GSI_STATUS_INVALID_PARAMS;
+	}
+
+	ctx = &gsi_ctx->evtr[evt_ring_hdl];
+	if (ctx->state != GSI_EVT_RING_STATE_ALLOCATED ||
+		ctx->props.intr != GSI_INTR_MSI) {
+		GSIERR("evt %lu has no MSI\n", evt_ring_hdl);
+		return -GSI_STATUS_UNSUPPORTED_OP;
+	}
+
+	mutex_lock(&gsi_ctx->mlock);
+	for (msi = 0; msi < gsi_ctx->msi.num; msi++) {
+		if (test_bit(msi, gsi_ctx->msi.used) &&
+			gsi_ctx->msi.evt[msi] == evt_ring_hdl)
+			break;
+	}
+
+	if (msi == gsi_ctx->msi.num) {
+		mutex_unlock(&gsi_ctx->mlock);
+		GSIERR("no MSI paired with evt %lu\n", evt_ring_hdl);
+		return -GSI_STATUS_UNSUPPORTED_OP;
+	}
+
+	res = irq_set_affinity_hint(gsi_ctx->msi.irq[msi],
+		cpu < 0 ? NULL : cpumask_of(cpu));
+	mutex_unlock(&gsi_ctx->mlock);
+	if (res) {
+		GSIERR("failed to steer msi %u to cpu %d %d\n", msi, cpu, res);
+		return -GSI_STATUS_ERROR;
+	}
+
+	GSIDBG("evt %lu msi %u irq %u on cpu %d\n", evt_ring_hdl, msi,
+		gsi_ctx->msi.irq[msi], cpu);
+
+	return GSI_STATUS_SUCCESS;
+}
+EXPORT_SYMBOL(gsi_set_evt_ring_msi_affinity);
+
+int gsi_get_num_free_msi(void)
+{
+	if (!gsi_ctx) {
+		pr_err("%s:%d gsi context not allocated\n", __func__, __LINE__);
+		return 0;
+	}
+
+	return gsi_ctx->msi.num -
+		bitmap_weight(gsi_ctx->msi.used, gsi_ctx->msi.num);
+}
+EXPORT_SYMBOL(gsi_get_num_free_msi);
+
 int gsi_query_device_msi_addr(u64 *addr)
 {
     if (!gsi_ctx) {
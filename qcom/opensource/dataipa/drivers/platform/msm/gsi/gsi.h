@@ -100,7 +100,7 @@
 	} while (0)
 
 #define GSI_IPC_LOG_PAGES 50
-#define GSI_MAX_NUM_MSI 2
+#define GSI_MAX_NUM_MSI 8
 
 enum gsi_ver {
 	GSI_VER_ERR = 0,
@@ -1471,6 +1471,8 @@ struct gsi_evt_ctx {
 	atomic_t chan_ref_cnt;
 	union __packed gsi_evt_scratch scratch;
 	struct gsi_evt_stats stats;
+	/* MSI disabled while the channels poll */
+	bool msi_irq_off;
 };
 
 struct gsi_ee_scratch {
@@ -2487,6 +2489,24 @@ int gsi_query_msi_addr(unsigned long chan_hdl, phys_addr_t *addr);
 */
 int gsi_query_device_msi_addr(u64 *addr);
 
+/**
+* gsi_set_evt_ring_msi_affinity - steer the MSI of an event ring to a CPU
+*
+* @evt_ring_hdl: handle of an event ring allocated with GSI_INTR_MSI
+* @cpu: CPU the MSI, and so the completion processing it drives, should
+*       run on. Negative to drop the hint.
+*
+* @Return gsi_status
+*/
+int gsi_set_evt_ring_msi_affinity(unsigned long evt_ring_hdl, int cpu);
+
+/**
+* gsi_get_num_free_msi - number of MSIs not paired with an event ring
+*
+* @Return the number of free MSIs
+*/
+int gsi_get_num_free_msi(void);
+
 /**
 * gsi_update_almst_empty_thrshold - update almst_empty_thrshold
 *
@@ -1154,6 +1154,7 @@ static int ipa3_usb_request_xdci_channel(
 		else
 			chan_params.notify = rndis_ptr->ipa_rx_notify;
 		chan_params.skip_ep_cfg = rndis_ptr->skip_ep_cfg;
+		chan_params.rx_frag_ok = true;
 		break;
 	case IPA_USB_ECM:
 		chan_params.priv = ecm_ptr->private;
@@ -1162,6 +1163,7 @@ static int ipa3_usb_request_xdci_channel(
 		else
 			chan_params.notify = ecm_ptr->ecm_ipa_rx_dp_notify;
 		chan_params.skip_ep_cfg = ecm_ptr->skip_ep_cfg;
+		chan_params.rx_frag_ok = true;
 		break;
 	case IPA_USB_RMNET:
 	case IPA_USB_MBIM:
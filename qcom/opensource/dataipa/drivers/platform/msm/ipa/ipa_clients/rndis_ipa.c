@@ -2323,7 +2323,7 @@ static void rndis_ipa_dump_skb(struct sk_buff *skb)
 		("packet dump start for skb->len=%d\n",
 		skb->len);
 
-	for (i = 0; i < (skb->len / 4); i++) {
+	for (i = 0; i < (skb_headlen(skb) / 4); i++) {
 		byte = (u8 *)(cur + i);
 		pr_info
 			("%2d %08x   %02x %02x %02x %02x\n",
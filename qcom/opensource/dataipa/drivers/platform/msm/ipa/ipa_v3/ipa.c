@@ -5892,6 +5892,9 @@ int _ipa_init_rt4_v3(void)
 		ipa3_ctx->rt_idx_bitmap[IPA_IP_v4] |= (1 << i);
 	IPADBG("v4 rt bitmap 0x%lx\n", ipa3_ctx->rt_idx_bitmap[IPA_IP_v4]);
 
+	/* the next commit cannot rely on the tables it replaces */
+	ipa3_ctx->rt_tbl_synced[IPA_IP_v4] = false;
+
 	rc = ipahal_rt_generate_empty_img(IPA_MEM_PART(v4_rt_num_index),
 		IPA_MEM_PART(v4_rt_hash_size), IPA_MEM_PART(v4_rt_nhash_size),
 		&mem, false);
@@ -5966,6 +5969,9 @@ int _ipa_init_rt6_v3(void)
 		ipa3_ctx->rt_idx_bitmap[IPA_IP_v6] |= (1 << i);
 	IPADBG("v6 rt bitmap 0x%lx\n", ipa3_ctx->rt_idx_bitmap[IPA_IP_v6]);
 
+	/* the next commit cannot rely on the tables it replaces */
+	ipa3_ctx->rt_tbl_synced[IPA_IP_v6] = false;
+
 	rc = ipahal_rt_generate_empty_img(IPA_MEM_PART(v6_rt_num_index),
 		IPA_MEM_PART(v6_rt_hash_size), IPA_MEM_PART(v6_rt_nhash_size),
 		&mem, false);
@@ -6033,6 +6039,9 @@ int _ipa_init_flt4_v3(void)
 	struct ipahal_imm_cmd_pyld *cmd_pyld;
 	int rc;
 
+	/* the next commit cannot rely on the tables it replaces */
+	ipa3_ctx->flt_tbl_synced[IPA_IP_v4] = false;
+
 	rc = ipahal_flt_generate_empty_img(ipa3_ctx->ep_flt_num,
 		IPA_MEM_PART(v4_flt_hash_size),
 		IPA_MEM_PART(v4_flt_nhash_size), ipa3_ctx->ep_flt_bitmap,
@@ -6101,6 +6110,9 @@ int _ipa_init_flt6_v3(void)
 	struct ipahal_imm_cmd_pyld *cmd_pyld;
 	int rc;
 
+	/* the next commit cannot rely on the tables it replaces */
+	ipa3_ctx->flt_tbl_synced[IPA_IP_v6] = false;
+
 	rc = ipahal_flt_generate_empty_img(ipa3_ctx->ep_flt_num,
 		IPA_MEM_PART(v6_flt_hash_size),
 		IPA_MEM_PART(v6_flt_nhash_size), ipa3_ctx->ep_flt_bitmap,
@@ -9291,6 +9303,8 @@ static int ipa3_pre_init(const struct ipa3_plat_drv_res *resource_p,
 	ipa3_ctx->lan_rx_napi_enable = resource_p->lan_rx_napi_enable;
 	ipa3_ctx->tx_napi_enable = resource_p->tx_napi_enable;
 	ipa3_ctx->tx_poll = resource_p->tx_poll;
+	memcpy(ipa3_ctx->msi_napi_cpu, resource_p->msi_napi_cpu,
+		sizeof(ipa3_ctx->msi_napi_cpu));
 	ipa3_ctx->ipa_gpi_event_rp_ddr = resource_p->ipa_gpi_event_rp_ddr;
 	ipa3_ctx->rmnet_ctl_enable = resource_p->rmnet_ctl_enable;
 	ipa3_ctx->lan_coal_enable = resource_p->lan_coal_enable;
@@ -9564,6 +9578,8 @@ static int ipa3_pre_init(const struct ipa3_plat_drv_res *resource_p,
 	}
 	mutex_init(&ipa3_ctx->recycle_stats_collection_lock);
 	memset(&ipa3_ctx->recycle_stats, 0, sizeof(struct ipa_lnx_pipe_page_recycling_stats));
+	memset(&ipa3_ctx->recycle_ext_stats, 0,
+		sizeof(struct ipa_lnx_pipe_page_recycling_ext_stats));
 	memset(&ipa3_ctx->prev_coal_recycle_stats, 0, sizeof(struct ipa3_page_recycle_stats));
 	memset(&ipa3_ctx->prev_default_recycle_stats, 0, sizeof(struct ipa3_page_recycle_stats));
 	memset(&ipa3_ctx->prev_low_lat_data_recycle_stats, 0, sizeof(struct ipa3_page_recycle_stats));
@@ -9673,6 +9689,7 @@ static int ipa3_pre_init(const struct ipa3_plat_drv_res *resource_p,
 			INIT_LIST_HEAD(&ipa3_ctx->hdr_tbl[hdr_tbl].head_free_offset_list[i]);
 		}
 	}
+	hash_init(ipa3_ctx->hdr_name_htable);
 	INIT_LIST_HEAD(&ipa3_ctx->hdr_proc_ctx_tbl.head_proc_ctx_entry_list);
 	for (i = 0; i < IPA_HDR_PROC_CTX_BIN_MAX; i++) {
 		INIT_LIST_HEAD(
@@ -9682,8 +9699,10 @@ static int ipa3_pre_init(const struct ipa3_plat_drv_res *resource_p,
 	}
 	INIT_LIST_HEAD(&ipa3_ctx->rt_tbl_set[IPA_IP_v4].head_rt_tbl_list);
 	idr_init(&ipa3_ctx->rt_tbl_set[IPA_IP_v4].rule_ids);
+	hash_init(ipa3_ctx->rt_tbl_set[IPA_IP_v4].name_htable);
 	INIT_LIST_HEAD(&ipa3_ctx->rt_tbl_set[IPA_IP_v6].head_rt_tbl_list);
 	idr_init(&ipa3_ctx->rt_tbl_set[IPA_IP_v6].rule_ids);
+	hash_init(ipa3_ctx->rt_tbl_set[IPA_IP_v6].name_htable);
 
 	rset = &ipa3_ctx->reap_rt_tbl_set[IPA_IP_v4];
 	INIT_LIST_HEAD(&rset->head_rt_tbl_list);
@@ -10577,6 +10596,23 @@ static int get_ipa_dts_configuration(struct platform_device *pdev,
 	IPADBG(": Enable tx polling = %s\n", ipa_drv_res->tx_poll
 		? "True" : "False");
 
+	for (i = 0; i < IPA_MSI_NAPI_MAX; i++)
+		ipa_drv_res->msi_napi_cpu[i] = -1;
+	elem_num = of_property_count_elems_of_size(pdev->dev.of_node,
+		"qcom,ipa-msi-napi-cpus", sizeof(u32));
+	if (elem_num > 0) {
+		if (elem_num > IPA_MSI_NAPI_MAX ||
+			of_property_read_u32_array(pdev->dev.of_node,
+			"qcom,ipa-msi-napi-cpus",
+			(u32 *)ipa_drv_res->msi_napi_cpu, elem_num)) {
+			IPAERR("failed to read msi napi cpus\n");
+			return -EFAULT;
+		}
+		for (i = 0; i < elem_num; i++)
+			IPADBG(": msi napi pipe %d on cpu %d\n", i,
+				ipa_drv_res->msi_napi_cpu[i]);
+	}
+
 	if (ipa_drv_res->platform_type != IPA_PLAT_TYPE_APQ) {
 		ipa_drv_res->rmnet_ctl_enable =
 			of_property_read_bool(pdev->dev.of_node,
@@ -625,7 +625,7 @@ int ipa3_request_gsi_channel(struct ipa_request_gsi_channel_params *params,
 	ep->client_notify = params->notify;
 	ep->priv = params->priv;
 	ep->keep_ipa_awake = params->keep_ipa_awake;
-
+	ep->rx_frag_ok = params->rx_frag_ok;
 
 	/* Config QMB for USB_CONS ep */
 	if (!IPA_CLIENT_IS_PROD(ep->client)) {
@@ -1534,6 +1534,9 @@ static ssize_t ipa3_read_stats(struct file *file, char __user *ubuf,
 		"sw_tx=%u\n"
 		"hw_tx=%u\n"
 		"tx_non_linear=%u\n"
+		"tx_db=%llu\n"
+		"tx_db_desc=%llu\n"
+		"tx_db_timer_flush=%llu\n"
 		"tx_compl=%u\n"
 		"wan_rx=%u\n"
 		"stat_compl=%u\n"
@@ -1548,6 +1551,8 @@ static ssize_t ipa3_read_stats(struct file *file, char __user *ubuf,
 		"rmnet_ll_repl_rx_empty=%u\n"
 		"lan_rx_empty=%u\n"
 		"lan_repl_rx_empty=%u\n"
+		"lan_rx_zero_copy=%llu\n"
+		"lan_rx_buf_busy=%u\n"
 		"flow_enable=%u\n"
 		"flow_disable=%u\n"
 		"rx_page_drop_cnt=%u\n"
@@ -1565,6 +1570,9 @@ static ssize_t ipa3_read_stats(struct file *file, char __user *ubuf,
 		ipa3_ctx->stats.tx_sw_pkts,
 		ipa3_ctx->stats.tx_hw_pkts,
 		ipa3_ctx->stats.tx_non_linear,
+		ipa3_ctx->stats.tx_db,
+		ipa3_ctx->stats.tx_db_desc,
+		ipa3_ctx->stats.tx_db_timer_flush,
 		ipa3_ctx->stats.tx_pkts_compl,
 		ipa3_ctx->stats.rx_pkts,
 		ipa3_ctx->stats.stat_compl,
@@ -1579,6 +1587,8 @@ static ssize_t ipa3_read_stats(struct file *file, char __user *ubuf,
 		ipa3_ctx->stats.rmnet_ll_repl_rx_empty,
 		ipa3_ctx->stats.lan_rx_empty,
 		ipa3_ctx->stats.lan_repl_rx_empty,
+		ipa3_ctx->stats.lan_rx_zero_copy,
+		ipa3_ctx->stats.lan_rx_buf_busy,
 		ipa3_ctx->stats.flow_enable,
 		ipa3_ctx->stats.flow_disable,
 		ipa3_ctx->stats.rx_page_drop_cnt,
@@ -1647,11 +1657,15 @@ static ssize_t ipa3_read_page_recycle_stats(struct file *file,
 		"COAL   : Number of page recycled packets  =%llu\n"
 		"COAL   : Number of tmp alloc packets  =%llu\n"
 		"COAL   : Number of times tasklet scheduled  =%llu\n"
+		"COAL   : Number of pages reclaimed on replenish  =%llu\n"
+		"COAL   : Number of busy pages seen on replenish  =%llu\n"
 
 		"DEF    : Total number of packets replenished =%llu\n"
 		"DEF    : Number of page recycled packets =%llu\n"
 		"DEF    : Number of tmp alloc packets  =%llu\n"
 		"DEF    : Number of times tasklet scheduled  =%llu\n"
+		"DEF    : Number of pages reclaimed on replenish  =%llu\n"
+		"DEF    : Number of busy pages seen on replenish  =%llu\n"
 
 		"COMMON : Number of page recycled in tasklet  =%llu\n"
 		"COMMON : Number of times free pages not found in tasklet =%llu\n",
@@ -1660,11 +1674,15 @@ static ssize_t ipa3_read_page_recycle_stats(struct file *file,
 		ipa3_ctx->stats.page_recycle_stats[0].page_recycled,
 		ipa3_ctx->stats.page_recycle_stats[0].tmp_alloc,
 		ipa3_ctx->stats.num_sort_tasklet_sched[0],
+		ipa3_ctx->stats.page_recycle_stats[0].page_reclaimed,
+		ipa3_ctx->stats.page_recycle_stats[0].page_busy,
 
 		ipa3_ctx->stats.page_recycle_stats[1].total_replenished,
 		ipa3_ctx->stats.page_recycle_stats[1].page_recycled,
 		ipa3_ctx->stats.page_recycle_stats[1].tmp_alloc,
 		ipa3_ctx->stats.num_sort_tasklet_sched[1],
+		ipa3_ctx->stats.page_recycle_stats[1].page_reclaimed,
+		ipa3_ctx->stats.page_recycle_stats[1].page_busy,
 
 		ipa3_ctx->stats.page_recycle_cnt_in_tasklet,
 		ipa3_ctx->stats.num_of_times_wq_reschd);
@@ -2728,6 +2746,39 @@ ret:
 	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, cnt);
 }
 
+static ssize_t ipa3_pm_read_governor(struct file *file, char __user *ubuf,
+		size_t count, loff_t *ppos)
+{
+	int result, cnt = 0;
+
+	result = ipa_pm_governor_stat(dbg_buff, IPA_MAX_MSG_LEN);
+	if (result < 0) {
+		cnt += scnprintf(dbg_buff + cnt, IPA_MAX_MSG_LEN - cnt,
+				"Error in printing PM governor %d\n", result);
+		goto ret;
+	}
+	cnt += result;
+ret:
+	return simple_read_from_buffer(ubuf, count, ppos, dbg_buff, cnt);
+}
+
+static ssize_t ipa3_pm_write_governor(struct file *file,
+		const char __user *buf, size_t count, loff_t *ppos)
+{
+	s8 option = 0;
+	int ret;
+
+	ret = kstrtos8_from_user(buf, count, 0, &option);
+	if (ret)
+		return ret;
+
+	ret = ipa_pm_governor_enable(option != 0);
+	if (ret)
+		return ret;
+
+	return count;
+}
+
 static ssize_t ipa3_read_ipahal_regs(struct file *file, char __user *ubuf,
 		size_t count, loff_t *ppos)
 {
@@ -3852,6 +3903,11 @@ static const struct ipa3_debugfs_file debugfs_files[] = {
 		"pm_ex_stats", IPA_READ_ONLY_MODE, NULL, {
 			.read = ipa3_pm_ex_read_stats,
 		}
+	}, {
+		"pm_governor", IPA_READ_WRITE_MODE, NULL, {
+			.read = ipa3_pm_read_governor,
+			.write = ipa3_pm_write_governor,
+		}
 	}, {
 		"status_stats", IPA_READ_ONLY_MODE, NULL, {
 			.read = ipa_status_stats_read,
@@ -67,6 +67,12 @@
 
 #define IPA_RX_BUFF_CLIENT_HEADROOM 256
 
+/* bytes of a LAN packet copied for the client to parse, the rest is a frag */
+#define IPA_LAN_RX_FRAG_HDR_LEN 128
+
+/* in-flight pages checked per lock hold by the free page tasklet */
+#define IPA_PAGE_RECLAIM_BATCH 64
+
 #define IPA_WLAN_RX_POOL_SZ 100
 #define IPA_WLAN_RX_POOL_SZ_LOW_WM 5
 #define IPA_WLAN_RX_BUFF_SZ 2048
@@ -93,6 +99,9 @@
 #define IPA_REPL_XFER_MAX 36
 
 #define IPA_TX_SEND_COMPL_NOP_DELAY_NS (2 * 1000 * 1000)
+/* longest a doorbell is held back while the stack has more to send */
+#define IPA_TX_DB_DEFER_DELAY_NS (100 * 1000)
+#define IPA_TX_DB_DEFER_MAX_DESC 64
 
 #define IPA_APPS_BW_FOR_PM 700
 
@@ -109,6 +118,8 @@
 static int ipa3_tx_switch_to_intr_mode(struct ipa3_sys_context *sys);
 static int ipa3_rx_switch_to_intr_mode(struct ipa3_sys_context *sys);
 static struct sk_buff *ipa3_get_skb_ipa_rx(unsigned int len, gfp_t flags);
+static void ipa3_rx_skb_recycle(struct ipa3_sys_context *sys,
+	struct sk_buff *skb);
 static void ipa3_replenish_wlan_rx_cache(struct ipa3_sys_context *sys);
 static void ipa3_replenish_rx_cache(struct ipa3_sys_context *sys);
 static void ipa3_first_replenish_rx_cache(struct ipa3_sys_context *sys);
@@ -168,6 +179,24 @@ static void ipa3_collect_low_lat_data_recycle_stats_wq(struct work_struct *work)
 static DECLARE_DELAYED_WORK(ipa3_collect_low_lat_data_recycle_stats_wq_work,
 	ipa3_collect_low_lat_data_recycle_stats_wq);
 
+/* Reclaimed and busy page counts, reported apart from the legacy stats */
+static void ipa3_collect_recycle_ext_stats(enum rx_channel_type ch,
+	int stat_interval_index, struct ipa3_page_recycle_stats *cur,
+	struct ipa3_page_recycle_stats *prev)
+{
+	struct ipa_lnx_recycling_ext_stats *ext =
+		&ipa3_ctx->recycle_ext_stats.rx_channel[ch][stat_interval_index];
+
+	ext->reclaim_cumulative = cur->page_reclaimed;
+	ext->busy_cumulative = cur->page_busy;
+	ext->reclaim_diff = ext->reclaim_cumulative - prev->page_reclaimed;
+	ext->busy_diff = ext->busy_cumulative - prev->page_busy;
+	ext->valid = 1;
+
+	prev->page_reclaimed = ext->reclaim_cumulative;
+	prev->page_busy = ext->busy_cumulative;
+}
+
 static void ipa3_collect_default_coal_recycle_stats_wq(struct work_struct *work)
 {
 	struct ipa3_sys_context *sys;
@@ -245,6 +274,17 @@ static void ipa3_collect_default_coal_recycle_stats_wq(struct work_struct *work)
 	ipa3_ctx->recycle_stats.default_coal_stats_index =
 			(ipa3_ctx->recycle_stats.default_coal_stats_index + 1) % IPA_LNX_PIPE_PAGE_RECYCLING_INTERVAL_COUNT;
 
+	stat_interval_index = ipa3_ctx->recycle_ext_stats.default_coal_stats_index;
+	ipa3_ctx->recycle_ext_stats.interval_time_in_ms = IPA_LNX_PIPE_PAGE_RECYCLING_INTERVAL_TIME;
+	ipa3_collect_recycle_ext_stats(RX_WAN_COALESCING, stat_interval_index,
+		&ipa3_ctx->stats.page_recycle_stats[0],
+		&ipa3_ctx->prev_coal_recycle_stats);
+	ipa3_collect_recycle_ext_stats(RX_WAN_DEFAULT, stat_interval_index,
+		&ipa3_ctx->stats.page_recycle_stats[1],
+		&ipa3_ctx->prev_default_recycle_stats);
+	ipa3_ctx->recycle_ext_stats.default_coal_stats_index =
+			(stat_interval_index + 1) % IPA_LNX_PIPE_PAGE_RECYCLING_INTERVAL_COUNT;
+
 	if (sys && atomic_read(&sys->curr_polling_state))
 		queue_delayed_work(ipa3_ctx->collect_recycle_stats_wq,
 				&ipa3_collect_default_coal_recycle_stats_wq_work, msecs_to_jiffies(10));
@@ -301,6 +341,13 @@ static void ipa3_collect_low_lat_data_recycle_stats_wq(struct work_struct *work)
 	ipa3_ctx->recycle_stats.low_lat_stats_index =
 			(ipa3_ctx->recycle_stats.low_lat_stats_index + 1) % IPA_LNX_PIPE_PAGE_RECYCLING_INTERVAL_COUNT;
 
+	stat_interval_index = ipa3_ctx->recycle_ext_stats.low_lat_stats_index;
+	ipa3_collect_recycle_ext_stats(RX_WAN_LOW_LAT_DATA, stat_interval_index,
+		&ipa3_ctx->stats.page_recycle_stats[2],
+		&ipa3_ctx->prev_low_lat_data_recycle_stats);
+	ipa3_ctx->recycle_ext_stats.low_lat_stats_index =
+			(stat_interval_index + 1) % IPA_LNX_PIPE_PAGE_RECYCLING_INTERVAL_COUNT;
+
 	if (sys && atomic_read(&sys->curr_polling_state))
 		queue_delayed_work(ipa3_ctx->collect_recycle_stats_wq,
 				&ipa3_collect_low_lat_data_recycle_stats_wq_work, msecs_to_jiffies(10));
@@ -552,6 +599,15 @@ poll_tx:
 	return min(tx_done, budget);
 }
 
+/* Account a doorbell covering all the descriptors queued so far */
+static inline void ipa3_tx_db_rung(struct ipa3_sys_context *sys,
+	u32 num_desc)
+{
+	ipa3_ctx->stats.tx_db++;
+	ipa3_ctx->stats.tx_db_desc += sys->db_pending + num_desc;
+	sys->db_pending = 0;
+}
+
 static void ipa3_send_nop_desc(struct work_struct *work)
 {
 	struct ipa3_sys_context *sys = container_of(work,
@@ -564,6 +620,13 @@ static void ipa3_send_nop_desc(struct work_struct *work)
 		return;
 
 	spin_lock_bh(&sys->spinlock);
+	/* publish the descriptors whose doorbell was deferred */
+	if (sys->db_pending &&
+		gsi_queue_xfer(sys->ep->gsi_chan_hdl, 0, NULL, true) ==
+		GSI_STATUS_SUCCESS) {
+		ipa3_ctx->stats.tx_db_timer_flush++;
+		ipa3_tx_db_rung(sys, 0);
+	}
 	if (!list_empty(&sys->avail_tx_wrapper_list)) {
 		tx_pkt = list_first_entry(&sys->avail_tx_wrapper_list,
 				struct ipa3_tx_pkt_wrapper, link);
@@ -606,6 +669,7 @@ static void ipa3_send_nop_desc(struct work_struct *work)
 		queue_work(sys->wq, &sys->work);
 		return;
 	}
+	ipa3_tx_db_rung(sys, 1);
 	sys->len++;
 	sys->nop_pending = false;
 	spin_unlock_bh(&sys->spinlock);
@@ -616,11 +680,14 @@ static void ipa3_send_nop_desc(struct work_struct *work)
 
 
 /**
- * ipa3_send() - Send multiple descriptors in one HW transaction
+ * __ipa3_send() - Send multiple descriptors in one HW transaction
  * @sys: system pipe context
  * @num_desc: number of packets
  * @desc: packets to send (may be immediate command or data)
  * @in_atomic:  whether caller is in atomic context
+ * @xmit_more: more packets follow, the doorbell may be deferred. Only for
+ *  pipes whose work is ipa3_send_nop_desc(), which rings it when db_timer
+ *  expires.
  *
  * This function is used for GPI connection.
  * - ipa3_tx_pkt_wrapper will be used for each ipa
@@ -632,10 +699,11 @@ static void ipa3_send_nop_desc(struct work_struct *work)
  *
  * Return codes: 0: success, -EFAULT: failure
  */
-int ipa3_send(struct ipa3_sys_context *sys,
+static int __ipa3_send(struct ipa3_sys_context *sys,
 		u32 num_desc,
 		struct ipa3_desc *desc,
-		bool in_atomic)
+		bool in_atomic,
+		bool xmit_more)
 {
 	struct ipa3_tx_pkt_wrapper *tx_pkt, *tx_pkt_first = NULL;
 	struct ipahal_imm_cmd_pyld *tag_pyld_ret = NULL;
@@ -647,6 +715,8 @@ int ipa3_send(struct ipa3_sys_context *sys,
 	u32 mem_flag = GFP_ATOMIC;
 	const struct ipa_gsi_ep_config *gsi_ep_cfg;
 	bool send_nop = false;
+	bool ring_db;
+	u64 timer_ns = 0;
 	unsigned int max_desc;
 
 	if (unlikely(!in_atomic))
@@ -688,6 +758,13 @@ int ipa3_send(struct ipa3_sys_context *sys,
 		return -EFAULT;
 	}
 
+	/*
+	 * While the stack has more packets for us only queue the descriptors,
+	 * they are published by the doorbell of a later send or by db_timer.
+	 */
+	ring_db = !xmit_more ||
+		sys->db_pending + num_desc >= IPA_TX_DB_DEFER_MAX_DESC;
+
 	for (i = 0; i < num_desc; i++) {
 		if (!list_empty(&sys->avail_tx_wrapper_list)) {
 			tx_pkt = list_first_entry(&sys->avail_tx_wrapper_list,
@@ -794,7 +871,8 @@ int ipa3_send(struct ipa3_sys_context *sys,
 					GSI_XFER_FLAG_EOT;
 				gsi_xfer[i].flags |=
 					GSI_XFER_FLAG_BEI;
-				hrtimer_try_to_cancel(&sys->db_timer);
+				if (ring_db)
+					hrtimer_try_to_cancel(&sys->db_timer);
 				sys->nop_pending = false;
 			} else {
 				send_nop = true;
@@ -809,9 +887,13 @@ int ipa3_send(struct ipa3_sys_context *sys,
 
 	IPADBG_LOW("ch:%lu queue xfer\n", sys->ep->gsi_chan_hdl);
 	result = gsi_queue_xfer(sys->ep->gsi_chan_hdl, num_desc,
-			gsi_xfer, true);
+			gsi_xfer, ring_db);
 	if (result != GSI_STATUS_SUCCESS) {
 		IPAERR_RL("GSI xfer failed.\n");
+		/* don't hold back what was queued before */
+		if (sys->db_pending && gsi_queue_xfer(sys->ep->gsi_chan_hdl,
+			0, NULL, true) == GSI_STATUS_SUCCESS)
+			ipa3_tx_db_rung(sys, 0);
 		result = -EFAULT;
 		goto failure;
 	}
@@ -821,12 +903,24 @@ int ipa3_send(struct ipa3_sys_context *sys,
 	else
 		send_nop = false;
 
+	if (ring_db) {
+		ipa3_tx_db_rung(sys, num_desc);
+	} else {
+		sys->db_pending += num_desc;
+		/* first deferred send bounds the doorbell delay */
+		if (sys->db_pending == num_desc)
+			timer_ns = IPA_TX_DB_DEFER_DELAY_NS;
+	}
+	if (send_nop && !timer_ns)
+		timer_ns = sys->db_pending ? IPA_TX_DB_DEFER_DELAY_NS :
+			IPA_TX_SEND_COMPL_NOP_DELAY_NS;
+
 	sys->pkt_sent++;
 	spin_unlock_bh(&sys->spinlock);
 
-	/* set the timer for sending the NOP descriptor */
-	if (send_nop) {
-		ktime_t time = ktime_set(0, IPA_TX_SEND_COMPL_NOP_DELAY_NS);
+	/* set the timer for sending the NOP descriptor or the doorbell */
+	if (timer_ns) {
+		ktime_t time = ktime_set(0, timer_ns);
 
 		IPADBG_LOW("scheduling timer for ch %lu\n",
 			sys->ep->gsi_chan_hdl);
@@ -869,6 +963,14 @@ failure:
 	return result;
 }
 
+int ipa3_send(struct ipa3_sys_context *sys,
+		u32 num_desc,
+		struct ipa3_desc *desc,
+		bool in_atomic)
+{
+	return __ipa3_send(sys, num_desc, desc, in_atomic, false);
+}
+
 /**
  * ipa3_send_one() - Send a single descriptor
  * @sys:	system pipe context
@@ -1392,6 +1494,60 @@ fail_setup:
 	return result;
 }
 
+/*
+ * Give a page whose only reference is ours back to the free ring. Should the
+ * ring be full, put it at the head of the in-flight list where the next
+ * reclaim pass picks it up first.
+ */
+static void ipa3_page_recycle_put(struct ipa3_sys_context *sys,
+	struct ipa3_rx_pkt_wrapper *rx_pkt)
+{
+	if (likely(!ptr_ring_produce_bh(&sys->page_recycle_repl->free_ring,
+		rx_pkt)))
+		return;
+
+	spin_lock_bh(&sys->common_sys->spinlock);
+	list_add(&rx_pkt->link, &sys->page_recycle_repl->page_repl_head);
+	spin_unlock_bh(&sys->common_sys->spinlock);
+}
+
+/*
+ * Check up to @budget pages from the head of the in-flight list, oldest
+ * first, and move the ones the stack has released to the free ring. Pages
+ * still in use are rotated to the tail so the next pass starts with the
+ * ones that had the longest time to be released.
+ * Returns the number of pages moved, @busy is set to the number in use.
+ */
+static int ipa3_page_recycle_reclaim(struct ipa3_sys_context *sys,
+	u32 budget, u32 *busy)
+{
+	struct ipa3_page_repl_ctx *repl = sys->page_recycle_repl;
+	struct ipa3_rx_pkt_wrapper *rx_pkt;
+	int reclaimed = 0;
+	u32 i;
+
+	*busy = 0;
+	spin_lock_bh(&sys->common_sys->spinlock);
+	for (i = 0; i < budget && !list_empty(&repl->page_repl_head); i++) {
+		rx_pkt = list_first_entry(&repl->page_repl_head,
+			struct ipa3_rx_pkt_wrapper, link);
+		if (page_ref_count(rx_pkt->page_data.page) != 1) {
+			list_move_tail(&rx_pkt->link, &repl->page_repl_head);
+			(*busy)++;
+			continue;
+		}
+		list_del_init(&rx_pkt->link);
+		if (ptr_ring_produce_bh(&repl->free_ring, rx_pkt)) {
+			list_add(&rx_pkt->link, &repl->page_repl_head);
+			break;
+		}
+		reclaimed++;
+	}
+	spin_unlock_bh(&sys->common_sys->spinlock);
+
+	return reclaimed;
+}
+
 static void ipa3_schd_freepage_work(struct work_struct *work)
 {
 	struct delayed_work *dwork;
@@ -1408,29 +1564,29 @@ static void ipa3_schd_freepage_work(struct work_struct *work)
 static void ipa3_tasklet_find_freepage(unsigned long data)
 {
 	struct ipa3_sys_context *sys;
-	struct ipa3_rx_pkt_wrapper *rx_pkt = NULL;
-	struct ipa3_rx_pkt_wrapper *tmp = NULL;
-	struct page *cur_page;
 	int found_free_page = 0;
-	struct list_head temp_head;
+	int found;
+	u32 visited;
+	u32 busy;
 
 	sys = (struct ipa3_sys_context *)data;
 
 	if(sys->page_recycle_repl == NULL)
 		return;
-	INIT_LIST_HEAD(&temp_head);
-	spin_lock_bh(&sys->common_sys->spinlock);
-	list_for_each_entry_safe(rx_pkt, tmp,
-		&sys->page_recycle_repl->page_repl_head, link) {
-		cur_page = rx_pkt->page_data.page;
-		if (page_ref_count(cur_page) == 1) {
-			/* Found a free page. */
-			list_del_init(&rx_pkt->link);
-			list_add(&rx_pkt->link, &temp_head);
-			found_free_page++;
-		}
+
+	/* One pass over the in-flight pages, the lock is dropped per batch */
+	for (visited = 0; visited < sys->page_recycle_repl->capacity;
+		visited += IPA_PAGE_RECLAIM_BATCH) {
+		found = ipa3_page_recycle_reclaim(sys,
+			IPA_PAGE_RECLAIM_BATCH, &busy);
+		found_free_page += found;
+		/* In-flight list exhausted or free ring full */
+		if (found + busy < IPA_PAGE_RECLAIM_BATCH)
+			break;
 	}
-	if (!found_free_page) {
+
+	if (!found_free_page &&
+		ptr_ring_empty_bh(&sys->page_recycle_repl->free_ring)) {
 		/*Not found free page rescheduling tasklet after 2msec*/
 		IPADBG_LOW("Scheduling WQ not found free pages\n");
 		++ipa3_ctx->stats.num_of_times_wq_reschd;
@@ -1439,14 +1595,11 @@ static void ipa3_tasklet_find_freepage(unsigned long data)
 				msecs_to_jiffies(ipa3_ctx->page_wq_reschd_time));
 	} else {
 		/*Allow to use pre-allocated buffers*/
-		list_splice(&temp_head, &sys->page_recycle_repl->page_repl_head);
 		ipa3_ctx->stats.page_recycle_cnt_in_tasklet += found_free_page;
 		IPADBG_LOW("found free pages count = %d\n", found_free_page);
 		ipa3_ctx->free_page_task_scheduled = false;
 		atomic_set(&sys->common_sys->page_avilable, 1);
 	}
-	spin_unlock_bh(&sys->common_sys->spinlock);
-
 }
 
 /**
@@ -1782,6 +1935,15 @@ int ipa3_setup_sys_pipe(struct ipa_sys_connect_params *sys_in, u32 *clnt_hdl)
 							IPA_GENERIC_RX_PAGE_POOL_SZ_FACTOR;
 				IPADBG("Page repl capacity for client:%d, value:%d\n",
 						   sys_in->client, ep->sys->page_recycle_repl->capacity);
+				if (ptr_ring_init(&ep->sys->page_recycle_repl->free_ring,
+					ep->sys->page_recycle_repl->capacity, GFP_KERNEL)) {
+					IPAERR("failed to alloc free ring for client %d\n",
+							sys_in->client);
+					kfree(ep->sys->page_recycle_repl);
+					ep->sys->page_recycle_repl = NULL;
+					result = -ENOMEM;
+					goto fail_napi;
+				}
 				INIT_LIST_HEAD(&ep->sys->page_recycle_repl->page_repl_head);
 				INIT_DELAYED_WORK(&ep->sys->freepage_work, ipa3_schd_freepage_work);
 				tasklet_init(&ep->sys->tasklet_find_freepage,
@@ -1932,6 +2094,7 @@ fail_repl:
 	}
 fail_page_recycle_repl:
 	if (ep->sys->page_recycle_repl && !ep->sys->common_buff_pool) {
+		ptr_ring_cleanup(&ep->sys->page_recycle_repl->free_ring, NULL);
 		kfree(ep->sys->page_recycle_repl);
 		ep->sys->page_recycle_repl = NULL;
 	}
@@ -2340,13 +2503,30 @@ void ipa3_tx_cmd_comp(void *user1, int user2)
  */
 int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 		struct ipa_tx_meta *meta)
+{
+	return __ipa3_tx_dp(dst, skb, meta, false);
+}
+
+/**
+ * __ipa3_tx_dp() - ipa3_tx_dp() with a doorbell batching hint
+ * @dst:	[in] which IPA destination to route tx packets to
+ * @skb:	[in] the packet to send
+ * @meta:	[in] TX packet meta-data
+ * @xmit_more:	[in] the caller has more packets to send right away, the
+ *		doorbell may be deferred until the last one. Only for
+ *		IPA_CLIENT_APPS_WAN_PROD, see __ipa3_send()
+ *
+ * Returns:	0 on success, negative on failure
+ */
+int __ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
+		struct ipa_tx_meta *meta, bool xmit_more)
 {
 	struct ipa3_desc *desc;
 	struct ipa3_desc _desc[3];
 	int dst_ep_idx;
 	struct ipa3_sys_context *sys;
 	int src_ep_idx;
-	int num_frags, f;
+	int num_frags, f, lin;
 	const struct ipa_gsi_ep_config *gsi_ep;
 	int data_idx;
 	unsigned int max_desc;
@@ -2513,7 +2693,8 @@ int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 			desc[skb_idx].callback = NULL;
 		}
 
-		if (ipa3_send(sys, num_frags + data_idx, desc, true)) {
+		if (__ipa3_send(sys, num_frags + data_idx, desc, true,
+			xmit_more)) {
 			IPAERR_RL("fail to send skb %pK num_frags %u SWP\n",
 				skb, num_frags);
 			goto fail_send;
@@ -2544,27 +2725,37 @@ int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 			desc[data_idx].dma_address = meta->dma_address;
 		}
 		if (num_frags == 0) {
-			if (ipa3_send(sys, data_idx + 1, desc, true)) {
+			if (__ipa3_send(sys, data_idx + 1, desc, true,
+				xmit_more)) {
 				IPAERR_RL("fail to send skb %pK HWP\n", skb);
 				goto fail_mem;
 			}
 		} else {
+			/*
+			 * An skb without linear data, like an rmnet SG
+			 * aggregate, is sent from its frags alone.
+			 */
+			lin = skb_headlen(skb) ? 1 : 0;
+			if (!lin)
+				memset(&desc[data_idx], 0, sizeof(*desc));
+
 			for (f = 0; f < num_frags; f++) {
-				desc[data_idx+f+1].frag =
+				desc[data_idx+f+lin].frag =
 					&skb_shinfo(skb)->frags[f];
-				desc[data_idx+f+1].type =
+				desc[data_idx+f+lin].type =
 					IPA_DATA_DESC_SKB_PAGED;
-				desc[data_idx+f+1].len =
-					skb_frag_size(desc[data_idx+f+1].frag);
+				desc[data_idx+f+lin].len =
+					skb_frag_size(desc[data_idx+f+lin].frag);
 			}
 			/* don't free skb till frag mappings are released */
-			desc[data_idx+f].callback = desc[data_idx].callback;
-			desc[data_idx+f].user1 = desc[data_idx].user1;
-			desc[data_idx+f].user2 = desc[data_idx].user2;
 			desc[data_idx].callback = NULL;
+			desc[data_idx+f+lin-1].callback =
+				ipa3_tx_comp_usr_notify_release;
+			desc[data_idx+f+lin-1].user1 = skb;
+			desc[data_idx+f+lin-1].user2 = src_ep_idx;
 
-			if (ipa3_send(sys, num_frags + data_idx + 1,
-				desc, true)) {
+			if (__ipa3_send(sys, num_frags + data_idx + lin,
+				desc, true, xmit_more)) {
 				IPAERR_RL("fail to send skb %pK num_frags %u\n",
 					skb, num_frags);
 				goto fail_mem;
@@ -2774,8 +2965,7 @@ static void ipa3_replenish_rx_page_cache(struct ipa3_sys_context *sys)
 		}
 		INIT_LIST_HEAD(&rx_pkt->link);
 		rx_pkt->sys = sys;
-		list_add_tail(&rx_pkt->link,
-			&sys->page_recycle_repl->page_repl_head);
+		ipa3_page_recycle_put(sys, rx_pkt);
 	}
 	atomic_set(&sys->common_sys->page_avilable, 1);
 
@@ -2852,30 +3042,31 @@ static struct ipa3_rx_pkt_wrapper * ipa3_get_free_page
 	u32 stats_i
 )
 {
-	struct ipa3_rx_pkt_wrapper *rx_pkt = NULL;
-	struct ipa3_rx_pkt_wrapper *tmp = NULL;
-	struct page *cur_page;
-	int i = 0;
-	u8 LOOP_THRESHOLD = ipa3_ctx->page_poll_threshold;
+	struct ipa3_page_recycle_stats *stats =
+		&ipa3_ctx->stats.page_recycle_stats[stats_i];
+	struct ipa3_rx_pkt_wrapper *rx_pkt;
+	u32 busy = 0;
 
-	spin_lock_bh(&sys->common_sys->spinlock);
-	list_for_each_entry_safe(rx_pkt, tmp,
-		&sys->page_recycle_repl->page_repl_head, link) {
-		if (i == LOOP_THRESHOLD)
-			break;
-		cur_page = rx_pkt->page_data.page;
-		if (page_ref_count(cur_page) == 1) {
-			/* Found a free page. */
-			page_ref_inc(cur_page);
-			list_del_init(&rx_pkt->link);
-			++ipa3_ctx->stats.page_recycle_cnt[stats_i][i];
-			sys->common_sys->napi_sort_page_thrshld_cnt = 0;
-			spin_unlock_bh(&sys->common_sys->spinlock);
-			return rx_pkt;
+	rx_pkt = ptr_ring_consume_bh(&sys->page_recycle_repl->free_ring);
+	if (!rx_pkt) {
+		/* Nothing released yet, check the oldest in-flight pages */
+		if (ipa3_page_recycle_reclaim(sys,
+			ipa3_ctx->page_poll_threshold, &busy)) {
+			rx_pkt = ptr_ring_consume_bh(
+				&sys->page_recycle_repl->free_ring);
+			if (rx_pkt)
+				stats->page_reclaimed++;
 		}
-		i++;
+		stats->page_busy += busy;
 	}
-	spin_unlock_bh(&sys->common_sys->spinlock);
+
+	if (rx_pkt) {
+		page_ref_inc(rx_pkt->page_data.page);
+		++ipa3_ctx->stats.page_recycle_cnt[stats_i][busy];
+		sys->common_sys->napi_sort_page_thrshld_cnt = 0;
+		return rx_pkt;
+	}
+
 	IPADBG_LOW("napi_sort_page_thrshld_cnt = %d ipa_max_napi_sort_page_thrshld = %d\n",
 			sys->common_sys->napi_sort_page_thrshld_cnt,
 			ipa3_ctx->ipa_max_napi_sort_page_thrshld);
@@ -3538,6 +3729,22 @@ static void ipa3_replenish_rx_cache_recycle(struct ipa3_sys_context *sys)
 			list_del_init(&rx_pkt->link);
 			spin_unlock_bh(&sys->spinlock);
 			ipa3_ctx->stats.cache_recycle_stats[stats_i].pkt_found++;
+
+			/* packets handed up still point into this buffer */
+			if (unlikely(sys->lan_rx_frag && page_ref_count(
+				virt_to_head_page(rx_pkt->data.skb->head)) > 1)) {
+				ipa3_ctx->stats.lan_rx_buf_busy++;
+				sys->free_skb(rx_pkt->data.skb);
+				rx_pkt->data.skb = sys->get_skb(sys->rx_buff_sz,
+					flag);
+				if (!rx_pkt->data.skb) {
+					IPAERR("failed to alloc skb\n");
+					kmem_cache_free(
+						ipa3_ctx->rx_pkt_wrapper_cache,
+						rx_pkt);
+					goto fail_kmem_cache_alloc;
+				}
+			}
 		}
 
 		ptr = skb_put(rx_pkt->data.skb, sys->rx_buff_sz);
@@ -3580,7 +3787,7 @@ static void ipa3_replenish_rx_cache_recycle(struct ipa3_sys_context *sys)
 	goto done;
 fail_dma_mapping:
 	spin_lock_bh(&sys->spinlock);
-	ipa3_skb_recycle(rx_pkt->data.skb);
+	ipa3_rx_skb_recycle(sys, rx_pkt->data.skb);
 	list_add_tail(&rx_pkt->link, &sys->rcycl_list);
 	spin_unlock_bh(&sys->spinlock);
 fail_kmem_cache_alloc:
@@ -3732,11 +3939,7 @@ static void free_rx_page(void *chan_user_data, void *xfer_user_data)
 	if (!rx_pkt->page_data.is_tmp_alloc) {
 		list_del_init(&rx_pkt->link);
 		page_ref_dec(rx_pkt->page_data.page);
-		spin_lock_bh(&rx_pkt->sys->common_sys->spinlock);
-		/* Add the element to head. */
-		list_add(&rx_pkt->link,
-			&rx_pkt->sys->page_recycle_repl->page_repl_head);
-		spin_unlock_bh(&rx_pkt->sys->common_sys->spinlock);
+		ipa3_page_recycle_put(rx_pkt->sys, rx_pkt);
 	} else {
 		dma_unmap_page(ipa3_ctx->pdev, rx_pkt->page_data.dma_addr,
 			rx_pkt->len, DMA_FROM_DEVICE);
@@ -3826,6 +4029,37 @@ static struct sk_buff *ipa3_skb_copy_for_client(struct sk_buff *skb, int len)
 	return skb2;
 }
 
+/*
+ * Hand up a packet that is fully in the RX buffer without copying its
+ * payload: the status and the first IPA_LAN_RX_FRAG_HDR_LEN bytes are
+ * copied for the client to parse, the rest is a frag of the buffer page.
+ * The frag is charged its share of the buffer, by the @used bytes of it
+ * the packets sharing the buffer take up.
+ */
+static struct sk_buff *ipa3_skb_frag_for_client(struct sk_buff *skb, int len,
+	u32 pkt_status_sz, unsigned int used)
+{
+	int copy = min_t(int, len, pkt_status_sz + IPA_LAN_RX_FRAG_HDR_LEN);
+	struct sk_buff *skb2;
+	struct page *page;
+	unsigned int truesize;
+
+	skb2 = ipa3_skb_copy_for_client(skb, copy);
+	if (unlikely(!skb2) || copy == len)
+		return skb2;
+
+	page = virt_to_head_page(skb->data);
+	truesize = (PAGE_SIZE << compound_order(page)) * ALIGN(len, 32) /
+		ALIGN(used, 32);
+	get_page(page);
+	skb_add_rx_frag(skb2, 0, page,
+		skb->data + copy - (unsigned char *)page_address(page),
+		len - copy, max_t(unsigned int, truesize, len - copy));
+	ipa3_ctx->stats.lan_rx_zero_copy++;
+
+	return skb2;
+}
+
 static int ipa3_lan_rx_pyld_hdlr(struct sk_buff *skb,
 		struct ipa3_sys_context *sys)
 {
@@ -3841,6 +4075,7 @@ static int ipa3_lan_rx_pyld_hdlr(struct sk_buff *skb,
 	unsigned long unused = IPA_GENERIC_RX_BUFF_BASE_SZ - used;
 	struct ipa3_tx_pkt_wrapper *tx_pkt = NULL;
 	unsigned long ptr;
+	bool frag;
 
 	IPA_DUMP_BUFF(skb->data, 0, skb->len);
 
@@ -4057,8 +4292,22 @@ begin:
 				sys->drop_packet = true;
 			}
 
-			skb2 = ipa3_skb_copy_for_client(skb,
-				min(status.pkt_len + pkt_status_sz, skb->len));
+			/*
+			 * Packets spanning buffers are still joined by copy,
+			 * and clients parsing the whole payload in place get
+			 * a linear copy.
+			 */
+			frag = sys->lan_rx_frag &&
+				ipa3_ctx->ep[src_pipe].rx_frag_ok &&
+				skb->len >= len + pkt_status_sz;
+			if (frag)
+				skb2 = ipa3_skb_frag_for_client(skb,
+					status.pkt_len + pkt_status_sz,
+					pkt_status_sz, used);
+			else
+				skb2 = ipa3_skb_copy_for_client(skb,
+					min(status.pkt_len + pkt_status_sz,
+					skb->len));
 			if (likely(skb2)) {
 				if (skb->len < len + pkt_status_sz) {
 					IPADBG_LOW("SPL skb len %d len %d\n",
@@ -4088,11 +4337,14 @@ begin:
 						sys->drop_packet = true;
 						dev_kfree_skb_any(skb2);
 					} else {
-						skb2->truesize = skb2->len +
-						sizeof(struct sk_buff) +
-						(ALIGN(len +
-						pkt_status_sz, 32) *
-						unused / used_align);
+						/* frags are charged when added */
+						if (!frag)
+							skb2->truesize =
+							skb2->len +
+							sizeof(struct sk_buff) +
+							(ALIGN(len +
+							pkt_status_sz, 32) *
+							unused / used_align);
 						sys->ep->client_notify(
 							sys->ep->priv,
 							IPA_RECEIVE,
@@ -4129,7 +4381,7 @@ begin:
 	}
 
 out:
-	ipa3_skb_recycle(skb);
+	ipa3_rx_skb_recycle(sys, skb);
 	return 0;
 }
 
@@ -4380,6 +4632,39 @@ static struct sk_buff *ipa3_get_skb_ipa_rx(unsigned int len, gfp_t flags)
 	return __dev_alloc_skb(len, flags);
 }
 
+/*
+ * Same layout as ipa3_get_skb_ipa_rx() but the head is a page, so packets
+ * can be handed up as frags of it.
+ */
+static struct sk_buff *ipa3_get_skb_ipa_rx_frag(unsigned int len,
+	gfp_t flags)
+{
+	unsigned int order = get_order(IPA_REAL_GENERIC_RX_BUFF_SZ(len));
+	struct sk_buff *skb;
+	struct page *page;
+
+	page = __dev_alloc_pages(flags, order);
+	if (unlikely(!page))
+		return NULL;
+
+	skb = build_skb(page_address(page), PAGE_SIZE << order);
+	if (unlikely(!skb)) {
+		__free_pages(page, order);
+		return NULL;
+	}
+	skb_reserve(skb, NET_SKB_PAD);
+
+	return skb;
+}
+
+static void ipa3_rx_skb_recycle(struct ipa3_sys_context *sys,
+	struct sk_buff *skb)
+{
+	ipa3_skb_recycle(skb);
+	/* cleared by the reset, needed to free a page head */
+	skb->head_frag = sys->lan_rx_frag;
+}
+
 static void ipa3_free_skb_rx(struct sk_buff *skb)
 {
 	dev_kfree_skb_any(skb);
@@ -5378,11 +5663,7 @@ static struct sk_buff *handle_page_completion(struct gsi_chan_xfer_notify
 		IPAERR("notify->veid > GSI_VEID_MAX\n");
 		if (!rx_page.is_tmp_alloc) {
 			init_page_count(rx_page.page);
-			spin_lock_bh(&rx_pkt->sys->common_sys->spinlock);
-			/* Add the element to head. */
-			list_add(&rx_pkt->link,
-				&rx_pkt->sys->page_recycle_repl->page_repl_head);
-			spin_unlock_bh(&rx_pkt->sys->common_sys->spinlock);
+			ipa3_page_recycle_put(rx_pkt->sys, rx_pkt);
 		} else {
 			dma_unmap_page(ipa3_ctx->pdev, rx_page.dma_addr,
 					rx_pkt->len, DMA_FROM_DEVICE);
@@ -5410,11 +5691,7 @@ static struct sk_buff *handle_page_completion(struct gsi_chan_xfer_notify
 				list_del_init(&rx_pkt->link);
 				if (!rx_page.is_tmp_alloc) {
 					init_page_count(rx_page.page);
-					spin_lock_bh(&rx_pkt->sys->common_sys->spinlock);
-					/* Add the element to head. */
-					list_add(&rx_pkt->link,
-						&rx_pkt->sys->page_recycle_repl->page_repl_head);
-					spin_unlock_bh(&rx_pkt->sys->common_sys->spinlock);
+					ipa3_page_recycle_put(rx_pkt->sys, rx_pkt);
 				} else {
 					dma_unmap_page(ipa3_ctx->pdev, rx_page.dma_addr,
 						rx_pkt->len, DMA_FROM_DEVICE);
@@ -5772,6 +6049,8 @@ static int ipa3_assign_policy(struct ipa_sys_connect_params *in,
 			if (IPA_CLIENT_IS_LAN_CONS(in->client)) {
 				INIT_WORK(&sys->repl_work, ipa3_wq_repl_rx);
 				sys->pyld_hdlr = ipa3_lan_rx_pyld_hdlr;
+				sys->get_skb = ipa3_get_skb_ipa_rx_frag;
+				sys->lan_rx_frag = true;
 				sys->repl_hdlr =
 					ipa3_replenish_rx_cache_recycle;
 				sys->free_rx_wrapper =
@@ -6719,21 +6998,104 @@ alloc:
 	return va_addr;
 }
 
+/**
+ * ipa3_msi_napi_cpu() - CPU the MSI of a consumer pipe is steered to
+ * @ep: endpoint the event ring is set up for
+ *
+ * Pipes with their own MSI run their completion ISR, and so their NAPI
+ * poll, on that CPU instead of behind the other pipes in the shared GSI ISR.
+ *
+ * Return: the CPU, or -1 if the pipe stays on the shared GSI IRQ
+ */
+static int ipa3_msi_napi_cpu(struct ipa3_ep_context *ep)
+{
+	enum ipa3_msi_napi_pipe pipe;
+
+	if (!ipa3_ctx->gsi_msi_addr)
+		return -1;
+
+	switch (ep->client) {
+	case IPA_CLIENT_APPS_WAN_COAL_CONS:
+		pipe = IPA_MSI_NAPI_WAN_COAL;
+		break;
+	case IPA_CLIENT_APPS_WAN_CONS:
+		pipe = IPA_MSI_NAPI_WAN;
+		break;
+	case IPA_CLIENT_APPS_LAN_CONS:
+	case IPA_CLIENT_APPS_LAN_COAL_CONS:
+		pipe = IPA_MSI_NAPI_LAN;
+		break;
+	case IPA_CLIENT_APPS_WAN_LOW_LAT_CONS:
+	case IPA_CLIENT_APPS_WAN_LOW_LAT_DATA_CONS:
+		pipe = IPA_MSI_NAPI_LOW_LAT;
+		break;
+	default:
+		return -1;
+	}
+
+	return ipa3_ctx->msi_napi_cpu[pipe];
+}
+
+/**
+ * ipa3_msi_required() - whether a consumer pipe only works with its own MSI
+ * @client: client of the pipe
+ */
+static bool ipa3_msi_required(enum ipa_client_type client)
+{
+	return client == IPA_CLIENT_APPS_WAN_LOW_LAT_CONS ||
+		client == IPA_CLIENT_APPS_WAN_LOW_LAT_DATA_CONS;
+}
+
+/**
+ * ipa3_msi_napi_avail() - whether an MSI is left for a NAPI consumer pipe
+ *
+ * MSIs are few, and the WAN and LAN pipes are set up before the low latency
+ * ones. Keep one MSI for each enabled low latency pipe not set up yet, as
+ * those fail without it.
+ */
+static bool ipa3_msi_napi_avail(void)
+{
+	int reserved = 0;
+	int ep_idx;
+
+	if (ipa3_ctx->rmnet_ctl_enable) {
+		ep_idx = ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_LOW_LAT_CONS);
+		if (ep_idx != IPA_EP_NOT_ALLOCATED &&
+			!ipa3_ctx->ep[ep_idx].valid)
+			reserved++;
+	}
+
+	if (ipa3_ctx->rmnet_ll_enable) {
+		ep_idx = ipa3_get_ep_mapping(
+			IPA_CLIENT_APPS_WAN_LOW_LAT_DATA_CONS);
+		if (ep_idx != IPA_EP_NOT_ALLOCATED &&
+			!ipa3_ctx->ep[ep_idx].valid)
+			reserved++;
+	}
+
+	return gsi_get_num_free_msi() > reserved;
+}
+
 static int ipa_gsi_setup_event_ring(struct ipa3_ep_context *ep,
 	u32 ring_size, gfp_t mem_flag)
 {
 	struct gsi_evt_ring_props gsi_evt_ring_props;
 	dma_addr_t evt_dma_addr;
 	dma_addr_t evt_rp_dma_addr;
+	bool msi_required = ipa3_msi_required(ep->client);
+	int msi_cpu = ipa3_msi_napi_cpu(ep);
 	int result;
 
 	evt_dma_addr = 0;
 	evt_rp_dma_addr = 0;
 	memset(&gsi_evt_ring_props, 0, sizeof(gsi_evt_ring_props));
 	gsi_evt_ring_props.intf = GSI_EVT_CHTYPE_GPI_EV;
-	if ((ipa3_ctx->gsi_msi_addr) &&
-		(ep->client == IPA_CLIENT_APPS_WAN_LOW_LAT_DATA_CONS ||
-		ep->client == IPA_CLIENT_APPS_WAN_LOW_LAT_CONS))
+	if (msi_cpu >= 0 && !msi_required && !ipa3_msi_napi_avail()) {
+		IPADBG("MSIs kept for low latency, client %d shares the IRQ\n",
+			ep->client);
+		msi_cpu = -1;
+	}
+	if ((ipa3_ctx->gsi_msi_addr) && (msi_required || msi_cpu >= 0))
 		gsi_evt_ring_props.intr = GSI_INTR_MSI; // intvec chosen dynamically.
 	else gsi_evt_ring_props.intr = GSI_INTR_IRQ;
 	gsi_evt_ring_props.re_size = GSI_EVT_RING_RE_SIZE_16B;
@@ -6802,9 +7164,24 @@ static int ipa_gsi_setup_event_ring(struct ipa3_ep_context *ep,
 
 	result = gsi_alloc_evt_ring(&gsi_evt_ring_props,
 		ipa3_ctx->gsi_dev_hdl, &ep->gsi_evt_ring_hdl);
+	if (result == -GSI_STATUS_NODEV && msi_cpu >= 0 && !msi_required) {
+		/* out of MSIs, share the GSI IRQ */
+		IPADBG("no MSI left for client %d\n", ep->client);
+		msi_cpu = -1;
+		gsi_evt_ring_props.intr = GSI_INTR_IRQ;
+		gsi_evt_ring_props.intvec = 0;
+		gsi_evt_ring_props.msi_addr = 0;
+		result = gsi_alloc_evt_ring(&gsi_evt_ring_props,
+			ipa3_ctx->gsi_dev_hdl, &ep->gsi_evt_ring_hdl);
+	}
 	if (result != GSI_STATUS_SUCCESS)
 		goto fail_alloc_evt_ring;
 
+	if (msi_cpu >= 0 &&
+		gsi_set_evt_ring_msi_affinity(ep->gsi_evt_ring_hdl, msi_cpu))
+		IPAERR("failed to steer client %d MSI to cpu %d\n",
+			ep->client, msi_cpu);
+
 	return 0;
 
 fail_alloc_evt_ring:
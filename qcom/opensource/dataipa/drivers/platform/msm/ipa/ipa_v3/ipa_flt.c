@@ -261,6 +261,7 @@ static int ipa_translate_flt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 			tbl->curr_mem[rlt] = tbl_mem;
 		} else {
 			offset = body_i - base + body_ofst;
+			tbl->lcl_ofst[rlt] = body_i - base;
 
 			/* update the hdr at the right index */
 			if (ipahal_fltrt_write_addr_to_hdr(offset, hdr,
@@ -290,6 +291,7 @@ static int ipa_translate_flt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 			body_i += ipahal_get_lcl_tbl_addr_alignment();
 			body_i = (u8 *)((long)body_i &
 				~ipahal_get_lcl_tbl_addr_alignment());
+			tbl->lcl_room[rlt] = body_i - base - tbl->lcl_ofst[rlt];
 		}
 		hdr_idx++;
 	}
@@ -471,7 +473,166 @@ static bool ipa_flt_skip_pipe_config(int pipe)
 }
 
 /**
- * __ipa_commit_flt_v3() - commit flt tables to the hw
+ * ipa_flt_prep_flush_cmds() - prepare the ICs each flt commit starts with:
+ *  close the coalescing frame (if coal is enabled) and flush the hashable
+ *  flt rules cache
+ * @ip: the ip address family type
+ * @desc: descriptor buffer
+ * @cmd_pyld: imm cmds payload pointers buffer
+ * @num_cmd: [IN/OUT] number of commands in the buffers
+ *
+ * Return: 0 on success, negative on failure
+ */
+static int ipa_flt_prep_flush_cmds(enum ipa_ip_type ip, struct ipa3_desc *desc,
+	struct ipahal_imm_cmd_pyld **cmd_pyld, int *num_cmd)
+{
+	struct ipahal_imm_cmd_register_write reg_write_cmd = {0};
+	struct ipahal_imm_cmd_register_write reg_write_coal_close;
+	struct ipahal_reg_valmask valmask;
+	int i;
+
+	/* IC to close the coal frame before HPS Clear if coal is enabled */
+	if (ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) != -1
+		&& !ipa3_ctx->ulso_wa) {
+		u32 offset = 0;
+
+		i = ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS);
+		reg_write_coal_close.skip_pipeline_clear = false;
+		reg_write_coal_close.pipeline_clear_options = IPAHAL_HPS_CLEAR;
+		if (ipa3_ctx->ipa_hw_type < IPA_HW_v5_0)
+			offset = ipahal_get_reg_ofst(
+				IPA_AGGR_FORCE_CLOSE);
+		else
+			offset = ipahal_get_ep_reg_offset(
+				IPA_AGGR_FORCE_CLOSE_n, i);
+		reg_write_coal_close.offset = offset;
+		ipahal_get_aggr_force_close_valmask(i, &valmask);
+		reg_write_coal_close.value = valmask.val;
+		reg_write_coal_close.value_mask = valmask.mask;
+		cmd_pyld[*num_cmd] = ipahal_construct_imm_cmd(
+			IPA_IMM_CMD_REGISTER_WRITE,
+			&reg_write_coal_close, false);
+		if (!cmd_pyld[*num_cmd]) {
+			IPAERR("failed to construct coal close IC\n");
+			return -ENOMEM;
+		}
+		ipa3_init_imm_cmd_desc(&desc[*num_cmd], cmd_pyld[*num_cmd]);
+		++(*num_cmd);
+	}
+
+	/*
+	 * SRAM memory not allocated to hash tables. Sending
+	 * command to hash tables(filer/routing) operation not supported.
+	 */
+	if (!ipa3_ctx->ipa_fltrt_not_hashable) {
+		/* flushing ipa internal hashable flt rules cache */
+		if (ipa3_ctx->ipa_hw_type >= IPA_HW_v5_0) {
+			struct ipahal_reg_fltrt_cache_flush flush_cache;
+
+			memset(&flush_cache, 0, sizeof(flush_cache));
+			flush_cache.flt = true;
+			ipahal_get_fltrt_cache_flush_valmask(
+				&flush_cache, &valmask);
+			reg_write_cmd.offset = ipahal_get_reg_ofst(
+				IPA_FILT_ROUT_CACHE_FLUSH);
+		} else {
+			struct ipahal_reg_fltrt_hash_flush flush_hash;
+
+			memset(&flush_hash, 0, sizeof(flush_hash));
+			if (ip == IPA_IP_v4)
+				flush_hash.v4_flt = true;
+			else
+				flush_hash.v6_flt = true;
+			ipahal_get_fltrt_hash_flush_valmask(
+				&flush_hash, &valmask);
+			reg_write_cmd.offset = ipahal_get_reg_ofst(
+				IPA_FILT_ROUT_HASH_FLUSH);
+		}
+		reg_write_cmd.skip_pipeline_clear = false;
+		reg_write_cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
+		reg_write_cmd.value = valmask.val;
+		reg_write_cmd.value_mask = valmask.mask;
+		cmd_pyld[*num_cmd] = ipahal_construct_imm_cmd(
+				IPA_IMM_CMD_REGISTER_WRITE, &reg_write_cmd,
+							false);
+		if (!cmd_pyld[*num_cmd]) {
+			IPAERR(
+			"fail construct register_write imm cmd: IP %d\n", ip);
+			return -EFAULT;
+		}
+		ipa3_init_imm_cmd_desc(&desc[*num_cmd], cmd_pyld[*num_cmd]);
+		++(*num_cmd);
+	}
+
+	return 0;
+}
+
+/**
+ * ipa_flt_prep_dma_cmd() - prepare an IC writing a DMA buffer to the SRAM
+ * @sys_addr: physical address of the buffer
+ * @lcl_addr: SRAM address to write to
+ * @size: number of bytes to write
+ * @desc: descriptor buffer
+ * @cmd_pyld: imm cmds payload pointers buffer
+ * @num_cmd: [IN/OUT] number of commands in the buffers
+ *
+ * Return: 0 on success, negative on failure
+ */
+static int ipa_flt_prep_dma_cmd(dma_addr_t sys_addr, u32 lcl_addr, u32 size,
+	struct ipa3_desc *desc, struct ipahal_imm_cmd_pyld **cmd_pyld,
+	int *num_cmd)
+{
+	struct ipahal_imm_cmd_dma_shared_mem mem_cmd = {0};
+
+	mem_cmd.is_read = false;
+	mem_cmd.skip_pipeline_clear = false;
+	mem_cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
+	mem_cmd.size = size;
+	mem_cmd.system_addr = sys_addr;
+	mem_cmd.local_addr = lcl_addr;
+	cmd_pyld[*num_cmd] = ipahal_construct_imm_cmd(
+		IPA_IMM_CMD_DMA_SHARED_MEM, &mem_cmd, false);
+	if (!cmd_pyld[*num_cmd]) {
+		IPAERR("fail construct dma_shared_mem cmd\n");
+		return -ENOMEM;
+	}
+	ipa3_init_imm_cmd_desc(&desc[*num_cmd], cmd_pyld[*num_cmd]);
+	++(*num_cmd);
+
+	return 0;
+}
+
+/**
+ * ipa_flt_send_cmds() - send the prepared ICs to the HW
+ *  Avoid sending long chains that may surpass the number of TLVs available
+ *  for the system pipe.
+ * @num_cmd: number of commands
+ * @desc: descriptor buffer
+ *
+ * Return: 0 on success, negative on failure
+ */
+static int ipa_flt_send_cmds(int num_cmd, struct ipa3_desc *desc)
+{
+	int num_cmd_to_send;
+
+	while (num_cmd > 0) {
+		num_cmd_to_send =
+			num_cmd > IPA_FLT_MAX_IMM_CMD_CHAIN_LENGTH ?
+			IPA_FLT_MAX_IMM_CMD_CHAIN_LENGTH : num_cmd;
+		num_cmd -= num_cmd_to_send;
+
+		if (ipa3_send_cmd(num_cmd_to_send, desc)) {
+			IPAERR("fail to send immediate command batch\n");
+			return -EFAULT;
+		}
+		desc += num_cmd_to_send;
+	}
+
+	return 0;
+}
+
+/**
+ * __ipa_commit_flt_full_v3() - commit all flt tables to the hw
  *  commit the headers and the bodies if are local with internal cache flushing.
  *  The headers (and local bodies) will first be created into dma buffers and
  *  then written via IC to the SRAM
@@ -479,26 +640,26 @@ static bool ipa_flt_skip_pipe_config(int pipe)
  *
  * Return: 0 on success, negative on failure
  */
-int __ipa_commit_flt_v3(enum ipa_ip_type ip)
+static int __ipa_commit_flt_full_v3(enum ipa_ip_type ip)
 {
 	struct ipahal_fltrt_alloc_imgs_params alloc_params;
 	int rc = 0;
-	struct ipa3_desc *desc, *desc_to_send;
-	struct ipahal_imm_cmd_register_write reg_write_cmd = {0};
+	struct ipa3_desc *desc;
 	struct ipahal_imm_cmd_dma_shared_mem mem_cmd = {0};
 	struct ipahal_imm_cmd_pyld **cmd_pyld;
-	int num_cmd = 0, remaining_num_cmd = 0, num_cmd_to_send = 0;
+	int num_cmd = 0;
 	int i;
 	int hdr_idx;
 	u32 lcl_hash_hdr, lcl_nhash_hdr;
 	u32 lcl_hash_bdy, lcl_nhash_bdy;
 	bool lcl_hash, lcl_nhash;
-	struct ipahal_reg_valmask valmask;
 	u32 tbl_hdr_width;
 	struct ipa3_flt_tbl *tbl;
 	struct ipa3_flt_tbl_nhash_lcl *lcl_tbl;
 	u16 entries;
-	struct ipahal_imm_cmd_register_write reg_write_coal_close;
+
+	/* until this commit is done the HW layout is unknown */
+	ipa3_ctx->flt_tbl_synced[ip] = false;
 
 	tbl_hdr_width = ipahal_get_hw_tbl_hdr_width();
 	memset(&alloc_params, 0, sizeof(alloc_params));
@@ -541,6 +702,7 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 			rc = -EPERM;
 			goto prep_failed;
 		}
+		tbl->dirty = false;
 
 		/* First try fitting tables in lcl memory if allowed */
 		tbl->force_sys[IPA_RULE_NON_HASHABLE] = false;
@@ -607,80 +769,9 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 		goto fail_size_valid;
 	}
 
-	/* IC to close the coal frame before HPS Clear if coal is enabled */
-	if (ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) != -1
-		&& !ipa3_ctx->ulso_wa) {
-		u32 offset = 0;
-
-		i = ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS);
-		reg_write_coal_close.skip_pipeline_clear = false;
-		reg_write_coal_close.pipeline_clear_options = IPAHAL_HPS_CLEAR;
-		if (ipa3_ctx->ipa_hw_type < IPA_HW_v5_0)
-			offset = ipahal_get_reg_ofst(
-				IPA_AGGR_FORCE_CLOSE);
-		else
-			offset = ipahal_get_ep_reg_offset(
-				IPA_AGGR_FORCE_CLOSE_n, i);
-		reg_write_coal_close.offset = offset;
-		ipahal_get_aggr_force_close_valmask(i, &valmask);
-		reg_write_coal_close.value = valmask.val;
-		reg_write_coal_close.value_mask = valmask.mask;
-		cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
-			IPA_IMM_CMD_REGISTER_WRITE,
-			&reg_write_coal_close, false);
-		if (!cmd_pyld[num_cmd]) {
-			IPAERR("failed to construct coal close IC\n");
-			rc = -ENOMEM;
-			goto fail_reg_write_construct;
-		}
-		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
-		++num_cmd;
-	}
-
-	/*
-	 * SRAM memory not allocated to hash tables. Sending
-	 * command to hash tables(filer/routing) operation not supported.
-	 */
-	if (!ipa3_ctx->ipa_fltrt_not_hashable) {
-		/* flushing ipa internal hashable flt rules cache */
-		if (ipa3_ctx->ipa_hw_type >= IPA_HW_v5_0) {
-			struct ipahal_reg_fltrt_cache_flush flush_cache;
-
-			memset(&flush_cache, 0, sizeof(flush_cache));
-			flush_cache.flt = true;
-			ipahal_get_fltrt_cache_flush_valmask(
-				&flush_cache, &valmask);
-			reg_write_cmd.offset = ipahal_get_reg_ofst(
-				IPA_FILT_ROUT_CACHE_FLUSH);
-		} else {
-			struct ipahal_reg_fltrt_hash_flush flush_hash;
-
-			memset(&flush_hash, 0, sizeof(flush_hash));
-			if (ip == IPA_IP_v4)
-				flush_hash.v4_flt = true;
-			else
-				flush_hash.v6_flt = true;
-			ipahal_get_fltrt_hash_flush_valmask(
-				&flush_hash, &valmask);
-			reg_write_cmd.offset = ipahal_get_reg_ofst(
-				IPA_FILT_ROUT_HASH_FLUSH);
-		}
-		reg_write_cmd.skip_pipeline_clear = false;
-		reg_write_cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
-		reg_write_cmd.value = valmask.val;
-		reg_write_cmd.value_mask = valmask.mask;
-		cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
-				IPA_IMM_CMD_REGISTER_WRITE, &reg_write_cmd,
-							false);
-		if (!cmd_pyld[num_cmd]) {
-			IPAERR(
-			"fail construct register_write imm cmd: IP %d\n", ip);
-			rc = -EFAULT;
-			goto fail_imm_cmd_construct;
-		}
-		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
-		++num_cmd;
-	}
+	rc = ipa_flt_prep_flush_cmds(ip, desc, cmd_pyld, &num_cmd);
+	if (rc)
+		goto fail_imm_cmd_construct;
 
 	hdr_idx = 0;
 	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
@@ -804,26 +895,9 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 		++num_cmd;
 	}
 
-	remaining_num_cmd = num_cmd;
-	desc_to_send = desc;
-
-	/*
-	 * Avoid sending longs chain that may surpass number of TLVs available
-	 * for the system pipe.
-	 */
-	while (remaining_num_cmd > 0) {
-		num_cmd_to_send =
-			remaining_num_cmd > IPA_FLT_MAX_IMM_CMD_CHAIN_LENGTH ?
-			IPA_FLT_MAX_IMM_CMD_CHAIN_LENGTH : remaining_num_cmd;
-		remaining_num_cmd -= num_cmd_to_send;
-
-		if (ipa3_send_cmd(num_cmd_to_send, desc_to_send)) {
-			IPAERR("fail to send immediate command batch\n");
-			rc = -EFAULT;
-			goto fail_imm_cmd_construct;
-		}
-		desc_to_send += num_cmd_to_send;
-	}
+	rc = ipa_flt_send_cmds(num_cmd, desc);
+	if (rc)
+		goto fail_imm_cmd_construct;
 
 	IPADBG_LOW("Hashable HEAD\n");
 	IPA_DUMP_BUFF(alloc_params.hash_hdr.base,
@@ -849,11 +923,11 @@ int __ipa_commit_flt_v3(enum ipa_ip_type ip)
 
 	__ipa_reap_sys_flt_tbls(ip, IPA_RULE_HASHABLE);
 	__ipa_reap_sys_flt_tbls(ip, IPA_RULE_NON_HASHABLE);
+	ipa3_ctx->flt_tbl_synced[ip] = true;
 
 fail_imm_cmd_construct:
 	for (i = 0 ; i < num_cmd ; i++)
 		ipahal_destroy_imm_cmd(cmd_pyld[i]);
-fail_reg_write_construct:
 	kfree(desc);
 	kfree(cmd_pyld);
 fail_size_valid:
@@ -868,6 +942,280 @@ prep_failed:
 	return rc;
 }
 
+static int ipa_flt_gen_tbl_rules(enum ipa_ip_type ip, struct ipa3_flt_tbl *tbl,
+	enum ipa_rule_type rlt, u8 *buf)
+{
+	struct ipa3_flt_entry *entry;
+
+	list_for_each_entry(entry, &tbl->head_flt_rule_list, link) {
+		if (IPA_FLT_GET_RULE_TYPE(entry) != rlt)
+			continue;
+		if (ipa3_generate_flt_hw_rule(ip, entry, buf)) {
+			IPAERR("failed to gen HW FLT rule\n");
+			return -EPERM;
+		}
+		buf += entry->hw_len;
+	}
+
+	return 0;
+}
+
+/**
+ * __ipa_commit_flt_delta_v3() - commit only the dirty flt tables to the hw
+ *  A dirty table in system memory gets a new body and only its header entry
+ *  is rewritten. A dirty local table is rewritten in place, in the room the
+ *  last full commit gave it. Clean tables are not touched.
+ * @ip: the ip address family type
+ *
+ * Return: 0 on success, -EAGAIN if the change does not fit the current
+ *  layout and a full commit is needed, other negative on failure
+ */
+static int __ipa_commit_flt_delta_v3(enum ipa_ip_type ip)
+{
+	struct ipa_mem_buffer scratch = {0};
+	struct ipa_mem_buffer tbl_mem;
+	struct ipa3_desc *desc;
+	struct ipahal_imm_cmd_pyld **cmd_pyld;
+	struct ipa3_flt_tbl *tbl;
+	u32 prev_sz[IPA_RULE_TYPE_MAX];
+	u32 lcl_hdr[IPA_RULE_TYPE_MAX];
+	u32 lcl_bdy[IPA_RULE_TYPE_MAX];
+	u32 tbl_hdr_width;
+	u32 scratch_sz = 0;
+	u32 scratch_ofst = 0;
+	int num_dirty = 0;
+	int num_cmd = 0;
+	int hdr_idx;
+	int rlt;
+	int rc = 0;
+	int i;
+
+	if (!ipa3_ctx->flt_tbl_synced[ip])
+		return -EAGAIN;
+
+	tbl_hdr_width = ipahal_get_hw_tbl_hdr_width();
+
+	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
+		if (!ipa_is_ep_support_flt(i))
+			continue;
+		tbl = &ipa3_ctx->flt_tbl[i][ip];
+		if (!tbl->dirty)
+			continue;
+
+		memcpy(prev_sz, tbl->sz, sizeof(prev_sz));
+		if (ipa_prep_flt_tbl_for_cmt(ip, tbl, i)) {
+			ipa3_ctx->flt_tbl_synced[ip] = false;
+			return -EPERM;
+		}
+
+		for (rlt = 0; rlt < IPA_RULE_TYPE_MAX; rlt++) {
+			/* emptying or populating a table changes the layout */
+			if (!prev_sz[rlt] != !tbl->sz[rlt])
+				return -EAGAIN;
+			if (!tbl->sz[rlt])
+				continue;
+
+			if (tbl->in_sys[rlt] || tbl->force_sys[rlt]) {
+				scratch_sz += tbl_hdr_width;
+			} else {
+				/*
+				 * sz counts a header word, which keeps room
+				 * for the rule-set terminator
+				 */
+				if (tbl->sz[rlt] > tbl->lcl_room[rlt])
+					return -EAGAIN;
+				scratch_sz += tbl->lcl_room[rlt];
+			}
+		}
+		num_dirty++;
+	}
+
+	if (!num_dirty)
+		return 0;
+
+	if (ip == IPA_IP_v4) {
+		lcl_hdr[IPA_RULE_HASHABLE] = ipa3_ctx->smem_restricted_bytes +
+			IPA_MEM_PART(v4_flt_hash_ofst) + tbl_hdr_width;
+		lcl_hdr[IPA_RULE_NON_HASHABLE] =
+			ipa3_ctx->smem_restricted_bytes +
+			IPA_MEM_PART(v4_flt_nhash_ofst) + tbl_hdr_width;
+		lcl_bdy[IPA_RULE_HASHABLE] = ipa3_ctx->smem_restricted_bytes +
+			IPA_MEM_PART(apps_v4_flt_hash_ofst);
+		lcl_bdy[IPA_RULE_NON_HASHABLE] =
+			ipa3_ctx->smem_restricted_bytes +
+			IPA_MEM_PART(apps_v4_flt_nhash_ofst);
+	} else {
+		lcl_hdr[IPA_RULE_HASHABLE] = ipa3_ctx->smem_restricted_bytes +
+			IPA_MEM_PART(v6_flt_hash_ofst) + tbl_hdr_width;
+		lcl_hdr[IPA_RULE_NON_HASHABLE] =
+			ipa3_ctx->smem_restricted_bytes +
+			IPA_MEM_PART(v6_flt_nhash_ofst) + tbl_hdr_width;
+		lcl_bdy[IPA_RULE_HASHABLE] = ipa3_ctx->smem_restricted_bytes +
+			IPA_MEM_PART(apps_v6_flt_hash_ofst);
+		lcl_bdy[IPA_RULE_NON_HASHABLE] =
+			ipa3_ctx->smem_restricted_bytes +
+			IPA_MEM_PART(apps_v6_flt_nhash_ofst);
+	}
+
+	if (scratch_sz) {
+		scratch.size = scratch_sz;
+		if (ipahal_fltrt_allocate_hw_sys_tbl(&scratch)) {
+			IPAERR("fail to alloc delta buf of size %d\n",
+				scratch_sz);
+			ipa3_ctx->flt_tbl_synced[ip] = false;
+			return -ENOMEM;
+		}
+	}
+
+	/* +2: for flushing and for closing the coalescing frame */
+	if (ipa_flt_alloc_cmd_buffers(ip, num_dirty * IPA_RULE_TYPE_MAX + 2,
+		&desc, &cmd_pyld)) {
+		rc = -ENOMEM;
+		goto fail_alloc_cmd;
+	}
+
+	rc = ipa_flt_prep_flush_cmds(ip, desc, cmd_pyld, &num_cmd);
+	if (rc)
+		goto fail_cmd_construct;
+
+	hdr_idx = 0;
+	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
+		if (!ipa_is_ep_support_flt(i))
+			continue;
+		tbl = &ipa3_ctx->flt_tbl[i][ip];
+		if (!tbl->dirty) {
+			hdr_idx++;
+			continue;
+		}
+
+		for (rlt = 0; rlt < IPA_RULE_TYPE_MAX; rlt++) {
+			u8 *buf = (u8 *)scratch.base + scratch_ofst;
+			dma_addr_t buf_phys = scratch.phys_base + scratch_ofst;
+
+			if (!tbl->sz[rlt])
+				continue;
+
+			if (!tbl->in_sys[rlt] && !tbl->force_sys[rlt]) {
+				rc = ipa_flt_gen_tbl_rules(ip, tbl, rlt, buf);
+				if (rc)
+					goto fail_cmd_construct;
+				rc = ipa_flt_prep_dma_cmd(buf_phys,
+					lcl_bdy[rlt] + tbl->lcl_ofst[rlt],
+					tbl->lcl_room[rlt], desc, cmd_pyld,
+					&num_cmd);
+				if (rc)
+					goto fail_cmd_construct;
+				scratch_ofst += tbl->lcl_room[rlt];
+				continue;
+			}
+
+			/* only body (no header) */
+			tbl_mem.size = tbl->sz[rlt] - tbl_hdr_width +
+				ipahal_get_hw_prefetch_buf_size();
+			if (ipahal_fltrt_allocate_hw_sys_tbl(&tbl_mem)) {
+				IPAERR("fail to alloc sys tbl of size %d\n",
+					tbl_mem.size);
+				rc = -ENOMEM;
+				goto fail_cmd_construct;
+			}
+			rc = ipa_flt_gen_tbl_rules(ip, tbl, rlt, tbl_mem.base);
+			if (rc) {
+				ipahal_free_dma_mem(&tbl_mem);
+				goto fail_cmd_construct;
+			}
+			if (tbl->curr_mem[rlt].phys_base) {
+				WARN_ON(tbl->prev_mem[rlt].phys_base);
+				tbl->prev_mem[rlt] = tbl->curr_mem[rlt];
+			}
+			tbl->curr_mem[rlt] = tbl_mem;
+			scratch_ofst += tbl_hdr_width;
+
+			/* headers the full commit leaves alone stay so here */
+			if (ipa_flt_skip_pipe_config(i) ||
+				(rlt == IPA_RULE_HASHABLE &&
+				ipa3_ctx->ipa_fltrt_not_hashable))
+				continue;
+
+			ipahal_fltrt_write_addr_to_hdr(tbl_mem.phys_base, buf,
+				0, true);
+			rc = ipa_flt_prep_dma_cmd(buf_phys,
+				lcl_hdr[rlt] + hdr_idx * tbl_hdr_width,
+				tbl_hdr_width, desc, cmd_pyld, &num_cmd);
+			if (rc)
+				goto fail_cmd_construct;
+		}
+		hdr_idx++;
+	}
+
+	if (ipa_flt_send_cmds(num_cmd, desc)) {
+		/* the HW may already use some of the new bodies, keep them */
+		rc = -EFAULT;
+		goto fail_send;
+	}
+
+	__ipa_reap_sys_flt_tbls(ip, IPA_RULE_HASHABLE);
+	__ipa_reap_sys_flt_tbls(ip, IPA_RULE_NON_HASHABLE);
+
+	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
+		if (ipa_is_ep_support_flt(i))
+			ipa3_ctx->flt_tbl[i][ip].dirty = false;
+	}
+	IPADBG_LOW("committed %d dirty flt tbls ip=%d cmds=%d\n",
+		num_dirty, ip, num_cmd);
+	goto free_cmds;
+
+fail_cmd_construct:
+	for (i = 0; i < ipa3_ctx->ipa_num_pipes; i++) {
+		if (!ipa_is_ep_support_flt(i))
+			continue;
+		tbl = &ipa3_ctx->flt_tbl[i][ip];
+		for (rlt = 0; rlt < IPA_RULE_TYPE_MAX; rlt++) {
+			if (!tbl->prev_mem[rlt].phys_base)
+				continue;
+			ipahal_free_dma_mem(&tbl->curr_mem[rlt]);
+			tbl->curr_mem[rlt] = tbl->prev_mem[rlt];
+			memset(&tbl->prev_mem[rlt], 0,
+				sizeof(tbl->prev_mem[rlt]));
+		}
+	}
+fail_send:
+	ipa3_ctx->flt_tbl_synced[ip] = false;
+free_cmds:
+	for (i = 0; i < num_cmd; i++)
+		ipahal_destroy_imm_cmd(cmd_pyld[i]);
+	kfree(desc);
+	kfree(cmd_pyld);
+	if (scratch.size)
+		ipahal_free_dma_mem(&scratch);
+	return rc;
+
+fail_alloc_cmd:
+	ipa3_ctx->flt_tbl_synced[ip] = false;
+	if (scratch.size)
+		ipahal_free_dma_mem(&scratch);
+	return rc;
+}
+
+/**
+ * __ipa_commit_flt_v3() - commit flt tables to the hw
+ *  Only the tables changed since the last commit are written when the
+ *  change fits the layout in HW, otherwise all the tables are rebuilt.
+ * @ip: the ip address family type
+ *
+ * Return: 0 on success, negative on failure
+ */
+int __ipa_commit_flt_v3(enum ipa_ip_type ip)
+{
+	int rc;
+
+	rc = __ipa_commit_flt_delta_v3(ip);
+	if (rc != -EAGAIN)
+		return rc;
+
+	IPADBG_LOW("full flt commit ip=%d\n", ip);
+	return __ipa_commit_flt_full_v3(ip);
+}
+
 static int __ipa_validate_flt_rule(const struct ipa_flt_rule_i *rule,
 		struct ipa3_rt_tbl **rt_tbl, enum ipa_ip_type ip)
 {
@@ -1019,6 +1367,7 @@ static int __ipa_finish_flt_rule_add(struct ipa3_flt_tbl *tbl,
 	}
 	*rule_hdl = id;
 	entry->id = id;
+	tbl->dirty = true;
 	IPADBG_LOW("add flt rule rule_cnt=%d\n", tbl->rule_cnt);
 
 	return 0;
@@ -1136,6 +1485,7 @@ static int __ipa_del_flt_rule(u32 rule_hdl)
 
 	list_del(&entry->link);
 	entry->tbl->rule_cnt--;
+	entry->tbl->dirty = true;
 	if (entry->rt_tbl && !ipa3_check_idr_if_freed(entry->rt_tbl))
 		entry->rt_tbl->ref_cnt--;
 	IPADBG("del flt rule rule_cnt=%d rule_id=%d\n",
@@ -1187,6 +1537,7 @@ static int __ipa_mdfy_flt_rule(struct ipa_flt_rule_mdfy_i *frule,
 		entry->cnt_idx = frule->rule.cnt_idx;
 	else
 		entry->cnt_idx = 0;
+	entry->tbl->dirty = true;
 
 	return 0;
 
@@ -1915,6 +2266,7 @@ int ipa3_reset_flt(enum ipa_ip_type ip, bool user_only)
 					entry->ipacm_installed) {
 				list_del(&entry->link);
 				entry->tbl->rule_cnt--;
+				entry->tbl->dirty = true;
 				if (entry->rt_tbl &&
 					(!ipa3_check_idr_if_freed(
 						entry->rt_tbl)))
@@ -2253,6 +2605,8 @@ int ipa_flt_sram_set_client_prio_high(enum ipa_client_type client)
 				break;
 			}
 		}
+		/* SRAM placement may change, next commit must be a full one */
+		ipa3_ctx->flt_tbl_synced[ip] = false;
 	}
 	mutex_unlock(&ipa3_ctx->lock);
 
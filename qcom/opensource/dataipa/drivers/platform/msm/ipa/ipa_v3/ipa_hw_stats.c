@@ -44,6 +44,7 @@ int ipa_hw_stats_init(void)
 	}
 
 	/* initialize stats here */
+	mutex_init(&ipa3_ctx->hw_stats->quota.lock);
 	ipa3_ctx->hw_stats->enabled = true;
 
 	/* for IPA_HW_v5_0, reserved teth_stats sram for flt-tbls */
@@ -674,7 +675,8 @@ destroy_init_pyld:
 	return ret;
 }
 
-int ipa_get_quota_stats(struct ipa_quota_stats_all *out)
+/* must hold quota.lock, the driver cache is updated from the HW counters */
+static int __ipa_get_quota_stats(struct ipa_quota_stats_all *out)
 {
 	int i;
 	int ret;
@@ -805,6 +807,20 @@ free_dma_mem:
 
 }
 
+int ipa_get_quota_stats(struct ipa_quota_stats_all *out)
+{
+	int ret;
+
+	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
+		return 0;
+
+	mutex_lock(&ipa3_ctx->hw_stats->quota.lock);
+	ret = __ipa_get_quota_stats(out);
+	mutex_unlock(&ipa3_ctx->hw_stats->quota.lock);
+
+	return ret;
+}
+
 int ipa_reset_quota_stats(enum ipa_client_type client)
 {
 	int ret;
@@ -818,17 +834,20 @@ int ipa_reset_quota_stats(enum ipa_client_type client)
 		return -EINVAL;
 	}
 
+	mutex_lock(&ipa3_ctx->hw_stats->quota.lock);
 	/* reading stats will reset them in hardware */
-	ret = ipa_get_quota_stats(NULL);
+	ret = __ipa_get_quota_stats(NULL);
 	if (ret) {
 		IPAERR("ipa_get_quota_stats failed %d\n", ret);
-		return ret;
+		goto unlock;
 	}
 
 	/* reset driver's cache */
 	stats = &ipa3_ctx->hw_stats->quota.stats.client[client];
 	memset(stats, 0, sizeof(*stats));
-	return 0;
+unlock:
+	mutex_unlock(&ipa3_ctx->hw_stats->quota.lock);
+	return ret;
 }
 
 int ipa_reset_all_quota_stats(void)
@@ -839,17 +858,20 @@ int ipa_reset_all_quota_stats(void)
 	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled))
 		return 0;
 
+	mutex_lock(&ipa3_ctx->hw_stats->quota.lock);
 	/* reading stats will reset them in hardware */
-	ret = ipa_get_quota_stats(NULL);
+	ret = __ipa_get_quota_stats(NULL);
 	if (ret) {
 		IPAERR("ipa_get_quota_stats failed %d\n", ret);
-		return ret;
+		goto unlock;
 	}
 
 	/* reset driver's cache */
 	stats = &ipa3_ctx->hw_stats->quota.stats;
 	memset(stats, 0, sizeof(*stats));
-	return 0;
+unlock:
+	mutex_unlock(&ipa3_ctx->hw_stats->quota.lock);
+	return ret;
 }
 
 int ipa_init_teth_stats(struct ipa_teth_stats_endpoints *in)
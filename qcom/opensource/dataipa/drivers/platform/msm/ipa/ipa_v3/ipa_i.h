@@ -11,12 +11,15 @@
 #include <linux/bitops.h>
 #include <linux/cdev.h>
 #include <linux/export.h>
+#include <linux/hashtable.h>
 #include <linux/idr.h>
+#include <linux/jhash.h>
 #include <linux/list.h>
 #include <linux/mutex.h>
 #include <linux/skbuff.h>
 #include <linux/slab.h>
 #include <linux/notifier.h>
+#include <linux/ptr_ring.h>
 #include <linux/interrupt.h>
 #include <linux/netdevice.h>
 #include <linux/ipa.h>
@@ -291,6 +294,7 @@ enum hdr_tbl_storage {
 #define IPA3_ACTIVE_CLIENTS_LOG_LINE_LEN 96
 #define IPA3_ACTIVE_CLIENTS_LOG_HASHTABLE_SIZE 50
 #define IPA3_ACTIVE_CLIENTS_LOG_NAME_LEN 40
+#define IPA3_NAME_HTABLE_BITS 6
 #define SMEM_IPA_FILTER_TABLE 497
 #define IPA_TX_WRAPPER_CACHE_MAX_THRESHOLD 2000
 
@@ -793,9 +797,15 @@ struct ipa3_flt_entry {
  * @prev_mem: previous routing table block in sys memory
  * @id: routing table id
  * @rule_ids: common idr structure that holds the rule_id for each rule
+ * @dirty: rules were changed since the last commit
+ * @lcl_ofst: offset of the local table body in the apps body image
+ * @lcl_room: bytes reserved for the local table body at the last
+ *  full commit
+ * @name_node: table's link in the routing table set name hash
  */
 struct ipa3_rt_tbl {
 	struct list_head link;
+	struct hlist_node name_node;
 	u32 cookie;
 	struct list_head head_rt_rule_list;
 	char name[IPA_RESOURCE_NAME_MAX];
@@ -809,6 +819,9 @@ struct ipa3_rt_tbl {
 	struct ipa_mem_buffer prev_mem[IPA_RULE_TYPE_MAX];
 	int id;
 	struct idr *rule_ids;
+	bool dirty;
+	u32 lcl_ofst[IPA_RULE_TYPE_MAX];
+	u32 lcl_room[IPA_RULE_TYPE_MAX];
 };
 
 /**
@@ -829,9 +842,11 @@ struct ipa3_rt_tbl {
  * @user_deleted: is the header deleted by the user?
  * @ipacm_installed: indicate if installed by ipacm
  * @is_lcl: is the entry in the SRAM?
+ * @name_node: entry's link in the header name hash
  */
 struct ipa3_hdr_entry {
 	struct list_head link;
+	struct hlist_node name_node;
 	u32 cookie;
 	u8 hdr[IPA_HDR_MAX_SIZE];
 	u32 hdr_len;
@@ -937,6 +952,10 @@ struct ipa3_hdr_proc_ctx_tbl {
  * @rule_ids: common idr structure that holds the rule_id for each rule
  * @force_sys: flag indicating if filter table is forced to be
 			located in system memory
+ * @dirty: rules were changed since the last commit
+ * @lcl_ofst: offset of the local table body in the apps body image
+ * @lcl_room: bytes reserved for the local table body at the last
+ *  full commit
  */
 struct ipa3_flt_tbl {
 	struct list_head head_flt_rule_list;
@@ -948,6 +967,9 @@ struct ipa3_flt_tbl {
 	bool sticky_rear;
 	struct idr *rule_ids;
 	bool force_sys[IPA_RULE_TYPE_MAX];
+	bool dirty;
+	u32 lcl_ofst[IPA_RULE_TYPE_MAX];
+	u32 lcl_room[IPA_RULE_TYPE_MAX];
 };
 
 struct ipa3_flt_tbl_nhash_lcl {
@@ -993,11 +1015,13 @@ struct ipa3_rt_entry {
  * @head_rt_tbl_list: collection of routing tables
  * @tbl_cnt: number of routing tables
  * @rule_ids: idr structure that holds the rule_id for each rule
+ * @name_htable: the routing tables of the set, hashed by name
  */
 struct ipa3_rt_tbl_set {
 	struct list_head head_rt_tbl_list;
 	u32 tbl_cnt;
 	struct idr rule_ids;
+	DECLARE_HASHTABLE(name_htable, IPA3_NAME_HTABLE_BITS);
 };
 
 /**
@@ -1079,6 +1103,8 @@ struct ipa3_status_stats {
  * @skip_ep_cfg: boolean field that determines if EP should be configured
  *  by IPA driver
  * @keep_ipa_awake: when true, IPA will not be clock gated
+ * @rx_frag_ok: client_notify accepts non-linear LAN RX skbs, whose linear
+ *              part only holds the headers
  * @disconnect_in_progress: Indicates client disconnect in progress.
  * @qmi_request_sent: Indicates whether QMI request to enable clear data path
  *					request is sent or not.
@@ -1107,6 +1133,7 @@ struct ipa3_ep_context {
 	u32 dflt_flt6_rule_hdl;
 	bool skip_ep_cfg;
 	bool keep_ipa_awake;
+	bool rx_frag_ok;
 	struct ipa3_wlan_stats wstats;
 	u32 uc_offload_state;
 	u32 gsi_offload_state;
@@ -1132,6 +1159,7 @@ struct ipa3_ep_context {
  * @skip_ep_cfg:         boolean field that determines if EP should be
  *                       configured by IPA driver
  * @keep_ipa_awake:      when true, IPA will not be clock gated
+ * @rx_frag_ok:          notify accepts non-linear LAN RX skbs
  * @evt_ring_params:     parameters for the channel's event ring
  * @evt_scratch:         parameters for the channel's event ring scratch
  * @chan_params:         parameters for the channel
@@ -1145,6 +1173,7 @@ struct ipa_request_gsi_channel_params {
 	ipa_notify_cb notify;
 	bool skip_ep_cfg;
 	bool keep_ipa_awake;
+	bool rx_frag_ok;
 	struct gsi_evt_ring_props evt_ring_params;
 	union __packed gsi_evt_scratch evt_scratch;
 	struct gsi_chan_props chan_params;
@@ -1166,7 +1195,10 @@ struct ipa3_repl_ctx {
 };
 
 struct ipa3_page_repl_ctx {
+	/* pages handed to the stack, oldest first */
 	struct list_head page_repl_head;
+	/* pages known to be free, ready to be given to HW */
+	struct ptr_ring free_ring;
 	u32 capacity;
 	atomic_t pending;
 };
@@ -1188,6 +1220,9 @@ struct ipa3_page_repl_ctx {
  * @buff_size: rx packet length
  * @page_order: page order of the rx pipe based on the ioctl version
  * @ext_ioctl_v2: specifies if it's new version of ingress/egress ioctl
+ * @db_pending: descriptors queued to GSI since the last doorbell
+ * @lan_rx_frag: RX buffers are pages, LAN packets are handed up as frags of
+ * them instead of copies
  *
  * IPA context specific to the GPI pipes a.k.a LAN IN/OUT and WAN
  */
@@ -1237,6 +1272,8 @@ struct ipa3_sys_context {
 	struct ipa3_sys_context *common_sys;
 	atomic_t page_avilable;
 	u32 napi_sort_page_thrshld_cnt;
+	u32 db_pending;
+	bool lan_rx_frag;
 
 	/* ordering is important - mutable fields go above */
 	struct ipa3_ep_context *ep;
@@ -1565,10 +1602,27 @@ enum ipa3_config_this_ep {
 	IPA_DO_NOT_CONFIGURE_THIS_EP,
 };
 
+/*
+ * enum ipa3_msi_napi_pipe - AP consumer pipes that can get their own MSI,
+ * in the order of the CPUs given in qcom,ipa-msi-napi-cpus
+ *
+ * IPA_MSI_NAPI_WAN only applies without WAN coalescing. Otherwise WAN_CONS
+ * shares the coalescing event ring and its MSI, set by IPA_MSI_NAPI_WAN_COAL.
+ */
+enum ipa3_msi_napi_pipe {
+	IPA_MSI_NAPI_WAN_COAL,
+	IPA_MSI_NAPI_WAN,
+	IPA_MSI_NAPI_LAN,
+	IPA_MSI_NAPI_LOW_LAT,
+	IPA_MSI_NAPI_MAX,
+};
+
 struct ipa3_page_recycle_stats {
 	u64 total_replenished;
 	u64 page_recycled;
 	u64 tmp_alloc;
+	u64 page_reclaimed;
+	u64 page_busy;
 };
 
 struct ipa3_cache_recycle_stats {
@@ -1616,11 +1670,16 @@ struct ipa3_stats {
 	u32 lan_rx_empty;
 	u32 lan_rx_empty_coal;
 	u32 lan_repl_rx_empty;
+	u64 lan_rx_zero_copy;
+	u32 lan_rx_buf_busy;
 	u32 low_lat_rx_empty;
 	u32 low_lat_repl_rx_empty;
 	u32 flow_enable;
 	u32 flow_disable;
 	u32 tx_non_linear;
+	u64 tx_db;
+	u64 tx_db_desc;
+	u64 tx_db_timer_flush;
 	u32 rx_page_drop_cnt;
 	u64 lower_order;
 	u32 pipe_setup_fail_cnt;
@@ -1948,6 +2007,8 @@ struct ipa_drop_stats_all {
 
 struct ipa_hw_stats_quota {
 	struct ipahal_stats_init_quota init;
+	/* protects the driver cache in stats */
+	struct mutex lock;
 	struct ipa_quota_stats_all stats;
 };
 
@@ -2221,9 +2282,13 @@ enum ipa_per_usb_enum_type_e {
  * @ipa_wrapper_size: size of the memory pointed to by ipa_wrapper_base
  * @ipa_cfg_offset: offset from IPA_WRAPPER_BASE to IPA registers
  * @hdr_tbl: IPA header table
+ * @hdr_name_htable: the entries of all the header tables, hashed by name
  * @hdr_proc_ctx_tbl: IPA processing context table
  * @rt_tbl_set: list of routing tables each of which is a list of rules
  * @reap_rt_tbl_set: list of sys mem routing tables waiting to be reaped
+ * @flt_tbl_synced: the filter tables in HW match the layout of the last full
+ *  commit, so a commit may rewrite only the dirty tables
+ * @rt_tbl_synced: same as @flt_tbl_synced, for the routing tables
  * @flt_rule_cache: filter rule cache
  * @rt_rule_cache: routing rule cache
  * @hdr_cache: header cache
@@ -2346,6 +2411,7 @@ struct ipa3_context {
 	u32 ipa_cfg_offset;
 	bool set_evict_reg;
 	struct ipa3_hdr_tbl hdr_tbl[HDR_TBLS_TOTAL];
+	DECLARE_HASHTABLE(hdr_name_htable, IPA3_NAME_HTABLE_BITS);
 	struct ipa3_hdr_proc_ctx_tbl hdr_proc_ctx_tbl;
 	struct ipa3_rt_tbl_set rt_tbl_set[IPA_IP_MAX];
 	struct ipa3_rt_tbl_set reap_rt_tbl_set[IPA_IP_MAX];
@@ -2380,6 +2446,8 @@ struct ipa3_context {
 	bool flt_tbl_hash_lcl[IPA_IP_MAX];
 	bool flt_tbl_nhash_lcl[IPA_IP_MAX];
 	struct list_head flt_tbl_nhash_lcl_list[IPA_IP_MAX];
+	bool flt_tbl_synced[IPA_IP_MAX];
+	bool rt_tbl_synced[IPA_IP_MAX];
 	struct ipa3_active_clients ipa3_active_clients;
 	struct ipa3_active_clients_log_ctx ipa3_active_clients_logging;
 	struct workqueue_struct *power_mgmt_wq;
@@ -2572,6 +2640,8 @@ struct ipa3_context {
 	bool is_device_crashed;
 	bool ulso_wa;
 	u64 gsi_msi_addr;
+	/* CPU per ipa3_msi_napi_pipe, -1 to share the GSI IRQ */
+	int msi_napi_cpu[IPA_MSI_NAPI_MAX];
 	spinlock_t notifier_lock;
 	struct raw_notifier_head *ipa_rmnet_notifier_list_internal;
 	struct notifier_block ipa_rmnet_notifier;
@@ -2600,6 +2670,7 @@ struct ipa3_context {
 	bool is_dual_pine_config;
 	struct workqueue_struct *collect_recycle_stats_wq;
 	struct ipa_lnx_pipe_page_recycling_stats recycle_stats;
+	struct ipa_lnx_pipe_page_recycling_ext_stats recycle_ext_stats;
 	struct ipa3_page_recycle_stats prev_coal_recycle_stats;
 	struct ipa3_page_recycle_stats prev_default_recycle_stats;
 	struct ipa3_page_recycle_stats prev_low_lat_data_recycle_stats;
@@ -2645,6 +2716,7 @@ struct ipa3_plat_drv_res {
 	bool lan_rx_napi_enable;
 	bool tx_napi_enable;
 	bool tx_poll;
+	int msi_napi_cpu[IPA_MSI_NAPI_MAX];
 	u32 mhi_evid_limits[2]; /* start and end values */
 	bool ipa_mhi_dynamic_config;
 	u32 ipa_tz_unlock_reg_num;
@@ -3195,6 +3267,8 @@ int ipa3_set_single_ndp_per_mbim(bool enable);
  */
 int ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
 		struct ipa_tx_meta *metadata);
+int __ipa3_tx_dp(enum ipa_client_type dst, struct sk_buff *skb,
+		struct ipa_tx_meta *metadata, bool xmit_more);
 
 /*
  * To transfer multiple data packets
@@ -3889,6 +3963,12 @@ static inline void *alloc_and_init(u32 size, u32 init_val)
 	return ptr;
 }
 
+/* key of the rt table and header name hashes */
+static inline u32 ipa3_name_hash(const char *name)
+{
+	return jhash(name, strnlen(name, IPA_RESOURCE_NAME_MAX), 0);
+}
+
 /**
  * The following used as defaults for struct ipa_ioc_coal_evict_policy.
  */
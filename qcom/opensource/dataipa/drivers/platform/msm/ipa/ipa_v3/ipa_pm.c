@@ -3,6 +3,7 @@
  * Copyright (c) 2017-2021, The Linux Foundation. All rights reserved.
  */
 
+#include <linux/average.h>
 #include <linux/debugfs.h>
 #include "ipa_pm.h"
 #include "ipa_stats.h"
@@ -49,6 +50,21 @@
 	IPA_PM_DBG_LOW("Client[%d] %s: %s\n", hdl, name, \
 		client_state_to_str[state])
 
+/*
+ * traffic governor sampling period, long since every quota stats read closes
+ * the WAN coalescing frame and clears the HPS pipeline
+ */
+#define IPA_PM_GOV_PERIOD_MS 1000
+/* load of a packet in bytes, so small packet floods scale the clock too */
+#define IPA_PM_GOV_PKT_BYTES 256
+/* scale down once the load is this percent below the threshold ... */
+#define IPA_PM_GOV_DOWN_MARGIN 20
+/* ... for this many consecutive samples */
+#define IPA_PM_GOV_DOWN_SAMPLES 3
+#define IPA_PM_GOV_TRACE_SIZE 32
+
+DECLARE_EWMA(ipa_pm_load, 4, 4)
+
 /*
  * struct ipa_pm_exception_list - holds information about an exception
  * @pending: number of clients in exception that have not yet been adctivated
@@ -87,6 +103,61 @@ struct clk_scaling_db {
 	int *current_threshold;
 };
 
+/*
+ * struct ipa_pm_gov_trace - a clock plan decision of the traffic governor
+ * @ts_ms: time of the decision
+ * @load: load of the last period in Mbps
+ * @ewma: smoothed load in Mbps
+ * @gov_idx: clock plan picked from the traffic
+ * @vote_idx: clock plan picked from the client votes
+ * @clk_idx: clock plan applied
+ */
+struct ipa_pm_gov_trace {
+	u64 ts_ms;
+	u32 load;
+	u32 ewma;
+	u8 gov_idx;
+	u8 vote_idx;
+	u8 clk_idx;
+};
+
+/*
+ * struct ipa_pm_governor - picks the clock plan from measured traffic
+ * @lock: protects the governor state
+ * @enabled: governor is running, client votes only act as floors
+ * @work: periodic sampling work
+ * @stats: HW quota stats snapshot
+ * @quota_mask: pipes the governor enabled quota stats for, all zero if it
+ *	found them already configured
+ * @last_bytes: bytes counted by HW up to the previous sample
+ * @last_pkts: packets counted by HW up to the previous sample
+ * @last_ts: time of the previous sample, 0 if there is none
+ * @ewma: smoothed load
+ * @idx: clock plan picked from the traffic
+ * @vote_idx: clock plan picked from the client votes
+ * @down_cnt: consecutive samples asking for a lower clock plan
+ * @samples: number of samples taken
+ * @trace: last decisions, oldest first from @trace_head
+ * @trace_head: next entry of @trace to be written
+ */
+struct ipa_pm_governor {
+	struct mutex lock;
+	bool enabled;
+	struct delayed_work work;
+	struct ipa_quota_stats_all *stats;
+	u32 quota_mask[IPA5_PIPE_REG_NUM];
+	u64 last_bytes;
+	u64 last_pkts;
+	ktime_t last_ts;
+	struct ewma_ipa_pm_load ewma;
+	int idx;
+	int vote_idx;
+	int down_cnt;
+	u64 samples;
+	struct ipa_pm_gov_trace trace[IPA_PM_GOV_TRACE_SIZE];
+	u32 trace_head;
+};
+
 /*
  * ipa_pm state names
  *
@@ -166,12 +237,14 @@ struct ipa_pm_client {
  * @client_mutex: global mutex to  lock the client arrays
  * @aggragated_tput: aggragated tput value of all valid activated clients
  * @group_tput: combined throughput for the groups
+ * @gov: traffic measured clock governor
  */
 struct ipa_pm_ctx {
 	struct ipa_pm_client *clients[IPA_PM_MAX_CLIENTS];
 	struct ipa_pm_client *clients_by_pipe[IPA5_PIPES_NUM];
 	struct workqueue_struct *wq;
 	struct clk_scaling_db clk_scaling;
+	struct ipa_pm_governor gov;
 	struct mutex client_mutex;
 	int aggregated_tput;
 	int group_tput[IPA_PM_GROUP_MAX];
@@ -350,6 +423,9 @@ static void set_current_threshold(void)
 /**
  * do_clk_scaling() - set the clock based on the activated clients
  *
+ * With the traffic governor running the clock plan it picked is used, the
+ * one from the activated clients votes is only a floor.
+ *
  * Returns: 0 if success, negative otherwise
  */
 static int do_clk_scaling(void)
@@ -378,6 +454,10 @@ static int do_clk_scaling(void)
 			new_th_idx++;
 	}
 
+	WRITE_ONCE(ipa_pm_ctx->gov.vote_idx, new_th_idx);
+	if (READ_ONCE(ipa_pm_ctx->gov.enabled))
+		new_th_idx = max(new_th_idx, READ_ONCE(ipa_pm_ctx->gov.idx));
+
 	IPA_PM_DBG_LOW("old idx was at %d\n", ipa_pm_ctx->clk_scaling.cur_vote);
 
 
@@ -399,6 +479,314 @@ static void clock_scaling_func(struct work_struct *work)
 	do_clk_scaling();
 }
 
+/**
+ * gov_read_counters() - read the bytes and packets HW counted on all the
+ * pipes quota stats are enabled for
+ *
+ * Returns: 0 on success, negative otherwise
+ */
+static int gov_read_counters(struct ipa_pm_governor *gov, u64 *bytes,
+	u64 *pkts)
+{
+	struct ipa_active_client_logging_info log_info;
+	int i, ret;
+
+	/* only sample while the clock is on anyway, no traffic otherwise */
+	IPA_ACTIVE_CLIENTS_PREP_SPECIAL(log_info, "PM_GOV");
+	if (ipa3_inc_client_enable_clks_no_block(&log_info))
+		return -EAGAIN;
+
+	ret = ipa_get_quota_stats(gov->stats);
+	ipa3_dec_client_disable_clks_no_block(&log_info);
+	if (ret)
+		return ret;
+
+	*bytes = 0;
+	*pkts = 0;
+	for (i = 0; i < IPA_CLIENT_MAX; i++) {
+		*bytes += gov->stats->client[i].num_ipv4_bytes +
+			gov->stats->client[i].num_ipv6_bytes;
+		*pkts += gov->stats->client[i].num_ipv4_pkts +
+			gov->stats->client[i].num_ipv6_pkts;
+	}
+
+	return 0;
+}
+
+/**
+ * gov_pick_idx() - clock plan index for a load, as done for the votes
+ * @load: load in Mbps
+ * @margin: percent the load must be above each threshold
+ */
+static int gov_pick_idx(u32 load, int margin)
+{
+	struct clk_scaling_db *clk = &ipa_pm_ctx->clk_scaling;
+	int i, idx = 1;
+
+	for (i = 0; i < clk->threshold_size; i++) {
+		if ((u64)load * 100 >=
+			(u64)clk->current_threshold[i] * (100 + margin))
+			idx++;
+	}
+
+	return idx;
+}
+
+static void gov_add_trace(struct ipa_pm_governor *gov, u32 load)
+{
+	struct ipa_pm_gov_trace *trace = &gov->trace[gov->trace_head];
+
+	trace->ts_ms = ktime_to_ms(ktime_get());
+	trace->load = load;
+	trace->ewma = ewma_ipa_pm_load_read(&gov->ewma);
+	trace->gov_idx = gov->idx;
+	trace->vote_idx = READ_ONCE(gov->vote_idx);
+	trace->clk_idx = ipa_pm_ctx->clk_scaling.cur_vote;
+	gov->trace_head = (gov->trace_head + 1) % IPA_PM_GOV_TRACE_SIZE;
+}
+
+/**
+ * gov_work_func() - sample the traffic and pick the clock plan from it
+ *
+ * Scaling up follows the higher of the last period and the smoothed load so
+ * bursts are not starved. Scaling down needs the smoothed load to stay
+ * IPA_PM_GOV_DOWN_MARGIN percent below the threshold for
+ * IPA_PM_GOV_DOWN_SAMPLES samples.
+ */
+static void gov_work_func(struct work_struct *work)
+{
+	struct ipa_pm_governor *gov = &ipa_pm_ctx->gov;
+	int old_clk = ipa_pm_ctx->clk_scaling.cur_vote;
+	u64 bytes, pkts, d_bytes, d_pkts, us;
+	unsigned long ewma;
+	int up_idx, down_idx, old_idx;
+	ktime_t now;
+	u32 load;
+
+	mutex_lock(&gov->lock);
+	if (!gov->enabled) {
+		mutex_unlock(&gov->lock);
+		return;
+	}
+
+	if (gov_read_counters(gov, &bytes, &pkts)) {
+		/* clock is off, start over once it is back */
+		gov->last_ts = 0;
+		goto resched;
+	}
+
+	now = ktime_get();
+	if (!gov->last_ts)
+		goto save;
+
+	us = ktime_us_delta(now, gov->last_ts);
+	if (!us)
+		goto resched;
+
+	/* counters go back when another user resets the quota stats */
+	d_bytes = bytes >= gov->last_bytes ? bytes - gov->last_bytes : bytes;
+	d_pkts = pkts >= gov->last_pkts ? pkts - gov->last_pkts : pkts;
+	load = min_t(u64, div64_u64(max(d_bytes,
+		d_pkts * IPA_PM_GOV_PKT_BYTES) * 8, us), U32_MAX);
+
+	ewma_ipa_pm_load_add(&gov->ewma, load);
+	ewma = ewma_ipa_pm_load_read(&gov->ewma);
+	gov->samples++;
+
+	old_idx = gov->idx;
+	up_idx = gov_pick_idx(max_t(unsigned long, load, ewma), 0);
+	down_idx = gov_pick_idx(ewma, IPA_PM_GOV_DOWN_MARGIN);
+	if (up_idx > gov->idx) {
+		gov->idx = up_idx;
+		gov->down_cnt = 0;
+	} else if (down_idx < gov->idx) {
+		if (++gov->down_cnt >= IPA_PM_GOV_DOWN_SAMPLES) {
+			gov->idx = down_idx;
+			gov->down_cnt = 0;
+		}
+	} else {
+		gov->down_cnt = 0;
+	}
+
+	if (gov->idx != old_idx) {
+		IPA_PM_DBG_LOW("load %u ewma %lu: idx %d -> %d\n", load, ewma,
+			old_idx, gov->idx);
+		mutex_unlock(&gov->lock);
+		do_clk_scaling();
+		mutex_lock(&gov->lock);
+	}
+	if (gov->idx != old_idx ||
+		ipa_pm_ctx->clk_scaling.cur_vote != old_clk)
+		gov_add_trace(gov, load);
+
+save:
+	gov->last_bytes = bytes;
+	gov->last_pkts = pkts;
+	gov->last_ts = now;
+resched:
+	if (gov->enabled)
+		queue_delayed_work(ipa_pm_ctx->wq, &gov->work,
+			msecs_to_jiffies(IPA_PM_GOV_PERIOD_MS));
+	mutex_unlock(&gov->lock);
+}
+
+/*
+ * Go back to no quota stats if the governor enabled them and nobody has
+ * configured them since. Must hold gov->lock.
+ */
+static void ipa_pm_gov_release_quota(struct ipa_pm_governor *gov)
+{
+	u32 pipe_bitmask[IPA5_PIPE_REG_NUM] = { 0 };
+	bool owned = false;
+	int i, ret;
+
+	for (i = 0; i < IPA5_PIPE_REG_NUM; i++)
+		if (gov->quota_mask[i])
+			owned = true;
+	if (!owned)
+		return;
+
+	if (!memcmp(gov->quota_mask,
+		ipa3_ctx->hw_stats->quota.init.enabled_bitmask,
+		sizeof(gov->quota_mask))) {
+		IPA_ACTIVE_CLIENTS_INC_SIMPLE();
+		ret = ipa_init_quota_stats(pipe_bitmask);
+		IPA_ACTIVE_CLIENTS_DEC_SIMPLE();
+		if (ret)
+			IPA_PM_ERR("failed to disable quota stats %d\n", ret);
+	}
+
+	memset(gov->quota_mask, 0, sizeof(gov->quota_mask));
+}
+
+/**
+ * ipa_pm_governor_enable() - start or stop picking the clock plan from the
+ * traffic measured by the HW quota stats
+ * @enable: true to start the governor, false to go back to client votes
+ *
+ * If no pipe has quota stats enabled, they are enabled for all the pipes
+ * that are set up, and disabled again when the governor stops.
+ *
+ * Returns: 0 on success, negative on failure
+ */
+int ipa_pm_governor_enable(bool enable)
+{
+	struct ipa_pm_governor *gov;
+	u32 pipe_bitmask[IPA5_PIPE_REG_NUM] = { 0 };
+	bool quota_on = false;
+	int i, ret = 0;
+
+	if (!ipa_pm_ctx)
+		return -EPERM;
+
+	gov = &ipa_pm_ctx->gov;
+	mutex_lock(&gov->lock);
+	if (gov->enabled == enable)
+		goto unlock;
+
+	if (!enable) {
+		gov->enabled = false;
+		ipa_pm_gov_release_quota(gov);
+		mutex_unlock(&gov->lock);
+		cancel_delayed_work_sync(&gov->work);
+		/* back to the client votes alone */
+		queue_work(ipa_pm_ctx->wq, &ipa_pm_ctx->clk_scaling.work);
+		IPA_PM_DBG("traffic governor stopped\n");
+		return 0;
+	}
+
+	if (!(ipa3_ctx->hw_stats && ipa3_ctx->hw_stats->enabled)) {
+		IPA_PM_ERR("HW stats are not supported\n");
+		ret = -EOPNOTSUPP;
+		goto unlock;
+	}
+
+	for (i = 0; i < IPA5_PIPE_REG_NUM; i++)
+		if (ipa3_ctx->hw_stats->quota.init.enabled_bitmask[i])
+			quota_on = true;
+
+	if (!quota_on) {
+		for (i = 0; i < ipa3_get_max_num_pipes(); i++)
+			if (ipa3_ctx->ep[i].valid)
+				pipe_bitmask[ipahal_get_ep_reg_idx(i)] |=
+					ipahal_get_ep_bit(i);
+		IPA_ACTIVE_CLIENTS_INC_SIMPLE();
+		ret = ipa_init_quota_stats(pipe_bitmask);
+		IPA_ACTIVE_CLIENTS_DEC_SIMPLE();
+		if (ret) {
+			IPA_PM_ERR("failed to enable quota stats %d\n", ret);
+			goto unlock;
+		}
+		memcpy(gov->quota_mask, pipe_bitmask, sizeof(gov->quota_mask));
+	}
+
+	if (!gov->stats) {
+		gov->stats = kzalloc(sizeof(*gov->stats), GFP_KERNEL);
+		if (!gov->stats) {
+			ipa_pm_gov_release_quota(gov);
+			ret = -ENOMEM;
+			goto unlock;
+		}
+	}
+
+	ewma_ipa_pm_load_init(&gov->ewma);
+	gov->last_ts = 0;
+	gov->idx = 1;
+	gov->down_cnt = 0;
+	gov->enabled = true;
+	queue_delayed_work(ipa_pm_ctx->wq, &gov->work, 0);
+	IPA_PM_DBG("traffic governor started\n");
+
+unlock:
+	mutex_unlock(&gov->lock);
+	return ret;
+}
+
+/**
+ * ipa_pm_governor_stat() - print the traffic governor state and decisions
+ * @buf: [in] The user buff used to print
+ * @size: [in] The size of buf
+ * Returns: number of bytes used on success, negative on failure
+ */
+int ipa_pm_governor_stat(char *buf, int size)
+{
+	struct ipa_pm_governor *gov;
+	struct ipa_pm_gov_trace *trace;
+	int i, cnt = 0;
+
+	if (!buf || size < 0)
+		return -EINVAL;
+
+	if (!ipa_pm_ctx)
+		return -EPERM;
+
+	gov = &ipa_pm_ctx->gov;
+	mutex_lock(&gov->lock);
+	cnt += scnprintf(buf + cnt, size - cnt,
+		"Enabled: %d Samples: %llu Ewma: %lu Mbps\n"
+		"Governor idx: %d Vote idx: %d Cur vote: %d\n\n",
+		gov->enabled, gov->samples,
+		ewma_ipa_pm_load_read(&gov->ewma), gov->idx,
+		READ_ONCE(gov->vote_idx), ipa_pm_ctx->clk_scaling.cur_vote);
+
+	cnt += scnprintf(buf + cnt, size - cnt,
+		"%-12s %-10s %-10s %-4s %-4s %-4s\n",
+		"time_ms", "load", "ewma", "gov", "vote", "clk");
+	for (i = 0; i < IPA_PM_GOV_TRACE_SIZE; i++) {
+		trace = &gov->trace[(gov->trace_head + i) %
+			IPA_PM_GOV_TRACE_SIZE];
+		if (!trace->ts_ms)
+			continue;
+		cnt += scnprintf(buf + cnt, size - cnt,
+			"%-12llu %-10u %-10u %-4u %-4u %-4u\n",
+			trace->ts_ms, trace->load, trace->ewma,
+			trace->gov_idx, trace->vote_idx, trace->clk_idx);
+	}
+	mutex_unlock(&gov->lock);
+
+	return cnt;
+}
+
 /**
  * activate_work_func - activate a client and vote for clock on a work queue
  */
@@ -664,6 +1052,10 @@ int ipa_pm_init(struct ipa_pm_init_params *params)
 	clk_scaling->exception_size = params->exception_size;
 	INIT_WORK(&clk_scaling->work, clock_scaling_func);
 
+	mutex_init(&ipa_pm_ctx->gov.lock);
+	INIT_DELAYED_WORK(&ipa_pm_ctx->gov.work, gov_work_func);
+	ewma_ipa_pm_load_init(&ipa_pm_ctx->gov.ewma);
+
 	for (i = 0; i < params->threshold_size; i++)
 		clk_scaling->default_threshold[i] =
 			params->default_threshold[i];
@@ -718,8 +1110,10 @@ int ipa_pm_destroy(void)
 		return -EPERM;
 	}
 
+	ipa_pm_governor_enable(false);
 	destroy_workqueue(ipa_pm_ctx->wq);
 
+	kfree(ipa_pm_ctx->gov.stats);
 	kfree(ipa_pm_ctx);
 	ipa_pm_ctx = NULL;
 
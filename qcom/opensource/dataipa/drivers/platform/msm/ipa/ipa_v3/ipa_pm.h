@@ -105,6 +105,8 @@ int ipa_pm_exceptions_stat(char *buf, int size);
 void ipa_pm_set_clock_index(int index);
 int ipa_pm_add_dummy_clients(s8 power_plan);
 int ipa_pm_remove_dummy_clients(void);
+int ipa_pm_governor_enable(bool enable);
+int ipa_pm_governor_stat(char *buf, int size);
 
 #else /* IS_ENABLED(CONFIG_IPA3) */
 
@@ -190,6 +192,16 @@ static inline int ipa_pm_remove_dummy_clients(void);
 {
 	return -EPERM;
 }
+
+static inline int ipa_pm_governor_enable(bool enable)
+{
+	return -EPERM;
+}
+
+static inline int ipa_pm_governor_stat(char *buf, int size)
+{
+	return -EPERM;
+}
 #endif /* IS_ENABLED(CONFIG_IPA3) */
 
 #endif /* _IPA_PM_H_ */
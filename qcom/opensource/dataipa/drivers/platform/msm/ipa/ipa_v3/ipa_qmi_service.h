@@ -326,6 +326,8 @@ int rmnet_ipa3_get_wan_mtu(
 int rmnet_ipa3_query_per_client_stats_v2(
 	struct wan_ioctl_query_per_client_stats *data);
 
+int rmnet_ipa3_stats_snap_mmap(struct file *filp, struct vm_area_struct *vma);
+
 int ipa3_qmi_get_data_stats(struct ipa_get_data_stats_req_msg_v01 *req,
 	struct ipa_get_data_stats_resp_msg_v01 *resp);
 
@@ -483,6 +485,12 @@ static inline int rmnet_ipa3_set_data_quota_warning(
 static inline void ipa3_broadcast_quota_reach_ind(uint32_t mux_id,
 	enum ipa_upstream_type upstream_type, bool is_warning_limit) { }
 
+static inline int rmnet_ipa3_stats_snap_mmap(struct file *filp,
+	struct vm_area_struct *vma)
+{
+	return -EPERM;
+}
+
 static inline int ipa3_qmi_get_data_stats(
 	struct ipa_get_data_stats_req_msg_v01 *req,
 	struct ipa_get_data_stats_resp_msg_v01 *resp)
@@ -209,6 +209,7 @@ static int ipa_translate_rt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 			tbl->curr_mem[rlt] = tbl_mem;
 		} else {
 			offset = body_i - base + body_ofst;
+			tbl->lcl_ofst[rlt] = body_i - base;
 
 			/* update the hdr at the right index */
 			if (ipahal_fltrt_write_addr_to_hdr(offset, hdr,
@@ -239,6 +240,7 @@ static int ipa_translate_rt_tbl_to_hw_fmt(enum ipa_ip_type ip,
 			body_i += ipahal_get_lcl_tbl_addr_alignment();
 			body_i = (u8 *)((long)body_i &
 				~ipahal_get_lcl_tbl_addr_alignment());
+			tbl->lcl_room[rlt] = body_i - base - tbl->lcl_ofst[rlt];
 		}
 	}
 
@@ -455,16 +457,110 @@ static bool ipa_rt_valid_lcl_tbl_size(enum ipa_ip_type ipt,
 }
 
 /**
- * __ipa_commit_rt_v3() - commit rt tables to the hw
+ * ipa_rt_prep_flush_cmds() - prepare the ICs each rt commit starts with:
+ *  close the coalescing frame (if coal is enabled) and flush the hashable
+ *  rt rules cache
+ * @ip: the ip address family type
+ * @desc: descriptor buffer
+ * @cmd_pyld: imm cmds payload pointers buffer
+ * @num_cmd: [IN/OUT] number of commands in the buffers
+ *
+ * Return: 0 on success, negative on failure
+ */
+static int ipa_rt_prep_flush_cmds(enum ipa_ip_type ip, struct ipa3_desc *desc,
+	struct ipahal_imm_cmd_pyld **cmd_pyld, int *num_cmd)
+{
+	struct ipahal_imm_cmd_register_write reg_write_cmd = {0};
+	struct ipahal_imm_cmd_register_write reg_write_coal_close;
+	struct ipahal_reg_valmask valmask;
+	int i;
+
+	/* IC to close the coal frame before HPS Clear if coal is enabled */
+	if (ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) != -1
+		&& !ipa3_ctx->ulso_wa) {
+		u32 offset = 0;
+
+		i = ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS);
+		reg_write_coal_close.skip_pipeline_clear = false;
+		reg_write_coal_close.pipeline_clear_options = IPAHAL_HPS_CLEAR;
+		if (ipa3_ctx->ipa_hw_type < IPA_HW_v5_0)
+			offset = ipahal_get_reg_ofst(
+				IPA_AGGR_FORCE_CLOSE);
+		else
+			offset = ipahal_get_ep_reg_offset(
+				IPA_AGGR_FORCE_CLOSE_n, i);
+		reg_write_coal_close.offset = offset;
+		ipahal_get_aggr_force_close_valmask(i, &valmask);
+		reg_write_coal_close.value = valmask.val;
+		reg_write_coal_close.value_mask = valmask.mask;
+		cmd_pyld[*num_cmd] = ipahal_construct_imm_cmd(
+			IPA_IMM_CMD_REGISTER_WRITE,
+			&reg_write_coal_close, false);
+		if (!cmd_pyld[*num_cmd]) {
+			IPAERR("failed to construct coal close IC\n");
+			return -ENOMEM;
+		}
+		ipa3_init_imm_cmd_desc(&desc[*num_cmd], cmd_pyld[*num_cmd]);
+		++(*num_cmd);
+	}
+
+	/*
+	 * SRAM memory not allocated to hash tables. Sending
+	 * command to hash tables(filer/routing) operation not supported.
+	 */
+	if (!ipa3_ctx->ipa_fltrt_not_hashable) {
+		/* flushing ipa internal hashable rt rules cache */
+		if (ipa3_ctx->ipa_hw_type >= IPA_HW_v5_0) {
+			struct ipahal_reg_fltrt_cache_flush flush_cache;
+
+			memset(&flush_cache, 0, sizeof(flush_cache));
+			flush_cache.rt = true;
+			ipahal_get_fltrt_cache_flush_valmask(
+				&flush_cache, &valmask);
+			reg_write_cmd.offset = ipahal_get_reg_ofst(
+				IPA_FILT_ROUT_CACHE_FLUSH);
+		} else {
+			struct ipahal_reg_fltrt_hash_flush flush_hash;
+
+			memset(&flush_hash, 0, sizeof(flush_hash));
+			if (ip == IPA_IP_v4)
+				flush_hash.v4_rt = true;
+			else
+				flush_hash.v6_rt = true;
+			ipahal_get_fltrt_hash_flush_valmask(
+				&flush_hash, &valmask);
+			reg_write_cmd.offset = ipahal_get_reg_ofst(
+				IPA_FILT_ROUT_HASH_FLUSH);
+		}
+		reg_write_cmd.skip_pipeline_clear = false;
+		reg_write_cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
+		reg_write_cmd.value = valmask.val;
+		reg_write_cmd.value_mask = valmask.mask;
+		cmd_pyld[*num_cmd] = ipahal_construct_imm_cmd(
+				IPA_IMM_CMD_REGISTER_WRITE, &reg_write_cmd,
+							false);
+		if (!cmd_pyld[*num_cmd]) {
+			IPAERR(
+			"fail construct register_write imm cmd. IP %d\n", ip);
+			return -EFAULT;
+		}
+		ipa3_init_imm_cmd_desc(&desc[*num_cmd], cmd_pyld[*num_cmd]);
+		++(*num_cmd);
+	}
+
+	return 0;
+}
+
+/**
+ * __ipa_commit_rt_full_v3() - commit all rt tables to the hw
  * commit the headers and the bodies if are local with internal cache flushing
  * @ipt: the ip address family type
  *
  * Return: 0 on success, negative on failure
  */
-int __ipa_commit_rt_v3(enum ipa_ip_type ip)
+static int __ipa_commit_rt_full_v3(enum ipa_ip_type ip)
 {
 	struct ipa3_desc desc[IPA_RT_MAX_NUM_OF_COMMIT_TABLES_CMD_DESC];
-	struct ipahal_imm_cmd_register_write reg_write_cmd = {0};
 	struct ipahal_imm_cmd_dma_shared_mem  mem_cmd = {0};
 	struct ipahal_imm_cmd_pyld
 		*cmd_pyld[IPA_RT_MAX_NUM_OF_COMMIT_TABLES_CMD_DESC];
@@ -475,12 +571,13 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 	u32 lcl_hash_hdr, lcl_nhash_hdr;
 	u32 lcl_hash_bdy, lcl_nhash_bdy;
 	bool lcl_hash, lcl_nhash;
-	struct ipahal_reg_valmask valmask;
 	int i;
 	struct ipa3_rt_tbl_set *set;
 	struct ipa3_rt_tbl *tbl;
 	u32 tbl_hdr_width;
-	struct ipahal_imm_cmd_register_write reg_write_coal_close;
+
+	/* until this commit is done the HW layout is unknown */
+	ipa3_ctx->rt_tbl_synced[ip] = false;
 
 	tbl_hdr_width = ipahal_get_hw_tbl_hdr_width();
 	memset(desc, 0, sizeof(desc));
@@ -538,6 +635,7 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 			rc = -EPERM;
 			goto no_rt_tbls;
 		}
+		tbl->dirty = false;
 		if (!tbl->in_sys[IPA_RULE_HASHABLE] &&
 			tbl->sz[IPA_RULE_HASHABLE]) {
 			alloc_params.num_lcl_hash_tbls++;
@@ -571,78 +669,9 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 		goto fail_size_valid;
 	}
 
-	/* IC to close the coal frame before HPS Clear if coal is enabled */
-	if (ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS) != -1
-		&& !ipa3_ctx->ulso_wa) {
-		u32 offset = 0;
-
-		i = ipa3_get_ep_mapping(IPA_CLIENT_APPS_WAN_COAL_CONS);
-		reg_write_coal_close.skip_pipeline_clear = false;
-		reg_write_coal_close.pipeline_clear_options = IPAHAL_HPS_CLEAR;
-		if (ipa3_ctx->ipa_hw_type < IPA_HW_v5_0)
-			offset = ipahal_get_reg_ofst(
-				IPA_AGGR_FORCE_CLOSE);
-		else
-			offset = ipahal_get_ep_reg_offset(
-				IPA_AGGR_FORCE_CLOSE_n, i);
-		reg_write_coal_close.offset = offset;
-		ipahal_get_aggr_force_close_valmask(i, &valmask);
-		reg_write_coal_close.value = valmask.val;
-		reg_write_coal_close.value_mask = valmask.mask;
-		cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
-			IPA_IMM_CMD_REGISTER_WRITE,
-			&reg_write_coal_close, false);
-		if (!cmd_pyld[num_cmd]) {
-			IPAERR("failed to construct coal close IC\n");
-			goto fail_size_valid;
-		}
-		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
-		++num_cmd;
-	}
-
-	/*
-	 * SRAM memory not allocated to hash tables. Sending
-	 * command to hash tables(filer/routing) operation not supported.
-	 */
-	if (!ipa3_ctx->ipa_fltrt_not_hashable) {
-		/* flushing ipa internal hashable rt rules cache */
-		if (ipa3_ctx->ipa_hw_type >= IPA_HW_v5_0) {
-			struct ipahal_reg_fltrt_cache_flush flush_cache;
-
-			memset(&flush_cache, 0, sizeof(flush_cache));
-			flush_cache.rt = true;
-			ipahal_get_fltrt_cache_flush_valmask(
-				&flush_cache, &valmask);
-			reg_write_cmd.offset = ipahal_get_reg_ofst(
-				IPA_FILT_ROUT_CACHE_FLUSH);
-		} else {
-			struct ipahal_reg_fltrt_hash_flush flush_hash;
-
-			memset(&flush_hash, 0, sizeof(flush_hash));
-			if (ip == IPA_IP_v4)
-				flush_hash.v4_rt = true;
-			else
-				flush_hash.v6_rt = true;
-			ipahal_get_fltrt_hash_flush_valmask(
-				&flush_hash, &valmask);
-			reg_write_cmd.offset = ipahal_get_reg_ofst(
-				IPA_FILT_ROUT_HASH_FLUSH);
-		}
-		reg_write_cmd.skip_pipeline_clear = false;
-		reg_write_cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
-		reg_write_cmd.value = valmask.val;
-		reg_write_cmd.value_mask = valmask.mask;
-		cmd_pyld[num_cmd] = ipahal_construct_imm_cmd(
-				IPA_IMM_CMD_REGISTER_WRITE, &reg_write_cmd,
-							false);
-		if (!cmd_pyld[num_cmd]) {
-			IPAERR(
-			"fail construct register_write imm cmd. IP %d\n", ip);
-			goto fail_imm_cmd_construct;
-		}
-		ipa3_init_imm_cmd_desc(&desc[num_cmd], cmd_pyld[num_cmd]);
-		num_cmd++;
-	}
+	rc = ipa_rt_prep_flush_cmds(ip, desc, cmd_pyld, &num_cmd);
+	if (rc)
+		goto fail_imm_cmd_construct;
 
 	mem_cmd.is_read = false;
 	mem_cmd.skip_pipeline_clear = false;
@@ -759,6 +788,7 @@ int __ipa_commit_rt_v3(enum ipa_ip_type ip)
 	}
 
 	__ipa_reap_sys_rt_tbls(ip);
+	ipa3_ctx->rt_tbl_synced[ip] = true;
 
 fail_imm_cmd_construct:
 	for (i = 0 ; i < num_cmd ; i++)
@@ -776,6 +806,328 @@ no_rt_tbls:
 	return rc;
 }
 
+/**
+ * ipa_rt_prep_dma_cmd() - prepare a DMA_SHARED_MEM IC writing to the SRAM
+ * @sys_addr: source address in system memory
+ * @lcl_addr: destination offset in the SRAM
+ * @size: number of bytes to write
+ * @desc: descriptor buffer
+ * @cmd_pyld: imm cmds payload pointers buffer
+ * @num_cmd: [IN/OUT] number of commands in the buffers
+ *
+ * Return: 0 on success, negative on failure
+ */
+static int ipa_rt_prep_dma_cmd(dma_addr_t sys_addr, u32 lcl_addr, u32 size,
+	struct ipa3_desc *desc, struct ipahal_imm_cmd_pyld **cmd_pyld,
+	int *num_cmd)
+{
+	struct ipahal_imm_cmd_dma_shared_mem mem_cmd = {0};
+
+	mem_cmd.is_read = false;
+	mem_cmd.skip_pipeline_clear = false;
+	mem_cmd.pipeline_clear_options = IPAHAL_HPS_CLEAR;
+	mem_cmd.size = size;
+	mem_cmd.system_addr = sys_addr;
+	mem_cmd.local_addr = lcl_addr;
+	cmd_pyld[*num_cmd] = ipahal_construct_imm_cmd(
+		IPA_IMM_CMD_DMA_SHARED_MEM, &mem_cmd, false);
+	if (!cmd_pyld[*num_cmd]) {
+		IPAERR("fail construct dma_shared_mem cmd\n");
+		return -ENOMEM;
+	}
+	ipa3_init_imm_cmd_desc(&desc[*num_cmd], cmd_pyld[*num_cmd]);
+	++(*num_cmd);
+
+	return 0;
+}
+
+static int ipa_rt_gen_tbl_rules(enum ipa_ip_type ip, struct ipa3_rt_tbl *tbl,
+	enum ipa_rule_type rlt, u8 *buf)
+{
+	struct ipa3_rt_entry *entry;
+
+	list_for_each_entry(entry, &tbl->head_rt_rule_list, link) {
+		if (IPA_RT_GET_RULE_TYPE(entry) != rlt)
+			continue;
+		if (ipa_generate_rt_hw_rule(ip, entry, buf)) {
+			IPAERR_RL("failed to gen HW RT rule\n");
+			return -EPERM;
+		}
+		buf += entry->hw_len;
+	}
+
+	return 0;
+}
+
+/**
+ * __ipa_commit_rt_delta_v3() - commit only the dirty rt tables to the hw
+ *  A dirty table in system memory gets a new body and only its header entry
+ *  is rewritten. A dirty local table is rewritten in place, in the room the
+ *  last full commit gave it. Clean tables are not touched.
+ * @ip: the ip address family type
+ *
+ * Return: 0 on success, -EAGAIN if the change does not fit the current
+ *  layout and a full commit is needed, other negative on failure
+ */
+static int __ipa_commit_rt_delta_v3(enum ipa_ip_type ip)
+{
+	struct ipa_mem_buffer scratch = {0};
+	struct ipa_mem_buffer tbl_mem;
+	struct ipa3_desc *desc;
+	struct ipahal_imm_cmd_pyld **cmd_pyld;
+	struct ipa3_rt_tbl_set *set;
+	struct ipa3_rt_tbl *tbl;
+	u32 prev_sz[IPA_RULE_TYPE_MAX];
+	u32 lcl_hdr[IPA_RULE_TYPE_MAX];
+	u32 lcl_bdy[IPA_RULE_TYPE_MAX];
+	u32 num_modem_rt_index;
+	u32 apps_start_idx;
+	u32 tbl_hdr_width;
+	u32 scratch_sz = 0;
+	u32 scratch_ofst = 0;
+	int num_dirty = 0;
+	int num_cmd = 0;
+	int num_cmd_to_send;
+	int rlt;
+	int rc = 0;
+	int i;
+
+	if (!ipa3_ctx->rt_tbl_synced[ip] || !ipa3_ctx->rt_idx_bitmap[ip])
+		return -EAGAIN;
+
+	tbl_hdr_width = ipahal_get_hw_tbl_hdr_width();
+
+	set = &ipa3_ctx->rt_tbl_set[ip];
+	list_for_each_entry(tbl, &set->head_rt_tbl_list, link) {
+		if (!tbl->dirty)
+			continue;
+
+		memcpy(prev_sz, tbl->sz, sizeof(prev_sz));
+		if (ipa_prep_rt_tbl_for_cmt(ip, tbl)) {
+			ipa3_ctx->rt_tbl_synced[ip] = false;
+			return -EPERM;
+		}
+
+		for (rlt = 0; rlt < IPA_RULE_TYPE_MAX; rlt++) {
+			/* emptying or populating a table changes the layout */
+			if (!prev_sz[rlt] != !tbl->sz[rlt])
+				return -EAGAIN;
+			if (!tbl->sz[rlt])
+				continue;
+
+			if (tbl->in_sys[rlt]) {
+				scratch_sz += tbl_hdr_width;
+			} else {
+				/*
+				 * sz counts a header word, which keeps room
+				 * for the rule-set terminator
+				 */
+				if (tbl->sz[rlt] > tbl->lcl_room[rlt])
+					return -EAGAIN;
+				scratch_sz += tbl->lcl_room[rlt];
+			}
+		}
+		num_dirty++;
+	}
+
+	if (!num_dirty)
+		return 0;
+
+	if (ip == IPA_IP_v4) {
+		num_modem_rt_index =
+			IPA_MEM_PART(v4_modem_rt_index_hi) -
+			IPA_MEM_PART(v4_modem_rt_index_lo) + 1;
+		lcl_hdr[IPA_RULE_HASHABLE] = ipa3_ctx->smem_restricted_bytes +
+			IPA_MEM_PART(v4_rt_hash_ofst) +
+			num_modem_rt_index * tbl_hdr_width;
+		lcl_hdr[IPA_RULE_NON_HASHABLE] =
+			ipa3_ctx->smem_restricted_bytes +
+			IPA_MEM_PART(v4_rt_nhash_ofst) +
+			num_modem_rt_index * tbl_hdr_width;
+		lcl_bdy[IPA_RULE_HASHABLE] = ipa3_ctx->smem_restricted_bytes +
+			IPA_MEM_PART(apps_v4_rt_hash_ofst);
+		lcl_bdy[IPA_RULE_NON_HASHABLE] =
+			ipa3_ctx->smem_restricted_bytes +
+			IPA_MEM_PART(apps_v4_rt_nhash_ofst);
+		apps_start_idx = IPA_MEM_PART(v4_apps_rt_index_lo);
+	} else {
+		num_modem_rt_index =
+			IPA_MEM_PART(v6_modem_rt_index_hi) -
+			IPA_MEM_PART(v6_modem_rt_index_lo) + 1;
+		lcl_hdr[IPA_RULE_HASHABLE] = ipa3_ctx->smem_restricted_bytes +
+			IPA_MEM_PART(v6_rt_hash_ofst) +
+			num_modem_rt_index * tbl_hdr_width;
+		lcl_hdr[IPA_RULE_NON_HASHABLE] =
+			ipa3_ctx->smem_restricted_bytes +
+			IPA_MEM_PART(v6_rt_nhash_ofst) +
+			num_modem_rt_index * tbl_hdr_width;
+		lcl_bdy[IPA_RULE_HASHABLE] = ipa3_ctx->smem_restricted_bytes +
+			IPA_MEM_PART(apps_v6_rt_hash_ofst);
+		lcl_bdy[IPA_RULE_NON_HASHABLE] =
+			ipa3_ctx->smem_restricted_bytes +
+			IPA_MEM_PART(apps_v6_rt_nhash_ofst);
+		apps_start_idx = IPA_MEM_PART(v6_apps_rt_index_lo);
+	}
+
+	if (scratch_sz) {
+		scratch.size = scratch_sz;
+		if (ipahal_fltrt_allocate_hw_sys_tbl(&scratch)) {
+			IPAERR("fail to alloc delta buf of size %d\n",
+				scratch_sz);
+			ipa3_ctx->rt_tbl_synced[ip] = false;
+			return -ENOMEM;
+		}
+	}
+
+	/* +2: for flushing and for closing the coalescing frame */
+	desc = kcalloc(num_dirty * IPA_RULE_TYPE_MAX + 2, sizeof(*desc),
+		GFP_KERNEL);
+	if (!desc) {
+		rc = -ENOMEM;
+		goto fail_alloc_desc;
+	}
+	cmd_pyld = kcalloc(num_dirty * IPA_RULE_TYPE_MAX + 2,
+		sizeof(*cmd_pyld), GFP_KERNEL);
+	if (!cmd_pyld) {
+		rc = -ENOMEM;
+		goto fail_alloc_cmd;
+	}
+
+	rc = ipa_rt_prep_flush_cmds(ip, desc, cmd_pyld, &num_cmd);
+	if (rc)
+		goto fail_cmd_construct;
+
+	list_for_each_entry(tbl, &set->head_rt_tbl_list, link) {
+		if (!tbl->dirty)
+			continue;
+
+		for (rlt = 0; rlt < IPA_RULE_TYPE_MAX; rlt++) {
+			u8 *buf = (u8 *)scratch.base + scratch_ofst;
+			dma_addr_t buf_phys = scratch.phys_base + scratch_ofst;
+
+			if (!tbl->sz[rlt])
+				continue;
+
+			if (!tbl->in_sys[rlt]) {
+				rc = ipa_rt_gen_tbl_rules(ip, tbl, rlt, buf);
+				if (rc)
+					goto fail_cmd_construct;
+				rc = ipa_rt_prep_dma_cmd(buf_phys,
+					lcl_bdy[rlt] + tbl->lcl_ofst[rlt],
+					tbl->lcl_room[rlt], desc, cmd_pyld,
+					&num_cmd);
+				if (rc)
+					goto fail_cmd_construct;
+				scratch_ofst += tbl->lcl_room[rlt];
+				continue;
+			}
+
+			/* only body (no header) */
+			tbl_mem.size = tbl->sz[rlt] - tbl_hdr_width +
+				ipahal_get_hw_prefetch_buf_size();
+			if (ipahal_fltrt_allocate_hw_sys_tbl(&tbl_mem)) {
+				IPAERR_RL("fail to alloc sys tbl of size %d\n",
+					tbl_mem.size);
+				rc = -ENOMEM;
+				goto fail_cmd_construct;
+			}
+			rc = ipa_rt_gen_tbl_rules(ip, tbl, rlt, tbl_mem.base);
+			if (rc) {
+				ipahal_free_dma_mem(&tbl_mem);
+				goto fail_cmd_construct;
+			}
+			if (tbl->curr_mem[rlt].phys_base) {
+				WARN_ON(tbl->prev_mem[rlt].phys_base);
+				tbl->prev_mem[rlt] = tbl->curr_mem[rlt];
+			}
+			tbl->curr_mem[rlt] = tbl_mem;
+			scratch_ofst += tbl_hdr_width;
+
+			/* the full commit does not write the hash hdr either */
+			if (rlt == IPA_RULE_HASHABLE &&
+				ipa3_ctx->ipa_fltrt_not_hashable)
+				continue;
+
+			ipahal_fltrt_write_addr_to_hdr(tbl_mem.phys_base, buf,
+				0, true);
+			rc = ipa_rt_prep_dma_cmd(buf_phys, lcl_hdr[rlt] +
+				(tbl->idx - apps_start_idx) * tbl_hdr_width,
+				tbl_hdr_width, desc, cmd_pyld, &num_cmd);
+			if (rc)
+				goto fail_cmd_construct;
+		}
+	}
+
+	for (i = 0; i < num_cmd; i += num_cmd_to_send) {
+		num_cmd_to_send = min_t(int, num_cmd - i,
+			IPA_RT_MAX_NUM_OF_COMMIT_TABLES_CMD_DESC);
+		if (ipa3_send_cmd(num_cmd_to_send, &desc[i])) {
+			IPAERR_RL("fail to send immediate command\n");
+			/* the HW may already use some new bodies, keep them */
+			rc = -EFAULT;
+			goto fail_send;
+		}
+	}
+
+	__ipa_reap_sys_rt_tbls(ip);
+
+	list_for_each_entry(tbl, &set->head_rt_tbl_list, link)
+		tbl->dirty = false;
+	IPADBG_LOW("committed %d dirty rt tbls ip=%d cmds=%d\n",
+		num_dirty, ip, num_cmd);
+	goto free_cmds;
+
+fail_cmd_construct:
+	list_for_each_entry(tbl, &set->head_rt_tbl_list, link) {
+		for (rlt = 0; rlt < IPA_RULE_TYPE_MAX; rlt++) {
+			if (!tbl->prev_mem[rlt].phys_base)
+				continue;
+			ipahal_free_dma_mem(&tbl->curr_mem[rlt]);
+			tbl->curr_mem[rlt] = tbl->prev_mem[rlt];
+			memset(&tbl->prev_mem[rlt], 0,
+				sizeof(tbl->prev_mem[rlt]));
+		}
+	}
+fail_send:
+	ipa3_ctx->rt_tbl_synced[ip] = false;
+free_cmds:
+	for (i = 0; i < num_cmd; i++)
+		ipahal_destroy_imm_cmd(cmd_pyld[i]);
+	kfree(cmd_pyld);
+	kfree(desc);
+	if (scratch.size)
+		ipahal_free_dma_mem(&scratch);
+	return rc;
+
+fail_alloc_cmd:
+	kfree(desc);
+fail_alloc_desc:
+	ipa3_ctx->rt_tbl_synced[ip] = false;
+	if (scratch.size)
+		ipahal_free_dma_mem(&scratch);
+	return rc;
+}
+
+/**
+ * __ipa_commit_rt_v3() - commit rt tables to the hw
+ *  Only the tables changed since the last commit are written when the
+ *  change fits the layout in HW, otherwise all the tables are rebuilt.
+ * @ip: the ip address family type
+ *
+ * Return: 0 on success, negative on failure
+ */
+int __ipa_commit_rt_v3(enum ipa_ip_type ip)
+{
+	int rc;
+
+	rc = __ipa_commit_rt_delta_v3(ip);
+	if (rc != -EAGAIN)
+		return rc;
+
+	IPADBG_LOW("full rt commit ip=%d\n", ip);
+	return __ipa_commit_rt_full_v3(ip);
+}
+
 /**
  * __ipa3_find_rt_tbl() - find the routing table
  *			which name is given as parameter
@@ -796,7 +1148,8 @@ struct ipa3_rt_tbl *__ipa3_find_rt_tbl(enum ipa_ip_type ip, const char *name)
 	}
 
 	set = &ipa3_ctx->rt_tbl_set[ip];
-	list_for_each_entry(entry, &set->head_rt_tbl_list, link) {
+	hash_for_each_possible(set->name_htable, entry, name_node,
+		ipa3_name_hash(name)) {
 		if (!ipa3_check_idr_if_freed(entry) &&
 			!strcmp(name, entry->name))
 			return entry;
@@ -897,6 +1250,8 @@ static struct ipa3_rt_tbl *__ipa_add_rt_tbl(enum ipa_ip_type ip,
 		set->tbl_cnt++;
 		entry->rule_ids = &set->rule_ids;
 		list_add(&entry->link, &set->head_rt_tbl_list);
+		hash_add(set->name_htable, &entry->name_node,
+			ipa3_name_hash(entry->name));
 
 		IPADBG("add rt tbl idx=%d tbl_cnt=%d ip=%d\n", entry->idx,
 				set->tbl_cnt, ip);
@@ -914,6 +1269,7 @@ static struct ipa3_rt_tbl *__ipa_add_rt_tbl(enum ipa_ip_type ip,
 ipa_insert_failed:
 	set->tbl_cnt--;
 	list_del(&entry->link);
+	hash_del(&entry->name_node);
 	idr_destroy(entry->rule_ids);
 fail_rt_idx_alloc:
 	entry->cookie = 0;
@@ -949,7 +1305,15 @@ static int __ipa_del_rt_tbl(struct ipa3_rt_tbl *entry)
 
 	rset = &ipa3_ctx->reap_rt_tbl_set[ip];
 
+	/*
+	 * the table's header entry must go back to the empty table, and
+	 * filtering rules may still point to its index
+	 */
+	ipa3_ctx->rt_tbl_synced[ip] = false;
+	ipa3_ctx->flt_tbl_synced[ip] = false;
+
 	entry->rule_ids = NULL;
+	hash_del(&entry->name_node);
 	if (entry->in_sys[IPA_RULE_HASHABLE] ||
 		entry->in_sys[IPA_RULE_NON_HASHABLE]) {
 		list_move(&entry->link, &rset->head_rt_tbl_list);
@@ -1128,6 +1492,7 @@ static int __ipa_finish_rt_rule_add(struct ipa3_rt_entry *entry, u32 *rule_hdl,
 		tbl->idx, tbl->rule_cnt, entry->rule_id);
 	*rule_hdl = id;
 	entry->id = id;
+	tbl->dirty = true;
 
 	return 0;
 
@@ -1819,6 +2184,7 @@ int __ipa3_del_rt_rule(u32 rule_hdl)
 		__ipa3_release_hdr_proc_ctx(entry->proc_ctx->id);
 	list_del(&entry->link);
 	entry->tbl->rule_cnt--;
+	entry->tbl->dirty = true;
 	IPADBG("del rt rule tbl_idx=%d rule_cnt=%d rule_id=%d\n ref_cnt=%u",
 		entry->tbl->idx, entry->tbl->rule_cnt,
 		entry->rule_id, entry->tbl->ref_cnt);
@@ -1964,6 +2330,9 @@ int ipa3_reset_rt(enum ipa_ip_type ip, bool user_only)
 	rset = &ipa3_ctx->reap_rt_tbl_set[ip];
 	mutex_lock(&ipa3_ctx->lock);
 	IPADBG("reset rt ip=%d\n", ip);
+	/* tables are removed below, rebuild everything on the next commits */
+	ipa3_ctx->rt_tbl_synced[ip] = false;
+	ipa3_ctx->flt_tbl_synced[ip] = false;
 	list_for_each_entry_safe(tbl, tbl_next, &set->head_rt_tbl_list, link) {
 		tbl_user = false;
 		list_for_each_entry_safe(rule, rule_next,
@@ -2044,6 +2413,7 @@ int ipa3_reset_rt(enum ipa_ip_type ip, bool user_only)
 		if (tbl->idx != apps_start_idx) {
 			if (!user_only || tbl_user) {
 				tbl->rule_ids = NULL;
+				hash_del(&tbl->name_node);
 				if (tbl->in_sys[IPA_RULE_HASHABLE] ||
 					tbl->in_sys[IPA_RULE_NON_HASHABLE]) {
 					list_move(&tbl->link,
@@ -2252,6 +2622,7 @@ static int __ipa_mdfy_rt_rule(struct ipa_rt_rule_mdfy_i *rtrule)
 		entry->cnt_idx = rtrule->rule.cnt_idx;
 	else
 		entry->cnt_idx = 0;
+	entry->tbl->dirty = true;
 	return 0;
 
 error:
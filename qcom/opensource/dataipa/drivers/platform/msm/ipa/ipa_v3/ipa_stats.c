@@ -1497,6 +1497,39 @@ static int ipa_get_page_recycle_stats(unsigned long arg)
 	return 0;
 }
 
+static int ipa_get_page_recycle_ext_stats(unsigned long arg)
+{
+	struct ipa_lnx_pipe_page_recycling_ext_stats *ext_stats;
+	int alloc_size;
+
+	alloc_size = sizeof(struct ipa_lnx_pipe_page_recycling_ext_stats);
+
+	ext_stats = kzalloc(alloc_size, GFP_KERNEL);
+	if (!ext_stats) {
+		IPA_STATS_ERR("alloc failed");
+		return -ENOMEM;
+	}
+
+	mutex_lock(&ipa3_ctx->recycle_stats_collection_lock);
+	memcpy(ext_stats, &ipa3_ctx->recycle_ext_stats, alloc_size);
+
+	/* Clear all the data and valid bits */
+	memset(&ipa3_ctx->recycle_ext_stats, 0, alloc_size);
+
+	mutex_unlock(&ipa3_ctx->recycle_stats_collection_lock);
+
+	ext_stats->version = IPA_LNX_RECYCLING_EXT_STATS_VERSION;
+
+	if (copy_to_user((void __user *)arg, (u8 *)ext_stats, alloc_size)) {
+		IPA_STATS_ERR("copy to user failed");
+		kfree(ext_stats);
+		return -EFAULT;
+	}
+
+	kfree(ext_stats);
+	return 0;
+}
+
 static int ipa_stats_get_alloc_info(unsigned long arg)
 {
 	int i = 0;
@@ -1795,6 +1828,11 @@ static long ipa_lnx_stats_ioctl(struct file *filp,
 		retval = IPA_LNX_STATS_SUCCESS;
 #endif
 		break;
+	case IPA_LNX_IOC_GET_RECYCLE_EXT_STATS:
+		retval = ipa_get_page_recycle_ext_stats(arg);
+		if (retval)
+			IPA_STATS_ERR("ipa get page recycle ext stats fail");
+		break;
 	case IPA_LNX_IOC_GET_CONSOLIDATED_STATS:
 		consolidated_stats = (struct ipa_lnx_consolidated_stats *) memdup_user((
 				const void __user *)arg, sizeof(struct ipa_lnx_consolidated_stats));
@@ -47,6 +47,10 @@
 	IPA_LNX_CMD_CONSOLIDATED_STATS, \
 	int)
 
+#define IPA_LNX_IOC_GET_RECYCLE_EXT_STATS _IOWR(IPA_LNX_STATS_IOC_MAGIC, \
+	IPA_LNX_CMD_RECYCLE_EXT_STATS, \
+	struct ipa_lnx_pipe_page_recycling_ext_stats)
+
 #define IPA_LNX_STATS_SUCCESS 0
 #define IPA_LNX_STATS_FAILURE -1
 
@@ -366,6 +370,33 @@ struct ipa_lnx_pipe_page_recycling_stats {
 	struct ipa_lnx_recycling_stats rx_channel[RX_CHANNEL_MAX][IPA_LNX_PIPE_PAGE_RECYCLING_INTERVAL_COUNT];
 };
 
+#define IPA_LNX_RECYCLING_EXT_STATS_VERSION 1
+
+/**
+ * Page recycling counters that ipa_lnx_recycling_stats has no room for.
+ * That structure is shared with existing agents and cannot grow.
+ */
+struct ipa_lnx_recycling_ext_stats {
+	uint64_t reclaim_cumulative;
+	uint64_t busy_cumulative;
+	uint64_t reclaim_diff;
+	uint64_t busy_diff;
+	uint64_t valid;
+};
+
+/**
+ * Read with IPA_LNX_IOC_GET_RECYCLE_EXT_STATS. The intervals are indexed
+ * as in ipa_lnx_pipe_page_recycling_stats, but kept and cleared apart.
+ * @version: IPA_LNX_RECYCLING_EXT_STATS_VERSION of the driver
+ */
+struct ipa_lnx_pipe_page_recycling_ext_stats {
+	uint32_t version;
+	uint32_t interval_time_in_ms;
+	uint32_t default_coal_stats_index;
+	uint32_t low_lat_stats_index;
+	struct ipa_lnx_recycling_ext_stats rx_channel[RX_CHANNEL_MAX][IPA_LNX_PIPE_PAGE_RECYCLING_INTERVAL_COUNT];
+};
+
 /* Explain below structures */
 struct ipa_lnx_each_inst_alloc_info {
 	uint32_t pipes_client_type[TLPD_NUM_MAX_PIPES];
@@ -410,6 +441,7 @@ enum ipa_lnx_stats_ioc_cmd_type {
 	IPA_LNX_CMD_USB_INST_STATS,
 	IPA_LNX_CMD_MHIP_INST_STATS,
 	IPA_LNX_CMD_CONSOLIDATED_STATS,
+	IPA_LNX_CMD_RECYCLE_EXT_STATS,
 	IPA_LNX_CMD_STATS_MAX,
 };
 
@@ -14,6 +14,7 @@
 #include <linux/interrupt.h>
 #include <linux/init.h>
 #include <linux/kernel.h>
+#include <linux/mm.h>
 #include <linux/module.h>
 #include <linux/netdevice.h>
 #include <linux/of_device.h>
@@ -43,6 +44,7 @@
 
 #include "ipa_trace.h"
 #include "ipa_odl.h"
+#include "rmnet_ipa_stats_snap.h"
 
 
 #define OUTSTANDING_HIGH_DEFAULT 256
@@ -210,6 +212,35 @@ static struct rmnet_ipa3_context *rmnet_ipa3_ctx;
 static struct ipa3_rmnet_plat_drv_res ipa3_rmnet_res;
 bool ipa_net_initialized = false;
 
+/**
+ * struct rmnet_ipa3_stats_snap_ctx - state of the mmap-able stats snapshot
+ * @lock: protects the fields below and the snapshot updates
+ * @users: number of live mappings, the snapshot is refreshed while non zero
+ * @interval_ms: refresh interval, tunable from debugfs
+ * @snap: the page mapped to user space
+ * @staging: the next snapshot, built without holding readers off
+ * @con_stats: DL counters of a producer and the sum over producers
+ * @work: periodic refresh
+ */
+struct rmnet_ipa3_stats_snap_ctx {
+	struct mutex lock;
+	int users;
+	u32 interval_ms;
+	struct rmnet_ipa_stats_snap *snap;
+	struct rmnet_ipa_stats_snap *staging;
+	struct ipa_quota_stats_all *con_stats;
+	struct delayed_work work;
+};
+
+static void rmnet_ipa3_stats_snap_work(struct work_struct *work);
+
+static struct rmnet_ipa3_stats_snap_ctx rmnet_ipa3_snap = {
+	.lock = __MUTEX_INITIALIZER(rmnet_ipa3_snap.lock),
+	.interval_ms = 1000,
+	.work = __DELAYED_WORK_INITIALIZER(rmnet_ipa3_snap.work,
+		rmnet_ipa3_stats_snap_work, 0),
+};
+
 struct rmnet_ipa_pipe_setup_status {
 	int ep_type;
 	int status;
@@ -1524,7 +1555,8 @@ send:
 	 * both data packets and command will be routed to
 	 * IPA_CLIENT_Q6_WAN_CONS based on status configuration
 	 */
-	ret = ipa3_tx_dp(IPA_CLIENT_APPS_WAN_PROD, skb, NULL);
+	ret = __ipa3_tx_dp(IPA_CLIENT_APPS_WAN_PROD, skb, NULL,
+		netdev_xmit_more());
 	if (ret) {
 		atomic_dec(&wwan_ptr->outstanding_pkts);
 		if (ret == -EPIPE) {
@@ -3633,9 +3665,15 @@ static int ipa3_wwan_probe(struct platform_device *pdev)
 		goto fail_pm;
 	}
 
-	/* Enable SG support in netdevice. */
-	if (ipa3_rmnet_res.ipa_advertise_sg_support)
+	/*
+	 * Enable SG support in netdevice. It is on by default so that rmnet
+	 * SG UL aggregates reach the pipe as frags instead of being
+	 * linearized by the stack.
+	 */
+	if (ipa3_rmnet_res.ipa_advertise_sg_support) {
 		dev->hw_features |= NETIF_F_SG;
+		dev->features |= NETIF_F_SG;
+	}
 
 	if (ipa3_is_ulso_supported()) {
 		dev->hw_features |= NETIF_F_GSO_UDP_L4;
@@ -6444,6 +6482,10 @@ static void rmnet_ipa_debugfs_init(void)
 		read_write_mode, dbgfs->dent,
 		&rmnet_ipa3_ctx->outstanding_low);
 
+	debugfs_create_u32("stats_snap_interval_ms",
+		read_write_mode, dbgfs->dent,
+		&rmnet_ipa3_snap.interval_ms);
+
 	return;
 }
 
@@ -6618,6 +6660,291 @@ int rmnet_ipa3_query_per_client_stats_v2(
 	return ret;
 }
 
+static int rmnet_ipa3_stats_snap_add_prod(enum ipa_client_type prod)
+{
+	struct ipa_quota_stats_all *stats = &rmnet_ipa3_snap.con_stats[0];
+	struct ipa_quota_stats_all *sum = &rmnet_ipa3_snap.con_stats[1];
+	int i, rc;
+
+	memset(stats, 0, sizeof(*stats));
+	rc = ipa_query_teth_stats(prod, stats, false);
+	if (rc)
+		return rc;
+
+	for (i = 0; i < IPA_CLIENT_MAX; i++) {
+		sum->client[i].num_ipv4_pkts += stats->client[i].num_ipv4_pkts;
+		sum->client[i].num_ipv4_bytes +=
+			stats->client[i].num_ipv4_bytes;
+		sum->client[i].num_ipv6_pkts += stats->client[i].num_ipv6_pkts;
+		sum->client[i].num_ipv6_bytes +=
+			stats->client[i].num_ipv6_bytes;
+	}
+
+	return 0;
+}
+
+/*
+ * A failed read leaves the snapshot unchanged, publishing zeroes would look
+ * like a counter reset to usage accounting.
+ */
+static int rmnet_ipa3_stats_snap_pipes(struct rmnet_ipa_stats_snap *snap)
+{
+	struct ipa_quota_stats_all *sum = &rmnet_ipa3_snap.con_stats[1];
+	int i, rc;
+
+	rc = ipa_get_teth_stats();
+	if (rc)
+		return rc;
+
+	memset(sum, 0, sizeof(*sum));
+	if (rmnet_ipa3_ctx->ipa_config_is_apq)
+		rc = rmnet_ipa3_stats_snap_add_prod(
+			IPA_CLIENT_MHI_PRIME_TETH_PROD);
+	else
+		rc = rmnet_ipa3_stats_snap_add_prod(IPA_CLIENT_Q6_WAN_PROD);
+	if (rc)
+		return rc;
+
+	if (ipa3_ctx->ipa_hw_type >= IPA_HW_v4_5 &&
+		ipa3_ctx->platform_type != IPA_PLAT_TYPE_APQ) {
+		rc = rmnet_ipa3_stats_snap_add_prod(
+			IPA_CLIENT_Q6_DL_NLO_DATA_PROD);
+		if (rc)
+			return rc;
+	}
+
+	snap->num_pipes = 0;
+	for (i = 0; i < IPA_CLIENT_MAX &&
+		snap->num_pipes < RMNET_IPA_SNAP_MAX_PIPES; i++) {
+		struct rmnet_ipa_snap_pipe *pipe;
+
+		if (!sum->client[i].num_ipv4_pkts &&
+			!sum->client[i].num_ipv6_pkts)
+			continue;
+
+		pipe = &snap->pipe[snap->num_pipes++];
+		pipe->client = i;
+		pipe->ipv4_pkts = sum->client[i].num_ipv4_pkts;
+		pipe->ipv4_bytes = sum->client[i].num_ipv4_bytes;
+		pipe->ipv6_pkts = sum->client[i].num_ipv6_pkts;
+		pipe->ipv6_bytes = sum->client[i].num_ipv6_bytes;
+	}
+
+	return 0;
+}
+
+/* a client whose counters cannot be read keeps its published values */
+static void rmnet_ipa3_stats_snap_clients(struct rmnet_ipa_stats_snap *snap,
+	const struct rmnet_ipa_stats_snap *prev)
+{
+	struct ipa_tether_device_info *teth_ptr;
+	struct ipa_lan_client_cntr_index *index;
+	struct rmnet_ipa_snap_client *client;
+	struct ipa_flt_rt_stats fnr[2];
+	struct ipa_ioc_flt_rt_query query;
+	int dev, i;
+
+	memset(snap->client, 0, sizeof(snap->client));
+
+	mutex_lock(&rmnet_ipa3_ctx->per_client_stats_guard);
+	for (dev = 0; dev < IPACM_MAX_CLIENT_DEVICE_TYPES &&
+		dev < RMNET_IPA_SNAP_MAX_DEVICES; dev++) {
+		teth_ptr = &rmnet_ipa3_ctx->tether_device[dev];
+		if (teth_ptr->ul_src_pipe == -1 || !teth_ptr->num_clients)
+			continue;
+
+		for (i = 0; i < IPA_MAX_NUM_HW_PATH_CLIENTS &&
+			i < RMNET_IPA_SNAP_MAX_CLIENTS; i++) {
+			if (!teth_ptr->lan_client[i].inited)
+				continue;
+
+			index = &teth_ptr->lan_client_indices[i];
+			if (index->dl_cnt_idx != index->ul_cnt_idx + 1)
+				continue;
+
+			memset(&query, 0, sizeof(query));
+			memset(fnr, 0, sizeof(fnr));
+			query.start_id = index->ul_cnt_idx;
+			query.end_id = index->dl_cnt_idx;
+			query.stats = (uint64_t)fnr;
+			client = &snap->client[dev][i];
+			if (ipa_get_flt_rt_stats(&query)) {
+				*client = prev->client[dev][i];
+				continue;
+			}
+
+			memcpy(client->mac, teth_ptr->lan_client[i].mac,
+				sizeof(client->mac));
+			client->valid = 1;
+			client->tx_pkts = fnr[0].num_pkts;
+			client->tx_bytes = fnr[0].num_bytes;
+			client->rx_pkts = fnr[1].num_pkts;
+			client->rx_bytes = fnr[1].num_bytes;
+		}
+	}
+	mutex_unlock(&rmnet_ipa3_ctx->per_client_stats_guard);
+}
+
+static void rmnet_ipa3_stats_snap_work(struct work_struct *work)
+{
+	struct rmnet_ipa3_stats_snap_ctx *ctx = &rmnet_ipa3_snap;
+	struct rmnet_ipa_stats_snap *snap, *staging;
+	struct ipa_active_client_logging_info log_info;
+
+	mutex_lock(&ctx->lock);
+	if (!ctx->users)
+		goto unlock;
+
+	snap = ctx->snap;
+	staging = ctx->staging;
+
+	if (!rmnet_ipa3_ctx || !atomic_read(&rmnet_ipa3_ctx->is_initialized))
+		goto resched;
+
+	/*
+	 * The counters do not move while IPA is idle, leave the snapshot as
+	 * it is rather than waking IPA up only to read them.
+	 */
+	IPA_ACTIVE_CLIENTS_PREP_SPECIAL(log_info, "TETH_SNAP");
+	if (ipa3_inc_client_enable_clks_no_block(&log_info))
+		goto resched;
+	if (rmnet_ipa3_stats_snap_pipes(staging)) {
+		ipa3_dec_client_disable_clks_no_block(&log_info);
+		goto resched;
+	}
+	rmnet_ipa3_stats_snap_clients(staging, snap);
+	ipa3_dec_client_disable_clks_no_block(&log_info);
+
+	WRITE_ONCE(snap->seq, snap->seq + 1);
+	smp_wmb();
+	snap->interval_ms = ctx->interval_ms;
+	snap->update_ns = ktime_get_ns();
+	snap->num_pipes = staging->num_pipes;
+	memcpy(snap->pipe, staging->pipe, sizeof(snap->pipe));
+	memcpy(snap->client, staging->client, sizeof(snap->client));
+	smp_wmb();
+	WRITE_ONCE(snap->seq, snap->seq + 1);
+
+resched:
+	schedule_delayed_work(&ctx->work,
+		msecs_to_jiffies(max_t(u32, ctx->interval_ms, 100)));
+unlock:
+	mutex_unlock(&ctx->lock);
+}
+
+static void rmnet_ipa3_stats_snap_vm_open(struct vm_area_struct *vma)
+{
+	mutex_lock(&rmnet_ipa3_snap.lock);
+	rmnet_ipa3_snap.users++;
+	mutex_unlock(&rmnet_ipa3_snap.lock);
+}
+
+/* the work stops rescheduling itself once the last mapping is gone */
+static void rmnet_ipa3_stats_snap_vm_close(struct vm_area_struct *vma)
+{
+	mutex_lock(&rmnet_ipa3_snap.lock);
+	rmnet_ipa3_snap.users--;
+	mutex_unlock(&rmnet_ipa3_snap.lock);
+}
+
+static const struct vm_operations_struct rmnet_ipa3_stats_snap_vm_ops = {
+	.open = rmnet_ipa3_stats_snap_vm_open,
+	.close = rmnet_ipa3_stats_snap_vm_close,
+};
+
+static int rmnet_ipa3_stats_snap_alloc(struct rmnet_ipa3_stats_snap_ctx *ctx)
+{
+	BUILD_BUG_ON(sizeof(struct rmnet_ipa_stats_snap) > PAGE_SIZE);
+
+	if (ctx->snap)
+		return 0;
+
+	ctx->staging = kzalloc(sizeof(*ctx->staging), GFP_KERNEL);
+	ctx->con_stats = kcalloc(2, sizeof(*ctx->con_stats), GFP_KERNEL);
+	ctx->snap = (struct rmnet_ipa_stats_snap *)get_zeroed_page(GFP_KERNEL);
+	if (!ctx->staging || !ctx->con_stats || !ctx->snap) {
+		kfree(ctx->staging);
+		kfree(ctx->con_stats);
+		free_page((unsigned long)ctx->snap);
+		ctx->staging = NULL;
+		ctx->con_stats = NULL;
+		ctx->snap = NULL;
+		return -ENOMEM;
+	}
+
+	ctx->snap->magic = RMNET_IPA_SNAP_MAGIC;
+	ctx->snap->version = RMNET_IPA_SNAP_VERSION;
+	ctx->snap->interval_ms = ctx->interval_ms;
+
+	return 0;
+}
+
+/**
+ * rmnet_ipa3_stats_snap_mmap() - map the tethering stats snapshot
+ * @filp: the wwan_ioctl file
+ * @vma: user mapping, one read only page at offset 0
+ *
+ * The snapshot layout is in rmnet_ipa_stats_snap.h. It is refreshed every
+ * interval_ms for as long as any mapping of it exists.
+ *
+ * Return: 0 on success, negative on failure
+ */
+int rmnet_ipa3_stats_snap_mmap(struct file *filp, struct vm_area_struct *vma)
+{
+	struct rmnet_ipa3_stats_snap_ctx *ctx = &rmnet_ipa3_snap;
+	int rc;
+
+	if (vma->vm_pgoff || vma->vm_end - vma->vm_start != PAGE_SIZE)
+		return -EINVAL;
+
+	if (vma->vm_flags & VM_WRITE)
+		return -EPERM;
+
+#if (LINUX_VERSION_CODE >= KERNEL_VERSION(6, 3, 0))
+	vm_flags_clear(vma, VM_MAYWRITE);
+#else
+	vma->vm_flags &= ~VM_MAYWRITE;
+#endif
+
+	mutex_lock(&ctx->lock);
+	rc = rmnet_ipa3_stats_snap_alloc(ctx);
+	if (rc)
+		goto unlock;
+
+	rc = remap_pfn_range(vma, vma->vm_start,
+		virt_to_phys(ctx->snap) >> PAGE_SHIFT, PAGE_SIZE,
+		vma->vm_page_prot);
+	if (rc)
+		goto unlock;
+
+	vma->vm_ops = &rmnet_ipa3_stats_snap_vm_ops;
+	if (!ctx->users++)
+		mod_delayed_work(system_wq, &ctx->work, 0);
+
+unlock:
+	mutex_unlock(&ctx->lock);
+	return rc;
+}
+
+static void rmnet_ipa3_stats_snap_cleanup(void)
+{
+	struct rmnet_ipa3_stats_snap_ctx *ctx = &rmnet_ipa3_snap;
+
+	cancel_delayed_work_sync(&ctx->work);
+
+	mutex_lock(&ctx->lock);
+	/* a page still mapped somewhere stays until the module goes away */
+	if (!ctx->users) {
+		kfree(ctx->staging);
+		kfree(ctx->con_stats);
+		free_page((unsigned long)ctx->snap);
+		ctx->staging = NULL;
+		ctx->con_stats = NULL;
+		ctx->snap = NULL;
+	}
+	mutex_unlock(&ctx->lock);
+}
+
 int ipa3_wwan_init(void)
 {
 	int i, j;
@@ -6753,6 +7080,7 @@ void ipa3_wwan_cleanup(void)
 			SUBSYS_REMOTE_MODEM, ret);
 	}
 	rmnet_ipa_debugfs_remove();
+	rmnet_ipa3_stats_snap_cleanup();
 	ipa3_qmi_cleanup();
 	mutex_destroy(&rmnet_ipa3_ctx->per_client_stats_guard);
 	mutex_destroy(&rmnet_ipa3_ctx->add_mux_channel_lock);
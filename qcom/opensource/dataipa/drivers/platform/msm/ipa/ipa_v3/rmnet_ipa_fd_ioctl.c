@@ -617,6 +617,7 @@ static const struct file_operations rmnet_ipa3_fops = {
 	.open = ipa3_wan_ioctl_open,
 	.read = NULL,
 	.unlocked_ioctl = ipa3_wan_ioctl,
+	.mmap = rmnet_ipa3_stats_snap_mmap,
 #ifdef CONFIG_COMPAT
 	.compat_ioctl = ipa3_compat_wan_ioctl,
 #endif
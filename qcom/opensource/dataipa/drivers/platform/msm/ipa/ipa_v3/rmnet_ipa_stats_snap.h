@@ -0,0 +1,93 @@
+/* SPDX-License-Identifier: GPL-2.0-only WITH Linux-syscall-note */
+
+#ifndef _RMNET_IPA_STATS_SNAP_H_
+#define _RMNET_IPA_STATS_SNAP_H_
+
+#include <linux/types.h>
+
+/*
+ * Tethering stats snapshot, mapped read only with mmap() of the wwan_ioctl
+ * device. The kernel refreshes it every interval_ms while it is mapped, so
+ * readers get the stats without a syscall or a QMI round-trip.
+ *
+ * seq is odd while the kernel updates the snapshot. Readers copy what they
+ * need and retry if seq changed or was odd:
+ *
+ *	do {
+ *		seq = __atomic_load_n(&snap->seq, __ATOMIC_ACQUIRE);
+ *		if (seq & 1)
+ *			continue;
+ *		copy = *snap;
+ *		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+ *	} while (seq & 1 || __atomic_load_n(&snap->seq, __ATOMIC_RELAXED) != seq);
+ */
+
+#define RMNET_IPA_SNAP_MAGIC 0x50414e53 /* "SNAP" */
+#define RMNET_IPA_SNAP_VERSION 1
+
+#define RMNET_IPA_SNAP_MAX_PIPES 16
+#define RMNET_IPA_SNAP_MAX_DEVICES 4
+#define RMNET_IPA_SNAP_MAX_CLIENTS 16
+
+/**
+ * struct rmnet_ipa_snap_pipe - DL counters of a tethered consumer pipe
+ * @client: enum ipa_client_type of the consumer pipe
+ * @ipv4_pkts: IPv4 packets from the modem to the pipe
+ * @ipv4_bytes: IPv4 bytes from the modem to the pipe
+ * @ipv6_pkts: IPv6 packets from the modem to the pipe
+ * @ipv6_bytes: IPv6 bytes from the modem to the pipe
+ */
+struct rmnet_ipa_snap_pipe {
+	__u32 client;
+	__u32 reserved;
+	__u64 ipv4_pkts;
+	__u64 ipv4_bytes;
+	__u64 ipv6_pkts;
+	__u64 ipv6_bytes;
+};
+
+/**
+ * struct rmnet_ipa_snap_client - IPv4 counters of a tethered LAN client
+ * @mac: MAC address of the client
+ * @valid: client is set up, the counters below are meaningful
+ * @tx_pkts: packets from the client
+ * @tx_bytes: bytes from the client
+ * @rx_pkts: packets to the client
+ * @rx_bytes: bytes to the client
+ */
+struct rmnet_ipa_snap_client {
+	__u8 mac[6];
+	__u8 valid;
+	__u8 reserved;
+	__u64 tx_pkts;
+	__u64 tx_bytes;
+	__u64 rx_pkts;
+	__u64 rx_bytes;
+};
+
+/**
+ * struct rmnet_ipa_stats_snap - the mapped snapshot
+ * @magic: RMNET_IPA_SNAP_MAGIC
+ * @version: RMNET_IPA_SNAP_VERSION
+ * @seq: update sequence, odd while the kernel updates the snapshot
+ * @interval_ms: refresh interval
+ * @update_ns: CLOCK_MONOTONIC time of the last refresh
+ * @num_pipes: valid entries in @pipe
+ * @pipe: counters per tethered consumer pipe
+ * @client: counters per device type (enum ipacm_per_client_device_type) and
+ *          client index
+ */
+struct rmnet_ipa_stats_snap {
+	__u32 magic;
+	__u32 version;
+	__u32 seq;
+	__u32 interval_ms;
+	__u64 update_ns;
+	__u32 num_pipes;
+	__u32 reserved;
+	struct rmnet_ipa_snap_pipe pipe[RMNET_IPA_SNAP_MAX_PIPES];
+	struct rmnet_ipa_snap_client
+		client[RMNET_IPA_SNAP_MAX_DEVICES][RMNET_IPA_SNAP_MAX_CLIENTS];
+};
+
+#endif /* _RMNET_IPA_STATS_SNAP_H_ */
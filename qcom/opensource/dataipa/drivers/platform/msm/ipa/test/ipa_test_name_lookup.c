@@ -0,0 +1,193 @@
+// SPDX-License-Identifier: GPL-2.0-only
+
+#include <linux/ktime.h>
+#include "ipa_ut_framework.h"
+#include "ipa_i.h"
+
+#define IPA_TEST_NAME_LOOKUP_CLIENTS 256
+#define IPA_TEST_NAME_LOOKUP_RT_TBLS 4
+
+/**
+ * Bulk setup as done by IPACM when many clients are tethered: for each
+ * client add a header, look it up by name, add a routing rule using it to
+ * a table given by name and query the table index. Nothing is committed to
+ * HW, so only the SW cost of the setup is measured.
+ */
+struct ipa_test_name_lookup_ctx {
+	u32 hdr_hdl[IPA_TEST_NAME_LOOKUP_CLIENTS];
+	u32 rt_rule_hdl[IPA_TEST_NAME_LOOKUP_CLIENTS];
+	int num_hdrs;
+	int num_rules;
+};
+
+static struct ipa_test_name_lookup_ctx *ctx;
+
+static int ipa_test_name_lookup_suite_setup(void **ppriv)
+{
+	IPA_UT_DBG("Start Setup\n");
+
+	ctx = kzalloc(sizeof(*ctx), GFP_KERNEL);
+	if (!ctx)
+		return -ENOMEM;
+	*ppriv = ctx;
+
+	return 0;
+}
+
+static int ipa_test_name_lookup_suite_teardown(void *priv)
+{
+	IPA_UT_DBG("Start Teardown\n");
+
+	kfree(ctx);
+	ctx = NULL;
+
+	return 0;
+}
+
+static int ipa_test_name_lookup_add_client(int i)
+{
+	struct ipa_ioc_add_hdr *hdrs;
+	struct ipa_ioc_add_rt_rule *rules;
+	struct ipa_ioc_get_hdr get_hdr;
+	struct ipa_ioc_get_rt_tbl_indx rt_idx;
+	int res = -ENOMEM;
+
+	hdrs = kzalloc(sizeof(*hdrs) + sizeof(hdrs->hdr[0]), GFP_KERNEL);
+	rules = kzalloc(sizeof(*rules) + sizeof(rules->rules[0]), GFP_KERNEL);
+	if (!hdrs || !rules)
+		goto free;
+
+	hdrs->commit = 0;
+	hdrs->num_hdrs = 1;
+	snprintf(hdrs->hdr[0].name, IPA_RESOURCE_NAME_MAX, "ut_lookup_hdr%d",
+		i);
+	hdrs->hdr[0].hdr_len = ETH_HLEN;
+	hdrs->hdr[0].is_partial = 1;
+	hdrs->hdr[0].type = IPA_HDR_L2_ETHERNET_II;
+	res = ipa3_add_hdr(hdrs);
+	if (res || hdrs->hdr[0].status) {
+		IPA_UT_ERR("fail to add hdr %d\n", i);
+		res = -EFAULT;
+		goto free;
+	}
+	ctx->hdr_hdl[ctx->num_hdrs++] = hdrs->hdr[0].hdr_hdl;
+
+	memset(&get_hdr, 0, sizeof(get_hdr));
+	strscpy(get_hdr.name, hdrs->hdr[0].name, IPA_RESOURCE_NAME_MAX);
+	res = ipa3_get_hdr(&get_hdr);
+	if (res || get_hdr.hdl != hdrs->hdr[0].hdr_hdl) {
+		IPA_UT_ERR("fail to find hdr %d\n", i);
+		res = -EFAULT;
+		goto free;
+	}
+
+	rules->commit = 0;
+	rules->ip = IPA_IP_v4;
+	rules->num_rules = 1;
+	snprintf(rules->rt_tbl_name, IPA_RESOURCE_NAME_MAX, "ut_lookup_rt%d",
+		i % IPA_TEST_NAME_LOOKUP_RT_TBLS);
+	rules->rules[0].rule.dst = IPA_CLIENT_APPS_LAN_CONS;
+	rules->rules[0].rule.hdr_hdl = get_hdr.hdl;
+	rules->rules[0].rule.attrib.attrib_mask = IPA_FLT_DST_ADDR;
+	rules->rules[0].rule.attrib.u.v4.dst_addr = 0xC0A80000 + i;
+	rules->rules[0].rule.attrib.u.v4.dst_addr_mask = 0xFFFFFFFF;
+	res = ipa3_add_rt_rule(rules);
+	if (res || rules->rules[0].status) {
+		IPA_UT_ERR("fail to add rt rule %d\n", i);
+		res = -EFAULT;
+		goto free;
+	}
+	ctx->rt_rule_hdl[ctx->num_rules++] = rules->rules[0].rt_rule_hdl;
+
+	memset(&rt_idx, 0, sizeof(rt_idx));
+	rt_idx.ip = IPA_IP_v4;
+	strscpy(rt_idx.name, rules->rt_tbl_name, IPA_RESOURCE_NAME_MAX);
+	res = ipa3_query_rt_index(&rt_idx);
+	if (res)
+		IPA_UT_ERR("fail to query rt tbl %s\n", rt_idx.name);
+
+free:
+	kfree(rules);
+	kfree(hdrs);
+	return res;
+}
+
+static void ipa_test_name_lookup_clean(void)
+{
+	struct ipa_ioc_del_rt_rule *del_rule;
+	struct ipa_ioc_del_hdr *del_hdr;
+
+	del_rule = kzalloc(sizeof(*del_rule) + sizeof(del_rule->hdl[0]),
+		GFP_KERNEL);
+	del_hdr = kzalloc(sizeof(*del_hdr) + sizeof(del_hdr->hdl[0]),
+		GFP_KERNEL);
+	if (!del_rule || !del_hdr)
+		goto free;
+
+	/* the rules hold references to the headers, they go first */
+	del_rule->ip = IPA_IP_v4;
+	del_rule->num_hdls = 1;
+	while (ctx->num_rules) {
+		del_rule->hdl[0].hdl = ctx->rt_rule_hdl[--ctx->num_rules];
+		if (ipa3_del_rt_rule(del_rule) || del_rule->hdl[0].status)
+			IPA_UT_ERR("fail to del rt rule 0x%x\n",
+				del_rule->hdl[0].hdl);
+	}
+
+	del_hdr->num_hdls = 1;
+	while (ctx->num_hdrs) {
+		del_hdr->hdl[0].hdl = ctx->hdr_hdl[--ctx->num_hdrs];
+		if (ipa3_del_hdr(del_hdr) || del_hdr->hdl[0].status)
+			IPA_UT_ERR("fail to del hdr 0x%x\n",
+				del_hdr->hdl[0].hdl);
+	}
+
+free:
+	kfree(del_hdr);
+	kfree(del_rule);
+}
+
+static int ipa_test_name_lookup_bulk_setup(void *priv)
+{
+	u64 total_ns = 0;
+	u64 bucket_ns = 0;
+	ktime_t start;
+	int res = 0;
+	int i;
+
+	for (i = 0; i < IPA_TEST_NAME_LOOKUP_CLIENTS; i++) {
+		start = ktime_get();
+		res = ipa_test_name_lookup_add_client(i);
+		bucket_ns += ktime_to_ns(ktime_sub(ktime_get(), start));
+		if (res) {
+			IPA_UT_TEST_FAIL_REPORT("fail to add client");
+			break;
+		}
+
+		if ((i + 1) % 64 == 0) {
+			IPA_UT_LOG("clients %d-%d: %llu ns per client\n",
+				i - 62, i + 1, bucket_ns / 64);
+			total_ns += bucket_ns;
+			bucket_ns = 0;
+		}
+	}
+
+	if (!res)
+		IPA_UT_LOG("%d clients set up in %llu us\n",
+			IPA_TEST_NAME_LOOKUP_CLIENTS, total_ns / NSEC_PER_USEC);
+
+	ipa_test_name_lookup_clean();
+
+	return res;
+}
+
+/* Suite definition block */
+IPA_UT_DEFINE_SUITE_START(name_lookup, "Name lookup of headers and rt tables",
+	ipa_test_name_lookup_suite_setup, ipa_test_name_lookup_suite_teardown)
+{
+	IPA_UT_ADD_TEST(bulk_setup,
+		"Time adding headers and rt rules for many clients",
+		ipa_test_name_lookup_bulk_setup, false, IPA_HW_v3_0,
+		IPA_HW_MAX),
+
+} IPA_UT_DEFINE_SUITE_END(name_lookup);
@@ -133,6 +133,40 @@ int ipa_ipv6ct_del_rule(uint32_t table_handle, uint32_t rule_handle);
  */
 int ipa_ipv6ct_query_timestamp(uint32_t table_handle, uint32_t rule_handle, uint32_t* time_stamp);
 
+/**
+ * struct ipa_ipv6ct_rule_tstamp - rule handle and timestamp pair
+ * @rule_hdl: IPv6CT rule handle
+ * @time_stamp: time stamp of rule
+ */
+typedef struct {
+	uint32_t rule_hdl;
+	uint32_t time_stamp;
+} ipa_ipv6ct_rule_tstamp;
+
+/* Rule time stamps are 24 bits wide and wrap */
+#define IPA_IPV6CT_TSTAMP_MASK 0xFFFFFF
+
+/**
+ * ipa_ipv6ct_query_timestamps() - to query the timestamps of all rules
+ * @table_handle: [in] handle of IPv6CT table
+ * @now: [in] current time stamp, used with @min_idle
+ * @min_idle: [in] only report rules not accessed in at least this many
+ *            time stamp units before @now; zero reports all rules
+ * @entries: [out] rule handles and their time stamps
+ * @max_entries: [in] number of elements in @entries
+ * @num_entries: [out] number of elements of @entries filled in
+ *
+ * To retrieve, under one lock and in one pass over the table, the
+ * timestamps of the rules that would otherwise need one
+ * ipa_ipv6ct_query_timestamp() call each
+ *
+ * Returns:	0  On Success, -ENOSPC if more rules matched than
+ *          max_entries (the first max_entries are returned),
+ *          negative on other failure
+ */
+int ipa_ipv6ct_query_timestamps(uint32_t table_handle, uint32_t now, uint32_t min_idle,
+	ipa_ipv6ct_rule_tstamp* entries, uint32_t max_entries, uint32_t* num_entries);
+
 /**
  * ipa_ipv6ct_dump_table() - dumps IPv6CT table
  * @table_handle: [in] handle of IPv6CT table
@@ -184,6 +184,45 @@ int ipa_nat_query_timestamp(uint32_t  table_handle,
 				uint32_t  rule_handle,
 				uint32_t  *time_stamp);
 
+/**
+ * struct ipa_nat_rule_tstamp - rule handle and timestamp pair
+ * @rule_hdl: ipv4 nat rule handle
+ * @time_stamp: time stamp of rule
+ */
+typedef struct {
+	uint32_t rule_hdl;
+	uint32_t time_stamp;
+} ipa_nat_rule_tstamp;
+
+/* Rule time stamps are 24 bits wide and wrap */
+#define IPA_NAT_TSTAMP_MASK 0xFFFFFF
+
+/**
+ * ipa_nat_query_timestamps() - to query the timestamps of all rules
+ * @table_handle: [in] handle of ipv4 nat table
+ * @now: [in] current time stamp, used with @min_idle
+ * @min_idle: [in] only report rules not accessed in at least this
+ *            many time stamp units before @now; zero reports all rules
+ * @entries: [out] rule handles and their time stamps
+ * @max_entries: [in] number of elements in @entries
+ * @num_entries: [out] number of elements of @entries filled in
+ *
+ * To retrieve, under one lock and in one pass over the table, the
+ * timestamps of the rules that would otherwise need one
+ * ipa_nat_query_timestamp() call each. The handles returned are
+ * those given out by ipa_nat_add_ipv4_rule(), whichever memory the
+ * rules currently live in.
+ *
+ * Returns:	0  On Success, -ENOSPC if more rules matched than
+ *          @max_entries (the first @max_entries are returned),
+ *          negative on other failure
+ */
+int ipa_nat_query_timestamps(uint32_t table_handle,
+				uint32_t  now,
+				uint32_t  min_idle,
+				ipa_nat_rule_tstamp *entries,
+				uint32_t  max_entries,
+				uint32_t  *num_entries);
 
 /**
  * ipa_nat_modify_pdn() - modify single PDN entry in the PDN config table
@@ -267,5 +306,25 @@ int ipa_nat_switch_to(
 	enum ipa3_nat_mem_in nmi,
 	bool                 hold_state );
 
+/**
+ * ipa_nat_set_migration_step() - While in HYBRID mode only, sets how
+ * many rules a table switch copies at a time.  The rest are copied by
+ * later rule adds and deletes, or by ipa_nat_migrate_step(). The IPA
+ * keeps using the old table until the copy completes.
+ * @rules_per_step: rules per step, or 0 to copy the whole table at
+ *                  once (the default)
+ */
+int ipa_nat_set_migration_step(
+	uint32_t rules_per_step );
+
+/**
+ * ipa_nat_migrate_step() - Runs one step of an in progress table
+ * switch, if any.
+ *
+ * Returns:	1 if a switch is still in progress, 0 if none is,
+ *		negative on failure
+ */
+int ipa_nat_migrate_step(void);
+
 #endif
 
@@ -291,6 +291,13 @@ int ipa_nati_query_timestamp(uint32_t  tbl_hdl,
 				uint32_t  rule_hdl,
 				uint32_t  *time_stamp);
 
+int ipa_nati_query_timestamps(uint32_t  tbl_hdl,
+				uint32_t  now,
+				uint32_t  min_idle,
+				ipa_nat_rule_tstamp *entries,
+				uint32_t  max_entries,
+				uint32_t  *num_entries);
+
 int ipa_nati_modify_pdn(struct ipa_ioc_nat_pdn_entry *entry);
 
 int ipa_nati_get_pdn_index(uint32_t public_ip, uint8_t *pdn_index);
@@ -379,6 +386,26 @@ int ipa_NATI_walk_ipv4_tbl(
 	ipa_table_walk_cb walk_cb,
 	void*             arb_data_ptr );
 
+/*
+ * As above, but starting at record start_index.  A walk_cb returning
+ * a positive value stops the walk early without it being an error.
+ */
+int ipa_NATI_walk_ipv4_tbl_from(
+	uint32_t          tbl_hdl,
+	WhichTbl2Use      which,
+	uint32_t          start_index,
+	ipa_table_walk_cb walk_cb,
+	void*             arb_data_ptr );
+
+/*
+ * Calls walk_cb on the one NAT table record rule_hdl refers to.
+ */
+int ipa_NATI_walk_ipv4_rule(
+	uint32_t          tbl_hdl,
+	uint32_t          rule_hdl,
+	ipa_table_walk_cb walk_cb,
+	void*             arb_data_ptr );
+
 int ipa_NATI_ipv4_tbl_stats(
 	uint32_t            tbl_hdl,
 	ipa_nati_tbl_stats* nat_stats_ptr,
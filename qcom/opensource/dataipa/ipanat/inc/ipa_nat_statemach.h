@@ -90,18 +90,19 @@ static inline ipa_nati_state mem_type_str_to_ipa_nati_state(
  * states defined in ipa_nati_state above.
  */
 typedef enum {
-	NATI_TRIG_NULL       =  0,
-	NATI_TRIG_ADD_TABLE  =  1,
-	NATI_TRIG_DEL_TABLE  =  2,
-	NATI_TRIG_CLR_TABLE  =  3,
-	NATI_TRIG_WLK_TABLE  =  4,
-	NATI_TRIG_TBL_STATS  =  5,
-	NATI_TRIG_ADD_RULE   =  6,
-	NATI_TRIG_DEL_RULE   =  7,
-	NATI_TRIG_TBL_SWITCH =  8,
-	NATI_TRIG_GOTO_DDR   =  9,
-	NATI_TRIG_GOTO_SRAM  = 10,
-	NATI_TRIG_GET_TSTAMP = 11,
+	NATI_TRIG_NULL        =  0,
+	NATI_TRIG_ADD_TABLE   =  1,
+	NATI_TRIG_DEL_TABLE   =  2,
+	NATI_TRIG_CLR_TABLE   =  3,
+	NATI_TRIG_WLK_TABLE   =  4,
+	NATI_TRIG_TBL_STATS   =  5,
+	NATI_TRIG_ADD_RULE    =  6,
+	NATI_TRIG_DEL_RULE    =  7,
+	NATI_TRIG_TBL_SWITCH  =  8,
+	NATI_TRIG_GOTO_DDR    =  9,
+	NATI_TRIG_GOTO_SRAM   = 10,
+	NATI_TRIG_GET_TSTAMP  = 11,
+	NATI_TRIG_GET_TSTAMPS = 12,
 
 	NATI_TRIG_LAST
 } ipa_nati_trigger;
@@ -114,8 +115,36 @@ typedef struct
 {
 	uint32_t pass;
 	uint32_t fail;
+	/*
+	 * Per step cost of incremental migration out of this memory
+	 * type, in nanoseconds...
+	 */
+	uint32_t steps;
+	uint64_t last_step_ns;
+	uint64_t max_step_ns;
+	uint64_t tot_step_ns;
 } nati_switch_stats;
 
+/******************************************************************************/
+/**
+ * The following structure used to track an in progress table switch.
+ *
+ * A switch copies the rules of the source table to the destination
+ * table a few at a time.  Records below next_index have been copied.
+ * The IPA keeps using the source table until the copy is done.
+ */
+typedef struct
+{
+	bool     active;
+	uint32_t src_sub;
+	uint32_t dst_sub;
+	uint32_t src_tbl_hdl;
+	uint32_t dst_tbl_hdl;
+	uint32_t next_index;
+	uint32_t budget;
+	uint64_t start;
+} nati_migration;
+
 /******************************************************************************/
 /**
  * The following structure used to direct map usage.
@@ -159,6 +188,11 @@ typedef struct
 	 * sw_stats[1] for sram
 	 */
 	nati_switch_stats sw_stats[2];
+	/*
+	 * Rules copied per migration step, zero meaning all of them...
+	 */
+	uint32_t       mig_rules_per_step;
+	nati_migration mig;
 } ipa_nati_obj;
 
 /*
@@ -218,6 +252,9 @@ typedef struct
  *   accesses, hence would lead to too many successive votes. Instead,
  *   it will be handled differently and in the app layer above.
  *
+ *   Bulk timestamp retrieval (NATI_TRIG_GET_TSTAMPS) is voted for,
+ *   since it covers a whole table in one call.
+ *
  *  In re table creation:
  *
  *    Because it can't be known, apriori, whether or not sram is
@@ -230,6 +267,18 @@ typedef struct
 	  (t) != NATI_TRIG_GET_TSTAMP && \
 	  (t) != NATI_TRIG_ADD_TABLE )
 
+/******************************************************************************/
+/**
+ * Triggers whose callback errors ipa_nati_statemach() passes on.  An
+ * add that found no room, or a table switch that failed, must not look
+ * like a success to the caller...
+ */
+#undef  KEEP_CB_ERR
+#define KEEP_CB_ERR(t) \
+	( (t) == NATI_TRIG_ADD_RULE   || \
+	  (t) == NATI_TRIG_TBL_SWITCH || \
+	  (t) == NATI_TRIG_GET_TSTAMPS )
+
 /******************************************************************************/
 /**
  * A helper macro for changing a nati object's state...
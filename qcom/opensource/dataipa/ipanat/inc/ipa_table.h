@@ -152,6 +152,25 @@ typedef struct
 	uint8_t            table_indx;
 } ipa_table_dma_cmd_helper;
 
+/*
+ * Free slot map for an expansion table. Bit n of map[] is set when
+ * expansion slot n is free. Bit n of sum[] is set when map[n] has any
+ * free slot, so the lowest free slot is found with two bit scans
+ * regardless of how full the table is.
+ */
+#define IPA_TABLE_FREE_MAP_BITS  64
+#define IPA_TABLE_FREE_MAP_WORDS \
+	( (IPA_TABLE_MAX_ENTRIES + IPA_TABLE_FREE_MAP_BITS - 1) / IPA_TABLE_FREE_MAP_BITS )
+#define IPA_TABLE_FREE_SUM_WORDS \
+	( (IPA_TABLE_FREE_MAP_WORDS + IPA_TABLE_FREE_MAP_BITS - 1) / IPA_TABLE_FREE_MAP_BITS )
+
+typedef struct
+{
+	uint64_t map[IPA_TABLE_FREE_MAP_WORDS];
+	uint64_t sum[IPA_TABLE_FREE_SUM_WORDS];
+	uint16_t num_free;
+} ipa_table_free_map;
+
 typedef struct
 {
 	char                       name[IPA_RESOURCE_NAME_MAX];
@@ -176,6 +195,8 @@ typedef struct
 
 	void*                      meta;
 	int                        meta_entry_size;
+
+	ipa_table_free_map         expn_free;
 } ipa_table;
 
 typedef struct
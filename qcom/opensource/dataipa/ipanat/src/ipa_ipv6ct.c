@@ -478,6 +478,107 @@ unlock:
 	return ret;
 }
 
+typedef struct
+{
+	ipa_ipv6ct_rule_tstamp* entries;
+	uint32_t max_entries;
+	uint32_t num_entries;
+	uint32_t now;
+	uint32_t min_idle;
+} ipa_ipv6ct_tstamp_helper;
+
+static int gather_tstamps(ipa_table* table, uint32_t rule_hdl, void* record, uint16_t record_index,
+	void* meta_record, uint16_t meta_record_index, void* arb_data)
+{
+	ipa_ipv6ct_tstamp_helper* helper = (ipa_ipv6ct_tstamp_helper*)arb_data;
+	ipa_ipv6ct_hw_entry* entry = (ipa_ipv6ct_hw_entry*)record;
+	uint32_t time_stamp;
+
+	/* A deleted list head is still enabled, but is not a rule */
+	if (entry->protocol == IPA_IPV6CT_INVALID_PROTO_FIELD_CMP)
+		return 0;
+
+	time_stamp = entry->time_stamp;
+
+	if (helper->min_idle &&
+		((helper->now - time_stamp) & IPA_IPV6CT_TSTAMP_MASK) < helper->min_idle)
+		return 0;
+
+	/* Out of room; a positive return stops the walk */
+	if (helper->num_entries >= helper->max_entries)
+		return 1;
+
+	helper->entries[helper->num_entries].rule_hdl = rule_hdl;
+	helper->entries[helper->num_entries].time_stamp = time_stamp;
+	helper->num_entries++;
+
+	return 0;
+}
+
+int ipa_ipv6ct_query_timestamps(uint32_t table_handle, uint32_t now, uint32_t min_idle,
+	ipa_ipv6ct_rule_tstamp* entries, uint32_t max_entries, uint32_t* num_entries)
+{
+	int ret;
+	ipa_ipv6ct_table* ipv6ct_table;
+	ipa_ipv6ct_tstamp_helper helper =
+	{
+		entries, max_entries, 0, now, min_idle
+	};
+
+	IPADBG("\n");
+
+	if (ipv6ct.ipa_desc->ver < IPA_HW_v4_0)
+	{
+		IPAERR("IPv6 connection tracking isn't supported for IPA version %d\n", ipv6ct.ipa_desc->ver);
+		return -EINVAL;
+	}
+
+	if (table_handle == IPA_TABLE_INVALID_ENTRY || table_handle > IPA_IPV6CT_MAX_TBLS ||
+		entries == NULL || num_entries == NULL)
+	{
+		IPAERR("invalid parameters passed table_handle=%d entries=%pK num_entries=%pK\n",
+			table_handle, entries, num_entries);
+		return -EINVAL;
+	}
+	IPADBG("Passed Table: %d now 0x%06X min_idle %u max_entries %u\n",
+		table_handle, now, min_idle, max_entries);
+
+	*num_entries = 0;
+
+	if (pthread_mutex_lock(&ipv6ct_mutex))
+	{
+		IPAERR("unable to lock the ipv6ct mutex\n");
+		return -EINVAL;
+	}
+
+	ipv6ct_table = &ipv6ct.tables[table_handle - 1];
+	if (!ipv6ct_table->mem_desc.valid)
+	{
+		IPAERR("invalid table handle %d\n", table_handle);
+		ret = -EINVAL;
+		goto unlock;
+	}
+
+	ret = ipa_table_walk(&ipv6ct_table->table, 0, WHEN_SLOT_FILLED, gather_tstamps, &helper);
+	if (ret > 0)
+	{
+		IPADBG("entries array full at %u entries\n", max_entries);
+		ret = -ENOSPC;
+	}
+
+	*num_entries = helper.num_entries;
+
+unlock:
+	if (pthread_mutex_unlock(&ipv6ct_mutex))
+	{
+		IPAERR("unable to unlock the ipv6ct mutex\n");
+		return (ret) ? ret : -EPERM;
+	}
+
+	IPADBG("return\n");
+	return ret;
+}
+
 /**
 * ipv6ct_hash() - Find the index into ipv6ct table
 * @rule: [in] an IPv6CT rule
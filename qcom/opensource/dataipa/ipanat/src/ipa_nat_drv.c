@@ -199,6 +199,44 @@ int ipa_nat_query_timestamp(
 	return ipa_nati_query_timestamp(tbl_hdl, rule_hdl, time_stamp);
 }
 
+/**
+ * ipa_nat_query_timestamps() - to query the timestamps of all rules
+ * @table_handle: [in] handle of ipv4 nat table
+ * @now: [in] current time stamp, used with @min_idle
+ * @min_idle: [in] only report rules idle at least this long; zero
+ *            reports all rules
+ * @entries: [out] rule handles and their time stamps
+ * @max_entries: [in] number of elements in @entries
+ * @num_entries: [out] number of elements of @entries filled in
+ *
+ * To retrieve the timestamps of many rules in one table walk
+ *
+ * Returns:	0  On Success, negative on failure
+ */
+int ipa_nat_query_timestamps(
+	uint32_t tbl_hdl,
+	uint32_t now,
+	uint32_t min_idle,
+	ipa_nat_rule_tstamp *entries,
+	uint32_t max_entries,
+	uint32_t *num_entries)
+{
+	if ( ! VALID_TBL_HDL(tbl_hdl) ||
+		 entries == NULL ||
+		 num_entries == NULL )
+	{
+		IPAERR("Invalid parameters passed tbl_hdl=0x%x entries=%pK num_entries=%pK\n",
+			   tbl_hdl, entries, num_entries);
+		return -EINVAL;
+	}
+
+	IPADBG("Passed Table 0x%x now(0x%06X) min_idle(%u) max_entries(%u)\n",
+		   tbl_hdl, now, min_idle, max_entries);
+
+	return ipa_nati_query_timestamps(
+		tbl_hdl, now, min_idle, entries, max_entries, num_entries);
+}
+
 /**
 * ipa_nat_modify_pdn() - modify single PDN entry in the PDN config table
 * @table_handle: [in] handle of ipv4 nat table
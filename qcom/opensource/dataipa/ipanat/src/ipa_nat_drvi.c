@@ -2334,6 +2334,17 @@ int ipa_NATI_walk_ipv4_tbl(
 	WhichTbl2Use      which,
 	ipa_table_walk_cb walk_cb,
 	void*             arb_data_ptr )
+{
+	return ipa_NATI_walk_ipv4_tbl_from(
+		tbl_hdl, which, 0, walk_cb, arb_data_ptr);
+}
+
+int ipa_NATI_walk_ipv4_tbl_from(
+	uint32_t          tbl_hdl,
+	WhichTbl2Use      which,
+	uint32_t          start_index,
+	ipa_table_walk_cb walk_cb,
+	void*             arb_data_ptr )
 {
 	enum ipa3_nat_mem_in            nmi;
 	uint32_t                        broken_tbl_hdl;
@@ -2391,11 +2402,22 @@ int ipa_NATI_walk_ipv4_tbl(
 		&nat_table->table     :
 		&nat_table->index_table;
 
-	ret = ipa_table_walk(ipa_tbl_ptr, 0, WHEN_SLOT_FILLED, walk_cb, arb_data_ptr);
+	/*
+	 * Nothing left to walk...
+	 */
+	if ( start_index >= ipa_tbl_ptr->tot_tbl_ents )
+	{
+		goto unlock;
+	}
+
+	ret = ipa_table_walk(ipa_tbl_ptr, start_index, WHEN_SLOT_FILLED, walk_cb, arb_data_ptr);
 
 	if ( ret != 0 )
 	{
-		IPAERR("ipa_table_walk returned non-zero (%d)\n", ret);
+		if ( ret < 0 )
+		{
+			IPAERR("ipa_table_walk returned non-zero (%d)\n", ret);
+		}
 		goto unlock;
 	}
 
@@ -2412,6 +2434,107 @@ bail:
 	return ret;
 }
 
+int ipa_NATI_walk_ipv4_rule(
+	uint32_t          tbl_hdl,
+	uint32_t          rule_hdl,
+	ipa_table_walk_cb walk_cb,
+	void*             arb_data_ptr )
+{
+	enum ipa3_nat_mem_in            nmi;
+	uint32_t                        broken_tbl_hdl;
+	struct ipa_nat_cache*           nat_cache_ptr;
+	struct ipa_nat_ip4_table_cache* nat_table;
+	ipa_table*                      ipa_tbl_ptr;
+	void*                           record_ptr;
+	void*                           meta_record_ptr = NULL;
+	uint16_t                        meta_record_index = 0;
+	uint16_t                        record_index;
+
+	int ret = 0;
+
+	IPADBG("In\n");
+
+	if ( ! VALID_TBL_HDL(tbl_hdl) || ! walk_cb )
+	{
+		IPAERR("Bad arg: tbl_hdl(0x%08X) and/or walk_cb(%p)\n",
+			   tbl_hdl, walk_cb);
+		ret = -EINVAL;
+		goto bail;
+	}
+
+	if ( pthread_mutex_lock(&nat_mutex) )
+	{
+		IPAERR("unable to lock the nat mutex\n");
+		ret = -EINVAL;
+		goto bail;
+	}
+
+	BREAK_TBL_HDL(tbl_hdl, nmi, broken_tbl_hdl);
+
+	if ( ! IPA_VALID_NAT_MEM_IN(nmi) )
+	{
+		IPAERR("Bad cache type argument passed\n");
+		ret = -EINVAL;
+		goto unlock;
+	}
+
+	nat_cache_ptr = &ipv4_nat_cache[nmi];
+
+	nat_table = &nat_cache_ptr->ip4_tbl[broken_tbl_hdl - 1];
+
+	if ( ! nat_table->mem_desc.valid )
+	{
+		IPAERR("invalid table handle 0x%08X\n", tbl_hdl);
+		ret = -EINVAL;
+		goto unlock;
+	}
+
+	ipa_tbl_ptr = &nat_table->table;
+
+	ret = ipa_table_get_entry(
+		ipa_tbl_ptr, rule_hdl, &record_ptr, &record_index);
+
+	if ( ret != 0 )
+	{
+		IPAERR("Unable to retrive the entry with handle=%u "
+			   "in NAT table with handle=0x%08X\n",
+			   rule_hdl, tbl_hdl);
+		goto unlock;
+	}
+
+	if ( record_index >= ipa_tbl_ptr->table_entries && ipa_tbl_ptr->meta )
+	{
+		meta_record_index = record_index - ipa_tbl_ptr->table_entries;
+
+		meta_record_ptr = (uint8_t*) ipa_tbl_ptr->meta +
+			(meta_record_index * ipa_tbl_ptr->meta_entry_size);
+	}
+
+	/*
+	 * Hand the one record to the callback, as ipa_table_walk() would...
+	 */
+	ret = walk_cb(
+		ipa_tbl_ptr,
+		rule_hdl,
+		record_ptr,
+		record_index,
+		meta_record_ptr,
+		meta_record_index,
+		arb_data_ptr);
+
+unlock:
+	if ( pthread_mutex_unlock(&nat_mutex) )
+	{
+		IPAERR("unable to unlock the nat mutex\n");
+		ret = (ret) ? ret : -EPERM;
+	}
+
+bail:
+	IPADBG("Out\n");
+
+	return ret;
+}
+
 typedef struct
 {
 	WhichTbl2Use        which;
@@ -26,14 +26,223 @@
  * OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN
  * IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
  */
-#include <map>
-#include <iterator>
+#include <new>
 
 #include "ipa_nat_utils.h"
 
 #include "ipa_nat_map.h"
 
-static std::map<uint32_t, uint32_t> map_array[MAP_NUM_MAX];
+/*
+ * Each map is an open addressed hash table using linear probing.  The
+ * slot array is allocated up front by ipa_nat_map_reserve(), sized
+ * from the number of entries in the NAT table the map shadows, so
+ * that adds and deletes do no allocation.  Should a map outgrow its
+ * reservation, it is doubled.
+ *
+ * Deletes shift later members of the probe sequence back, rather
+ * than leaving tombstones, so lookups never slow down under rule
+ * churn.
+ */
+typedef struct
+{
+	uint32_t key;
+	uint32_t val;
+	uint32_t used;
+} map_slot;
+
+typedef struct
+{
+	map_slot* slots;
+	uint32_t  num_slots;
+	uint32_t  mask;
+	uint32_t  cnt;
+} map_tbl;
+
+#define MAP_MIN_SLOTS   64
+#define MAP_MAX_ENTRIES (1U << 30)
+
+static map_tbl map_array[MAP_NUM_MAX];
+
+static inline uint32_t map_hash(
+	const map_tbl* mt,
+	uint32_t       key )
+{
+	/*
+	 * Rule handles are close to sequential, so spread them with a
+	 * multiplicative hash before masking.
+	 */
+	return (key * 0x9E3779B1U) & mt->mask;
+}
+
+static inline map_slot* map_lookup(
+	map_tbl* mt,
+	uint32_t key )
+{
+	uint32_t i;
+
+	if ( ! mt->slots )
+	{
+		return NULL;
+	}
+
+	for ( i = map_hash(mt, key); mt->slots[i].used; i = (i + 1) & mt->mask )
+	{
+		if ( mt->slots[i].key == key )
+		{
+			return &mt->slots[i];
+		}
+	}
+
+	return NULL;
+}
+
+static void map_insert(
+	map_tbl* mt,
+	uint32_t key,
+	uint32_t val )
+{
+	uint32_t i = map_hash(mt, key);
+
+	while ( mt->slots[i].used )
+	{
+		i = (i + 1) & mt->mask;
+	}
+
+	mt->slots[i].key  = key;
+	mt->slots[i].val  = val;
+	mt->slots[i].used = 1;
+
+	mt->cnt++;
+}
+
+static void map_erase(
+	map_tbl*  mt,
+	map_slot* slot )
+{
+	uint32_t i = slot - &mt->slots[0];
+	uint32_t j = i;
+	uint32_t home;
+
+	/*
+	 * Close the hole at i by moving back any later entry whose probe
+	 * sequence passes through it.
+	 */
+	for ( ;; )
+	{
+		j = (j + 1) & mt->mask;
+
+		if ( ! mt->slots[j].used )
+		{
+			break;
+		}
+
+		home = map_hash(mt, mt->slots[j].key);
+
+		if ( ((j - home) & mt->mask) >= ((j - i) & mt->mask) )
+		{
+			mt->slots[i] = mt->slots[j];
+			i = j;
+		}
+	}
+
+	mt->slots[i].used = 0;
+
+	mt->cnt--;
+}
+
+/*
+ * Make the map at least big enough for num_entries at a load factor
+ * of one half.  Existing entries are kept.
+ */
+static int map_resize(
+	map_tbl* mt,
+	uint32_t num_entries )
+{
+	map_slot* old_slots;
+	uint32_t  old_num_slots;
+	uint32_t  num_slots = MAP_MIN_SLOTS;
+	uint32_t  i;
+
+	if ( num_entries > MAP_MAX_ENTRIES )
+	{
+		return -1;
+	}
+
+	while ( num_slots < num_entries * 2 )
+	{
+		num_slots <<= 1;
+	}
+
+	if ( num_slots <= mt->num_slots )
+	{
+		return 0;
+	}
+
+	/*
+	 * The library is built without exceptions, so allocate with
+	 * nothrow and keep the old slots on failure.
+	 */
+	old_slots     = mt->slots;
+	old_num_slots = mt->num_slots;
+
+	mt->slots = new (std::nothrow) map_slot[num_slots]();
+
+	if ( ! mt->slots )
+	{
+		mt->slots = old_slots;
+		return -1;
+	}
+
+	mt->num_slots = num_slots;
+	mt->mask      = num_slots - 1;
+	mt->cnt       = 0;
+
+	for ( i = 0; i < old_num_slots; i++ )
+	{
+		if ( old_slots[i].used )
+		{
+			map_insert(mt, old_slots[i].key, old_slots[i].val);
+		}
+	}
+
+	delete[] old_slots;
+
+	return 0;
+}
+
+/******************************************************************************/
+
+int ipa_nat_map_reserve(
+	ipa_which_map which,
+	uint32_t      num_entries )
+{
+	int ret_val = 0;
+
+	IPADBG("In\n");
+
+	if ( ! VALID_IPA_USE_MAP(which) )
+	{
+		IPAERR("Bad arg which(%u)\n", which);
+		ret_val = -1;
+		goto bail;
+	}
+
+	IPADBG("[%s] num_entries(%u)\n",
+		   ipa_which_map_as_str(which), num_entries);
+
+	if ( map_resize(&map_array[which], num_entries) )
+	{
+		IPAERR("[%s] Unable to reserve %u entries\n",
+			   ipa_which_map_as_str(which),
+			   num_entries);
+		ret_val = -1;
+	}
+
+bail:
+	IPADBG("Out\n");
+
+	return ret_val;
+}
 
 /******************************************************************************/
 
@@ -42,9 +251,9 @@ int ipa_nat_map_add(
 	uint32_t      key,
 	uint32_t      val )
 {
-	int ret_val = 0;
+	map_tbl* mt;
 
-	std::pair<std::map<uint32_t, uint32_t>::iterator, bool> ret;
+	int ret_val = 0;
 
 	IPADBG("In\n");
 
@@ -58,16 +267,28 @@ int ipa_nat_map_add(
 	IPADBG("[%s] key(%u) -> val(%u)\n",
 		   ipa_which_map_as_str(which), key, val);
 
-	ret = map_array[which].insert(std::pair<uint32_t, uint32_t>(key, val));
+	mt = &map_array[which];
 
-	if ( ret.second == false )
+	if ( map_lookup(mt, key) )
 	{
 		IPAERR("[%s] key(%u) already exists in map\n",
 			   ipa_which_map_as_str(which),
 			   key);
 		ret_val = -1;
+		goto bail;
+	}
+
+	if ( map_resize(mt, mt->cnt + 1) )
+	{
+		IPAERR("[%s] Unable to grow map past %u entries\n",
+			   ipa_which_map_as_str(which),
+			   mt->cnt);
+		ret_val = -1;
+		goto bail;
 	}
 
+	map_insert(mt, key, val);
+
 bail:
 	IPADBG("Out\n");
 
@@ -81,9 +302,9 @@ int ipa_nat_map_find(
 	uint32_t      key,
 	uint32_t*     val_ptr )
 {
-	int ret_val = 0;
+	map_slot* slot;
 
-	std::map<uint32_t, uint32_t>::iterator it;
+	int ret_val = 0;
 
 	IPADBG("In\n");
 
@@ -97,9 +318,9 @@ int ipa_nat_map_find(
 	IPADBG("[%s] key(%u)\n",
 		   ipa_which_map_as_str(which), key);
 
-	it = map_array[which].find(key);
+	slot = map_lookup(&map_array[which], key);
 
-	if ( it == map_array[which].end() )
+	if ( ! slot )
 	{
 		IPAERR("[%s] key(%u) not found in map\n",
 			   ipa_which_map_as_str(which),
@@ -110,7 +331,7 @@ int ipa_nat_map_find(
 	{
 		if ( val_ptr )
 		{
-			*val_ptr = it->second;
+			*val_ptr = slot->val;
 			IPADBG("[%s] key(%u) -> val(%u)\n",
 				   ipa_which_map_as_str(which),
 				   key, *val_ptr);
@@ -130,9 +351,9 @@ int ipa_nat_map_del(
 	uint32_t      key,
 	uint32_t*     val_ptr )
 {
-	int ret_val = 0;
+	map_slot* slot;
 
-	std::map<uint32_t, uint32_t>::iterator it;
+	int ret_val = 0;
 
 	IPADBG("In\n");
 
@@ -146,9 +367,9 @@ int ipa_nat_map_del(
 	IPADBG("[%s] key(%u)\n",
 		   ipa_which_map_as_str(which), key);
 
-	it = map_array[which].find(key);
+	slot = map_lookup(&map_array[which], key);
 
-	if ( it == map_array[which].end() )
+	if ( ! slot )
 	{
 		IPAERR("[%s] key(%u) not found in map\n",
 			   ipa_which_map_as_str(which),
@@ -159,12 +380,12 @@ int ipa_nat_map_del(
 	{
 		if ( val_ptr )
 		{
-			*val_ptr = it->second;
+			*val_ptr = slot->val;
 			IPADBG("[%s] key(%u) -> val(%u)\n",
 				   ipa_which_map_as_str(which),
 				   key, *val_ptr);
 		}
-		map_array[which].erase(it);
+		map_erase(&map_array[which], slot);
 	}
 
 bail:
@@ -173,9 +394,15 @@ bail:
 	return ret_val;
 }
 
+/*
+ * Empties the map but keeps its slots, so that a table recreated at
+ * the same size does not reallocate.
+ */
 int ipa_nat_map_clear(
 	ipa_which_map which )
 {
+	map_tbl* mt;
+
 	int ret_val = 0;
 
 	IPADBG("In\n");
@@ -187,7 +414,13 @@ int ipa_nat_map_clear(
 		goto bail;
 	}
 
-	map_array[which].clear();
+	mt = &map_array[which];
+
+	if ( mt->cnt )
+	{
+		memset(mt->slots, 0, mt->num_slots * sizeof(map_slot));
+		mt->cnt = 0;
+	}
 
 bail:
 	IPADBG("Out\n");
@@ -198,7 +431,9 @@ bail:
 int ipa_nat_map_dump(
 	ipa_which_map which )
 {
-	std::map<uint32_t, uint32_t>::iterator it;
+	map_tbl* mt;
+
+	uint32_t i;
 
 	int ret_val = 0;
 
@@ -211,17 +446,25 @@ int ipa_nat_map_dump(
 		goto bail;
 	}
 
-	printf("Dumping: %s\n", ipa_which_map_as_str(which));
+	mt = &map_array[which];
+
+	printf("Dumping: %s entries(%u) slots(%u)\n",
+		   ipa_which_map_as_str(which),
+		   mt->cnt,
+		   mt->num_slots);
 
-	for ( it  = map_array[which].begin();
-		  it != map_array[which].end();
-		  it++ )
+	for ( i = 0; i < mt->num_slots; i++ )
 	{
+		if ( ! mt->slots[i].used )
+		{
+			continue;
+		}
+
 		printf("  Key[%u|0x%08X] -> Value[%u|0x%08X]\n",
-			   it->first,
-			   it->first,
-			   it->second,
-			   it->second);
+			   mt->slots[i].key,
+			   mt->slots[i].key,
+			   mt->slots[i].val,
+			   mt->slots[i].val);
 	}
 
 bail:
@@ -170,6 +170,11 @@ static ipa_nati_obj nati_obj = {
 	 *   sw_stats[1] for sram
 	 */
 	.sw_stats = { {0, 0}, {0, 0} },
+	/*
+	 * Table switches copy the whole table in one go by default...
+	 */
+	.mig_rules_per_step  = 0,
+	.mig                 = { .active = false },
 };
 
 /*
@@ -461,6 +466,40 @@ int ipa_nati_query_timestamp(
 	return ret;
 }
 
+int ipa_nati_query_timestamps(
+	uint32_t             tbl_hdl,
+	uint32_t             now,
+	uint32_t             min_idle,
+	ipa_nat_rule_tstamp* entries,
+	uint32_t             max_entries,
+	uint32_t*            num_entries )
+{
+	arb_t* args[] = {
+		(arb_t*)(arb_t)tbl_hdl,
+		(arb_t*)(arb_t)now,
+		(arb_t*)(arb_t)min_idle,
+		(arb_t*) entries,
+		(arb_t*)(arb_t)max_entries,
+		(arb_t*) num_entries,
+		(arb_t*)(arb_t)false,
+		(arb_t*)(arb_t)0,
+	};
+
+	int ret;
+
+	IPADBG("In\n");
+
+	*num_entries = 0;
+
+	ret = ipa_nati_statemach(&nati_obj, NATI_TRIG_GET_TSTAMPS, args);
+
+	IPADBG("num_entries val(%u)\n", *num_entries);
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
 int ipa_nat_switch_to(
 	enum ipa3_nat_mem_in nmi,
 	bool                 hold_state )
@@ -517,7 +556,14 @@ int ipa_nat_switch_to(
 
 		if ( COMPATIBLE_NMI_4SWITCH(nmi) )
 		{
-			ret = ipa_nati_statemach(&nati_obj, NATI_TRIG_TBL_SWITCH, 0);
+			/*
+			 * An explicit switch is done in full, even when table
+			 * switches are otherwise done a step at a time...
+			 */
+			do
+			{
+				ret = ipa_nati_statemach(&nati_obj, NATI_TRIG_TBL_SWITCH, 0);
+			} while ( ret == 0 && nati_obj.mig.active );
 		}
 
 		if ( ret == 0 )
@@ -604,6 +650,69 @@ bail:
 	return ret;
 }
 
+int ipa_nat_set_migration_step(
+	uint32_t rules_per_step )
+{
+	int ret;
+
+	IPADBG("In\n");
+
+	ret = take_mutex();
+
+	if ( ret != 0 )
+	{
+		goto bail;
+	}
+
+	nati_obj.mig_rules_per_step = rules_per_step;
+
+	IPADBG("Table switches will copy %u rules per step\n", rules_per_step);
+
+	if ( give_mutex() != 0 )
+	{
+		ret = -EPERM;
+	}
+
+bail:
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+int ipa_nat_migrate_step(void)
+{
+	int ret;
+
+	IPADBG("In\n");
+
+	ret = take_mutex();
+
+	if ( ret != 0 )
+	{
+		goto bail;
+	}
+
+	if ( nati_obj.mig.active )
+	{
+		ret = ipa_nati_statemach(&nati_obj, NATI_TRIG_TBL_SWITCH, 0);
+
+		if ( ret == 0 && nati_obj.mig.active )
+		{
+			ret = 1;
+		}
+	}
+
+	if ( give_mutex() != 0 && ret >= 0 )
+	{
+		ret = -EPERM;
+	}
+
+bail:
+	IPADBG("Out\n");
+
+	return ret;
+}
+
 bool ipa_nat_is_sram_supported(void)
 {
 	return VALID_TBL_HDL(nati_obj.sram_tbl_hdl);
@@ -805,6 +914,326 @@ bail:
 	return ret;
 }
 
+/******************************************************************************/
+/*
+ * INCREMENTAL MIGRATION
+ *
+ *   Copying a large table in one go holds the nat mutex, and so stalls
+ *   rule adds and deletes, for as long as the copy takes.  When
+ *   nati_obj.mig_rules_per_step is non-zero, a table switch instead
+ *   copies that many source records per step, remembering where it
+ *   stopped in nati_obj.mig.next_index.
+ *
+ *   While the copy is in progress:
+ *
+ *     (1) The IPA, and the maps, counters and state, stay on the
+ *         source table.
+ *
+ *     (2) Every live source rule below next_index has a copy in the
+ *         destination table.  Rule records never move, so adds that
+ *         land below next_index are copied right away and deletes
+ *         remove the copy too.  Anything above next_index is picked
+ *         up by a later step.
+ *
+ *     (3) If the source table is full, the rest of the copy is done
+ *         at once and the rule is added to the destination table,
+ *         which the IPA then uses.  Rules never live in the
+ *         destination table alone, so abandoning a copy loses
+ *         nothing.
+ *
+ *   When the last step completes, the IPA is pointed at the
+ *   destination table.  The steps themselves run via
+ *   NATI_TRIG_TBL_SWITCH, so they are voted for like the switch.
+ */
+
+/*
+ * ipa_table_walk() callback for a step.  Copies records until the
+ * step's budget is used, then stops the walk with a positive return.
+ */
+static int migrate_rule_step(
+	ipa_table*      table_ptr,
+	uint32_t        tbl_rule_hdl,
+	void*           record_ptr,
+	uint16_t        record_index,
+	void*           meta_record_ptr,
+	uint16_t        meta_record_index,
+	void*           arb_data_ptr )
+{
+	nati_migration* mig_ptr = (nati_migration*) arb_data_ptr;
+
+	int ret;
+
+	if ( mig_ptr->budget == 0 )
+	{
+		mig_ptr->next_index = record_index;
+		return 1;
+	}
+
+	ret = migrate_rule(
+		table_ptr,
+		tbl_rule_hdl,
+		record_ptr,
+		record_index,
+		meta_record_ptr,
+		meta_record_index,
+		(arb_t*)(arb_t) mig_ptr->dst_tbl_hdl);
+
+	if ( ret == 0 )
+	{
+		mig_ptr->budget--;
+		mig_ptr->next_index = record_index + 1;
+	}
+
+	return ret;
+}
+
+/*
+ * Copies a newly added source rule, if the copy has already gone past
+ * its record.
+ */
+static int mirror_rule(
+	ipa_table*      table_ptr,
+	uint32_t        tbl_rule_hdl,
+	void*           record_ptr,
+	uint16_t        record_index,
+	void*           meta_record_ptr,
+	uint16_t        meta_record_index,
+	void*           arb_data_ptr )
+{
+	nati_migration* mig_ptr = (nati_migration*) arb_data_ptr;
+
+	if ( record_index >= mig_ptr->next_index )
+	{
+		return 0;
+	}
+
+	return migrate_rule(
+		table_ptr,
+		tbl_rule_hdl,
+		record_ptr,
+		record_index,
+		meta_record_ptr,
+		meta_record_index,
+		(arb_t*)(arb_t) mig_ptr->dst_tbl_hdl);
+}
+
+/*
+ * Returns 1 if the copy has already gone past the rule's record...
+ */
+static int rule_is_copied(
+	ipa_table*      table_ptr,
+	uint32_t        tbl_rule_hdl,
+	void*           record_ptr,
+	uint16_t        record_index,
+	void*           meta_record_ptr,
+	uint16_t        meta_record_index,
+	void*           arb_data_ptr )
+{
+	nati_migration* mig_ptr = (nati_migration*) arb_data_ptr;
+
+	return ( record_index < mig_ptr->next_index ) ? 1 : 0;
+}
+
+/*
+ * Empties the destination and readies a copy into it...
+ */
+static int migrate_tbl_start(
+	ipa_nati_obj* nati_obj_ptr,
+	uint32_t      src_sub,
+	uint32_t      dst_sub )
+{
+	nati_migration* mig_ptr = &nati_obj_ptr->mig;
+
+	int ret;
+
+	IPADBG("In\n");
+
+	mig_ptr->src_sub     = src_sub;
+	mig_ptr->dst_sub     = dst_sub;
+	mig_ptr->src_tbl_hdl =
+		(src_sub == SRAM_SUB)      ?
+		nati_obj_ptr->sram_tbl_hdl :
+		nati_obj_ptr->ddr_tbl_hdl;
+	mig_ptr->dst_tbl_hdl =
+		(dst_sub == SRAM_SUB)      ?
+		nati_obj_ptr->sram_tbl_hdl :
+		nati_obj_ptr->ddr_tbl_hdl;
+	mig_ptr->next_index  = 0;
+
+	/*
+	 * Clear destination counter, maps and table...
+	 */
+	nati_obj_ptr->tot_rules_in_table[dst_sub] = 0;
+
+	ipa_nat_map_clear(nati_obj_ptr->map_pairs[dst_sub].orig2new_map);
+	ipa_nat_map_clear(nati_obj_ptr->map_pairs[dst_sub].new2orig_map);
+
+	ret = ipa_NATI_clear_ipv4_tbl(mig_ptr->dst_tbl_hdl);
+
+	if ( ret == 0 )
+	{
+		currTimeAs(TimeAsNanSecs, &mig_ptr->start);
+
+		mig_ptr->active = true;
+	}
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+/*
+ * Copies the next mig_rules_per_step records, and accounts the time
+ * taken to the source memory type's switch stats.
+ *
+ * Returns 1 once the copy is complete, 0 if there is more to copy,
+ * otherwise negative.
+ */
+static int migrate_tbl_step(
+	ipa_nati_obj* nati_obj_ptr )
+{
+	nati_migration*    mig_ptr      = &nati_obj_ptr->mig;
+	nati_switch_stats* sw_stats_ptr = &nati_obj_ptr->sw_stats[mig_ptr->src_sub];
+
+	uint64_t           start, stop;
+
+	int                ret;
+
+	IPADBG("In\n");
+
+	mig_ptr->budget =
+		(nati_obj_ptr->mig_rules_per_step) ?
+		nati_obj_ptr->mig_rules_per_step   :
+		UINT32_MAX;
+
+	currTimeAs(TimeAsNanSecs, &start);
+
+	ret = ipa_NATI_walk_ipv4_tbl_from(
+		mig_ptr->src_tbl_hdl,
+		USE_NAT_TABLE,
+		mig_ptr->next_index,
+		migrate_rule_step,
+		mig_ptr);
+
+	currTimeAs(TimeAsNanSecs, &stop);
+
+	sw_stats_ptr->steps        += 1;
+	sw_stats_ptr->last_step_ns  = stop - start;
+	sw_stats_ptr->tot_step_ns  += stop - start;
+
+	if ( sw_stats_ptr->last_step_ns > sw_stats_ptr->max_step_ns )
+	{
+		sw_stats_ptr->max_step_ns = sw_stats_ptr->last_step_ns;
+	}
+
+	IPADBG("Migration step took %f microseconds, next_index(%u)\n",
+		   (float) (stop - start) / 1000.0,
+		   mig_ptr->next_index);
+
+	if ( ret == 0 )
+	{
+		ret = 1;
+	}
+	else if ( ret > 0 )
+	{
+		ret = 0;
+	}
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+/*
+ * Copies a rule just added to the source table, if need be...
+ */
+static int migrate_add_rule(
+	ipa_nati_obj* nati_obj_ptr,
+	uint32_t      src_rule_hdl )
+{
+	nati_migration* mig_ptr = &nati_obj_ptr->mig;
+
+	return ipa_NATI_walk_ipv4_rule(
+		mig_ptr->src_tbl_hdl, src_rule_hdl, mirror_rule, mig_ptr);
+}
+
+/*
+ * Deletes a rule's copy from the destination table...
+ */
+static int migrate_del_rule(
+	ipa_nati_obj* nati_obj_ptr,
+	uint32_t      orig_rule_hdl )
+{
+	nati_migration* mig_ptr = &nati_obj_ptr->mig;
+
+	uint32_t        orig2new_map = nati_obj_ptr->map_pairs[mig_ptr->dst_sub].orig2new_map;
+	uint32_t        new2orig_map = nati_obj_ptr->map_pairs[mig_ptr->dst_sub].new2orig_map;
+
+	uint32_t        new_rule_hdl;
+
+	int             ret;
+
+	IPADBG("In\n");
+
+	ret = ipa_nat_map_del(orig2new_map, orig_rule_hdl, &new_rule_hdl);
+
+	if ( ret == 0 )
+	{
+		ipa_nat_map_del(new2orig_map, new_rule_hdl, NULL);
+
+		ret = ipa_NATI_del_ipv4_rule(mig_ptr->dst_tbl_hdl, new_rule_hdl);
+
+		if ( ret == 0 )
+		{
+			nati_obj_ptr->tot_rules_in_table[mig_ptr->dst_sub]--;
+		}
+	}
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+/*
+ * Gives up on an in progress copy.  The IPA never left the source
+ * table, which still holds every rule, so only the partial copy is
+ * lost...
+ */
+static void migrate_tbl_abort(
+	ipa_nati_obj* nati_obj_ptr )
+{
+	nati_migration* mig_ptr = &nati_obj_ptr->mig;
+
+	if ( mig_ptr->active )
+	{
+		IPAERR("Table switch abandoned at index %u\n", mig_ptr->next_index);
+
+		nati_obj_ptr->sw_stats[mig_ptr->src_sub].fail += 1;
+
+		mig_ptr->active = false;
+	}
+}
+
+/*
+ * Completes an in progress copy in one step, and moves the IPA to the
+ * destination table...
+ */
+static int migrate_tbl_finish(
+	ipa_nati_obj* nati_obj_ptr )
+{
+	uint32_t rules_per_step = nati_obj_ptr->mig_rules_per_step;
+
+	int      ret;
+
+	nati_obj_ptr->mig_rules_per_step = 0;
+
+	ret = ipa_nati_statemach(nati_obj_ptr, NATI_TRIG_TBL_SWITCH, 0);
+
+	nati_obj_ptr->mig_rules_per_step = rules_per_step;
+
+	return ret;
+}
+
 /*
  * ****************************************************************************
  *
@@ -1114,6 +1543,8 @@ static int _smAddSramAndDdrTbl(
 
 	IPADBG("In\n");
 
+	nati_obj_ptr->mig.active = false;
+
 	nati_obj_ptr->tot_rules_in_table[SRAM_SUB] = 0;
 	nati_obj_ptr->tot_rules_in_table[DDR_SUB]  = 0;
 
@@ -1126,6 +1557,17 @@ static int _smAddSramAndDdrTbl(
 
 	if ( ret == 0 )
 	{
+		/*
+		 * Size the handle maps from the tables they shadow, so that
+		 * rule adds and migrations don't allocate...
+		 */
+		ipa_nat_map_reserve(
+			nati_obj_ptr->map_pairs[SRAM_SUB].orig2new_map,
+			nati_obj_ptr->tot_slots_in_sram);
+		ipa_nat_map_reserve(
+			nati_obj_ptr->map_pairs[SRAM_SUB].new2orig_map,
+			nati_obj_ptr->tot_slots_in_sram);
+
 		if ( nati_obj_ptr->tot_slots_in_sram >= number_of_entries )
 		{
 			/*
@@ -1151,6 +1593,13 @@ static int _smAddSramAndDdrTbl(
 
 			if ( ret == 0 )
 			{
+				ipa_nat_map_reserve(
+					nati_obj_ptr->map_pairs[DDR_SUB].orig2new_map,
+					number_of_entries);
+				ipa_nat_map_reserve(
+					nati_obj_ptr->map_pairs[DDR_SUB].new2orig_map,
+					number_of_entries);
+
 				/*
 				 * The following will tell the IPA to change focus to
 				 * SRAM...
@@ -1208,6 +1657,8 @@ static int _smDelSramAndDdrTbl(
 
 	IPADBG("In\n");
 
+	nati_obj_ptr->mig.active = false;
+
 	nati_obj_ptr->tot_rules_in_table[SRAM_SUB] = 0;
 	nati_obj_ptr->tot_rules_in_table[DDR_SUB]  = 0;
 
@@ -1342,6 +1793,12 @@ static int _smClrTblHybrid(
 
 	IPADBG("In\n");
 
+	/*
+	 * Any in progress table switch is dropped.  The next one starts
+	 * by clearing its destination table...
+	 */
+	nati_obj_ptr->mig.active = false;
+
 	ret = _smClrTbl(nati_obj_ptr, trigger, new_args);
 
 	IPADBG("Out\n");
@@ -1739,6 +2196,37 @@ static int _smAddRuleHybrid(
 		{
 			ret = ipa_nat_map_add(new2orig_map, *rule_hdl, *rule_hdl);
 		}
+
+		if ( ret == 0 && nati_obj_ptr->mig.active )
+		{
+			/*
+			 * A table switch is in progress.  If it has already
+			 * copied the record the rule landed in, copy the rule
+			 * too...
+			 */
+			if ( migrate_add_rule(nati_obj_ptr, *rule_hdl) != 0 )
+			{
+				migrate_tbl_abort(nati_obj_ptr);
+			}
+		}
+	}
+	else if ( ret == -ENOSPC && nati_obj_ptr->mig.active )
+	{
+		/*
+		 * The source table of an in progress table switch is full.
+		 * Finish the switch, then add the rule to the table the IPA
+		 * moved to.  If the switch fails, so does the add...
+		 */
+		IPAINFO("Add of rule failed...completing table switch\n");
+
+		ret = migrate_tbl_finish(nati_obj_ptr);
+
+		if ( ret == 0 )
+		{
+			ret = ipa_nati_statemach(nati_obj_ptr, trigger, arb_data_ptr);
+		}
+
+		goto bail;
 	}
 	else
 	{
@@ -1761,16 +2249,34 @@ static int _smAddRuleHybrid(
 
 			if ( ret == 0 )
 			{
-				SET_NATIOBJ_STATE(nati_obj_ptr, NATI_STATE_HYBRID_DDR);
+				if ( ! nati_obj_ptr->mig.active )
+				{
+					SET_NATIOBJ_STATE(nati_obj_ptr, NATI_STATE_HYBRID_DDR);
+				}
 
 				/*
-				 * Now add the rule to DDR...
+				 * Now add the rule to DDR (this also moves the
+				 * switch along)...
 				 */
 				ret = ipa_nati_statemach(nati_obj_ptr, trigger, arb_data_ptr);
 			}
+
+			goto bail;
 		}
 	}
 
+	if ( ret == 0 && nati_obj_ptr->mig.active )
+	{
+		/*
+		 * Move an in progress table switch along...
+		 */
+		if ( ipa_nati_statemach(nati_obj_ptr, NATI_TRIG_TBL_SWITCH, 0) != 0 )
+		{
+			IPAERR("Table switch step failed\n");
+		}
+	}
+
+bail:
 	IPADBG("Out\n");
 
 	return ret;
@@ -1854,14 +2360,41 @@ static int _smDelRuleHybrid(
 			(arb_t*)(arb_t)new_rule_hdl,
 		};
 
+		bool copied = false;
+
 		IPADBG("orig_rule_hdl(0x%08X) -> new_rule_hdl(0x%08X)\n",
 			   orig_rule_hdl, new_rule_hdl);
 
 		ipa_nat_map_del(new2orig_map, new_rule_hdl, NULL);
 
+		if ( nati_obj_ptr->mig.active )
+		{
+			copied = ipa_NATI_walk_ipv4_rule(
+				nati_obj_ptr->mig.src_tbl_hdl,
+				new_rule_hdl,
+				rule_is_copied,
+				&nati_obj_ptr->mig) > 0;
+		}
+
 		ret = _smDelRuleFromTbl(nati_obj_ptr, trigger, new_args);
 
-		if ( ret == 0 && nati_obj_ptr->curr_state == NATI_STATE_HYBRID_DDR )
+		if ( ret == 0 && copied )
+		{
+			/*
+			 * An in progress table switch has already copied the
+			 * rule, so delete the copy too...
+			 */
+			if ( migrate_del_rule(nati_obj_ptr, orig_rule_hdl) != 0 )
+			{
+				migrate_tbl_abort(nati_obj_ptr);
+			}
+		}
+
+		if ( ret == 0
+			 &&
+			 nati_obj_ptr->curr_state == NATI_STATE_HYBRID_DDR
+			 &&
+			 ! nati_obj_ptr->mig.active )
 		{
 			/*
 			 * We need to check when/if we can go back to SRAM.
@@ -1891,7 +2424,12 @@ static int _smDelRuleHybrid(
 
 				if ( ret == 0 )
 				{
-					SET_NATIOBJ_STATE(nati_obj_ptr, NATI_STATE_HYBRID);
+					if ( ! nati_obj_ptr->mig.active )
+					{
+						SET_NATIOBJ_STATE(nati_obj_ptr, NATI_STATE_HYBRID);
+					}
+
+					goto bail;
 				}
 				else
 				{
@@ -1907,6 +2445,18 @@ static int _smDelRuleHybrid(
 		}
 	}
 
+	if ( ret == 0 && nati_obj_ptr->mig.active )
+	{
+		/*
+		 * Move an in progress table switch along...
+		 */
+		if ( ipa_nati_statemach(nati_obj_ptr, NATI_TRIG_TBL_SWITCH, 0) != 0 )
+		{
+			IPAERR("Table switch step failed\n");
+		}
+	}
+
+bail:
 	IPADBG("Out\n");
 
 	return ret;
@@ -2013,6 +2563,10 @@ static int _smGoToSram(
  *   The following will cause a copy of the DDR table to SRAM and then
  *   will make the IPA use the SRAM...
  *
+ *   With nati_obj.mig_rules_per_step set, each call copies only that
+ *   many rules.  The IPA is moved to SRAM by the call that completes
+ *   the copy...
+ *
  * RETURNS:
  *
  *   zero on success, otherwise non-zero
@@ -2043,52 +2597,66 @@ static int _smSwitchFromDdrToSram(
 			nati_obj_ptr->ddr_tbl_hdl, &nat_stats, &idx_stats) :
 		-1;
 
-	currTimeAs(TimeAsNanSecs, &start);
-
 	/*
-	 * First, switch focus to SRAM...
+	 * First, start copying DDR's content to SRAM, unless already
+	 * underway.  The IPA stays on DDR until the copy is done...
 	 */
-	ret = ipa_nati_statemach(nati_obj_ptr, NATI_TRIG_GOTO_SRAM, 0);
+	if ( ! nati_obj_ptr->mig.active )
+	{
+		ret = migrate_tbl_start(nati_obj_ptr, DDR_SUB, SRAM_SUB);
+
+		if ( ret != 0 )
+		{
+			sw_stats_ptr->fail += 1;
+			goto bail;
+		}
+	}
+
+	ret = migrate_tbl_step(nati_obj_ptr);
 
 	if ( ret == 0 )
 	{
-		/*
-		 * Clear destination counter...
-		 */
-		nati_obj_ptr->tot_rules_in_table[SRAM_SUB] = 0;
+		IPADBG("Transistion from DDR to SRAM in progress\n");
+		goto bail;
+	}
 
+	if ( ret == 1 )
+	{
 		/*
-		 * Clear destination SRAM maps...
+		 * Copy complete, now switch focus to SRAM...
 		 */
-		ipa_nat_map_clear(nati_obj.map_pairs[SRAM_SUB].orig2new_map);
-		ipa_nat_map_clear(nati_obj.map_pairs[SRAM_SUB].new2orig_map);
+		ret = ipa_nati_statemach(nati_obj_ptr, NATI_TRIG_GOTO_SRAM, 0);
+	}
+	else
+	{
+		IPAERR("Transistion from DDR to SRAM abandoned at index %u\n",
+			   nati_obj_ptr->mig.next_index);
+	}
 
-		/*
-		 * Now copy DDR's content to SRAM...
-		 */
-		ret = ipa_nati_copy_ipv4_tbl(
-			nati_obj_ptr->ddr_tbl_hdl,
-			nati_obj_ptr->sram_tbl_hdl,
-			migrate_rule);
+	nati_obj_ptr->mig.active = false;
 
-		currTimeAs(TimeAsNanSecs, &stop);
+	currTimeAs(TimeAsNanSecs, &stop);
 
-		if ( ret == 0 )
-		{
-			sw_stats_ptr->pass += 1;
+	start = nati_obj_ptr->mig.start;
 
-			IPADBG("Transistion from DDR to SRAM took %f microseconds\n",
-				   (float) (stop - start) / 1000.0);
-		}
-		else
-		{
-			sw_stats_ptr->fail += 1;
-		}
+	if ( ret == 0 )
+	{
+		sw_stats_ptr->pass += 1;
+
+		IPADBG("Transistion from DDR to SRAM took %f microseconds\n",
+			   (float) (stop - start) / 1000.0);
+	}
+	else
+	{
+		sw_stats_ptr->fail += 1;
+	}
 
-		IPADBG("Transistion pass/fail counts (DDR to SRAM) PASS: %u FAIL: %u\n",
-			   sw_stats_ptr->pass,
-			   sw_stats_ptr->fail);
+	IPADBG("Transistion pass/fail counts (DDR to SRAM) PASS: %u FAIL: %u\n",
+		   sw_stats_ptr->pass,
+		   sw_stats_ptr->fail);
 
+	if ( ret == 0 )
+	{
 		if ( stats_ret == 0 )
 		{
 			mem_type = ipa3_nat_mem_in_as_str(nat_stats.nmi);
@@ -2161,6 +2729,7 @@ static int _smSwitchFromDdrToSram(
 		}
 	}
 
+bail:
 	IPADBG("Out\n");
 
 	return ret;
@@ -2183,6 +2752,10 @@ static int _smSwitchFromDdrToSram(
  *   The following will cause a copy of the SRAM table to DDR and then
  *   will make the IPA use the DDR...
  *
+ *   With nati_obj.mig_rules_per_step set, each call copies only that
+ *   many rules.  The IPA is moved to DDR by the call that completes
+ *   the copy...
+ *
  * RETURNS:
  *
  *   zero on success, otherwise non-zero
@@ -2213,52 +2786,66 @@ static int _smSwitchFromSramToDdr(
 			nati_obj_ptr->sram_tbl_hdl, &nat_stats, &idx_stats) :
 		-1;
 
-	currTimeAs(TimeAsNanSecs, &start);
-
 	/*
-	 * First, switch focus to DDR...
+	 * First, start copying SRAM's content to DDR, unless already
+	 * underway.  The IPA stays on SRAM until the copy is done...
 	 */
-	ret = ipa_nati_statemach(nati_obj_ptr, NATI_TRIG_GOTO_DDR, 0);
+	if ( ! nati_obj_ptr->mig.active )
+	{
+		ret = migrate_tbl_start(nati_obj_ptr, SRAM_SUB, DDR_SUB);
+
+		if ( ret != 0 )
+		{
+			sw_stats_ptr->fail += 1;
+			goto bail;
+		}
+	}
+
+	ret = migrate_tbl_step(nati_obj_ptr);
 
 	if ( ret == 0 )
 	{
-		/*
-		 * Clear destination counter...
-		 */
-		nati_obj_ptr->tot_rules_in_table[DDR_SUB] = 0;
+		IPADBG("Transistion from SRAM to DDR in progress\n");
+		goto bail;
+	}
 
+	if ( ret == 1 )
+	{
 		/*
-		 * Clear destination DDR maps...
+		 * Copy complete, now switch focus to DDR...
 		 */
-		ipa_nat_map_clear(nati_obj.map_pairs[DDR_SUB].orig2new_map);
-		ipa_nat_map_clear(nati_obj.map_pairs[DDR_SUB].new2orig_map);
+		ret = ipa_nati_statemach(nati_obj_ptr, NATI_TRIG_GOTO_DDR, 0);
+	}
+	else
+	{
+		IPAERR("Transistion from SRAM to DDR abandoned at index %u\n",
+			   nati_obj_ptr->mig.next_index);
+	}
 
-		/*
-		 * Now copy SRAM's content to DDR...
-		 */
-		ret = ipa_nati_copy_ipv4_tbl(
-			nati_obj_ptr->sram_tbl_hdl,
-			nati_obj_ptr->ddr_tbl_hdl,
-			migrate_rule);
+	nati_obj_ptr->mig.active = false;
 
-		currTimeAs(TimeAsNanSecs, &stop);
+	currTimeAs(TimeAsNanSecs, &stop);
 
-		if ( ret == 0 )
-		{
-			sw_stats_ptr->pass += 1;
+	start = nati_obj_ptr->mig.start;
 
-			IPADBG("Transistion from SRAM to DDR took %f microseconds\n",
-				   (float) (stop - start) / 1000.0);
-		}
-		else
-		{
-			sw_stats_ptr->fail += 1;
-		}
+	if ( ret == 0 )
+	{
+		sw_stats_ptr->pass += 1;
+
+		IPADBG("Transistion from SRAM to DDR took %f microseconds\n",
+			   (float) (stop - start) / 1000.0);
+	}
+	else
+	{
+		sw_stats_ptr->fail += 1;
+	}
 
-		IPADBG("Transistion pass/fail counts (SRAM to DDR) PASS: %u FAIL: %u\n",
-			   sw_stats_ptr->pass,
-			   sw_stats_ptr->fail);
+	IPADBG("Transistion pass/fail counts (SRAM to DDR) PASS: %u FAIL: %u\n",
+		   sw_stats_ptr->pass,
+		   sw_stats_ptr->fail);
 
+	if ( ret == 0 )
+	{
 		if ( stats_ret == 0 )
 		{
 			mem_type = ipa3_nat_mem_in_as_str(nat_stats.nmi);
@@ -2331,6 +2918,7 @@ static int _smSwitchFromSramToDdr(
 		}
 	}
 
+bail:
 	IPADBG("Out\n");
 
 	return ret;
@@ -2447,6 +3035,203 @@ static int _smGetTmStmpHybrid(
 	return ret;
 }
 
+/*
+ * Used to gather timestamps during a table walk...
+ */
+typedef struct
+{
+	ipa_nat_rule_tstamp* entries;
+	uint32_t             max_entries;
+	uint32_t*            num_entries_ptr;
+	uint32_t             now;
+	uint32_t             min_idle;
+	bool                 use_map;
+	uint32_t             new2orig_map;
+} tstamp_helper;
+
+static int gather_tstamps(
+	ipa_table*      table_ptr,
+	uint32_t        rule_hdl,
+	void*           record_ptr,
+	uint16_t        record_index,
+	void*           meta_record_ptr,
+	uint16_t        meta_record_index,
+	void*           arb_data_ptr )
+{
+	tstamp_helper*       th_ptr   = (tstamp_helper*) arb_data_ptr;
+	struct ipa_nat_rule* rule_ptr = (struct ipa_nat_rule*) record_ptr;
+
+	uint32_t             time_stamp;
+	uint32_t             orig_rule_hdl = rule_hdl;
+
+	/*
+	 * A deleted list head is still enabled, but is not a rule...
+	 */
+	if ( rule_ptr->protocol == IPA_NAT_INVALID_PROTO_FIELD_VALUE_IN_RULE )
+	{
+		return 0;
+	}
+
+	time_stamp = rule_ptr->time_stamp;
+
+	if ( th_ptr->min_idle
+		 &&
+		 ((th_ptr->now - time_stamp) & IPA_NAT_TSTAMP_MASK) < th_ptr->min_idle )
+	{
+		return 0;
+	}
+
+	if ( *th_ptr->num_entries_ptr >= th_ptr->max_entries )
+	{
+		/*
+		 * Out of room. A positive return stops the walk...
+		 */
+		return 1;
+	}
+
+	if ( th_ptr->use_map
+		 &&
+		 ipa_nat_map_find(th_ptr->new2orig_map, rule_hdl, &orig_rule_hdl) )
+	{
+		IPAERR("No original handle for rule_hdl(0x%08X)\n", rule_hdl);
+		return -EINVAL;
+	}
+
+	th_ptr->entries[*th_ptr->num_entries_ptr].rule_hdl   = orig_rule_hdl;
+	th_ptr->entries[*th_ptr->num_entries_ptr].time_stamp = time_stamp;
+
+	(*th_ptr->num_entries_ptr)++;
+
+	return 0;
+}
+
+/******************************************************************************/
+/*
+ * FUNCTION: _smGetTmStmps
+ *
+ * PARAMS:
+ *
+ *   nati_obj_ptr (IN) A pointer to an initialized nati object
+ *
+ *   trigger      (IN) The trigger to run through the state machine
+ *
+ *   arb_data_ptr (IN) Whatever you like
+ *
+ * DESCRIPTION:
+ *
+ *   Retrieve the timestamps of all (or all idle) rules from a NAT
+ *   table in one walk of it.
+ *
+ * RETURNS:
+ *
+ *   zero on success, -ENOSPC when the caller's array was too small,
+ *   otherwise non-zero
+ */
+static int _smGetTmStmps(
+	ipa_nati_obj*    nati_obj_ptr,
+	ipa_nati_trigger trigger,
+	arb_t*           arb_data_ptr )
+{
+	arb_t** args = arb_data_ptr;
+
+	uint32_t  tbl_hdl  = (uint32_t) args[0];
+	tstamp_helper th   = {
+		.entries         = (ipa_nat_rule_tstamp*) args[3],
+		.max_entries     = (uint32_t)  args[4],
+		.num_entries_ptr = (uint32_t*) args[5],
+		.now             = (uint32_t)  args[1],
+		.min_idle        = (uint32_t)  args[2],
+		.use_map         = false,
+		.new2orig_map    = 0,
+	};
+
+	int ret;
+
+	IPADBG("In\n");
+
+	IPADBG("tbl_hdl(0x%08X) now(0x%06X) min_idle(%u) max_entries(%u)\n",
+		   tbl_hdl, th.now, th.min_idle, th.max_entries);
+
+	if ( args[6] )
+	{
+		th.use_map      = true;
+		th.new2orig_map = (uint32_t) args[7];
+	}
+
+	ret = ipa_NATI_walk_ipv4_tbl(tbl_hdl, USE_NAT_TABLE, gather_tstamps, &th);
+
+	if ( ret > 0 )
+	{
+		IPADBG("Entries array full at %u entries\n", th.max_entries);
+		ret = -ENOSPC;
+	}
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
+/******************************************************************************/
+/*
+ * FUNCTION: _smGetTmStmpsHybrid
+ *
+ * PARAMS:
+ *
+ *   nati_obj_ptr (IN) A pointer to an initialized nati object
+ *
+ *   trigger      (IN) The trigger to run through the state machine
+ *
+ *   arb_data_ptr (IN) Whatever you like
+ *
+ * DESCRIPTION:
+ *
+ *   Retrieve the timestamps of all (or all idle) rules from the state
+ *   approriate NAT table, reporting them by their original handles.
+ *
+ * RETURNS:
+ *
+ *   zero on success, -ENOSPC when the caller's array was too small,
+ *   otherwise non-zero
+ */
+static int _smGetTmStmpsHybrid(
+	ipa_nati_obj*    nati_obj_ptr,
+	ipa_nati_trigger trigger,
+	arb_t*           arb_data_ptr )
+{
+	arb_t** args = arb_data_ptr;
+
+	uint32_t  tbl_hdl = (uint32_t) args[0];
+
+	uint32_t  orig2new_map, new2orig_map;
+
+	int       ret;
+
+	IPADBG("In\n");
+
+	CHOOSE_MAPS(orig2new_map, new2orig_map);
+
+	{
+		arb_t* new_args[] = {
+			(arb_t*)(arb_t)(nati_obj_ptr->curr_state == NATI_STATE_HYBRID) ?
+			         tbl_hdl :
+			         nati_obj_ptr->ddr_tbl_hdl,
+			args[1],
+			args[2],
+			args[3],
+			args[4],
+			args[5],
+			(arb_t*)(arb_t)true,
+			(arb_t*)(arb_t)new2orig_map,
+		};
+
+		ret = _smGetTmStmps(nati_obj_ptr, trigger, new_args);
+	}
+
+	IPADBG("Out\n");
+
+	return ret;
+}
+
 /******************************************************************************/
 /*
  * The following table relates a nati object's state and a transition
@@ -2468,6 +3253,7 @@ _state_mach_tbl[NATI_STATE_LAST+1][NATI_TRIG_LAST+1] =
 		SM_ROW( NATI_STATE_NULL,       NATI_TRIG_GOTO_DDR,   _smUndef ),
 		SM_ROW( NATI_STATE_NULL,       NATI_TRIG_GOTO_SRAM,  _smUndef ),
 		SM_ROW( NATI_STATE_NULL,       NATI_TRIG_GET_TSTAMP, _smUndef ),
+		SM_ROW( NATI_STATE_NULL,       NATI_TRIG_GET_TSTAMPS, _smUndef ),
 		SM_ROW( NATI_STATE_NULL,       NATI_TRIG_LAST,       _smUndef ),
 	},
 
@@ -2484,6 +3270,7 @@ _state_mach_tbl[NATI_STATE_LAST+1][NATI_TRIG_LAST+1] =
 		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_GOTO_DDR,   _smUndef ),
 		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_GOTO_SRAM,  _smUndef ),
 		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_GET_TSTAMP, _smGetTmStmp ),
+		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_GET_TSTAMPS, _smGetTmStmps ),
 		SM_ROW( NATI_STATE_DDR_ONLY,   NATI_TRIG_LAST,       _smUndef ),
 	},
 
@@ -2500,6 +3287,7 @@ _state_mach_tbl[NATI_STATE_LAST+1][NATI_TRIG_LAST+1] =
 		SM_ROW( NATI_STATE_SRAM_ONLY,  NATI_TRIG_GOTO_DDR,   _smUndef ),
 		SM_ROW( NATI_STATE_SRAM_ONLY,  NATI_TRIG_GOTO_SRAM,  _smUndef ),
 		SM_ROW( NATI_STATE_SRAM_ONLY,  NATI_TRIG_GET_TSTAMP, _smGetTmStmp ),
+		SM_ROW( NATI_STATE_SRAM_ONLY,  NATI_TRIG_GET_TSTAMPS, _smGetTmStmps ),
 		SM_ROW( NATI_STATE_SRAM_ONLY,  NATI_TRIG_LAST,       _smUndef ),
 	},
 
@@ -2516,6 +3304,7 @@ _state_mach_tbl[NATI_STATE_LAST+1][NATI_TRIG_LAST+1] =
 		SM_ROW( NATI_STATE_HYBRID,     NATI_TRIG_GOTO_DDR,   _smGoToDdr ),
 		SM_ROW( NATI_STATE_HYBRID,     NATI_TRIG_GOTO_SRAM,  _smGoToSram ),
 		SM_ROW( NATI_STATE_HYBRID,     NATI_TRIG_GET_TSTAMP, _smGetTmStmpHybrid ),
+		SM_ROW( NATI_STATE_HYBRID,     NATI_TRIG_GET_TSTAMPS, _smGetTmStmpsHybrid ),
 		SM_ROW( NATI_STATE_HYBRID,     NATI_TRIG_LAST,       _smUndef ),
 	},
 
@@ -2532,6 +3321,7 @@ _state_mach_tbl[NATI_STATE_LAST+1][NATI_TRIG_LAST+1] =
 		SM_ROW( NATI_STATE_HYBRID_DDR, NATI_TRIG_GOTO_DDR,   _smGoToDdr ),
 		SM_ROW( NATI_STATE_HYBRID_DDR, NATI_TRIG_GOTO_SRAM,  _smGoToSram ),
 		SM_ROW( NATI_STATE_HYBRID_DDR, NATI_TRIG_GET_TSTAMP, _smGetTmStmpHybrid ),
+		SM_ROW( NATI_STATE_HYBRID_DDR, NATI_TRIG_GET_TSTAMPS, _smGetTmStmpsHybrid ),
 		SM_ROW( NATI_STATE_HYBRID_DDR, NATI_TRIG_LAST,       _smUndef ),
 	},
 
@@ -2548,6 +3338,7 @@ _state_mach_tbl[NATI_STATE_LAST+1][NATI_TRIG_LAST+1] =
 		SM_ROW( NATI_STATE_LAST,       NATI_TRIG_GOTO_DDR,   _smUndef ),
 		SM_ROW( NATI_STATE_LAST,       NATI_TRIG_GOTO_SRAM,  _smUndef ),
 		SM_ROW( NATI_STATE_LAST,       NATI_TRIG_GET_TSTAMP, _smUndef ),
+		SM_ROW( NATI_STATE_LAST,       NATI_TRIG_GET_TSTAMPS, _smUndef ),
 		SM_ROW( NATI_STATE_LAST,       NATI_TRIG_LAST,       _smUndef ),
 	},
 };
@@ -2662,7 +3453,21 @@ int ipa_nati_statemach(
 	}
 
 unlock:
-	ret = give_mutex();
+	/*
+	 * Some triggers report their own errors, like -ENOSPC.  Every other
+	 * trigger returns the outcome of giving back the mutex...
+	 */
+	if ( KEEP_CB_ERR(trigger) )
+	{
+		if ( give_mutex() != 0 && ret == 0 )
+		{
+			ret = -EPERM;
+		}
+	}
+	else
+	{
+		ret = give_mutex();
+	}
 
 bail:
 	IPADBG("Out\n");
@@ -70,6 +70,14 @@ static int FindExpnTblFreeEntry(
 	void**     free_entry,
 	uint16_t*  entry_index );
 
+static void ExpnFreeMapReset(
+	ipa_table* table );
+
+static void ExpnFreeMapSet(
+	ipa_table* table,
+	uint16_t   rec_index,
+	bool       is_free );
+
 static int Get2PowerTightUpperBound(
 	uint16_t num);
 
@@ -217,6 +225,8 @@ void ipa_table_reset(
 	for (i = 0; i < tot; i++)
 		table->expn_table_addr[i] = '\0';
 
+	ExpnFreeMapReset(table);
+
 	IPADBG("Out\n");
 }
 
@@ -377,6 +387,8 @@ void ipa_table_delete_entry(
 
 			memset(iterator->prev_entry, 0, table->entry_size);
 
+			ExpnFreeMapSet(table, iterator->prev_index, true);
+
 			--table->cur_tbl_cnt;
 		}
 	}
@@ -404,6 +416,8 @@ void ipa_table_erase_entry(
 	}
 	else
 	{
+		ExpnFreeMapSet(table, index, true);
+
 		--table->cur_expn_tbl_cnt;
 	}
 
@@ -917,6 +931,8 @@ static int InsertTail(
 		iterator.curr_index,
 		cmd);
 
+	ExpnFreeMapSet(table, iterator.curr_index, false);
+
 	++table->cur_expn_tbl_cnt;
 
 	*rec_index_ptr = iterator.curr_index;
@@ -974,21 +990,69 @@ static uint16_t MakeEntryHdl(
 	return entry_hdl;
 }
 
-static int mt_slot(
-	ipa_table*      table_ptr,
-	uint32_t        rule_hdl,
-	void*           record_ptr,
-	uint16_t        record_index,
-	void*           meta_record_ptr,
-	uint16_t        meta_record_index,
-	void*           arb_data_ptr )
+/*
+ * Marks an expansion table slot free or in use. Base table indices are
+ * ignored, so callers need not check which table the index is in.
+ */
+static void ExpnFreeMapSet(
+	ipa_table* table,
+	uint16_t   rec_index,
+	bool       is_free )
+{
+	ipa_table_free_map* fm_ptr = &table->expn_free;
+	uint16_t            slot, word;
+	uint64_t            bit;
+
+	if ( rec_index < table->table_entries ||
+		 rec_index >= table->table_entries + table->expn_table_entries )
+	{
+		return;
+	}
+
+	slot = rec_index - table->table_entries;
+	word = slot / IPA_TABLE_FREE_MAP_BITS;
+	bit  = 1ULL << (slot % IPA_TABLE_FREE_MAP_BITS);
+
+	if ( is_free )
+	{
+		if ( ! (fm_ptr->map[word] & bit) )
+		{
+			fm_ptr->map[word] |= bit;
+			fm_ptr->sum[word / IPA_TABLE_FREE_MAP_BITS] |=
+				1ULL << (word % IPA_TABLE_FREE_MAP_BITS);
+			++fm_ptr->num_free;
+		}
+	}
+	else if ( fm_ptr->map[word] & bit )
+	{
+		fm_ptr->map[word] &= ~bit;
+		if ( ! fm_ptr->map[word] )
+		{
+			fm_ptr->sum[word / IPA_TABLE_FREE_MAP_BITS] &=
+				~(1ULL << (word % IPA_TABLE_FREE_MAP_BITS));
+		}
+		--fm_ptr->num_free;
+	}
+}
+
+/*
+ * Marks every expansion table slot free. Only called when the
+ * expansion table itself has just been zeroed.
+ */
+static void ExpnFreeMapReset(
+	ipa_table* table )
 {
-	IPADBG("%s: Empty expansion slot: (%u) in table of size: (%u)\n",
-		   table_ptr->name,
-		   record_index,
-		   table_ptr->tot_tbl_ents);
+	uint16_t i;
+
+	memset(&table->expn_free, 0, sizeof(table->expn_free));
 
-	return record_index;
+	for ( i = 0; i < table->expn_table_entries; i++ )
+	{
+		ExpnFreeMapSet(table, table->table_entries + i, true);
+	}
+
+	IPADBG("%s: %u free expansion slots\n",
+		   table->name, table->expn_free.num_free);
 }
 
 /*
@@ -999,7 +1063,10 @@ static int FindExpnTblFreeEntry(
 	void**     free_entry,
 	uint16_t*  entry_index )
 {
-	int ret;
+	ipa_table_free_map* fm_ptr;
+	uint16_t            w, word, slot;
+
+	int ret = -1;
 
 	IPADBG("In\n");
 
@@ -1008,24 +1075,47 @@ static int FindExpnTblFreeEntry(
 		IPAERR("Bad arg: table(%p) and/or "
 			   "free_entry(%p) and/or entry_index(%p)\n",
 			   table, free_entry, entry_index);
-		ret = -1;
 		goto bail;
 	}
 
 	*entry_index = 0;
 	*free_entry  = NULL;
 
-	/*
-	 * The following will start walk at expansion slots
-	 * (ie. just after table->table_entries)...
-	 */
-	ret = ipa_table_walk(table, table->table_entries, WHEN_SLOT_EMPTY, mt_slot, 0);
+	fm_ptr = &table->expn_free;
 
-	if ( ret > 0 )
+	while ( fm_ptr->num_free )
 	{
-		*entry_index = (uint16_t) ret;
+		/*
+		 * Lowest free slot: first non-empty map word from the
+		 * summary, then first free slot within that word...
+		 */
+		for ( w = 0; w < IPA_TABLE_FREE_SUM_WORDS && ! fm_ptr->sum[w]; w++ );
 
-		*free_entry = GOTO_REC(table, *entry_index);
+		if ( w == IPA_TABLE_FREE_SUM_WORDS )
+		{
+			IPAERR("%s: free count (%u) with no free slots in map\n",
+				   table->name, fm_ptr->num_free);
+			fm_ptr->num_free = 0;
+			break;
+		}
+
+		word = w * IPA_TABLE_FREE_MAP_BITS + __builtin_ctzll(fm_ptr->sum[w]);
+		slot = word * IPA_TABLE_FREE_MAP_BITS + __builtin_ctzll(fm_ptr->map[word]);
+
+		*entry_index = table->table_entries + slot;
+		*free_entry  = GOTO_REC(table, *entry_index);
+
+		/*
+		 * The map is only updated by this file, but never hand out
+		 * a slot the IPA considers in use...
+		 */
+		if ( table->entry_interface->entry_is_valid(*free_entry) )
+		{
+			IPAERR("%s: slot (%u) marked free but in use\n",
+				   table->name, *entry_index);
+			ExpnFreeMapSet(table, *entry_index, false);
+			continue;
+		}
 
 		IPADBG("%s: entry_index val (%u) free_entry val (%p)\n",
 			   table->name,
@@ -1033,27 +1123,21 @@ static int FindExpnTblFreeEntry(
 			   *free_entry);
 
 		ret = 0;
+		goto bail;
 	}
-	else
-	{
-		if ( ret < 0 )
-		{
-			IPAERR("%s: While searching table for emtpy slot\n",
-				   table->name);
-		}
-		else
-		{
-			IPADBG("%s: No empty slots (ie. expansion table full): "
-				   "BASE (avail/used): (%u/%u) EXPN (avail/used): (%u/%u)\n",
-				   table->name,
-				   table->table_entries,
-				   table->cur_tbl_cnt,
-				   table->expn_table_entries,
-				   table->cur_expn_tbl_cnt);
-		}
 
-		ret = -1;
-	}
+	*entry_index = 0;
+	*free_entry  = NULL;
+
+	ret = -ENOSPC;
+
+	IPADBG("%s: No empty slots (ie. expansion table full): "
+		   "BASE (avail/used): (%u/%u) EXPN (avail/used): (%u/%u)\n",
+		   table->name,
+		   table->table_entries,
+		   table->cur_tbl_cnt,
+		   table->expn_table_entries,
+		   table->cur_expn_tbl_cnt);
 
 bail:
 	IPADBG("Out\n");
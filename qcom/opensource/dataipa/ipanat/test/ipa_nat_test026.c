@@ -0,0 +1,171 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+/*=========================================================================*/
+/*!
+	@file
+	ipa_nat_test026.c
+
+	@brief
+	Note: Verify the following scenario:
+	1. Add ipv4 table
+	2. Add ipv4 rules till filled, timing each add
+	3. Print add latency for each tenth of the table filled
+	4. Delete ipv4 rules and table
+
+	With an O(1) expansion slot allocator, add latency should stay
+	flat as the table fills.
+*/
+/*=========================================================================*/
+
+#include "ipa_nat_test.h"
+
+#define NUM_BUCKETS 10
+
+static inline uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+int ipa_nat_test026(
+	const char* nat_mem_type,
+	u32 pub_ip_add,
+	int total_entries,
+	u32 tbl_hdl,
+	int sep,
+	void* arb_data_ptr)
+{
+	int* tbl_hdl_ptr = (int*) arb_data_ptr;
+
+	ipa_nat_ipv4_rule  ipv4_rule;
+	u32*               rule_hdls;
+
+	ipa_nati_tbl_stats nstats, istats;
+
+	uint64_t           tot_ns[NUM_BUCKETS];
+	uint64_t           max_ns[NUM_BUCKETS];
+	u32                cnt[NUM_BUCKETS];
+
+	u32                i, b, tot, max_rules;
+
+	int ret;
+
+	IPADBG("In\n");
+
+	if ( sep )
+	{
+		ret = ipa_nat_add_ipv4_tbl(pub_ip_add, nat_mem_type, total_entries, &tbl_hdl);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	ret = ipa_nati_clear_ipv4_tbl(tbl_hdl);
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	ret = ipa_nati_ipv4_tbl_stats(tbl_hdl, &nstats, &istats);
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	max_rules = nstats.tot_ents;
+
+	rule_hdls = calloc(max_rules, sizeof(*rule_hdls));
+
+	if ( ! rule_hdls )
+	{
+		IPAERR("Unable to allocate %u rule handles\n", max_rules);
+		ret = -1;
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	memset(tot_ns, 0, sizeof(tot_ns));
+	memset(max_ns, 0, sizeof(max_ns));
+	memset(cnt,    0, sizeof(cnt));
+
+	IPAINFO("Filling %s table of size: (%u)\n",
+			ipa3_nat_mem_in_as_str(nstats.nmi),
+			max_rules);
+
+	for ( tot = 0; tot < max_rules; tot++ )
+	{
+		uint64_t start, elapsed;
+
+		memset(&ipv4_rule, 0, sizeof(ipv4_rule));
+
+		ipv4_rule.protocol     = IPPROTO_TCP;
+		ipv4_rule.public_port  = RAN_PORT;
+		ipv4_rule.target_ip    = RAN_ADDR;
+		ipv4_rule.target_port  = RAN_PORT;
+		ipv4_rule.private_ip   = RAN_ADDR;
+		ipv4_rule.private_port = RAN_PORT;
+
+		start = now_ns();
+
+		ret = ipa_nat_add_ipv4_rule(tbl_hdl, &ipv4_rule, &rule_hdls[tot]);
+
+		elapsed = now_ns() - start;
+
+		if ( ret )
+		{
+			IPADBG("Table full after %u adds\n", tot);
+			ret = 0;
+			break;
+		}
+
+		b = (tot * NUM_BUCKETS) / max_rules;
+
+		tot_ns[b] += elapsed;
+		cnt[b]++;
+
+		if ( elapsed > max_ns[b] )
+		{
+			max_ns[b] = elapsed;
+		}
+	}
+
+	ret = ipa_nati_ipv4_tbl_stats(tbl_hdl, &nstats, &istats);
+	CHECK_ERR_TBL_ACTION(ret, tbl_hdl, free(rule_hdls); return -1);
+
+	IPAINFO("Added (%u) records: BASE (%u/%u) EXPN (%u/%u)\n",
+			tot,
+			nstats.tot_base_ents_filled,
+			nstats.tot_base_ents,
+			nstats.tot_expn_ents_filled,
+			nstats.tot_expn_ents);
+
+	for ( b = 0; b < NUM_BUCKETS; b++ )
+	{
+		if ( ! cnt[b] )
+		{
+			continue;
+		}
+
+		IPAINFO("Fill %3u%%-%3u%%: adds(%u) avg_ns(%llu) max_ns(%llu)\n",
+				b * 100 / NUM_BUCKETS,
+				(b + 1) * 100 / NUM_BUCKETS,
+				cnt[b],
+				(unsigned long long) (tot_ns[b] / cnt[b]),
+				(unsigned long long) max_ns[b]);
+	}
+
+	IPAINFO("Deleting rules\n");
+
+	for ( i = 0; i < tot; i++ )
+	{
+		ret = ipa_nat_del_ipv4_rule(tbl_hdl, rule_hdls[i]);
+		CHECK_ERR_TBL_ACTION(ret, tbl_hdl, free(rule_hdls); return -1);
+	}
+
+	free(rule_hdls);
+
+	if ( sep )
+	{
+		ret = ipa_nat_del_ipv4_tbl(tbl_hdl);
+		*tbl_hdl_ptr = 0;
+		CHECK_ERR(ret);
+	}
+
+	IPADBG("Out\n");
+
+	return 0;
+}
@@ -0,0 +1,150 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+/*=========================================================================*/
+/*!
+	@file
+	ipa_nat_test027.c
+
+	@brief
+	Verify the following scenario:
+	1. Reserve a handle map for 64K entries
+	2. Add, find, then delete 64K handle mappings, timing each pass
+	3. Verify every mapping found and deleted matches what was added
+
+	The NAT table itself is not used, so this runs the same in any
+	memory mode.
+*/
+/*=========================================================================*/
+
+#include "ipa_nat_test.h"
+#include "ipa_nat_map.h"
+
+#define NUM_MAP_ENTRIES (64 * 1024)
+
+static inline uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static void report(
+	const char* what,
+	uint64_t    elapsed_ns )
+{
+	IPAINFO("%-4s %u entries: %llu ns/op, %llu ops/sec\n",
+			what,
+			NUM_MAP_ENTRIES,
+			(unsigned long long) (elapsed_ns / NUM_MAP_ENTRIES),
+			(unsigned long long) (elapsed_ns ?
+								  (NUM_MAP_ENTRIES * 1000000000ULL) / elapsed_ns :
+								  0));
+}
+
+int ipa_nat_test027(
+	const char* nat_mem_type,
+	u32 pub_ip_add,
+	int total_entries,
+	u32 tbl_hdl,
+	int sep,
+	void* arb_data_ptr)
+{
+	uint32_t* keys;
+	uint32_t  i, j, tmp, val;
+	uint64_t  start;
+
+	int ret = -1;
+
+	IPADBG("In\n");
+
+	keys = calloc(NUM_MAP_ENTRIES, sizeof(*keys));
+
+	if ( ! keys )
+	{
+		IPAERR("Unable to allocate %u keys\n", NUM_MAP_ENTRIES);
+		return -1;
+	}
+
+	/*
+	 * Keys look like rule handles, and are looked up and deleted in
+	 * a different order than they were added...
+	 */
+	for ( i = 0; i < NUM_MAP_ENTRIES; i++ )
+	{
+		keys[i] = (i << 1) | 1;
+	}
+
+	ipa_nat_map_clear(MAP_NUM_99);
+
+	if ( ipa_nat_map_reserve(MAP_NUM_99, NUM_MAP_ENTRIES) )
+	{
+		IPAERR("ipa_nat_map_reserve() failed\n");
+		goto bail;
+	}
+
+	start = now_ns();
+
+	for ( i = 0; i < NUM_MAP_ENTRIES; i++ )
+	{
+		if ( ipa_nat_map_add(MAP_NUM_99, keys[i], ~keys[i]) )
+		{
+			IPAERR("ipa_nat_map_add(key(%u)) failed\n", keys[i]);
+			goto bail;
+		}
+	}
+
+	report("add", now_ns() - start);
+
+	for ( i = NUM_MAP_ENTRIES - 1; i > 0; i-- )
+	{
+		j       = rand() % (i + 1);
+		tmp     = keys[i];
+		keys[i] = keys[j];
+		keys[j] = tmp;
+	}
+
+	start = now_ns();
+
+	for ( i = 0; i < NUM_MAP_ENTRIES; i++ )
+	{
+		if ( ipa_nat_map_find(MAP_NUM_99, keys[i], &val) || val != ~keys[i] )
+		{
+			IPAERR("ipa_nat_map_find(key(%u)) failed\n", keys[i]);
+			goto bail;
+		}
+	}
+
+	report("find", now_ns() - start);
+
+	start = now_ns();
+
+	for ( i = 0; i < NUM_MAP_ENTRIES; i++ )
+	{
+		if ( ipa_nat_map_del(MAP_NUM_99, keys[i], &val) || val != ~keys[i] )
+		{
+			IPAERR("ipa_nat_map_del(key(%u)) failed\n", keys[i]);
+			goto bail;
+		}
+	}
+
+	report("del", now_ns() - start);
+
+	if ( ipa_nat_map_find(MAP_NUM_99, keys[0], NULL) == 0 )
+	{
+		IPAERR("key(%u) still in map after delete\n", keys[0]);
+		goto bail;
+	}
+
+	ret = 0;
+
+bail:
+	ipa_nat_map_clear(MAP_NUM_99);
+
+	free(keys);
+
+	IPADBG("Out\n");
+
+	return ret;
+}
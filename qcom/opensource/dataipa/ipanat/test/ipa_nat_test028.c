@@ -0,0 +1,216 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+/*=========================================================================*/
+/*!
+	@file
+	ipa_nat_test028.c
+
+	@brief
+	Verify the following scenario:
+	1. Add ipv4 table
+	2. Add ipv4 rules till filled
+	3. Time querying each rule's timestamp one call at a time
+	4. Time querying all rules' timestamps with one bulk call
+	5. Verify the bulk call returned every rule and the same timestamps
+	6. Verify idle filtering excludes rules accessed at "now"
+	7. Delete ipv4 rules and table
+*/
+/*=========================================================================*/
+
+#include "ipa_nat_test.h"
+
+static inline uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+int ipa_nat_test028(
+	const char* nat_mem_type,
+	u32 pub_ip_add,
+	int total_entries,
+	u32 tbl_hdl,
+	int sep,
+	void* arb_data_ptr)
+{
+	int* tbl_hdl_ptr = (int*) arb_data_ptr;
+
+	ipa_nat_ipv4_rule    ipv4_rule;
+	ipa_nati_tbl_stats   nstats, istats;
+
+	u32*                 rule_hdls = NULL;
+	u32*                 tstamps   = NULL;
+	ipa_nat_rule_tstamp* entries   = NULL;
+
+	u32                  i, j, tot, max_rules, num_entries;
+	uint64_t             start, single_ns, bulk_ns;
+
+	int ret;
+
+	IPADBG("In\n");
+
+	if ( sep )
+	{
+		ret = ipa_nat_add_ipv4_tbl(pub_ip_add, nat_mem_type, total_entries, &tbl_hdl);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	ret = ipa_nati_clear_ipv4_tbl(tbl_hdl);
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	ret = ipa_nati_ipv4_tbl_stats(tbl_hdl, &nstats, &istats);
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	max_rules = nstats.tot_ents;
+
+	rule_hdls = calloc(max_rules, sizeof(*rule_hdls));
+	tstamps   = calloc(max_rules, sizeof(*tstamps));
+	entries   = calloc(max_rules, sizeof(*entries));
+
+	if ( ! rule_hdls || ! tstamps || ! entries )
+	{
+		IPAERR("Unable to allocate for %u rules\n", max_rules);
+		ret = -1;
+		goto bail;
+	}
+
+	for ( tot = 0; tot < max_rules; tot++ )
+	{
+		memset(&ipv4_rule, 0, sizeof(ipv4_rule));
+
+		ipv4_rule.protocol     = IPPROTO_TCP;
+		ipv4_rule.public_port  = RAN_PORT;
+		ipv4_rule.target_ip    = RAN_ADDR;
+		ipv4_rule.target_port  = RAN_PORT;
+		ipv4_rule.private_ip   = RAN_ADDR;
+		ipv4_rule.private_port = RAN_PORT;
+
+		if ( ipa_nat_add_ipv4_rule(tbl_hdl, &ipv4_rule, &rule_hdls[tot]) )
+		{
+			break;
+		}
+	}
+
+	IPAINFO("Added (%u) rules\n", tot);
+
+	start = now_ns();
+
+	for ( i = 0; i < tot; i++ )
+	{
+		ret = ipa_nat_query_timestamp(tbl_hdl, rule_hdls[i], &tstamps[i]);
+
+		if ( ret )
+		{
+			IPAERR("ipa_nat_query_timestamp(rule_hdl(%u)) failed\n", rule_hdls[i]);
+			goto del;
+		}
+	}
+
+	single_ns = now_ns() - start;
+
+	start = now_ns();
+
+	ret = ipa_nat_query_timestamps(tbl_hdl, 0, 0, entries, max_rules, &num_entries);
+
+	bulk_ns = now_ns() - start;
+
+	if ( ret )
+	{
+		IPAERR("ipa_nat_query_timestamps() failed (%d)\n", ret);
+		goto del;
+	}
+
+	IPAINFO("Per rule queries: %llu ns total, %llu ns/rule\n",
+			(unsigned long long) single_ns,
+			(unsigned long long) (tot ? single_ns / tot : 0));
+
+	IPAINFO("Bulk query:       %llu ns total, %llu ns/rule\n",
+			(unsigned long long) bulk_ns,
+			(unsigned long long) (num_entries ? bulk_ns / num_entries : 0));
+
+	ret = -1;
+
+	if ( num_entries != tot )
+	{
+		IPAERR("Bulk query returned (%u) rules, expected (%u)\n", num_entries, tot);
+		goto del;
+	}
+
+	for ( i = 0; i < num_entries; i++ )
+	{
+		for ( j = 0; j < tot && rule_hdls[j] != entries[i].rule_hdl; j++ );
+
+		if ( j == tot )
+		{
+			IPAERR("Bulk query returned unknown rule_hdl(%u)\n", entries[i].rule_hdl);
+			goto del;
+		}
+
+		if ( tstamps[j] != entries[i].time_stamp )
+		{
+			IPAERR("rule_hdl(%u) time_stamp bulk(0x%06X) single(0x%06X)\n",
+				   entries[i].rule_hdl, entries[i].time_stamp, tstamps[j]);
+			goto del;
+		}
+	}
+
+	if ( num_entries )
+	{
+		u32 now = entries[0].time_stamp;
+		u32 num_idle;
+
+		if ( ipa_nat_query_timestamps(tbl_hdl, now, 1, entries, max_rules, &num_idle) )
+		{
+			IPAERR("ipa_nat_query_timestamps(idle) failed\n");
+			goto del;
+		}
+
+		for ( i = 0; i < num_idle; i++ )
+		{
+			if ( entries[i].time_stamp == now )
+			{
+				IPAERR("rule_hdl(%u) accessed at now, yet reported idle\n",
+					   entries[i].rule_hdl);
+				goto del;
+			}
+		}
+
+		IPAINFO("Rules idle relative to (0x%06X): (%u)\n", now, num_idle);
+	}
+
+	ret = 0;
+
+del:
+	for ( i = 0; i < tot; i++ )
+	{
+		if ( ipa_nat_del_ipv4_rule(tbl_hdl, rule_hdls[i]) )
+		{
+			IPAERR("ipa_nat_del_ipv4_rule(rule_hdl(%u)) failed\n", rule_hdls[i]);
+			ret = -1;
+		}
+	}
+
+bail:
+	free(rule_hdls);
+	free(tstamps);
+	free(entries);
+
+	if ( ret )
+	{
+		return ret;
+	}
+
+	if ( sep )
+	{
+		ret = ipa_nat_del_ipv4_tbl(tbl_hdl);
+		*tbl_hdl_ptr = 0;
+		CHECK_ERR(ret);
+	}
+
+	IPADBG("Out\n");
+
+	return 0;
+}
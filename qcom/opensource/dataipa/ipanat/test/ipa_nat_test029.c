@@ -0,0 +1,200 @@
+/* SPDX-License-Identifier: BSD-3-Clause */
+
+/*=========================================================================*/
+/*!
+	@file
+	ipa_nat_test029.c
+
+	@brief
+	Verify the following scenario:
+	1. Add ipv4 table
+	2. Have table switches copy a few rules per step
+	3. Add ipv4 rules till filled, timing each add
+	4. Run any in progress table switch to completion
+	5. Verify every rule can still be found
+	6. Delete every other rule, timing each delete, then run any
+	   in progress table switch to completion
+	7. Delete the remaining ipv4 rules and table
+*/
+/*=========================================================================*/
+
+#include "ipa_nat_test.h"
+
+#define MIG_RULES_PER_STEP 16
+
+static inline uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+
+	return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static int finish_migration(
+	u32* steps_ptr )
+{
+	int ret;
+
+	while ( (ret = ipa_nat_migrate_step()) > 0 )
+	{
+		(*steps_ptr)++;
+	}
+
+	return ret;
+}
+
+int ipa_nat_test029(
+	const char* nat_mem_type,
+	u32 pub_ip_add,
+	int total_entries,
+	u32 tbl_hdl,
+	int sep,
+	void* arb_data_ptr)
+{
+	int* tbl_hdl_ptr = (int*) arb_data_ptr;
+
+	ipa_nat_ipv4_rule ipv4_rule;
+
+	u32*              rule_hdls = NULL;
+	bool*             deleted   = NULL;
+
+	u32               i, tot, time_stamp, steps = 0;
+	uint64_t          start, elapsed, add_max = 0, del_max = 0;
+
+	int ret;
+
+	IPADBG("In\n");
+
+	if ( sep )
+	{
+		ret = ipa_nat_add_ipv4_tbl(pub_ip_add, nat_mem_type, total_entries, &tbl_hdl);
+		CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+	}
+
+	ret = ipa_nat_set_migration_step(MIG_RULES_PER_STEP);
+	CHECK_ERR_TBL_STOP(ret, tbl_hdl);
+
+	rule_hdls = calloc(total_entries, sizeof(*rule_hdls));
+	deleted   = calloc(total_entries, sizeof(*deleted));
+
+	if ( ! rule_hdls || ! deleted )
+	{
+		IPAERR("Unable to allocate for %d rules\n", total_entries);
+		ret = -1;
+		goto bail;
+	}
+
+	for ( tot = 0; tot < (u32) total_entries; tot++ )
+	{
+		memset(&ipv4_rule, 0, sizeof(ipv4_rule));
+
+		ipv4_rule.protocol     = IPPROTO_TCP;
+		ipv4_rule.public_port  = RAN_PORT;
+		ipv4_rule.target_ip    = RAN_ADDR;
+		ipv4_rule.target_port  = RAN_PORT;
+		ipv4_rule.private_ip   = RAN_ADDR;
+		ipv4_rule.private_port = RAN_PORT;
+
+		start = now_ns();
+
+		if ( ipa_nat_add_ipv4_rule(tbl_hdl, &ipv4_rule, &rule_hdls[tot]) )
+		{
+			break;
+		}
+
+		elapsed = now_ns() - start;
+
+		if ( elapsed > add_max )
+		{
+			add_max = elapsed;
+		}
+	}
+
+	IPAINFO("Added (%u) rules, slowest add %llu ns\n",
+			tot, (unsigned long long) add_max);
+
+	ret = finish_migration(&steps);
+
+	if ( ret )
+	{
+		IPAERR("ipa_nat_migrate_step() failed (%d)\n", ret);
+		goto del;
+	}
+
+	for ( i = 0; i < tot; i++ )
+	{
+		ret = ipa_nat_query_timestamp(tbl_hdl, rule_hdls[i], &time_stamp);
+
+		if ( ret )
+		{
+			IPAERR("rule_hdl(%u) lost after table switch\n", rule_hdls[i]);
+			goto del;
+		}
+	}
+
+	for ( i = 0; i < tot; i += 2 )
+	{
+		start = now_ns();
+
+		ret = ipa_nat_del_ipv4_rule(tbl_hdl, rule_hdls[i]);
+
+		elapsed = now_ns() - start;
+
+		if ( ret )
+		{
+			IPAERR("ipa_nat_del_ipv4_rule(rule_hdl(%u)) failed\n", rule_hdls[i]);
+			goto del;
+		}
+
+		deleted[i] = true;
+
+		if ( elapsed > del_max )
+		{
+			del_max = elapsed;
+		}
+	}
+
+	ret = finish_migration(&steps);
+
+	if ( ret )
+	{
+		IPAERR("ipa_nat_migrate_step() failed (%d)\n", ret);
+		goto del;
+	}
+
+	IPAINFO("Slowest delete %llu ns, (%u) explicit migration steps\n",
+			(unsigned long long) del_max, steps);
+
+del:
+	for ( i = 0; i < tot; i++ )
+	{
+		if ( ! deleted[i] && ipa_nat_del_ipv4_rule(tbl_hdl, rule_hdls[i]) )
+		{
+			IPAERR("ipa_nat_del_ipv4_rule(rule_hdl(%u)) failed\n", rule_hdls[i]);
+			ret = -1;
+		}
+	}
+
+bail:
+	free(rule_hdls);
+	free(deleted);
+
+	ipa_nat_set_migration_step(0);
+
+	if ( ret )
+	{
+		return ret;
+	}
+
+	if ( sep )
+	{
+		ret = ipa_nat_del_ipv4_tbl(tbl_hdl);
+		*tbl_hdl_ptr = 0;
+		CHECK_ERR(ret);
+	}
+
+	IPADBG("Out\n");
+
+	return 0;
+}
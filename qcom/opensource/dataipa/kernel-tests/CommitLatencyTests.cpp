@@ -0,0 +1,459 @@
+/* SPDX-License-Identifier: BSD-3-Clause-Clear */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <time.h>
+
+#include "Constants.h"
+#include "Logger.h"
+#include "TestsUtils.h"
+#include "linux/msm_ipa.h"
+#include "RoutingDriverWrapper.h"
+#include "Filtering.h"
+
+#define COMMIT_LATENCY_RT_TBL_NAME "CommitLatency"
+#define COMMIT_LATENCY_MAX_RT_RULES (128)
+#define COMMIT_LATENCY_MAX_FLT_RULES (64)
+#define COMMIT_LATENCY_BUCKETS (4)
+
+extern Logger g_Logger;
+
+/*
+ * Latency of the add/del ioctls, each committing a single rule, bucketed
+ * by the number of rules already in the table:
+ * 1-16, 17-32, 33-64 and 65-128.
+ */
+class CommitLatencyStats
+{
+public:
+	CommitLatencyStats(const char *name) : m_name(name)
+	{
+		memset(m_sumUs, 0, sizeof(m_sumUs));
+		memset(m_maxUs, 0, sizeof(m_maxUs));
+		memset(m_count, 0, sizeof(m_count));
+	}
+
+	static uint64_t NowUs()
+	{
+		struct timespec ts;
+
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+	}
+
+	void Add(unsigned int numRules, uint64_t us)
+	{
+		int bucket = Bucket(numRules);
+
+		m_sumUs[bucket] += us;
+		m_count[bucket]++;
+		if (us > m_maxUs[bucket])
+			m_maxUs[bucket] = us;
+	}
+
+	void Print()
+	{
+		static const unsigned int lo[COMMIT_LATENCY_BUCKETS] = {1, 17, 33, 65};
+		static const unsigned int hi[COMMIT_LATENCY_BUCKETS] = {16, 32, 64, 128};
+
+		for (int i = 0; i < COMMIT_LATENCY_BUCKETS; i++) {
+			if (!m_count[i])
+				continue;
+			printf("%-10s rules %3u-%3u: %3u commits, avg %6llu us, max %6llu us\n",
+				m_name, lo[i], hi[i], m_count[i],
+				(unsigned long long)(m_sumUs[i] / m_count[i]),
+				(unsigned long long)m_maxUs[i]);
+		}
+	}
+
+private:
+	static int Bucket(unsigned int numRules)
+	{
+		if (numRules <= 16)
+			return 0;
+		if (numRules <= 32)
+			return 1;
+		if (numRules <= 64)
+			return 2;
+		return 3;
+	}
+
+	const char *m_name;
+	uint64_t m_sumUs[COMMIT_LATENCY_BUCKETS];
+	uint64_t m_maxUs[COMMIT_LATENCY_BUCKETS];
+	unsigned int m_count[COMMIT_LATENCY_BUCKETS];
+};
+
+class CommitLatencyTestFixture : public TestBase
+{
+public:
+	CommitLatencyTestFixture() :
+		m_IpaIPType(IPA_IP_v4),
+		m_numRtRules(0),
+		m_numFltRules(0)
+	{
+		memset(m_rtRuleHdl, 0, sizeof(m_rtRuleHdl));
+		memset(m_fltRuleHdl, 0, sizeof(m_fltRuleHdl));
+		m_testSuiteName.push_back("CommitLatency");
+		m_runInRegression = false;
+	}
+
+	static int SetupKernelModule()
+	{
+		struct ipa_channel_config from_ipa_channels[1];
+		struct test_ipa_ep_cfg from_ipa_cfg[1];
+		struct ipa_channel_config to_ipa_channels[1];
+		struct test_ipa_ep_cfg to_ipa_cfg[1];
+
+		struct ipa_test_config_header header = {0};
+		struct ipa_channel_config *to_ipa_array[1];
+		struct ipa_channel_config *from_ipa_array[1];
+
+		/* From ipa configurations - 1 pipe */
+		memset(&from_ipa_cfg[0], 0, sizeof(from_ipa_cfg[0]));
+		prepare_channel_struct(&from_ipa_channels[0],
+				header.from_ipa_channels_num++,
+				IPA_CLIENT_TEST2_CONS,
+				(void *)&from_ipa_cfg[0],
+				sizeof(from_ipa_cfg[0]));
+		from_ipa_array[0] = &from_ipa_channels[0];
+
+		/* To ipa configurations - 1 pipe */
+		memset(&to_ipa_cfg[0], 0, sizeof(to_ipa_cfg[0]));
+		prepare_channel_struct(&to_ipa_channels[0],
+				header.to_ipa_channels_num++,
+				IPA_CLIENT_TEST_PROD,
+				(void *)&to_ipa_cfg[0],
+				sizeof(to_ipa_cfg[0]));
+		to_ipa_array[0] = &to_ipa_channels[0];
+
+		prepare_header_struct(&header, from_ipa_array, to_ipa_array);
+
+		return GenericConfigureScenario(&header);
+	}
+
+	bool Setup()
+	{
+		if (!SetupKernelModule())
+			return false;
+
+		if (!m_routing.DeviceNodeIsOpened()) {
+			printf("Routing block is not ready for immediate commands!\n");
+			return false;
+		}
+		if (!m_filtering.DeviceNodeIsOpened()) {
+			printf("Filtering block is not ready for immediate commands!\n");
+			return false;
+		}
+		m_filtering.Reset(m_IpaIPType);
+		m_routing.Reset(m_IpaIPType);
+
+		return true;
+	}
+
+	bool Teardown()
+	{
+		m_filtering.Reset(m_IpaIPType);
+		m_routing.Reset(m_IpaIPType);
+
+		return true;
+	}
+
+	bool Run()
+	{
+		CommitLatencyStats rtAdd("rt add");
+		CommitLatencyStats fltAdd("flt add");
+		CommitLatencyStats fltDel("flt del");
+		CommitLatencyStats rtDel("rt del");
+		struct ipa_ioc_get_rt_tbl rtTbl;
+		bool res = true;
+
+		/* the first rule is the default route and is not timed */
+		if (!AddRtRule(0, NULL)) {
+			printf("Failed adding the default routing rule.\n");
+			return false;
+		}
+
+		while (m_numRtRules < COMMIT_LATENCY_MAX_RT_RULES) {
+			uint64_t us;
+
+			if (!AddRtRule(m_numRtRules, &us)) {
+				printf("Routing rule %u addition failed, stopping.\n",
+					m_numRtRules);
+				break;
+			}
+			rtAdd.Add(m_numRtRules, us);
+		}
+
+		memset(&rtTbl, 0, sizeof(rtTbl));
+		rtTbl.ip = m_IpaIPType;
+		strlcpy(rtTbl.name, COMMIT_LATENCY_RT_TBL_NAME, sizeof(rtTbl.name));
+		if (!m_routing.GetRoutingTable(&rtTbl)) {
+			printf("Failed getting routing table handle.\n");
+			res = false;
+			goto del_rt;
+		}
+
+		while (m_numFltRules < COMMIT_LATENCY_MAX_FLT_RULES) {
+			uint64_t us;
+
+			if (!AddFltRule(rtTbl.hdl, &us)) {
+				printf("Filtering rule %u addition failed, stopping.\n",
+					m_numFltRules);
+				break;
+			}
+			fltAdd.Add(m_numFltRules, us);
+		}
+
+		while (m_numFltRules) {
+			uint64_t us;
+			unsigned int numRules = m_numFltRules;
+
+			if (!DelFltRule(&us)) {
+				printf("Filtering rule deletion failed.\n");
+				res = false;
+				break;
+			}
+			fltDel.Add(numRules, us);
+		}
+		m_routing.PutRoutingTable(rtTbl.hdl);
+
+del_rt:
+		/* the default route goes with the table at Teardown() */
+		while (m_numRtRules > 1) {
+			uint64_t us;
+			unsigned int numRules = m_numRtRules;
+
+			if (!DelRtRule(&us)) {
+				printf("Routing rule deletion failed.\n");
+				res = false;
+				break;
+			}
+			rtDel.Add(numRules, us);
+		}
+
+		printf("Commit latency, IP type %d:\n", m_IpaIPType);
+		rtAdd.Print();
+		fltAdd.Print();
+		fltDel.Print();
+		rtDel.Print();
+
+		return res;
+	}
+
+protected:
+	/* Rule @idx matches destination address <base> + @idx, 0 is default */
+	void SetDstAddr(struct ipa_rule_attrib *attrib, unsigned int idx)
+	{
+		if (!idx)
+			return;
+
+		attrib->attrib_mask = IPA_FLT_DST_ADDR;
+		if (m_IpaIPType == IPA_IP_v4) {
+			attrib->u.v4.dst_addr = 0xC0A80100 + idx;
+			attrib->u.v4.dst_addr_mask = 0xFFFFFFFF;
+		} else {
+			attrib->u.v6.dst_addr[0] = 0x20010DB8;
+			attrib->u.v6.dst_addr[3] = idx;
+			memset(attrib->u.v6.dst_addr_mask, 0xFF,
+				sizeof(attrib->u.v6.dst_addr_mask));
+		}
+	}
+
+	bool AddRtRule(unsigned int idx, uint64_t *us)
+	{
+		struct ipa_ioc_add_rt_rule *rt_rule;
+		struct ipa_rt_rule_add *rt_rule_entry;
+		uint64_t start;
+		bool res;
+
+		rt_rule = (struct ipa_ioc_add_rt_rule *)
+			calloc(1, sizeof(struct ipa_ioc_add_rt_rule) +
+			       sizeof(struct ipa_rt_rule_add));
+		if (!rt_rule) {
+			printf("Failed memory allocation for rt_rule\n");
+			return false;
+		}
+
+		rt_rule->commit = 1;
+		rt_rule->num_rules = 1;
+		rt_rule->ip = m_IpaIPType;
+		strlcpy(rt_rule->rt_tbl_name, COMMIT_LATENCY_RT_TBL_NAME,
+			sizeof(rt_rule->rt_tbl_name));
+
+		rt_rule_entry = &rt_rule->rules[0];
+		rt_rule_entry->at_rear = 0;
+		rt_rule_entry->rule.dst = IPA_CLIENT_TEST2_CONS;
+		SetDstAddr(&rt_rule_entry->rule.attrib, idx);
+
+		start = CommitLatencyStats::NowUs();
+		res = m_routing.AddRoutingRule(rt_rule) &&
+			!rt_rule_entry->status;
+		if (us)
+			*us = CommitLatencyStats::NowUs() - start;
+		if (res)
+			m_rtRuleHdl[m_numRtRules++] = rt_rule_entry->rt_rule_hdl;
+
+		free(rt_rule);
+		return res;
+	}
+
+	bool DelRtRule(uint64_t *us)
+	{
+		struct ipa_ioc_del_rt_rule *ruleTable;
+		uint64_t start;
+		bool res;
+
+		ruleTable = (struct ipa_ioc_del_rt_rule *)
+			calloc(1, sizeof(struct ipa_ioc_del_rt_rule) +
+			       sizeof(struct ipa_rt_rule_del));
+		if (!ruleTable) {
+			printf("Failed memory allocation for ruleTable\n");
+			return false;
+		}
+
+		ruleTable->commit = 1;
+		ruleTable->ip = m_IpaIPType;
+		ruleTable->num_hdls = 1;
+		ruleTable->hdl[0].hdl = m_rtRuleHdl[m_numRtRules - 1];
+
+		start = CommitLatencyStats::NowUs();
+		res = m_routing.DeleteRoutingRule(ruleTable) &&
+			!ruleTable->hdl[0].status;
+		*us = CommitLatencyStats::NowUs() - start;
+		if (res)
+			m_numRtRules--;
+
+		free(ruleTable);
+		return res;
+	}
+
+	bool AddFltRule(uint32_t rtTblHdl, uint64_t *us)
+	{
+		struct ipa_ioc_add_flt_rule *flt_rule;
+		struct ipa_flt_rule_add *flt_rule_entry;
+		uint64_t start;
+		bool res;
+
+		flt_rule = (struct ipa_ioc_add_flt_rule *)
+			calloc(1, sizeof(struct ipa_ioc_add_flt_rule) +
+			       sizeof(struct ipa_flt_rule_add));
+		if (!flt_rule) {
+			printf("Failed memory allocation for flt_rule\n");
+			return false;
+		}
+
+		flt_rule->commit = 1;
+		flt_rule->ip = m_IpaIPType;
+		flt_rule->ep = IPA_CLIENT_TEST_PROD;
+		flt_rule->global = 0;
+		flt_rule->num_rules = 1;
+
+		flt_rule_entry = &flt_rule->rules[0];
+		flt_rule_entry->at_rear = 1;
+		flt_rule_entry->rule.action = IPA_PASS_TO_ROUTING;
+		flt_rule_entry->rule.rt_tbl_hdl = rtTblHdl;
+		SetDstAddr(&flt_rule_entry->rule.attrib, m_numFltRules + 1);
+
+		start = CommitLatencyStats::NowUs();
+		res = m_filtering.AddFilteringRule(flt_rule) &&
+			!flt_rule_entry->status;
+		*us = CommitLatencyStats::NowUs() - start;
+		if (res)
+			m_fltRuleHdl[m_numFltRules++] = flt_rule_entry->flt_rule_hdl;
+
+		free(flt_rule);
+		return res;
+	}
+
+	bool DelFltRule(uint64_t *us)
+	{
+		struct ipa_ioc_del_flt_rule *ruleTable;
+		uint64_t start;
+		bool res;
+
+		ruleTable = (struct ipa_ioc_del_flt_rule *)
+			calloc(1, sizeof(struct ipa_ioc_del_flt_rule) +
+			       sizeof(struct ipa_flt_rule_del));
+		if (!ruleTable) {
+			printf("Failed memory allocation for ruleTable\n");
+			return false;
+		}
+
+		ruleTable->commit = 1;
+		ruleTable->ip = m_IpaIPType;
+		ruleTable->num_hdls = 1;
+		ruleTable->hdl[0].hdl = m_fltRuleHdl[m_numFltRules - 1];
+
+		start = CommitLatencyStats::NowUs();
+		res = m_filtering.DeleteFilteringRule(ruleTable) &&
+			!ruleTable->hdl[0].status;
+		*us = CommitLatencyStats::NowUs() - start;
+		if (res)
+			m_numFltRules--;
+
+		free(ruleTable);
+		return res;
+	}
+
+	static RoutingDriverWrapper m_routing;
+	static Filtering m_filtering;
+
+	enum ipa_ip_type m_IpaIPType;
+	uint32_t m_rtRuleHdl[COMMIT_LATENCY_MAX_RT_RULES + 1];
+	uint32_t m_fltRuleHdl[COMMIT_LATENCY_MAX_FLT_RULES];
+	unsigned int m_numRtRules;
+	unsigned int m_numFltRules;
+};
+
+RoutingDriverWrapper CommitLatencyTestFixture::m_routing;
+Filtering CommitLatencyTestFixture::m_filtering;
+
+/*---------------------------------------------------------------------------*/
+/* Test001: IPv4 rt/flt commit latency against the number of rules          */
+/*---------------------------------------------------------------------------*/
+class CommitLatencyTest001 : public CommitLatencyTestFixture
+{
+public:
+	CommitLatencyTest001()
+	{
+		m_name = "CommitLatencyTest001";
+		m_description = "\
+		Commit latency test 001 - IPv4 \
+		1. Add routing rules one at a time, committing each, to a single \
+		   routing table and time each commit. \
+		2. Add filtering rules to IPA_CLIENT_TEST_PROD one at a time, \
+		   pointing to that table, and time each commit. \
+		3. Delete the rules one at a time and time each commit. \
+		4. Print the average and maximal latency per number of rules.";
+		m_IpaIPType = IPA_IP_v4;
+		Register(*this);
+	}
+};
+
+/*---------------------------------------------------------------------------*/
+/* Test002: IPv6 rt/flt commit latency against the number of rules          */
+/*---------------------------------------------------------------------------*/
+class CommitLatencyTest002 : public CommitLatencyTestFixture
+{
+public:
+	CommitLatencyTest002()
+	{
+		m_name = "CommitLatencyTest002";
+		m_description = "\
+		Commit latency test 002 - IPv6 \
+		1. Add routing rules one at a time, committing each, to a single \
+		   routing table and time each commit. \
+		2. Add filtering rules to IPA_CLIENT_TEST_PROD one at a time, \
+		   pointing to that table, and time each commit. \
+		3. Delete the rules one at a time and time each commit. \
+		4. Print the average and maximal latency per number of rules.";
+		m_IpaIPType = IPA_IP_v6;
+		Register(*this);
+	}
+};
+
+static class CommitLatencyTest001 commitLatencyTest001;
+static class CommitLatencyTest002 commitLatencyTest002;
@@ -32,6 +32,7 @@
 #include <unistd.h>
 #include <string.h>
 #include <stdint.h>
+#include <time.h>
 #include "hton.h" /* for htonl*/
 #include "DataPathTestFixture.h"
 #include "Constants.h"
@@ -39,6 +40,9 @@
 #include "linux/msm_ipa.h"
 
 #define PACKET_SIZE ((10)*(4))
+#define PERF_MAX_PACKET_SIZE (1400)
+#define PERF_BURST (10)
+#define PERF_LOOPS (200)
 
 class IpaTxDpTest:public DataPathTestFixture {
 
@@ -384,8 +388,99 @@ fail:
 	}
 };
 
+/*
+ * Per packet cost of the USB_PROD to apps path, which goes through the LAN
+ * RX status parsing, for small, medium and MTU sized packets. Each loop
+ * sends a burst so that several packets share an aggregation buffer.
+ */
+class IPAToAppsPerfTest:public DataPathTestFixture {
+
+public:
+	IPAToAppsPerfTest() {
+		m_name = "IPAToAppsPerfTest";
+		m_description = "Sending bursts of SKBs of several sizes via"
+				" USB_PROD pipe and reporting the time per packet";
+		m_runInRegression = false;
+	}
+
+	static uint64_t NowNs()
+	{
+		struct timespec ts;
+
+		clock_gettime(CLOCK_MONOTONIC, &ts);
+		return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+	}
+
+	bool RunSize(size_t size, unsigned char *input, unsigned char *output)
+	{
+		uint64_t start, total = 0;
+		int i, j, ret;
+
+		for (i = 0; i < PERF_LOOPS; i++) {
+			start = NowNs();
+			for (j = 0; j < PERF_BURST; j++) {
+				input[0] = i;
+				input[1] = j;
+				ret = m_ToIpaPipe.Send(input, size);
+				if (ret != (int)size) {
+					LOG_MSG_ERROR("Sent %d bytes instead of %zu\n",
+						ret, size);
+					return false;
+				}
+			}
+
+			for (j = 0; j < PERF_BURST; j++) {
+				input[0] = i;
+				input[1] = j;
+				ret = m_IpaDriverPipe.Receive(output, size);
+				if (ret != 0) {
+					LOG_MSG_ERROR("Failed in reading buffer. %d error", ret);
+					return false;
+				}
+				if (memcmp(input, output, size)) {
+					LOG_MSG_ERROR("Failed in buffers comparison");
+					return false;
+				}
+			}
+			total += NowNs() - start;
+		}
+
+		printf("%4zu bytes: %d packets, avg %6llu ns per packet\n", size,
+			PERF_LOOPS * PERF_BURST,
+			(unsigned long long)(total / (PERF_LOOPS * PERF_BURST)));
+
+		return true;
+	}
+
+	bool TestLogic() {
+		const size_t sizes[] = { 64, 512, PERF_MAX_PACKET_SIZE };
+		unsigned char *input, *output;
+		bool res = true;
+		size_t i;
+
+		input = (unsigned char *)malloc(PERF_MAX_PACKET_SIZE);
+		output = (unsigned char *)malloc(PERF_MAX_PACKET_SIZE);
+		if (!input || !output) {
+			LOG_MSG_ERROR("Error in allocation\n");
+			free(input);
+			free(output);
+			return false;
+		}
+
+		for (i = 0; i < PERF_MAX_PACKET_SIZE; i++)
+			input[i] = i & 0xFF;
+
+		for (i = 0; res && i < sizeof(sizes) / sizeof(sizes[0]); i++)
+			res = RunSize(sizes[i], input, output);
+
+		free(input);
+		free(output);
+		return res;
+	}
+};
 
 static IpaTxDpTest ipaTxDpTest;
 static IpaTxDpMultipleTest ipaTxDpMultipleTest;
 static IPAToAppsTest ipaToApps;
 static IPAToAppsMultipleTest iPAToAppsMultipleTestApps;
+static IPAToAppsPerfTest ipaToAppsPerfTest;
@@ -13,7 +13,10 @@
 
 #include <linux/log2.h>
 #include <linux/list.h>
+#include <linux/hash.h>
 #include <linux/hashtable.h>
+#include <linux/jiffies.h>
+#include <linux/slab.h>
 #include "rmnet_descriptor.h"
 #include "rmnet_module.h"
 #include "rmnet_offload_state.h"
@@ -23,18 +26,20 @@
 #include "rmnet_offload_udp.h"
 #include "rmnet_offload_stats.h"
 #include "rmnet_offload_knob.h"
-#define DATARMNET644a5e11da \
-	(const_ilog2(DATARMNET78d9393ac8))
-static DEFINE_HASHTABLE(DATARMNET4791268d67,DATARMNET644a5e11da);static u32 
-DATARMNET1993bae165(u8 DATARMNET06d2413ad2,struct list_head*DATARMNET6f9bfa17e6)
-{struct DATARMNETd7c9631acd*DATARMNET7c382e536d;int DATARMNETae0201901a;u32 
-DATARMNET737bbd41c3=(0xd2d+202-0xdf7);hash_for_each(DATARMNET4791268d67,
-DATARMNETae0201901a,DATARMNET7c382e536d,DATARMNETbd5d7d96d8){if(
-DATARMNET7c382e536d->DATARMNET1db11fa85e&&DATARMNET7c382e536d->
-DATARMNET78fd20ce0e.DATARMNET7fa8b2acbf==DATARMNET06d2413ad2){
-DATARMNET737bbd41c3++;DATARMNETa3055c21f2(DATARMNET7c382e536d,
-DATARMNET6f9bfa17e6);}}return DATARMNET737bbd41c3;}static bool 
-DATARMNET2013036d80(u8 DATARMNET06d2413ad2){u64 DATARMNET3924f3f9e3;
+static struct hlist_head*DATARMNETba65ede8c2(struct DATARMNET907d58c807*
+DATARMNETa6f73cbe10,u32 DATARMNET3f8cc6fc24){return&DATARMNETa6f73cbe10->
+DATARMNET70ee946782[hash_32(DATARMNET3f8cc6fc24,DATARMNETa6f73cbe10->
+DATARMNET5e730d125a)];}static u32 DATARMNET1993bae165(u8 DATARMNET06d2413ad2,
+struct list_head*DATARMNET6f9bfa17e6){struct DATARMNET70f3b87b5d*
+DATARMNETe05748b000=DATARMNETc2a630b113();struct DATARMNETd7c9631acd*
+DATARMNET7c382e536d,*DATARMNET0386f6f82a;u32 DATARMNET737bbd41c3=
+(0xd2d+202-0xdf7);if(!DATARMNETe05748b000)return(0xd2d+202-0xdf7);
+list_for_each_entry_safe(DATARMNET7c382e536d,DATARMNET0386f6f82a,&
+DATARMNETe05748b000->DATARMNETebb45c8d86.DATARMNET683f45ba3f,DATARMNET7576e4c419
+){if(DATARMNET7c382e536d->DATARMNET78fd20ce0e.DATARMNET7fa8b2acbf==
+DATARMNET06d2413ad2){DATARMNET737bbd41c3++;DATARMNETa3055c21f2(
+DATARMNET7c382e536d,DATARMNET6f9bfa17e6);}}return DATARMNET737bbd41c3;}static 
+bool DATARMNET2013036d80(u8 DATARMNET06d2413ad2){u64 DATARMNET3924f3f9e3;
 DATARMNET3924f3f9e3=DATARMNETf1d1b8287f(DATARMNET6d2ed4b822);if(
 DATARMNET3924f3f9e3==DATARMNET2d89680280)return true;if(DATARMNET3924f3f9e3==
 DATARMNET03daf91a60&&DATARMNET06d2413ad2==DATARMNETfd5c3d30e5)return true;if(
@@ -82,52 +87,117 @@ return true;}static struct DATARMNETd7c9631acd*DATARMNETd41def0046(void){struct
 DATARMNET70f3b87b5d*DATARMNETe05748b000=DATARMNETc2a630b113();struct 
 DATARMNET907d58c807*DATARMNETa6f73cbe10;struct DATARMNETd7c9631acd*
 DATARMNET6745427f98;LIST_HEAD(DATARMNET6f9bfa17e6);DATARMNETa6f73cbe10=&
-DATARMNETe05748b000->DATARMNETebb45c8d86;if(DATARMNETa6f73cbe10->
-DATARMNET8dfc11cccd<DATARMNET78d9393ac8){DATARMNET6745427f98=&
-DATARMNETa6f73cbe10->DATARMNET2846a01cce[DATARMNETa6f73cbe10->
-DATARMNET8dfc11cccd];DATARMNETa6f73cbe10->DATARMNET8dfc11cccd++;return 
-DATARMNET6745427f98;}DATARMNET6745427f98=&DATARMNETa6f73cbe10->
-DATARMNET2846a01cce[DATARMNETa6f73cbe10->DATARMNET57d435b225];
-DATARMNETa6f73cbe10->DATARMNET57d435b225++;DATARMNETa6f73cbe10->
-DATARMNET57d435b225%=DATARMNET78d9393ac8;hash_del(&DATARMNET6745427f98->
-DATARMNETbd5d7d96d8);if(DATARMNET6745427f98->DATARMNET1db11fa85e){
-DATARMNETa00cda79d0(DATARMNETf3f92fc0b9);DATARMNETa3055c21f2(DATARMNET6745427f98
-,&DATARMNET6f9bfa17e6);}DATARMNETc70e73c8d4(&DATARMNET6f9bfa17e6);return 
-DATARMNET6745427f98;}static void DATARMNETbe30d096c6(void){LIST_HEAD(
+DATARMNETe05748b000->DATARMNETebb45c8d86;if(!list_empty(&DATARMNETa6f73cbe10->
+DATARMNET6e2733388d)){DATARMNET6745427f98=list_first_entry(&DATARMNETa6f73cbe10
+->DATARMNET6e2733388d,struct DATARMNETd7c9631acd,DATARMNET3f4183c7aa);
+list_move_tail(&DATARMNET6745427f98->DATARMNET3f4183c7aa,&DATARMNETa6f73cbe10->
+DATARMNET60b9fe7c08);return DATARMNET6745427f98;}DATARMNET6745427f98=
+list_first_entry(&DATARMNETa6f73cbe10->DATARMNET60b9fe7c08,struct 
+DATARMNETd7c9631acd,DATARMNET3f4183c7aa);list_move_tail(&DATARMNET6745427f98->
+DATARMNET3f4183c7aa,&DATARMNETa6f73cbe10->DATARMNET60b9fe7c08);hash_del(&
+DATARMNET6745427f98->DATARMNETbd5d7d96d8);if(DATARMNET6745427f98->
+DATARMNET1db11fa85e){DATARMNETa00cda79d0(DATARMNETf3f92fc0b9);
+DATARMNETa3055c21f2(DATARMNET6745427f98,&DATARMNET6f9bfa17e6);}
+DATARMNETc70e73c8d4(&DATARMNET6f9bfa17e6);return DATARMNET6745427f98;}static 
+void DATARMNET497c6b1320(void){struct DATARMNET70f3b87b5d*DATARMNETe05748b000=
+DATARMNETc2a630b113();struct DATARMNET907d58c807*DATARMNETa6f73cbe10=&
+DATARMNETe05748b000->DATARMNETebb45c8d86;struct DATARMNETd7c9631acd*
+DATARMNETaa568481cf,*DATARMNET0386f6f82a;unsigned long DATARMNETec1dad6cb9;u64 
+DATARMNET09b48b099a;DATARMNET09b48b099a=DATARMNETf1d1b8287f(DATARMNET7a7e42d522)
+;if(!DATARMNET09b48b099a)return;DATARMNETec1dad6cb9=msecs_to_jiffies((unsigned 
+int)DATARMNET09b48b099a);list_for_each_entry_safe(DATARMNETaa568481cf,
+DATARMNET0386f6f82a,&DATARMNETa6f73cbe10->DATARMNET60b9fe7c08,
+DATARMNET3f4183c7aa){if(time_before(jiffies,DATARMNETaa568481cf->
+DATARMNETd2f7455d1a+DATARMNETec1dad6cb9))break;hash_del(&DATARMNETaa568481cf->
+DATARMNETbd5d7d96d8);list_move(&DATARMNETaa568481cf->DATARMNET3f4183c7aa,&
+DATARMNETa6f73cbe10->DATARMNET6e2733388d);DATARMNETa00cda79d0(
+DATARMNET3086847595);}}static void DATARMNETbe30d096c6(void){LIST_HEAD(
 DATARMNET6f9bfa17e6);DATARMNET664568fcd0();if(DATARMNETae70636c90(&
 DATARMNET6f9bfa17e6))DATARMNETa00cda79d0(DATARMNET5727f095ec);
-DATARMNET6a76048590();DATARMNETc70e73c8d4(&DATARMNET6f9bfa17e6);}static const 
-struct rmnet_module_hook_register_info DATARMNETcbc211d052={.hooknum=
-RMNET_MODULE_HOOK_OFFLOAD_CHAIN_END,.func=DATARMNETbe30d096c6,};void 
-DATARMNETd4230b6bfe(void){rcu_assign_pointer(rmnet_perf_chain_end,
-DATARMNETbe30d096c6);rmnet_module_hook_register(&DATARMNETcbc211d052,
-(0xd26+209-0xdf6));}void DATARMNET560e127137(void){rcu_assign_pointer(
-rmnet_perf_chain_end,NULL);rmnet_module_hook_unregister_no_sync(&
-DATARMNETcbc211d052,(0xd26+209-0xdf6));}int DATARMNET241493ab9a(u64 
-DATARMNET0470698d6c,u64 DATARMNETfeff65e096){LIST_HEAD(DATARMNET6f9bfa17e6);u32 
-DATARMNET737bbd41c3=(0xd2d+202-0xdf7);if(DATARMNET0470698d6c==
-DATARMNET5fe3af8828||DATARMNETfeff65e096==DATARMNET2d89680280)return
-(0xd2d+202-0xdf7);switch(DATARMNETfeff65e096){case DATARMNET03daf91a60:
-DATARMNET737bbd41c3=DATARMNET1993bae165(DATARMNETa656f324b2,&DATARMNET6f9bfa17e6
-);break;case DATARMNET88a9920663:DATARMNET737bbd41c3=DATARMNET1993bae165(
-DATARMNETfd5c3d30e5,&DATARMNET6f9bfa17e6);break;case DATARMNET5fe3af8828:
-DATARMNET737bbd41c3=DATARMNETae70636c90(&DATARMNET6f9bfa17e6);break;}
-DATARMNETbad3b5165e(DATARMNETddf572458d,DATARMNET737bbd41c3);DATARMNETc70e73c8d4
-(&DATARMNET6f9bfa17e6);return(0xd2d+202-0xdf7);}void DATARMNETa3055c21f2(struct 
-DATARMNETd7c9631acd*DATARMNETaa568481cf,struct list_head*DATARMNET6f9bfa17e6){
-struct DATARMNET70f3b87b5d*DATARMNETe05748b000=DATARMNETc2a630b113();struct 
-rmnet_frag_descriptor*DATARMNETd74aeaa49a,*DATARMNETa1625e27e2,*
-DATARMNET0386f6f82a;struct DATARMNET4287f07234*DATARMNET699c2c62cd=&
-DATARMNETaa568481cf->DATARMNET78fd20ce0e;u32 DATARMNET567bdc7221=
-DATARMNET699c2c62cd->DATARMNET4ca5ac9de1+DATARMNET699c2c62cd->
-DATARMNET0aeee57ceb;if(!DATARMNETaa568481cf->DATARMNET1db11fa85e)return;
-DATARMNETd74aeaa49a=list_first_entry(&DATARMNETaa568481cf->DATARMNETb76b79d0d5,
-struct rmnet_frag_descriptor,list);if(!DATARMNETd74aeaa49a->gso_segs)
-DATARMNETd74aeaa49a->gso_segs=(0xd26+209-0xdf6);DATARMNETd74aeaa49a->gso_size=
-DATARMNETaa568481cf->DATARMNET1978d5d8de;DATARMNETa1625e27e2=DATARMNETd74aeaa49a
-;list_for_each_entry_safe_continue(DATARMNETa1625e27e2,DATARMNET0386f6f82a,&
-DATARMNETaa568481cf->DATARMNETb76b79d0d5,list){u32 DATARMNET904423d5e4=
-DATARMNETa1625e27e2->len-DATARMNET567bdc7221;if(!
+DATARMNET497c6b1320();DATARMNET6a76048590();DATARMNETc70e73c8d4(&
+DATARMNET6f9bfa17e6);}static const struct rmnet_module_hook_register_info 
+DATARMNETcbc211d052={.hooknum=RMNET_MODULE_HOOK_OFFLOAD_CHAIN_END,.func=
+DATARMNETbe30d096c6,};static int DATARMNETc9b06f8206(struct DATARMNET907d58c807*
+DATARMNETa6f73cbe10,u32 DATARMNET320d1a1508,gfp_t DATARMNETb466ac8a9c){u8 
+DATARMNET5e730d125a=order_base_2(DATARMNET320d1a1508);DATARMNETa6f73cbe10->
+DATARMNET2846a01cce=kcalloc(DATARMNET320d1a1508,sizeof(*DATARMNETa6f73cbe10->
+DATARMNET2846a01cce),DATARMNETb466ac8a9c);DATARMNETa6f73cbe10->
+DATARMNET70ee946782=kcalloc((0xd26+209-0xdf6)<<DATARMNET5e730d125a,sizeof(*
+DATARMNETa6f73cbe10->DATARMNET70ee946782),DATARMNETb466ac8a9c);if(!
+DATARMNETa6f73cbe10->DATARMNET2846a01cce||!DATARMNETa6f73cbe10->
+DATARMNET70ee946782){kfree(DATARMNETa6f73cbe10->DATARMNET2846a01cce);kfree(
+DATARMNETa6f73cbe10->DATARMNET70ee946782);DATARMNETa6f73cbe10->
+DATARMNET2846a01cce=NULL;DATARMNETa6f73cbe10->DATARMNET70ee946782=NULL;return-
+ENOMEM;}DATARMNETa6f73cbe10->DATARMNET320d1a1508=DATARMNET320d1a1508;
+DATARMNETa6f73cbe10->DATARMNET5e730d125a=DATARMNET5e730d125a;return
+(0xd2d+202-0xdf7);}static void DATARMNETa75f138e88(struct DATARMNET907d58c807*
+DATARMNETa6f73cbe10){u32 DATARMNETefc9df3df2;INIT_LIST_HEAD(&DATARMNETa6f73cbe10
+->DATARMNET6e2733388d);INIT_LIST_HEAD(&DATARMNETa6f73cbe10->DATARMNET60b9fe7c08)
+;INIT_LIST_HEAD(&DATARMNETa6f73cbe10->DATARMNET683f45ba3f);for(
+DATARMNETefc9df3df2=(0xd2d+202-0xdf7);DATARMNETefc9df3df2<((0xd26+209-0xdf6)<<
+DATARMNETa6f73cbe10->DATARMNET5e730d125a);DATARMNETefc9df3df2++)INIT_HLIST_HEAD(
+&DATARMNETa6f73cbe10->DATARMNET70ee946782[DATARMNETefc9df3df2]);for(
+DATARMNETefc9df3df2=(0xd2d+202-0xdf7);DATARMNETefc9df3df2<DATARMNETa6f73cbe10->
+DATARMNET320d1a1508;DATARMNETefc9df3df2++){struct DATARMNETd7c9631acd*
+DATARMNETaa568481cf;DATARMNETaa568481cf=&DATARMNETa6f73cbe10->
+DATARMNET2846a01cce[DATARMNETefc9df3df2];INIT_LIST_HEAD(&DATARMNETaa568481cf->
+DATARMNETb76b79d0d5);INIT_LIST_HEAD(&DATARMNETaa568481cf->DATARMNET7576e4c419);
+INIT_HLIST_NODE(&DATARMNETaa568481cf->DATARMNETbd5d7d96d8);list_add_tail(&
+DATARMNETaa568481cf->DATARMNET3f4183c7aa,&DATARMNETa6f73cbe10->
+DATARMNET6e2733388d);}}void DATARMNETd4230b6bfe(void){rcu_assign_pointer(
+rmnet_perf_chain_end,DATARMNETbe30d096c6);rmnet_module_hook_register(&
+DATARMNETcbc211d052,(0xd26+209-0xdf6));}void DATARMNET560e127137(void){
+rcu_assign_pointer(rmnet_perf_chain_end,NULL);
+rmnet_module_hook_unregister_no_sync(&DATARMNETcbc211d052,(0xd26+209-0xdf6));}
+int DATARMNET241493ab9a(u64 DATARMNET0470698d6c,u64 DATARMNETfeff65e096){
+LIST_HEAD(DATARMNET6f9bfa17e6);u32 DATARMNET737bbd41c3=(0xd2d+202-0xdf7);if(
+DATARMNET0470698d6c==DATARMNET5fe3af8828||DATARMNETfeff65e096==
+DATARMNET2d89680280)return(0xd2d+202-0xdf7);switch(DATARMNETfeff65e096){case 
+DATARMNET03daf91a60:DATARMNET737bbd41c3=DATARMNET1993bae165(DATARMNETa656f324b2,
+&DATARMNET6f9bfa17e6);break;case DATARMNET88a9920663:DATARMNET737bbd41c3=
+DATARMNET1993bae165(DATARMNETfd5c3d30e5,&DATARMNET6f9bfa17e6);break;case 
+DATARMNET5fe3af8828:DATARMNET737bbd41c3=DATARMNETae70636c90(&DATARMNET6f9bfa17e6
+);break;}DATARMNETbad3b5165e(DATARMNETddf572458d,DATARMNET737bbd41c3);
+DATARMNETc70e73c8d4(&DATARMNET6f9bfa17e6);return(0xd2d+202-0xdf7);}int 
+DATARMNET0ec2d7dfdd(u64 DATARMNET0470698d6c,u64 DATARMNETfeff65e096){struct 
+DATARMNET70f3b87b5d*DATARMNETe05748b000=DATARMNETc2a630b113();struct 
+DATARMNET907d58c807 DATARMNETeefe75d3c0;LIST_HEAD(DATARMNET6f9bfa17e6);if(!
+DATARMNETe05748b000||!DATARMNETe05748b000->DATARMNETebb45c8d86.
+DATARMNET2846a01cce)return(0xd2d+202-0xdf7);if(DATARMNETc9b06f8206(&
+DATARMNETeefe75d3c0,(u32)DATARMNETfeff65e096,GFP_ATOMIC))return-ENOMEM;
+DATARMNETbad3b5165e(DATARMNETddf572458d,DATARMNETae70636c90(&DATARMNET6f9bfa17e6
+));DATARMNETb98b78b8e3();DATARMNETe05748b000->DATARMNETebb45c8d86.
+DATARMNET2846a01cce=DATARMNETeefe75d3c0.DATARMNET2846a01cce;DATARMNETe05748b000
+->DATARMNETebb45c8d86.DATARMNET70ee946782=DATARMNETeefe75d3c0.
+DATARMNET70ee946782;DATARMNETe05748b000->DATARMNETebb45c8d86.DATARMNET320d1a1508
+=DATARMNETeefe75d3c0.DATARMNET320d1a1508;DATARMNETe05748b000->
+DATARMNETebb45c8d86.DATARMNET5e730d125a=DATARMNETeefe75d3c0.DATARMNET5e730d125a;
+DATARMNETa75f138e88(&DATARMNETe05748b000->DATARMNETebb45c8d86);
+DATARMNETa00cda79d0(DATARMNET06c149c249);DATARMNETc70e73c8d4(&
+DATARMNET6f9bfa17e6);return(0xd2d+202-0xdf7);}void DATARMNETfb008bfe9e(struct 
+DATARMNET4287f07234*DATARMNET24e0357785,u32 DATARMNETb639f6e1b1){u32 
+DATARMNET09b48b099a=DATARMNETd771b3ac06;if(DATARMNET24e0357785->
+DATARMNET7fa8b2acbf==DATARMNETa656f324b2)DATARMNET09b48b099a+=(0xd11+230-0xdf3);
+else if(DATARMNET24e0357785->DATARMNET7fa8b2acbf!=DATARMNETfd5c3d30e5)return;if(
+DATARMNET24e0357785->DATARMNET388842c721==(0xd03+244-0xdf1))DATARMNET09b48b099a
++=(0xd1f+216-0xdf5);DATARMNETbad3b5165e(DATARMNET09b48b099a,DATARMNETb639f6e1b1)
+;DATARMNETa00cda79d0(DATARMNET09b48b099a+(0xd26+209-0xdf6));}void 
+DATARMNETa3055c21f2(struct DATARMNETd7c9631acd*DATARMNETaa568481cf,struct 
+list_head*DATARMNET6f9bfa17e6){struct DATARMNET70f3b87b5d*DATARMNETe05748b000=
+DATARMNETc2a630b113();struct rmnet_frag_descriptor*DATARMNETd74aeaa49a,*
+DATARMNETa1625e27e2,*DATARMNET0386f6f82a;struct DATARMNET4287f07234*
+DATARMNET699c2c62cd=&DATARMNETaa568481cf->DATARMNET78fd20ce0e;u32 
+DATARMNET567bdc7221=DATARMNET699c2c62cd->DATARMNET4ca5ac9de1+DATARMNET699c2c62cd
+->DATARMNET0aeee57ceb;if(!DATARMNETaa568481cf->DATARMNET1db11fa85e)return;
+list_del_init(&DATARMNETaa568481cf->DATARMNET7576e4c419);DATARMNETfb008bfe9e(&
+DATARMNETaa568481cf->DATARMNET78fd20ce0e,DATARMNETaa568481cf->
+DATARMNET1db11fa85e);DATARMNETd74aeaa49a=list_first_entry(&DATARMNETaa568481cf->
+DATARMNETb76b79d0d5,struct rmnet_frag_descriptor,list);if(!DATARMNETd74aeaa49a->
+gso_segs)DATARMNETd74aeaa49a->gso_segs=(0xd26+209-0xdf6);DATARMNETd74aeaa49a->
+gso_size=DATARMNETaa568481cf->DATARMNET1978d5d8de;DATARMNETa1625e27e2=
+DATARMNETd74aeaa49a;list_for_each_entry_safe_continue(DATARMNETa1625e27e2,
+DATARMNET0386f6f82a,&DATARMNETaa568481cf->DATARMNETb76b79d0d5,list){u32 
+DATARMNET904423d5e4=DATARMNETa1625e27e2->len-DATARMNET567bdc7221;if(!
 rmnet_frag_descriptor_add_frags_from(DATARMNETd74aeaa49a,DATARMNETa1625e27e2,
 DATARMNET567bdc7221,DATARMNET904423d5e4)){DATARMNETd74aeaa49a->gso_segs+=(
 DATARMNETa1625e27e2->gso_segs)?:(0xd26+209-0xdf6);DATARMNETd74aeaa49a->
@@ -139,38 +209,54 @@ DATARMNETd74aeaa49a->hash=DATARMNETaa568481cf->DATARMNET381f1cadc4;list_del_init
 DATARMNET6f9bfa17e6);DATARMNETaa568481cf->DATARMNET1db11fa85e=(0xd2d+202-0xdf7);
 DATARMNETaa568481cf->DATARMNETcf28ae376b=(0xd2d+202-0xdf7);}void 
 DATARMNETc38c135c9f(u32 DATARMNET3f8cc6fc24,struct list_head*DATARMNET6f9bfa17e6
-){struct DATARMNETd7c9631acd*DATARMNETaa568481cf;hash_for_each_possible(
-DATARMNET4791268d67,DATARMNETaa568481cf,DATARMNETbd5d7d96d8,DATARMNET3f8cc6fc24)
-{if(DATARMNETaa568481cf->DATARMNET381f1cadc4==DATARMNET3f8cc6fc24&&
-DATARMNETaa568481cf->DATARMNET1db11fa85e)DATARMNETa3055c21f2(DATARMNETaa568481cf
-,DATARMNET6f9bfa17e6);}}u32 DATARMNETae70636c90(struct list_head*
-DATARMNET6f9bfa17e6){struct DATARMNETd7c9631acd*DATARMNETaa568481cf;int 
-DATARMNETae0201901a;u32 DATARMNET737bbd41c3=(0xd2d+202-0xdf7);hash_for_each(
-DATARMNET4791268d67,DATARMNETae0201901a,DATARMNETaa568481cf,DATARMNETbd5d7d96d8)
-{if(DATARMNETaa568481cf->DATARMNET1db11fa85e){DATARMNET737bbd41c3++;
-DATARMNETa3055c21f2(DATARMNETaa568481cf,DATARMNET6f9bfa17e6);}}return 
+){struct DATARMNET70f3b87b5d*DATARMNETe05748b000=DATARMNETc2a630b113();struct 
+DATARMNETd7c9631acd*DATARMNETaa568481cf;if(!DATARMNETe05748b000||!
+DATARMNETe05748b000->DATARMNETebb45c8d86.DATARMNET2846a01cce)return;
+hlist_for_each_entry(DATARMNETaa568481cf,DATARMNETba65ede8c2(&
+DATARMNETe05748b000->DATARMNETebb45c8d86,DATARMNET3f8cc6fc24),
+DATARMNETbd5d7d96d8){if(DATARMNETaa568481cf->DATARMNET381f1cadc4==
+DATARMNET3f8cc6fc24&&DATARMNETaa568481cf->DATARMNET1db11fa85e)
+DATARMNETa3055c21f2(DATARMNETaa568481cf,DATARMNET6f9bfa17e6);}}u32 
+DATARMNETae70636c90(struct list_head*DATARMNET6f9bfa17e6){struct 
+DATARMNET70f3b87b5d*DATARMNETe05748b000=DATARMNETc2a630b113();struct 
+DATARMNETd7c9631acd*DATARMNETaa568481cf,*DATARMNET0386f6f82a;u32 
+DATARMNET737bbd41c3=(0xd2d+202-0xdf7);if(!DATARMNETe05748b000||!
+DATARMNETe05748b000->DATARMNETebb45c8d86.DATARMNET2846a01cce)return
+(0xd2d+202-0xdf7);list_for_each_entry_safe(DATARMNETaa568481cf,
+DATARMNET0386f6f82a,&DATARMNETe05748b000->DATARMNETebb45c8d86.
+DATARMNET683f45ba3f,DATARMNET7576e4c419){DATARMNET737bbd41c3++;
+DATARMNETa3055c21f2(DATARMNETaa568481cf,DATARMNET6f9bfa17e6);}return 
 DATARMNET737bbd41c3;}void DATARMNET33aa5df9ef(struct DATARMNETd7c9631acd*
-DATARMNETaa568481cf,struct DATARMNETd812bcdbb5*DATARMNET5fe4c722a8){if(
-DATARMNET5fe4c722a8->DATARMNETf1b6b0a6cc){memcpy(&DATARMNETaa568481cf->
-DATARMNET78fd20ce0e,&DATARMNET5fe4c722a8->DATARMNET144d119066,sizeof(
-DATARMNETaa568481cf->DATARMNET78fd20ce0e));DATARMNETaa568481cf->
-DATARMNET381f1cadc4=DATARMNET5fe4c722a8->DATARMNET645e8912b8;DATARMNETaa568481cf
-->DATARMNET1978d5d8de=(DATARMNET5fe4c722a8->DATARMNET719f68fb88->gso_size)?:
-DATARMNET5fe4c722a8->DATARMNET1ef22e4c76;}if(DATARMNET5fe4c722a8->
-DATARMNET144d119066.DATARMNET7fa8b2acbf==DATARMNETfd5c3d30e5)DATARMNETaa568481cf
-->DATARMNET78fd20ce0e.DATARMNETbc28a5970f+=DATARMNET5fe4c722a8->
+DATARMNETaa568481cf,struct DATARMNETd812bcdbb5*DATARMNET5fe4c722a8){struct 
+DATARMNET70f3b87b5d*DATARMNETe05748b000=DATARMNETc2a630b113();if(!
+DATARMNETaa568481cf->DATARMNET1db11fa85e)list_add_tail(&DATARMNETaa568481cf->
+DATARMNET7576e4c419,&DATARMNETe05748b000->DATARMNETebb45c8d86.
+DATARMNET683f45ba3f);if(DATARMNET5fe4c722a8->DATARMNETf1b6b0a6cc){memcpy(&
+DATARMNETaa568481cf->DATARMNET78fd20ce0e,&DATARMNET5fe4c722a8->
+DATARMNET144d119066,sizeof(DATARMNETaa568481cf->DATARMNET78fd20ce0e));
+DATARMNETaa568481cf->DATARMNET381f1cadc4=DATARMNET5fe4c722a8->
+DATARMNET645e8912b8;DATARMNETaa568481cf->DATARMNET1978d5d8de=(
+DATARMNET5fe4c722a8->DATARMNET719f68fb88->gso_size)?:DATARMNET5fe4c722a8->
+DATARMNET1ef22e4c76;}if(DATARMNET5fe4c722a8->DATARMNET144d119066.
+DATARMNET7fa8b2acbf==DATARMNETfd5c3d30e5)DATARMNETaa568481cf->
+DATARMNET78fd20ce0e.DATARMNETbc28a5970f+=DATARMNET5fe4c722a8->
 DATARMNET1ef22e4c76;list_add_tail(&DATARMNET5fe4c722a8->DATARMNET719f68fb88->
 list,&DATARMNETaa568481cf->DATARMNETb76b79d0d5);DATARMNETaa568481cf->
 DATARMNET1db11fa85e++;DATARMNETaa568481cf->DATARMNETcf28ae376b+=
 DATARMNET5fe4c722a8->DATARMNET1ef22e4c76;}bool DATARMNETfbf5798e15(struct 
 DATARMNETd812bcdbb5*DATARMNET5fe4c722a8,struct list_head*DATARMNET6f9bfa17e6){
-struct DATARMNETd7c9631acd*DATARMNETaa568481cf;bool DATARMNET885970f252=false;u8
- DATARMNET9695aa5b1d=DATARMNET5fe4c722a8->DATARMNET144d119066.
-DATARMNET7fa8b2acbf;if(!DATARMNET2013036d80(DATARMNET9695aa5b1d)){
-DATARMNETa00cda79d0(DATARMNET6a894ab63d);return false;}hash_for_each_possible(
-DATARMNET4791268d67,DATARMNETaa568481cf,DATARMNETbd5d7d96d8,DATARMNET5fe4c722a8
-->DATARMNET645e8912b8){bool DATARMNET2dd83daa1c;if(!DATARMNET6895620058(
-DATARMNETaa568481cf,DATARMNET5fe4c722a8))continue;DATARMNETc6f994577c:
+struct DATARMNET70f3b87b5d*DATARMNETe05748b000=DATARMNETc2a630b113();struct 
+DATARMNET907d58c807*DATARMNETa6f73cbe10=&DATARMNETe05748b000->
+DATARMNETebb45c8d86;struct DATARMNETd7c9631acd*DATARMNETaa568481cf;bool 
+DATARMNET885970f252=false;u8 DATARMNET9695aa5b1d=DATARMNET5fe4c722a8->
+DATARMNET144d119066.DATARMNET7fa8b2acbf;if(!DATARMNET2013036d80(
+DATARMNET9695aa5b1d)){DATARMNETa00cda79d0(DATARMNET6a894ab63d);return false;}
+hlist_for_each_entry(DATARMNETaa568481cf,DATARMNETba65ede8c2(DATARMNETa6f73cbe10
+,DATARMNET5fe4c722a8->DATARMNET645e8912b8),DATARMNETbd5d7d96d8){bool 
+DATARMNET2dd83daa1c;if(!DATARMNET6895620058(DATARMNETaa568481cf,
+DATARMNET5fe4c722a8))continue;DATARMNETc6f994577c:list_move_tail(&
+DATARMNETaa568481cf->DATARMNET3f4183c7aa,&DATARMNETa6f73cbe10->
+DATARMNET60b9fe7c08);DATARMNETaa568481cf->DATARMNETd2f7455d1a=jiffies;
 DATARMNET2dd83daa1c=DATARMNET5a0f9fc3a2(DATARMNETaa568481cf,DATARMNET5fe4c722a8)
 ;DATARMNET5fe4c722a8->DATARMNETf1b6b0a6cc=true;DATARMNET885970f252=true;switch(
 DATARMNET9695aa5b1d){case DATARMNETfd5c3d30e5:return DATARMNET4c7cdc25b7(
@@ -179,17 +265,20 @@ DATARMNETaa568481cf,DATARMNET5fe4c722a8,DATARMNET2dd83daa1c,DATARMNET6f9bfa17e6)
 DATARMNET5fe4c722a8,DATARMNET2dd83daa1c,DATARMNET6f9bfa17e6);default:return 
 false;}}if(!DATARMNET885970f252){DATARMNETaa568481cf=DATARMNETd41def0046();
 DATARMNETaa568481cf->DATARMNET381f1cadc4=DATARMNET5fe4c722a8->
-DATARMNET645e8912b8;hash_add(DATARMNET4791268d67,&DATARMNETaa568481cf->
-DATARMNETbd5d7d96d8,DATARMNETaa568481cf->DATARMNET381f1cadc4);goto 
-DATARMNETc6f994577c;}return false;}void DATARMNETb98b78b8e3(void){struct 
-DATARMNETd7c9631acd*DATARMNETaa568481cf;struct hlist_node*DATARMNET0386f6f82a;
-int DATARMNETae0201901a;hash_for_each_safe(DATARMNET4791268d67,
-DATARMNETae0201901a,DATARMNET0386f6f82a,DATARMNETaa568481cf,DATARMNETbd5d7d96d8)
-hash_del(&DATARMNETaa568481cf->DATARMNETbd5d7d96d8);}int DATARMNETdbcaf01255(
-void){struct DATARMNET70f3b87b5d*DATARMNETe05748b000=DATARMNETc2a630b113();u8 
-DATARMNETefc9df3df2;for(DATARMNETefc9df3df2=(0xd2d+202-0xdf7);
-DATARMNETefc9df3df2<DATARMNET78d9393ac8;DATARMNETefc9df3df2++){struct 
-DATARMNETd7c9631acd*DATARMNETaa568481cf;DATARMNETaa568481cf=&DATARMNETe05748b000
-->DATARMNETebb45c8d86.DATARMNET2846a01cce[DATARMNETefc9df3df2];INIT_LIST_HEAD(&
-DATARMNETaa568481cf->DATARMNETb76b79d0d5);INIT_HLIST_NODE(&DATARMNETaa568481cf->
-DATARMNETbd5d7d96d8);}return DATARMNET0529bb9c4e;}
+DATARMNET645e8912b8;hlist_add_head(&DATARMNETaa568481cf->DATARMNETbd5d7d96d8,
+DATARMNETba65ede8c2(DATARMNETa6f73cbe10,DATARMNETaa568481cf->DATARMNET381f1cadc4
+));goto DATARMNETc6f994577c;}return false;}void DATARMNETb98b78b8e3(void){struct 
+DATARMNET70f3b87b5d*DATARMNETe05748b000=DATARMNETc2a630b113();struct 
+DATARMNET907d58c807*DATARMNETa6f73cbe10=&DATARMNETe05748b000->
+DATARMNETebb45c8d86;u32 DATARMNETefc9df3df2;if(!DATARMNETa6f73cbe10->
+DATARMNET2846a01cce)return;for(DATARMNETefc9df3df2=(0xd2d+202-0xdf7);
+DATARMNETefc9df3df2<DATARMNETa6f73cbe10->DATARMNET320d1a1508;DATARMNETefc9df3df2
+++)hash_del(&DATARMNETa6f73cbe10->DATARMNET2846a01cce[DATARMNETefc9df3df2].
+DATARMNETbd5d7d96d8);kfree(DATARMNETa6f73cbe10->DATARMNET2846a01cce);kfree(
+DATARMNETa6f73cbe10->DATARMNET70ee946782);DATARMNETa6f73cbe10->
+DATARMNET2846a01cce=NULL;DATARMNETa6f73cbe10->DATARMNET70ee946782=NULL;}int 
+DATARMNETdbcaf01255(void){struct DATARMNET70f3b87b5d*DATARMNETe05748b000=
+DATARMNETc2a630b113();if(DATARMNETc9b06f8206(&DATARMNETe05748b000->
+DATARMNETebb45c8d86,(u32)DATARMNETf1d1b8287f(DATARMNET97bacb222e),GFP_KERNEL))
+return-ENOMEM;DATARMNETa75f138e88(&DATARMNETe05748b000->DATARMNETebb45c8d86);
+return DATARMNET0529bb9c4e;}
@@ -15,23 +15,32 @@
 #include <linux/types.h>
 #include "rmnet_offload_main.h"
 #define DATARMNET78d9393ac8 (0xef7+1112-0x131d)
+#define DATARMNETc5f691edbf (0xd35+210-0xdff)
+#define DATARMNET4652f087ae 1024
+#define DATARMNET238ca5bffc 1000
+#define DATARMNETf0eaa011e8 60000
 enum{DATARMNET7af645849a,DATARMNETb0bd5db24d,DATARMNET0413b43080,};enum{
 DATARMNETa2ddeec85f,DATARMNET2d89680280=DATARMNETa2ddeec85f,DATARMNET03daf91a60,
 DATARMNET88a9920663,DATARMNET5fe3af8828,DATARMNETaccb69cf16=DATARMNET5fe3af8828,
 };struct DATARMNETd7c9631acd{struct hlist_node DATARMNETbd5d7d96d8;struct 
-list_head DATARMNETb76b79d0d5;struct DATARMNET4287f07234 DATARMNET78fd20ce0e;u32
- DATARMNET381f1cadc4;u16 DATARMNETcf28ae376b;u32 DATARMNETd3a1a2b9b5;u16 
-DATARMNET1978d5d8de;u8 DATARMNET1db11fa85e;};struct DATARMNET907d58c807{struct 
-DATARMNETd7c9631acd DATARMNET2846a01cce[DATARMNET78d9393ac8];u8 
-DATARMNET8dfc11cccd;u8 DATARMNET57d435b225;};void DATARMNETd4230b6bfe(void);void
- DATARMNET560e127137(void);int DATARMNET241493ab9a(u64 DATARMNET0470698d6c,u64 
-DATARMNETfeff65e096);void DATARMNETa3055c21f2(struct DATARMNETd7c9631acd*
-DATARMNETaa568481cf,struct list_head*DATARMNET6f9bfa17e6);void 
-DATARMNETc38c135c9f(u32 DATARMNET3f8cc6fc24,struct list_head*DATARMNET6f9bfa17e6
-);u32 DATARMNETae70636c90(struct list_head*DATARMNET6f9bfa17e6);void 
-DATARMNET33aa5df9ef(struct DATARMNETd7c9631acd*DATARMNETaa568481cf,struct 
-DATARMNETd812bcdbb5*DATARMNET5fe4c722a8);bool DATARMNETfbf5798e15(struct 
-DATARMNETd812bcdbb5*DATARMNET5fe4c722a8,struct list_head*DATARMNET6f9bfa17e6);
-void DATARMNETb98b78b8e3(void);int DATARMNETdbcaf01255(void);
+list_head DATARMNETb76b79d0d5;struct list_head DATARMNET3f4183c7aa;struct 
+list_head DATARMNET7576e4c419;struct DATARMNET4287f07234 DATARMNET78fd20ce0e;u32 
+DATARMNET381f1cadc4;u16 DATARMNETcf28ae376b;u32 DATARMNETd3a1a2b9b5;u16 
+DATARMNET1978d5d8de;u8 DATARMNET1db11fa85e;unsigned long DATARMNETd2f7455d1a;};
+struct DATARMNET907d58c807{struct DATARMNETd7c9631acd*DATARMNET2846a01cce;struct 
+hlist_head*DATARMNET70ee946782;struct list_head DATARMNET6e2733388d;struct 
+list_head DATARMNET60b9fe7c08;struct list_head DATARMNET683f45ba3f;u32 
+DATARMNET320d1a1508;u8 DATARMNET5e730d125a;};void DATARMNETd4230b6bfe(void);void 
+DATARMNET560e127137(void);int DATARMNET241493ab9a(u64 DATARMNET0470698d6c,u64 
+DATARMNETfeff65e096);int DATARMNET0ec2d7dfdd(u64 DATARMNET0470698d6c,u64 
+DATARMNETfeff65e096);void DATARMNETfb008bfe9e(struct DATARMNET4287f07234*
+DATARMNET24e0357785,u32 DATARMNETb639f6e1b1);void DATARMNETa3055c21f2(struct 
+DATARMNETd7c9631acd*DATARMNETaa568481cf,struct list_head*DATARMNET6f9bfa17e6);
+void DATARMNETc38c135c9f(u32 DATARMNET3f8cc6fc24,struct list_head*
+DATARMNET6f9bfa17e6);u32 DATARMNETae70636c90(struct list_head*
+DATARMNET6f9bfa17e6);void DATARMNET33aa5df9ef(struct DATARMNETd7c9631acd*
+DATARMNETaa568481cf,struct DATARMNETd812bcdbb5*DATARMNET5fe4c722a8);bool 
+DATARMNETfbf5798e15(struct DATARMNETd812bcdbb5*DATARMNET5fe4c722a8,struct 
+list_head*DATARMNET6f9bfa17e6);void DATARMNETb98b78b8e3(void);int 
+DATARMNETdbcaf01255(void);
 #endif
-
@@ -240,10 +240,12 @@ DATARMNET719f68fb88;u32 DATARMNET5affe290b8=DATARMNET458b70e7e5->
 DATARMNET1ef22e4c76+DATARMNET458b70e7e5->DATARMNET144d119066.DATARMNET4ca5ac9de1
 +DATARMNET458b70e7e5->DATARMNET144d119066.DATARMNET0aeee57ceb;if(
 DATARMNET5affe290b8>65536)return;if(!DATARMNET458b70e7e5->DATARMNET3eb91ee54d)
-DATARMNET9d1b321642->hash=DATARMNET458b70e7e5->DATARMNET645e8912b8;list_add_tail
-(&DATARMNET9d1b321642->list,DATARMNET6f9bfa17e6);}void DATARMNET9292bebdd3(void*
-DATARMNETf0d9de7e2f){}void DATARMNETb7e47d7254(void*DATARMNETf0d9de7e2f){}void 
-DATARMNET95e1703026(struct rmnet_map_dl_ind_hdr*DATARMNET7c7748ef7a,struct 
+DATARMNETfb008bfe9e(&DATARMNET458b70e7e5->DATARMNET144d119066,(0xd26+209-0xdf6))
+;if(!DATARMNET458b70e7e5->DATARMNET3eb91ee54d)DATARMNET9d1b321642->hash=
+DATARMNET458b70e7e5->DATARMNET645e8912b8;list_add_tail(&DATARMNET9d1b321642->
+list,DATARMNET6f9bfa17e6);}void DATARMNET9292bebdd3(void*DATARMNETf0d9de7e2f){}
+void DATARMNETb7e47d7254(void*DATARMNETf0d9de7e2f){}void DATARMNET95e1703026(
+struct rmnet_map_dl_ind_hdr*DATARMNET7c7748ef7a,struct 
 rmnet_map_control_command_header*DATARMNET8b07ee3e82){struct DATARMNET70f3b87b5d
 *DATARMNETe05748b000=DATARMNETc2a630b113();LIST_HEAD(DATARMNET6f9bfa17e6);(void)
 DATARMNET8b07ee3e82;DATARMNET664568fcd0();if(DATARMNETe05748b000->
@@ -166,6 +166,7 @@ qmi_rmnet_clean_flow_list(struct qos_info *qos)
 	memset(qos->mq, 0, sizeof(qos->mq));
 }
 
+/* Must be called with either qos_lock or rcu_read_lock held */
 struct rmnet_flow_map *
 qmi_rmnet_get_flow_map(struct qos_info *qos, u32 flow_id, int ip_type)
 {
@@ -174,13 +175,15 @@ qmi_rmnet_get_flow_map(struct qos_info *qos, u32 flow_id, int ip_type)
 	if (!qos)
 		return NULL;
 
-	list_for_each_entry(itm, &qos->flow_head, list) {
+	hash_for_each_possible_rcu(qos->flow_ht, itm, hlist, flow_id,
+				   lockdep_is_held(&qos->qos_lock)) {
 		if ((itm->flow_id == flow_id) && (itm->ip_type == ip_type))
 			return itm;
 	}
 	return NULL;
 }
 
+/* Must be called with either qos_lock or rcu_read_lock held */
 struct rmnet_bearer_map *
 qmi_rmnet_get_bearer_map(struct qos_info *qos, uint8_t bearer_id)
 {
@@ -189,7 +192,8 @@ qmi_rmnet_get_bearer_map(struct qos_info *qos, uint8_t bearer_id)
 	if (!qos)
 		return NULL;
 
-	list_for_each_entry(itm, &qos->bearer_head, list) {
+	hash_for_each_possible_rcu(qos->bearer_ht, itm, hlist, bearer_id,
+				   lockdep_is_held(&qos->qos_lock)) {
 		if (itm->bearer_id == bearer_id)
 			return itm;
 	}
@@ -202,7 +206,7 @@ static void qmi_rmnet_update_flow_map(struct rmnet_flow_map *itm,
 	itm->bearer_id = new_map->bearer_id;
 	itm->flow_id = new_map->flow_id;
 	itm->ip_type = new_map->ip_type;
-	itm->mq_idx = new_map->mq_idx;
+	WRITE_ONCE(itm->mq_idx, new_map->mq_idx);
 }
 
 int qmi_rmnet_flow_control(struct net_device *dev, u32 mq_idx, int enable)
@@ -306,7 +310,7 @@ static void qmi_rmnet_bearer_clean(struct qos_info *qos)
 		del_timer_sync(&qos->removed_bearer->watchdog);
 		qos->removed_bearer->ch_switch.timer_quit = true;
 		del_timer_sync(&qos->removed_bearer->ch_switch.guard_timer);
-		kfree(qos->removed_bearer);
+		kfree_rcu(qos->removed_bearer, rcu);
 		qos->removed_bearer = NULL;
 	}
 }
@@ -335,6 +339,7 @@ static struct rmnet_bearer_map *__qmi_rmnet_bearer_get(
 		timer_setup(&bearer->ch_switch.guard_timer,
 			    rmnet_ll_guard_fn, 0);
 		list_add(&bearer->list, &qos_info->bearer_head);
+		hash_add_rcu(qos_info->bearer_ht, &bearer->hlist, bearer_id);
 	}
 
 	return bearer;
@@ -368,6 +373,7 @@ static void __qmi_rmnet_bearer_put(struct net_device *dev,
 
 		/* Remove from bearer map */
 		list_del(&bearer->list);
+		hash_del_rcu(&bearer->hlist);
 		qos_info->removed_bearer = bearer;
 	}
 }
@@ -391,10 +397,11 @@ static void __qmi_rmnet_update_mq(struct net_device *dev,
 		smp_mb();
 
 		if (dfc_mode == DFC_MODE_SA) {
-			bearer->mq_idx = itm->mq_idx;
-			bearer->ack_mq_idx = itm->mq_idx + ACK_MQ_OFFSET;
+			WRITE_ONCE(bearer->mq_idx, itm->mq_idx);
+			WRITE_ONCE(bearer->ack_mq_idx,
+				   itm->mq_idx + ACK_MQ_OFFSET);
 		} else {
-			bearer->mq_idx = itm->mq_idx;
+			WRITE_ONCE(bearer->mq_idx, itm->mq_idx);
 		}
 
 		/* Always enable flow for the newly associated bearer */
@@ -423,7 +430,7 @@ static int __qmi_rmnet_rebind_flow(struct net_device *dev,
 		return -ENOMEM;
 
 	qmi_rmnet_update_flow_map(itm, new_map);
-	itm->bearer = bearer;
+	rcu_assign_pointer(itm->bearer, bearer);
 
 	__qmi_rmnet_update_mq(dev, qos_info, bearer, itm);
 
@@ -488,6 +495,7 @@ again:
 
 	qmi_rmnet_update_flow_map(itm, &new_map);
 	list_add(&itm->list, &qos_info->flow_head);
+	hash_add_rcu(qos_info->flow_ht, &itm->hlist, itm->flow_id);
 
 	/* Create or update bearer map */
 	bearer = __qmi_rmnet_bearer_get(qos_info, new_map.bearer_id);
@@ -496,7 +504,7 @@ again:
 		goto done;
 	}
 
-	itm->bearer = bearer;
+	rcu_assign_pointer(itm->bearer, bearer);
 
 	__qmi_rmnet_update_mq(dev, qos_info, bearer, itm);
 
@@ -541,7 +549,8 @@ qmi_rmnet_del_flow(struct net_device *dev, struct tcmsg *tcm,
 
 		/* Remove from flow map */
 		list_del(&itm->list);
-		kfree(itm);
+		hash_del_rcu(&itm->hlist);
+		kfree_rcu(itm, rcu);
 	}
 
 	if (list_empty(&qos_info->flow_head))
@@ -1023,6 +1032,7 @@ static inline bool qmi_rmnet_is_tcp_ack(struct sk_buff *skb)
 
 static int qmi_rmnet_get_queue_sa(struct qos_info *qos, struct sk_buff *skb)
 {
+	struct rmnet_bearer_map *bearer;
 	struct rmnet_flow_map *itm;
 	int ip_type;
 	int txq = DEFAULT_MQ_NUM;
@@ -1037,20 +1047,21 @@ static int qmi_rmnet_get_queue_sa(struct qos_info *qos, struct sk_buff *skb)
 
 	ip_type = (skb->protocol == htons(ETH_P_IPV6)) ? AF_INET6 : AF_INET;
 
-	spin_lock_bh(&qos->qos_lock);
+	rcu_read_lock();
 
 	itm = qmi_rmnet_get_flow_map(qos, skb->mark, ip_type);
 	if (unlikely(!itm))
 		goto done;
 
 	/* Put the packet in the assigned mq except TCP ack */
-	if (likely(itm->bearer) && qmi_rmnet_is_tcp_ack(skb))
-		txq = itm->bearer->ack_mq_idx;
+	bearer = rcu_dereference(itm->bearer);
+	if (likely(bearer) && qmi_rmnet_is_tcp_ack(skb))
+		txq = READ_ONCE(bearer->ack_mq_idx);
 	else
-		txq = itm->mq_idx;
+		txq = READ_ONCE(itm->mq_idx);
 
 done:
-	spin_unlock_bh(&qos->qos_lock);
+	rcu_read_unlock();
 	return txq;
 }
 
@@ -1069,13 +1080,13 @@ int qmi_rmnet_get_queue(struct net_device *dev, struct sk_buff *skb)
 
 	ip_type = (skb->protocol == htons(ETH_P_IPV6)) ? AF_INET6 : AF_INET;
 
-	spin_lock_bh(&qos->qos_lock);
+	rcu_read_lock();
 
 	itm = qmi_rmnet_get_flow_map(qos, mark, ip_type);
 	if (itm)
-		txq = itm->mq_idx;
+		txq = READ_ONCE(itm->mq_idx);
 
-	spin_unlock_bh(&qos->qos_lock);
+	rcu_read_unlock();
 
 	return txq;
 }
@@ -1102,6 +1113,8 @@ void *qmi_rmnet_qos_init(struct net_device *real_dev,
 	qos->tran_num = 0;
 	INIT_LIST_HEAD(&qos->flow_head);
 	INIT_LIST_HEAD(&qos->bearer_head);
+	hash_init(qos->flow_ht);
+	hash_init(qos->bearer_ht);
 	spin_lock_init(&qos->qos_lock);
 
 	return qos;
@@ -18,6 +18,7 @@
 #include <linux/netdevice.h>
 #include <linux/skbuff.h>
 #include <linux/timer.h>
+#include <linux/hashtable.h>
 #include <uapi/linux/rtnetlink.h>
 #include <linux/soc/qcom/qmi.h>
 
@@ -31,6 +32,9 @@
 #define ACK_MQ_OFFSET (MAX_MQ_NUM - 1)
 #define INVALID_MQ 0xFF
 
+#define QMI_RMNET_FLOW_HT_BITS 5
+#define QMI_RMNET_BEARER_HT_BITS 4
+
 #define DFC_MODE_SA 4
 #define PS_MAX_BEARERS 32
 
@@ -74,6 +78,8 @@ struct rmnet_ch_switch {
 
 struct rmnet_bearer_map {
 	struct list_head list;
+	struct hlist_node hlist;
+	struct rcu_head rcu;
 	u8 bearer_id;
 	int flow_ref;
 	u32 grant_size;
@@ -100,6 +106,8 @@ struct rmnet_bearer_map {
 
 struct rmnet_flow_map {
 	struct list_head list;
+	struct hlist_node hlist;
+	struct rcu_head rcu;
 	u8 bearer_id;
 	u32 flow_id;
 	int ip_type;
@@ -126,6 +134,11 @@ struct qos_info {
 	struct net_device *vnd_dev;
 	struct list_head flow_head;
 	struct list_head bearer_head;
+	/* RCU lookup indices for the flow and bearer lists. Updated under
+	 * qos_lock, read locklessly from the TX path.
+	 */
+	DECLARE_HASHTABLE(flow_ht, QMI_RMNET_FLOW_HT_BITS);
+	DECLARE_HASHTABLE(bearer_ht, QMI_RMNET_BEARER_HT_BITS);
 	struct mq_map mq[MAX_MQ_NUM];
 	u32 tran_num;
 	spinlock_t qos_lock;
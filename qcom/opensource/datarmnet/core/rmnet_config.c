@@ -854,6 +854,7 @@ static void __exit rmnet_exit(void)
 	rtnl_link_unregister(&rmnet_link_ops);
 	rmnet_ll_exit();
 	rmnet_core_genl_deinit();
+	rmnet_descriptor_exit();
 
 	module_put(THIS_MODULE);
 }
@@ -57,6 +57,37 @@ struct rmnet_endpoint {
 struct rmnet_agg_stats {
 	u64 ul_agg_reuse;
 	u64 ul_agg_alloc;
+	u64 ul_agg_sg;
+};
+
+/* Reasons a per-CPU UL aggregation buffer was sent out */
+enum {
+	RMNET_AGG_FLUSH_SIZE,
+	RMNET_AGG_FLUSH_COUNT,
+	RMNET_AGG_FLUSH_TIME,
+	RMNET_AGG_FLUSH_TIMER,
+	RMNET_AGG_FLUSH_FLOW,
+	RMNET_AGG_FLUSH_BYPASS,
+	RMNET_AGG_FLUSH_MAX,
+};
+
+struct rmnet_agg_pcpu_stats {
+	u64 flush[RMNET_AGG_FLUSH_MAX];
+};
+
+struct rmnet_frag_cache_stats {
+	u64 hit;
+	u64 refill;
+	u64 flush;
+	u64 alloc;
+};
+
+struct rmnet_rx_batch_stats {
+	u64 batches;
+	u64 pkts;
+	u64 flows;
+	u64 overflow;
+	u64 shs_list;
 };
 
 struct rmnet_port_priv_stats {
@@ -76,6 +107,10 @@ struct rmnet_port_priv_stats {
 	u64 dl_chain_stat[7];
 	u64 dl_frag_stat_1;
 	u64 dl_frag_stat[5];
+	struct rmnet_frag_cache_stats desc_cache;
+	struct rmnet_frag_cache_stats frag_cache;
+	struct rmnet_agg_pcpu_stats agg_pcpu;
+	struct rmnet_rx_batch_stats rx_batch;
 };
 
 struct rmnet_egress_agg_params {
@@ -91,6 +126,37 @@ enum {
 	RMNET_MAX_AGG_STATE,
 };
 
+#define RMNET_AGG_FLOW_BUCKETS 64
+
+/* Adaptive UL aggregation controller state, used with RMNET_ADAPTIVE_AGG.
+ * The effective limits never exceed the ones configured by the modem in
+ * rmnet_egress_agg_params.
+ */
+struct rmnet_agg_ctl {
+	u64 ewma_iat;
+	u32 ewma_fill;
+	u32 time;
+	u32 time_limit;
+	u8 count;
+	u8 sparse;
+};
+
+/* Per-CPU UL aggregation buffer used with RMNET_PCPU_AGG */
+struct rmnet_agg_pcpu {
+	/* Protects the buffer against flushes from other CPUs */
+	spinlock_t lock;
+	struct sk_buff *agg_skb;
+	struct timespec64 agg_time;
+	struct timespec64 agg_last;
+	/* Buffers taken for sending, and buffers sent, in generation order */
+	u32 flush_gen;
+	u32 sent_gen;
+	u8 agg_count;
+	/* Adaptive limits for this CPU's buffer, tuned on its own traffic */
+	struct rmnet_agg_ctl ctl;
+	u64 flush[RMNET_AGG_FLUSH_MAX];
+};
+
 struct rmnet_aggregation_state {
 	struct rmnet_egress_agg_params params;
 	struct timespec64 agg_time;
@@ -107,6 +173,11 @@ struct rmnet_aggregation_state {
 	struct list_head agg_list;
 	struct rmnet_agg_page *agg_head;
 	struct rmnet_agg_stats *stats;
+	struct rmnet_agg_ctl ctl;
+	struct rmnet_agg_pcpu __percpu *pcpu;
+	unsigned long pcpu_timer_armed;
+	/* Last CPU and buffer generation holding packets of each flow bucket */
+	u32 flow_owner[RMNET_AGG_FLOW_BUCKETS];
 };
 
 
@@ -51,31 +51,134 @@ typedef void (*rmnet_perf_tether_ingress_hook_t)(struct tcphdr *tp, struct sk_bu
 rmnet_perf_tether_ingress_hook_t rmnet_perf_tether_ingress_hook __rcu __read_mostly;
 EXPORT_SYMBOL(rmnet_perf_tether_ingress_hook);
 
+/* Fragments are not tied to a port, so a single set of per-CPU magazines
+ * and one depot serve every port.
+ */
+static DEFINE_PER_CPU(struct rmnet_frag_cache, rmnet_frag_pcpu_cache);
+static LIST_HEAD(rmnet_frag_free_list);
+static DEFINE_SPINLOCK(rmnet_frag_pool_lock);
+
+/* Take an object from the local magazine, refilling it from the depot if
+ * needed. Must be called with IRQs disabled.
+ */
+static struct list_head *rmnet_frag_cache_get(struct rmnet_frag_cache *cache,
+					      spinlock_t *lock,
+					      struct list_head *depot)
+{
+	struct list_head *obj;
+
+	if (likely(cache->count)) {
+		cache->stats.hit++;
+		return cache->objs[--cache->count];
+	}
+
+	spin_lock(lock);
+	while (cache->count < RMNET_FRAG_CACHE_SIZE / 2 && !list_empty(depot)) {
+		obj = depot->next;
+		list_del_init(obj);
+		cache->objs[cache->count++] = obj;
+	}
+	spin_unlock(lock);
+
+	if (!cache->count)
+		return NULL;
+
+	cache->stats.refill++;
+	return cache->objs[--cache->count];
+}
+
+/* Return an object to the local magazine, moving the older half of the
+ * magazine to the depot if it is full. Must be called with IRQs disabled.
+ */
+static void rmnet_frag_cache_put(struct rmnet_frag_cache *cache,
+				 spinlock_t *lock, struct list_head *depot,
+				 struct list_head *obj)
+{
+	u32 half = RMNET_FRAG_CACHE_SIZE / 2;
+	u32 i;
+
+	if (unlikely(cache->count == RMNET_FRAG_CACHE_SIZE)) {
+		spin_lock(lock);
+		for (i = 0; i < half; i++)
+			list_add_tail(cache->objs[i], depot);
+		spin_unlock(lock);
+
+		memmove(cache->objs, cache->objs + half,
+			(cache->count - half) * sizeof(*cache->objs));
+		cache->count -= half;
+		cache->stats.flush++;
+	}
+
+	cache->objs[cache->count++] = obj;
+}
+
+static struct rmnet_fragment *rmnet_frag_alloc(void)
+{
+	struct rmnet_frag_cache *cache;
+	struct rmnet_fragment *frag;
+	struct list_head *obj;
+	unsigned long flags;
+
+	local_irq_save(flags);
+	cache = this_cpu_ptr(&rmnet_frag_pcpu_cache);
+	obj = rmnet_frag_cache_get(cache, &rmnet_frag_pool_lock,
+				   &rmnet_frag_free_list);
+	if (obj) {
+		frag = list_entry(obj, struct rmnet_fragment, list);
+		memset(frag, 0, sizeof(*frag));
+	} else {
+		frag = kzalloc(sizeof(*frag), GFP_ATOMIC);
+		if (frag)
+			cache->stats.alloc++;
+	}
+
+	local_irq_restore(flags);
+	return frag;
+}
+
+static void rmnet_frag_free(struct rmnet_fragment *frag)
+{
+	unsigned long flags;
+
+	local_irq_save(flags);
+	rmnet_frag_cache_put(this_cpu_ptr(&rmnet_frag_pcpu_cache),
+			     &rmnet_frag_pool_lock, &rmnet_frag_free_list,
+			     &frag->list);
+	local_irq_restore(flags);
+}
+
 struct rmnet_frag_descriptor *
 rmnet_get_frag_descriptor(struct rmnet_port *port)
 {
 	struct rmnet_frag_descriptor_pool *pool = port->frag_desc_pool;
 	struct rmnet_frag_descriptor *frag_desc;
+	struct rmnet_frag_cache *cache;
+	struct list_head *obj;
 	unsigned long flags;
 
-	spin_lock_irqsave(&port->desc_pool_lock, flags);
-	if (!list_empty(&pool->free_list)) {
-		frag_desc = list_first_entry(&pool->free_list,
-					     struct rmnet_frag_descriptor,
-					     list);
-		list_del_init(&frag_desc->list);
-	} else {
-		frag_desc = kzalloc(sizeof(*frag_desc), GFP_ATOMIC);
-		if (!frag_desc)
-			goto out;
-
-		INIT_LIST_HEAD(&frag_desc->list);
-		INIT_LIST_HEAD(&frag_desc->frags);
-		pool->pool_size++;
+	local_irq_save(flags);
+	cache = this_cpu_ptr(pool->cache);
+	obj = rmnet_frag_cache_get(cache, &port->desc_pool_lock,
+				   &pool->free_list);
+	if (obj) {
+		frag_desc = list_entry(obj, struct rmnet_frag_descriptor,
+				       list);
+		goto out;
 	}
 
+	frag_desc = kzalloc(sizeof(*frag_desc), GFP_ATOMIC);
+	if (!frag_desc)
+		goto out;
+
+	INIT_LIST_HEAD(&frag_desc->list);
+	INIT_LIST_HEAD(&frag_desc->frags);
+	cache->stats.alloc++;
+	spin_lock(&port->desc_pool_lock);
+	pool->pool_size++;
+	spin_unlock(&port->desc_pool_lock);
+
 out:
-	spin_unlock_irqrestore(&port->desc_pool_lock, flags);
+	local_irq_restore(flags);
 	return frag_desc;
 }
 EXPORT_SYMBOL(rmnet_get_frag_descriptor);
@@ -96,15 +199,16 @@ void rmnet_recycle_frag_descriptor(struct rmnet_frag_descriptor *frag_desc,
 			put_page(page);
 
 		list_del(&frag->list);
-		kfree(frag);
+		rmnet_frag_free(frag);
 	}
 
 	memset(frag_desc, 0, sizeof(*frag_desc));
 	INIT_LIST_HEAD(&frag_desc->list);
 	INIT_LIST_HEAD(&frag_desc->frags);
-	spin_lock_irqsave(&port->desc_pool_lock, flags);
-	list_add_tail(&frag_desc->list, &pool->free_list);
-	spin_unlock_irqrestore(&port->desc_pool_lock, flags);
+	local_irq_save(flags);
+	rmnet_frag_cache_put(this_cpu_ptr(pool->cache), &port->desc_pool_lock,
+			     &pool->free_list, &frag_desc->list);
+	local_irq_restore(flags);
 }
 EXPORT_SYMBOL(rmnet_recycle_frag_descriptor);
 
@@ -136,7 +240,7 @@ void *rmnet_frag_pull(struct rmnet_frag_descriptor *frag_desc,
 			list_del(&frag->list);
 			size -= frag_size;
 			frag_desc->len -= frag_size;
-			kfree(frag);
+			rmnet_frag_free(frag);
 			continue;
 		}
 
@@ -186,7 +290,7 @@ void *rmnet_frag_trim(struct rmnet_frag_descriptor *frag_desc,
 			list_del(&frag->list);
 			eat -= frag_size;
 			frag_desc->len -= frag_size;
-			kfree(frag);
+			rmnet_frag_free(frag);
 			continue;
 		}
 
@@ -280,7 +384,7 @@ int rmnet_frag_descriptor_add_frag(struct rmnet_frag_descriptor *frag_desc,
 {
 	struct rmnet_fragment *frag;
 
-	frag = kzalloc(sizeof(*frag), GFP_ATOMIC);
+	frag = rmnet_frag_alloc();
 	if (!frag)
 		return -ENOMEM;
 
@@ -1791,9 +1895,13 @@ int rmnet_frag_process_next_hdr_packet(struct rmnet_frag_descriptor *frag_desc,
 rmnet_perf_desc_hook_t rmnet_perf_desc_entry __rcu __read_mostly;
 EXPORT_SYMBOL(rmnet_perf_desc_entry);
 
+/* Largest batch built before delivering it to the stack */
+#define RMNET_FRAG_BATCH_MAX 64
+
 static void
 __rmnet_frag_ingress_handler(struct rmnet_frag_descriptor *frag_desc,
-			     struct rmnet_port *port)
+			     struct rmnet_port *port,
+			     struct sk_buff_head *batch)
 {
 	rmnet_perf_desc_hook_t rmnet_perf_ingress;
 	struct rmnet_map_header *qmap, __qmap;
@@ -1872,8 +1980,21 @@ __rmnet_frag_ingress_handler(struct rmnet_frag_descriptor *frag_desc,
 
 no_perf:
 	list_for_each_entry_safe(frag, tmp, &segs, list) {
+		struct sk_buff *skb;
+
 		list_del_init(&frag->list);
-		rmnet_frag_deliver(frag, port);
+		if (!batch) {
+			rmnet_frag_deliver(frag, port);
+			continue;
+		}
+
+		skb = rmnet_alloc_skb(frag, port);
+		if (skb)
+			__skb_queue_tail(batch, skb);
+
+		rmnet_recycle_frag_descriptor(frag, port);
+		if (skb_queue_len(batch) >= RMNET_FRAG_BATCH_MAX)
+			rmnet_deliver_skb_batch(batch, port);
 	}
 	return;
 
@@ -1924,10 +2045,17 @@ void rmnet_frag_ingress_handler(struct sk_buff *skb,
 				struct rmnet_port *port)
 {
 	rmnet_perf_chain_hook_t rmnet_perf_opt_chain_end;
+	struct sk_buff_head batch, *batchp = NULL;
 	LIST_HEAD(desc_list);
 	bool skip_perf = (skb->priority == 0xda1a);
 	u64 chain_count = 0;
 
+	/* Low latency packets keep their own delivery path */
+	if (!skip_perf && (port->data_format & RMNET_INGRESS_FORMAT_LIST_RX)) {
+		__skb_queue_head_init(&batch);
+		batchp = &batch;
+	}
+
 	/* Deaggregation and freeing of HW originating
 	 * buffers is done within here
 	 */
@@ -1945,7 +2073,8 @@ void rmnet_frag_ingress_handler(struct sk_buff *skb,
 			list_for_each_entry_safe(frag_desc, tmp, &desc_list,
 						 list) {
 				list_del_init(&frag_desc->list);
-				__rmnet_frag_ingress_handler(frag_desc, port);
+				__rmnet_frag_ingress_handler(frag_desc, port,
+							     batchp);
 			}
 		}
 
@@ -1956,6 +2085,8 @@ void rmnet_frag_ingress_handler(struct sk_buff *skb,
 	}
 
 	rmnet_descriptor_classify_chain_count(chain_count, port);
+	if (batchp)
+		rmnet_deliver_skb_batch(batchp, port);
 
 	if (skip_perf)
 		return;
@@ -1971,8 +2102,31 @@ void rmnet_descriptor_deinit(struct rmnet_port *port)
 {
 	struct rmnet_frag_descriptor_pool *pool;
 	struct rmnet_frag_descriptor *frag_desc, *tmp;
+	int cpu;
 
 	pool = port->frag_desc_pool;
+	if (!pool)
+		return;
+
+	if (pool->cache) {
+		for_each_possible_cpu(cpu) {
+			struct rmnet_frag_cache *cache;
+
+			cache = per_cpu_ptr(pool->cache, cpu);
+			while (cache->count) {
+				struct list_head *obj;
+
+				obj = cache->objs[--cache->count];
+				frag_desc = list_entry(obj,
+						       struct rmnet_frag_descriptor,
+						       list);
+				kfree(frag_desc);
+				pool->pool_size--;
+			}
+		}
+
+		free_percpu(pool->cache);
+	}
 
 	list_for_each_entry_safe(frag_desc, tmp, &pool->free_list, list) {
 		kfree(frag_desc);
@@ -1980,6 +2134,7 @@ void rmnet_descriptor_deinit(struct rmnet_port *port)
 	}
 
 	kfree(pool);
+	port->frag_desc_pool = NULL;
 }
 
 int rmnet_descriptor_init(struct rmnet_port *port)
@@ -1995,6 +2150,10 @@ int rmnet_descriptor_init(struct rmnet_port *port)
 	INIT_LIST_HEAD(&pool->free_list);
 	port->frag_desc_pool = pool;
 
+	pool->cache = alloc_percpu_gfp(struct rmnet_frag_cache, GFP_ATOMIC);
+	if (!pool->cache)
+		return -ENOMEM;
+
 	for (i = 0; i < RMNET_FRAG_DESCRIPTOR_POOL_SIZE; i++) {
 		struct rmnet_frag_descriptor *frag_desc;
 
@@ -2010,3 +2169,69 @@ int rmnet_descriptor_init(struct rmnet_port *port)
 
 	return 0;
 }
+
+/* Release the fragments cached across all ports. Called on module exit */
+void rmnet_descriptor_exit(void)
+{
+	struct rmnet_fragment *frag, *tmp;
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		struct rmnet_frag_cache *cache;
+
+		cache = per_cpu_ptr(&rmnet_frag_pcpu_cache, cpu);
+		while (cache->count) {
+			frag = list_entry(cache->objs[--cache->count],
+					  struct rmnet_fragment, list);
+			kfree(frag);
+		}
+	}
+
+	list_for_each_entry_safe(frag, tmp, &rmnet_frag_free_list, list) {
+		list_del(&frag->list);
+		kfree(frag);
+	}
+}
+
+static void rmnet_frag_cache_stats_add(struct rmnet_frag_cache_stats *to,
+				       struct rmnet_frag_cache_stats *from)
+{
+	to->hit += from->hit;
+	to->refill += from->refill;
+	to->flush += from->flush;
+	to->alloc += from->alloc;
+}
+
+void rmnet_descriptor_get_cache_stats(struct rmnet_port *port,
+				      struct rmnet_frag_cache_stats *desc,
+				      struct rmnet_frag_cache_stats *frag)
+{
+	struct rmnet_frag_descriptor_pool *pool = port->frag_desc_pool;
+	int cpu;
+
+	memset(desc, 0, sizeof(*desc));
+	memset(frag, 0, sizeof(*frag));
+	for_each_possible_cpu(cpu) {
+		if (pool && pool->cache)
+			rmnet_frag_cache_stats_add(desc,
+				&per_cpu_ptr(pool->cache, cpu)->stats);
+
+		rmnet_frag_cache_stats_add(frag,
+			&per_cpu_ptr(&rmnet_frag_pcpu_cache, cpu)->stats);
+	}
+}
+
+void rmnet_descriptor_reset_cache_stats(struct rmnet_port *port)
+{
+	struct rmnet_frag_descriptor_pool *pool = port->frag_desc_pool;
+	int cpu;
+
+	for_each_possible_cpu(cpu) {
+		if (pool && pool->cache)
+			memset(&per_cpu_ptr(pool->cache, cpu)->stats, 0,
+			       sizeof(struct rmnet_frag_cache_stats));
+
+		memset(&per_cpu_ptr(&rmnet_frag_pcpu_cache, cpu)->stats, 0,
+		       sizeof(struct rmnet_frag_cache_stats));
+	}
+}
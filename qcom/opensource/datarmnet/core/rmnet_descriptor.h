@@ -23,9 +23,24 @@
 #include "rmnet_config.h"
 #include "rmnet_map.h"
 
+/* Number of free objects each CPU keeps on hand before going to the depot */
+#define RMNET_FRAG_CACHE_SIZE 32
+
+/* Per-CPU magazine of free descriptors or fragments. Objects are refilled
+ * from and flushed to a shared depot in batches of half the magazine size,
+ * so the depot lock is only taken once per batch.
+ */
+struct rmnet_frag_cache {
+	struct list_head *objs[RMNET_FRAG_CACHE_SIZE];
+	u32 count;
+	struct rmnet_frag_cache_stats stats;
+};
+
 struct rmnet_frag_descriptor_pool {
+	/* Depot, protected by port->desc_pool_lock */
 	struct list_head free_list;
 	u32 pool_size;
+	struct rmnet_frag_cache __percpu *cache;
 };
 
 struct rmnet_fragment {
@@ -102,6 +117,11 @@ void rmnet_frag_ingress_handler(struct sk_buff *skb,
 
 int rmnet_descriptor_init(struct rmnet_port *port);
 void rmnet_descriptor_deinit(struct rmnet_port *port);
+void rmnet_descriptor_exit(void);
+void rmnet_descriptor_get_cache_stats(struct rmnet_port *port,
+				      struct rmnet_frag_cache_stats *desc,
+				      struct rmnet_frag_cache_stats *frag);
+void rmnet_descriptor_reset_cache_stats(struct rmnet_port *port);
 
 static inline void *rmnet_frag_data_ptr(struct rmnet_frag_descriptor *frag_desc)
 {
@@ -19,6 +19,7 @@ static struct nla_policy rmnet_genl_attr_policy[RMNET_CORE_GENL_ATTR_MAX +
 	[RMNET_CORE_GENL_ATTR_PID_BPS] = NLA_POLICY_EXACT_LEN(sizeof(struct rmnet_core_pid_bps_resp)),
 	[RMNET_CORE_GENL_ATTR_PID_BOOST] = NLA_POLICY_EXACT_LEN(sizeof(struct rmnet_core_pid_boost_req)),
 	[RMNET_CORE_GENL_ATTR_TETHER_INFO] = NLA_POLICY_EXACT_LEN(sizeof(struct rmnet_core_tether_info_req)),
+	[RMNET_CORE_GENL_ATTR_AGG_CTL] = NLA_POLICY_EXACT_LEN(sizeof(struct rmnet_core_agg_ctl_resp)),
 	[RMNET_CORE_GENL_ATTR_STR]  = { .type = NLA_NUL_STRING, .len =
 				RMNET_CORE_GENL_MAX_STR_LEN },
 };
@@ -38,6 +39,8 @@ static const struct genl_ops rmnet_core_genl_ops[] = {
 			   rmnet_core_genl_pid_boost_req_hdlr),
 	RMNET_CORE_GENL_OP(RMNET_CORE_GENL_CMD_TETHER_INFO_REQ,
 			   rmnet_core_genl_tether_info_req_hdlr),
+	RMNET_CORE_GENL_OP(RMNET_CORE_GENL_CMD_AGG_CTL_REQ,
+			   rmnet_core_genl_agg_ctl_req_hdlr),
 };
 
 struct genl_family rmnet_core_genl_family = {
@@ -81,6 +84,13 @@ struct rmnet_pid_node_s {
 	pid_t pid;
 };
 
+/* Ring of the most recent UL aggregation controller decisions */
+static struct rmnet_core_agg_ctl_info
+rmnet_agg_ctl_ring[RMNET_CORE_GENL_MAX_AGG_CTL];
+static u32 rmnet_agg_ctl_head;
+static u32 rmnet_agg_ctl_len;
+static DEFINE_SPINLOCK(rmnet_agg_ctl_splock);
+
 typedef void (*rmnet_perf_tether_cmd_hook_t)(u8 message, u64 val);
 rmnet_perf_tether_cmd_hook_t rmnet_perf_tether_cmd_hook __rcu __read_mostly;
 EXPORT_SYMBOL(rmnet_perf_tether_cmd_hook);
@@ -432,6 +442,97 @@ int rmnet_core_genl_tether_info_req_hdlr(struct sk_buff *skb_2,
 	return RMNET_GENL_SUCCESS;
 }
 
+void rmnet_core_genl_agg_ctl_record(struct rmnet_core_agg_ctl_info *info)
+{
+	unsigned long ht_flags;
+
+	spin_lock_irqsave(&rmnet_agg_ctl_splock, ht_flags);
+	rmnet_agg_ctl_ring[rmnet_agg_ctl_head] = *info;
+	rmnet_agg_ctl_head = (rmnet_agg_ctl_head + 1) %
+			     RMNET_CORE_GENL_MAX_AGG_CTL;
+	if (rmnet_agg_ctl_len < RMNET_CORE_GENL_MAX_AGG_CTL)
+		rmnet_agg_ctl_len++;
+	spin_unlock_irqrestore(&rmnet_agg_ctl_splock, ht_flags);
+}
+
+/* Move the recorded decisions, oldest first, into the response */
+static void rmnet_create_agg_ctl_resp(struct rmnet_core_agg_ctl_resp *resp)
+{
+	struct timespec64 time;
+	unsigned long ht_flags;
+	u32 i, idx;
+
+	ktime_get_real_ts64(&time);
+	resp->timestamp = RMNET_GENL_SEC_TO_NSEC(time.tv_sec) + time.tv_nsec;
+
+	spin_lock_irqsave(&rmnet_agg_ctl_splock, ht_flags);
+	idx = (rmnet_agg_ctl_head + RMNET_CORE_GENL_MAX_AGG_CTL -
+	       rmnet_agg_ctl_len) % RMNET_CORE_GENL_MAX_AGG_CTL;
+	for (i = 0; i < rmnet_agg_ctl_len; i++) {
+		resp->list[i] = rmnet_agg_ctl_ring[idx];
+		idx = (idx + 1) % RMNET_CORE_GENL_MAX_AGG_CTL;
+	}
+
+	resp->list_len = rmnet_agg_ctl_len;
+	rmnet_agg_ctl_len = 0;
+	spin_unlock_irqrestore(&rmnet_agg_ctl_splock, ht_flags);
+}
+
+int rmnet_core_genl_agg_ctl_req_hdlr(struct sk_buff *skb_2,
+				     struct genl_info *info)
+{
+	struct rmnet_core_agg_ctl_resp *resp;
+	struct sk_buff *skb;
+	void *msg_head;
+	int rc;
+
+	rm_err("CORE_GNL: %s", __func__);
+
+	if (!info) {
+		rm_err("%s", "CORE_GNL: error - info is null");
+		return RMNET_GENL_FAILURE;
+	}
+
+	resp = kzalloc(sizeof(*resp), GFP_KERNEL);
+	if (!resp)
+		return RMNET_GENL_FAILURE;
+
+	rmnet_create_agg_ctl_resp(resp);
+	resp->valid = 1;
+
+	skb = genlmsg_new(sizeof(*resp), GFP_KERNEL);
+	if (!skb)
+		goto out;
+
+	msg_head = genlmsg_put(skb, 0, info->snd_seq + 1,
+			       &rmnet_core_genl_family,
+			       0, RMNET_CORE_GENL_CMD_AGG_CTL_REQ);
+	if (!msg_head) {
+		nlmsg_free(skb);
+		goto out;
+	}
+
+	rc = nla_put(skb, RMNET_CORE_GENL_ATTR_AGG_CTL, sizeof(*resp), resp);
+	if (rc != 0) {
+		nlmsg_free(skb);
+		goto out;
+	}
+
+	genlmsg_end(skb, msg_head);
+
+	rc = genlmsg_unicast(genl_info_net(info), skb, info->snd_portid);
+	if (rc != 0)
+		goto out;
+
+	kfree(resp);
+	return RMNET_GENL_SUCCESS;
+
+out:
+	rm_err("%s", "CORE_GNL: FAILED to send agg ctl info\n");
+	kfree(resp);
+	return RMNET_GENL_FAILURE;
+}
+
 /* register new rmnet core driver generic netlink family */
 int rmnet_core_genl_init(void)
 {
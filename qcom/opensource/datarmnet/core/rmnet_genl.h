@@ -20,6 +20,7 @@
 #define RMNET_CORE_GENL_FAMILY_NAME "RMNET_CORE"
 
 #define RMNET_CORE_GENL_MAX_PIDS 32
+#define RMNET_CORE_GENL_MAX_AGG_CTL 32
 
 #define RMNET_GENL_SUCCESS (0)
 #define RMNET_GENL_FAILURE (-1)
@@ -31,6 +32,7 @@ enum {
 	RMNET_CORE_GENL_CMD_PID_BPS_REQ,
 	RMNET_CORE_GENL_CMD_PID_BOOST_REQ,
 	RMNET_CORE_GENL_CMD_TETHER_INFO_REQ,
+	RMNET_CORE_GENL_CMD_AGG_CTL_REQ,
 	__RMNET_CORE_GENL_CMD_MAX,
 };
 
@@ -41,6 +43,7 @@ enum {
 	RMNET_CORE_GENL_ATTR_PID_BPS,
 	RMNET_CORE_GENL_ATTR_PID_BOOST,
 	RMNET_CORE_GENL_ATTR_TETHER_INFO,
+	RMNET_CORE_GENL_ATTR_AGG_CTL,
 	__RMNET_CORE_GENL_ATTR_MAX,
 };
 
@@ -86,6 +89,27 @@ struct rmnet_core_tether_info_req {
 	uint8_t valid;
 };
 
+/* Adaptive UL aggregation decision */
+struct rmnet_core_agg_ctl_info {
+	u64 timestamp;
+	/* EWMA of packet inter-arrival time */
+	u64 ewma_iat_ns;
+	u32 agg_time_ns;
+	u32 agg_time_limit_ns;
+	/* EWMA of packets per aggregate, in 1/16 packet units */
+	u32 ewma_fill;
+	u8 agg_count;
+	u8 agg_state;
+	u8 sparse;
+};
+
+struct rmnet_core_agg_ctl_resp {
+	struct rmnet_core_agg_ctl_info list[RMNET_CORE_GENL_MAX_AGG_CTL];
+	u64 timestamp;
+	u16 list_len;
+	u8 valid;
+};
+
 /* Function Prototypes */
 int rmnet_core_genl_pid_bps_req_hdlr(struct sk_buff *skb_2,
 				     struct genl_info *info);
@@ -96,6 +120,12 @@ int rmnet_core_genl_pid_boost_req_hdlr(struct sk_buff *skb_2,
 int rmnet_core_genl_tether_info_req_hdlr(struct sk_buff *skb_2,
 					 struct genl_info *info);
 
+int rmnet_core_genl_agg_ctl_req_hdlr(struct sk_buff *skb_2,
+				     struct genl_info *info);
+
+/* Called by the UL aggregation controller on every decision change */
+void rmnet_core_genl_agg_ctl_record(struct rmnet_core_agg_ctl_info *info);
+
 /* Called by vnd select queue */
 void rmnet_update_pid_and_check_boost(pid_t pid, unsigned int len,
 				      int *boost_enable, u64 *boost_period);
@@ -20,6 +20,9 @@
 #include <linux/ip.h>
 #include <linux/ipv6.h>
 #include <linux/inet.h>
+#include <linux/jhash.h>
+#include <net/ip.h>
+#include <net/ipv6.h>
 #include <net/sock.h>
 #include <linux/tracepoint.h>
 #include "rmnet_private.h"
@@ -182,6 +185,160 @@ rmnet_deliver_skb_wq(struct sk_buff *skb, struct rmnet_port *port,
 }
 EXPORT_SYMBOL(rmnet_deliver_skb_wq);
 
+/* Flows grouped per batch. Packets from any further flows are delivered
+ * after the groups, in arrival order.
+ */
+#define RMNET_RX_BATCH_FLOWS 8
+
+/* Cheap flow key, only used to group a batch. Not exposed as skb->hash */
+static u32 rmnet_skb_flow_key(struct sk_buff *skb)
+{
+	u32 *ports, __ports, l4 = 0;
+
+	if (skb->sw_hash || skb->l4_hash)
+		return skb->hash;
+
+	if (skb->protocol == htons(ETH_P_IP)) {
+		struct iphdr *iph, __iph;
+
+		iph = skb_header_pointer(skb, 0, sizeof(*iph), &__iph);
+		if (!iph)
+			return 0;
+
+		if (!ip_is_fragment(iph) &&
+		    (iph->protocol == IPPROTO_TCP ||
+		     iph->protocol == IPPROTO_UDP)) {
+			ports = skb_header_pointer(skb, iph->ihl * 4,
+						   sizeof(*ports), &__ports);
+			if (ports)
+				l4 = *ports;
+		}
+
+		return jhash_3words((__force u32)iph->saddr,
+				    (__force u32)iph->daddr,
+				    l4 ^ iph->protocol, 0);
+	} else if (skb->protocol == htons(ETH_P_IPV6)) {
+		struct ipv6hdr *ip6h, __ip6h;
+
+		ip6h = skb_header_pointer(skb, 0, sizeof(*ip6h), &__ip6h);
+		if (!ip6h)
+			return 0;
+
+		if (ip6h->nexthdr == IPPROTO_TCP ||
+		    ip6h->nexthdr == IPPROTO_UDP) {
+			ports = skb_header_pointer(skb, sizeof(*ip6h),
+						   sizeof(*ports), &__ports);
+			if (ports)
+				l4 = *ports;
+		}
+
+		return jhash_3words(ipv6_addr_hash(&ip6h->saddr),
+				    ipv6_addr_hash(&ip6h->daddr),
+				    l4 ^ ip6h->nexthdr, 0);
+	}
+
+	return 0;
+}
+
+/* Reorder the batch so that each flow's packets are contiguous, keeping
+ * the order within every flow.
+ */
+static void rmnet_skb_batch_group(struct sk_buff_head *head,
+				  struct rmnet_port *port)
+{
+	struct sk_buff_head groups[RMNET_RX_BATCH_FLOWS], rest;
+	u32 keys[RMNET_RX_BATCH_FLOWS];
+	struct sk_buff *skb;
+	int flows = 0, i;
+
+	__skb_queue_head_init(&rest);
+	while ((skb = __skb_dequeue(head))) {
+		u32 key = rmnet_skb_flow_key(skb);
+
+		for (i = 0; i < flows; i++) {
+			if (keys[i] == key)
+				break;
+		}
+
+		if (i == flows) {
+			if (flows == RMNET_RX_BATCH_FLOWS) {
+				__skb_queue_tail(&rest, skb);
+				continue;
+			}
+
+			keys[flows] = key;
+			__skb_queue_head_init(&groups[flows++]);
+		}
+
+		__skb_queue_tail(&groups[i], skb);
+	}
+
+	for (i = 0; i < flows; i++)
+		skb_queue_splice_tail(&groups[i], head);
+
+	skb_queue_splice_tail(&rest, head);
+	port->stats.rx_batch.flows += flows;
+	if (!skb_queue_empty(&rest))
+		port->stats.rx_batch.overflow++;
+}
+
+/* Deliver a batch of skbs built from an aggregated frame chain. SHS gets
+ * the whole batch if it takes lists, and netif_receive_skb_list() is used
+ * when SHS is not loaded.
+ */
+void rmnet_deliver_skb_batch(struct sk_buff_head *head,
+			     struct rmnet_port *port)
+{
+	int (*rmnet_shs_stamp)(struct sk_buff *skb,
+			       struct rmnet_shs_clnt_s *cfg);
+	struct sk_buff *skb;
+	LIST_HEAD(rx_list);
+
+	if (skb_queue_empty(head))
+		return;
+
+	port->stats.rx_batch.batches++;
+	port->stats.rx_batch.pkts += skb_queue_len(head);
+	rmnet_skb_batch_group(head, port);
+
+	skb_queue_walk(head, skb) {
+		trace_rmnet_low(RMNET_MODULE, RMNET_DLVR_SKB, 0xDEF, 0xDEF,
+				0xDEF, 0xDEF, (void *)skb, NULL);
+		skb_reset_network_header(skb);
+		rmnet_vnd_rx_fixup(skb->dev, skb->len);
+
+		skb->pkt_type = PACKET_HOST;
+		skb_set_mac_header(skb, 0);
+	}
+
+	if (rmnet_module_hook_shs_skb_list_entry(head, &port->shs_cfg)) {
+		port->stats.rx_batch.shs_list++;
+		return;
+	}
+
+	rcu_read_lock();
+	rmnet_shs_stamp = rcu_dereference(rmnet_shs_skb_entry);
+	if (rmnet_shs_stamp) {
+		while ((skb = __skb_dequeue(head)))
+			rmnet_shs_stamp(skb, &port->shs_cfg);
+
+		rcu_read_unlock();
+		return;
+	}
+	rcu_read_unlock();
+
+	while ((skb = __skb_dequeue(head))) {
+		if (rmnet_module_hook_shs_skb_ll_entry(NULL, skb,
+						       &port->shs_cfg))
+			continue;
+
+		list_add_tail(&skb->list, &rx_list);
+	}
+
+	netif_receive_skb_list(&rx_list);
+}
+EXPORT_SYMBOL(rmnet_deliver_skb_batch);
+
 /* Deliver a list of skbs after undoing coalescing */
 static void rmnet_deliver_skb_list(struct sk_buff_head *head,
 				   struct rmnet_port *port)
@@ -376,8 +533,7 @@ static int rmnet_map_egress_handler(struct sk_buff *skb,
 	if (csum_type &&
 	    (skb_shinfo(skb)->gso_type & (SKB_GSO_UDP_L4 | SKB_GSO_TCPV4 | SKB_GSO_TCPV6)) &&
 	     skb_shinfo(skb)->gso_size) {
-		spin_lock_bh(&state->agg_lock);
-		rmnet_map_send_agg_skb(state);
+		rmnet_map_tx_agg_flush(state, skb);
 
 		if (rmnet_map_add_tso_header(skb, port, orig_dev))
 			return -EINVAL;
@@ -25,6 +25,8 @@ enum rmnet_packet_context {
 
 void rmnet_egress_handler(struct sk_buff *skb, bool low_latency);
 void rmnet_deliver_skb(struct sk_buff *skb, struct rmnet_port *port);
+void rmnet_deliver_skb_batch(struct sk_buff_head *head,
+			     struct rmnet_port *port);
 void rmnet_deliver_skb_wq(struct sk_buff *skb, struct rmnet_port *port,
 			  enum rmnet_packet_context ctx);
 void rmnet_set_skb_proto(struct sk_buff *skb);
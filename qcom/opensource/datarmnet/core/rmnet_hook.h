@@ -48,6 +48,15 @@ RMNET_MODULE_HOOK(shs_skb_ll_entry,
 	RMNET_MODULE_HOOK_RETURN_TYPE(int)
 );
 
+/* Takes ownership of every skb on the list */
+RMNET_MODULE_HOOK(shs_skb_list_entry,
+	RMNET_MODULE_HOOK_NUM(SHS_SKB_LIST_ENTRY),
+	RMNET_MODULE_HOOK_PROTOCOL(struct sk_buff_head *list,
+				   struct rmnet_shs_clnt_s *cfg),
+	RMNET_MODULE_HOOK_ARGS(list, cfg),
+	RMNET_MODULE_HOOK_RETURN_TYPE(void)
+);
+
 RMNET_MODULE_HOOK(shs_switch,
 	RMNET_MODULE_HOOK_NUM(SHS_SWITCH),
 	RMNET_MODULE_HOOK_PROTOCOL(struct sk_buff *skb,
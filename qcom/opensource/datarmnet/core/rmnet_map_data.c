@@ -23,6 +23,7 @@
 #include "rmnet_private.h"
 #include "rmnet_handlers.h"
 #include "rmnet_ll.h"
+#include "rmnet_genl.h"
 
 #define RMNET_MAP_PKT_COPY_THRESHOLD 64
 #define RMNET_MAP_DEAGGR_SPACING  64
@@ -718,12 +719,17 @@ static void rmnet_map_partial_csum(struct sk_buff *skb,
 	if (coal_meta->ip_proto == 4) {
 		struct iphdr *iph = (struct iphdr *)data;
 
+		iph->tot_len = htons(skb->len);
+		iph->check = 0;
+		iph->check = ip_fast_csum(iph, iph->ihl);
 		pseudo = ~csum_tcpudp_magic(iph->saddr, iph->daddr,
 					    pkt_len, coal_meta->trans_proto,
 					    0);
 	} else {
 		struct ipv6hdr *ip6h = (struct ipv6hdr *)data;
 
+		/* Payload length includes any extension headers */
+		ip6h->payload_len = htons(skb->len - sizeof(*ip6h));
 		pseudo = ~csum_ipv6_magic(&ip6h->saddr, &ip6h->daddr,
 					  pkt_len, coal_meta->trans_proto, 0);
 	}
@@ -736,6 +742,7 @@ static void rmnet_map_partial_csum(struct sk_buff *skb,
 	} else {
 		struct udphdr *up = (struct udphdr *)(data + coal_meta->ip_len);
 
+		up->len = htons(pkt_len);
 		up->check = pseudo;
 		skb->csum_offset = offsetof(struct udphdr, check);
 	}
@@ -1231,6 +1238,151 @@ int rmnet_map_process_next_hdr_packet(struct sk_buff *skb,
 long rmnet_agg_time_limit __read_mostly = 1000000L;
 long rmnet_agg_bypass_time __read_mostly = 10000000L;
 
+/* Adaptive aggregation controller tunables. Inter-arrival samples are
+ * clamped to the bypass time so a single idle period doesn't dominate.
+ */
+#define RMNET_AGG_CTL_MIN_TIME 100000U
+#define RMNET_AGG_CTL_IAT_SHIFT 3
+#define RMNET_AGG_CTL_FILL_SHIFT 2
+#define RMNET_AGG_CTL_FILL_SCALE 16
+
+static bool rmnet_map_agg_adaptive(struct rmnet_aggregation_state *state)
+{
+	return state->params.agg_features & RMNET_ADAPTIVE_AGG;
+}
+
+/* The limits in force for an aggregation buffer. @ctl is the controller of
+ * that buffer: the shared state's own, or that of a per-CPU buffer.
+ */
+static u32 rmnet_map_agg_time(struct rmnet_aggregation_state *state,
+			      struct rmnet_agg_ctl *ctl)
+{
+	if (rmnet_map_agg_adaptive(state))
+		return ctl->time;
+
+	return state->params.agg_time;
+}
+
+static long rmnet_map_agg_time_limit(struct rmnet_aggregation_state *state,
+				     struct rmnet_agg_ctl *ctl)
+{
+	if (rmnet_map_agg_adaptive(state))
+		return ctl->time_limit;
+
+	return rmnet_agg_time_limit;
+}
+
+static u8 rmnet_map_agg_count(struct rmnet_aggregation_state *state,
+			      struct rmnet_agg_ctl *ctl)
+{
+	if (rmnet_map_agg_adaptive(state))
+		return ctl->count;
+
+	return state->params.agg_count;
+}
+
+static void rmnet_map_agg_ctl_reset(struct rmnet_aggregation_state *state,
+				    struct rmnet_agg_ctl *ctl)
+{
+	memset(ctl, 0, sizeof(*ctl));
+	ctl->time = state->params.agg_time;
+	ctl->time_limit = min_t(long, rmnet_agg_time_limit,
+				state->params.agg_time);
+	ctl->count = state->params.agg_count;
+}
+
+/* Track packet inter-arrival time, from the arrival before @now at @last.
+ * Must hold the lock of the buffer @ctl belongs to.
+ */
+static void rmnet_map_agg_ctl_sample(struct rmnet_aggregation_state *state,
+				     struct rmnet_agg_ctl *ctl,
+				     struct timespec64 *now,
+				     struct timespec64 *last)
+{
+	struct timespec64 diff;
+	u64 iat;
+
+	if (!rmnet_map_agg_adaptive(state))
+		return;
+
+	diff = timespec64_sub(*now, *last);
+	iat = min_t(u64, timespec64_to_ns(&diff), rmnet_agg_bypass_time);
+	ctl->ewma_iat = ctl->ewma_iat - (ctl->ewma_iat >> RMNET_AGG_CTL_IAT_SHIFT) +
+			(iat >> RMNET_AGG_CTL_IAT_SHIFT);
+}
+
+/* Retune the limits when an aggregate of @agg_count packets goes out. If a
+ * full aggregate takes longer than the modem's timer to fill, the traffic is
+ * sparse: holding packets for the whole timer only adds latency, so wait
+ * about two inter-arrival times instead. Otherwise let aggregates grow to
+ * the full modem limits rather than closing them early on the static age
+ * limit. Must hold the lock of the buffer @ctl belongs to.
+ */
+static void rmnet_map_agg_ctl_flush(struct rmnet_aggregation_state *state,
+				    struct rmnet_agg_ctl *ctl, u8 agg_count)
+{
+	struct rmnet_egress_agg_params *params = &state->params;
+	struct rmnet_core_agg_ctl_info info;
+	struct timespec64 now;
+	u64 fill_time, time;
+	u32 count, time_limit;
+	u8 sparse;
+
+	if (!rmnet_map_agg_adaptive(state))
+		return;
+
+	ctl->ewma_fill = ctl->ewma_fill -
+			 (ctl->ewma_fill >> RMNET_AGG_CTL_FILL_SHIFT) +
+			 ((agg_count * RMNET_AGG_CTL_FILL_SCALE) >>
+			  RMNET_AGG_CTL_FILL_SHIFT);
+
+	/* The modem limits may be below the floors, so cap the floors first
+	 * to keep each clamp's lower bound at or below its upper bound.
+	 */
+	fill_time = ctl->ewma_iat * params->agg_count;
+	if (fill_time > params->agg_time) {
+		sparse = 1;
+		time = clamp_t(u64, ctl->ewma_iat * 2,
+			       min_t(u64, RMNET_AGG_CTL_MIN_TIME,
+				     params->agg_time),
+			       params->agg_time);
+		count = clamp_t(u32, div64_u64(time, ctl->ewma_iat ?: 1) + 1,
+				min_t(u32, 2, params->agg_count),
+				params->agg_count);
+		time_limit = time;
+	} else {
+		sparse = 0;
+		time = params->agg_time;
+		count = params->agg_count;
+		time_limit = clamp_t(u64, fill_time * 2,
+				     min_t(u64, rmnet_agg_time_limit,
+					   params->agg_time),
+				     params->agg_time);
+	}
+
+	if (time == ctl->time && count == ctl->count &&
+	    time_limit == ctl->time_limit && sparse == ctl->sparse)
+		return;
+
+	ctl->time = time;
+	ctl->count = count;
+	ctl->time_limit = time_limit;
+	ctl->sparse = sparse;
+
+	ktime_get_real_ts64(&now);
+	memset(&info, 0, sizeof(info));
+	info.timestamp = timespec64_to_ns(&now);
+	info.ewma_iat_ns = ctl->ewma_iat;
+	info.agg_time_ns = ctl->time;
+	info.agg_time_limit_ns = ctl->time_limit;
+	info.ewma_fill = ctl->ewma_fill;
+	info.agg_count = ctl->count;
+	info.agg_state = state->send_agg_skb == rmnet_ll_send_skb ?
+			 RMNET_LL_AGG_STATE : RMNET_DEFAULT_AGG_STATE;
+	info.sparse = sparse;
+	rmnet_core_genl_agg_ctl_record(&info);
+}
+
 int rmnet_map_tx_agg_skip(struct sk_buff *skb, int offset)
 {
 	u8 *packet_start = skb->data + offset;
@@ -1259,6 +1411,133 @@ int rmnet_map_tx_agg_skip(struct sk_buff *skb, int offset)
 	return is_icmp;
 }
 
+static bool rmnet_map_agg_pcpu(struct rmnet_aggregation_state *state)
+{
+	return state->pcpu && (state->params.agg_features & RMNET_PCPU_AGG);
+}
+
+/* Take a CPU's aggregation buffer for sending. Must hold pcpu->lock.
+ * Returns the buffer, or NULL if there is none, and sets @gen to the
+ * generation it must be sent as. Without a buffer, @gen is that of the next
+ * one, so rmnet_map_pcpu_send() waits for all the buffers taken so far.
+ */
+static struct sk_buff *
+__rmnet_map_pcpu_detach(struct rmnet_aggregation_state *state,
+			struct rmnet_agg_pcpu *pcpu, int reason, u32 *gen)
+{
+	struct sk_buff *agg_skb = pcpu->agg_skb;
+
+	*gen = pcpu->flush_gen;
+	if (!agg_skb)
+		return NULL;
+
+	rmnet_map_agg_ctl_flush(state, &pcpu->ctl, pcpu->agg_count);
+	pcpu->agg_skb = NULL;
+	pcpu->agg_count = 0;
+	memset(&pcpu->agg_time, 0, sizeof(pcpu->agg_time));
+	WRITE_ONCE(pcpu->flush_gen, pcpu->flush_gen + 1);
+	pcpu->flush[reason]++;
+	return agg_skb;
+}
+
+/* Send a buffer taken by __rmnet_map_pcpu_detach(), without holding
+ * pcpu->lock. The buffers of a CPU may be taken by different CPUs, so each
+ * one waits for the ones taken before it to be sent. Call with BHs
+ * disabled.
+ */
+static void rmnet_map_pcpu_send(struct rmnet_aggregation_state *state,
+				struct rmnet_agg_pcpu *pcpu,
+				struct sk_buff *agg_skb, u32 gen)
+{
+	while (smp_load_acquire(&pcpu->sent_gen) != gen)
+		cpu_relax();
+
+	if (!agg_skb)
+		return;
+
+	state->send_agg_skb(agg_skb);
+	smp_store_release(&pcpu->sent_gen, gen + 1);
+}
+
+/* Whether the buffer generation @gen, as kept in flow_owner, was sent */
+static bool rmnet_map_pcpu_sent(struct rmnet_agg_pcpu *pcpu, u32 gen)
+{
+	return !((smp_load_acquire(&pcpu->sent_gen) - gen - 1) & 0x800000);
+}
+
+static void rmnet_map_pcpu_flush_cpu(struct rmnet_aggregation_state *state,
+				     int cpu, int reason)
+{
+	struct rmnet_agg_pcpu *pcpu = per_cpu_ptr(state->pcpu, cpu);
+	struct sk_buff *agg_skb;
+	u32 gen;
+
+	spin_lock_bh(&pcpu->lock);
+	agg_skb = __rmnet_map_pcpu_detach(state, pcpu, reason, &gen);
+	spin_unlock(&pcpu->lock);
+	rmnet_map_pcpu_send(state, pcpu, agg_skb, gen);
+	local_bh_enable();
+}
+
+static void rmnet_map_pcpu_flush_all(struct rmnet_aggregation_state *state,
+				     int reason)
+{
+	int cpu;
+
+	if (!state->pcpu)
+		return;
+
+	for_each_possible_cpu(cpu)
+		rmnet_map_pcpu_flush_cpu(state, cpu, reason);
+}
+
+static u32 rmnet_map_pcpu_flow_bucket(struct sk_buff *skb)
+{
+	return (skb_get_hash(skb) ^ skb->mark) & (RMNET_AGG_FLOW_BUCKETS - 1);
+}
+
+/* Packets of a flow must leave in the order they were sent. If another CPU
+ * may still hold buffered packets of this flow, send its buffer out before
+ * the local CPU queues anything for the flow.
+ */
+static void rmnet_map_pcpu_claim_flow(struct rmnet_aggregation_state *state,
+				      u32 bucket, int cpu)
+{
+	struct rmnet_agg_pcpu *remote;
+	u32 owner, owner_cpu;
+
+	owner = READ_ONCE(state->flow_owner[bucket]);
+	owner_cpu = owner & 0xFF;
+	if (!owner_cpu || owner_cpu - 1 == cpu)
+		return;
+
+	/* Skip the remote lock if that buffer was sent already */
+	remote = per_cpu_ptr(state->pcpu, owner_cpu - 1);
+	if (rmnet_map_pcpu_sent(remote, owner >> 8))
+		return;
+
+	if ((READ_ONCE(remote->flush_gen) & 0xFFFFFF) == owner >> 8)
+		rmnet_map_pcpu_flush_cpu(state, owner_cpu - 1,
+					 RMNET_AGG_FLUSH_FLOW);
+
+	/* Taken already by a flush on another CPU, which may still be
+	 * sending it
+	 */
+	while (!rmnet_map_pcpu_sent(remote, owner >> 8))
+		cpu_relax();
+}
+
+/* Record that the current buffer of this CPU holds packets of the flow.
+ * Must hold pcpu->lock.
+ */
+static void rmnet_map_pcpu_own_flow(struct rmnet_aggregation_state *state,
+				    struct rmnet_agg_pcpu *pcpu, u32 bucket,
+				    int cpu)
+{
+	WRITE_ONCE(state->flow_owner[bucket],
+		   ((pcpu->flush_gen & 0xFFFFFF) << 8) | (cpu + 1));
+}
+
 static void rmnet_map_flush_tx_packet_work(struct work_struct *work)
 {
 	struct sk_buff *skb = NULL;
@@ -1266,11 +1545,18 @@ static void rmnet_map_flush_tx_packet_work(struct work_struct *work)
 
 	state = container_of(work, struct rmnet_aggregation_state, agg_wq);
 
+	if (state->pcpu) {
+		clear_bit(0, &state->pcpu_timer_armed);
+		rmnet_map_pcpu_flush_all(state, RMNET_AGG_FLUSH_TIMER);
+	}
+
 	spin_lock_bh(&state->agg_lock);
 	if (likely(state->agg_state == -EINPROGRESS)) {
 		/* Buffer may have already been shipped out */
 		if (likely(state->agg_skb)) {
 			skb = state->agg_skb;
+			rmnet_map_agg_ctl_flush(state, &state->ctl,
+						state->agg_count);
 			state->agg_skb = NULL;
 			state->agg_count = 0;
 			memset(&state->agg_time, 0, sizeof(state->agg_time));
@@ -1437,6 +1723,139 @@ rmnet_map_build_skb(struct rmnet_aggregation_state *state)
 	return skb;
 }
 
+/* Fill level of the header page of an SG aggregate, kept in its cb until
+ * the aggregate is sent.
+ */
+struct rmnet_map_agg_sg_cb {
+	u32 hdr_off;
+};
+
+#define RMNET_MAP_AGG_SG_CB(skb) ((struct rmnet_map_agg_sg_cb *)(skb)->cb)
+
+static bool rmnet_map_agg_use_sg(struct rmnet_aggregation_state *state,
+				 struct sk_buff *skb)
+{
+	/* Packets are handed to the transport as they are, so they must not
+	 * need a checksum. Their page frags are referenced rather than copied,
+	 * which rules out frag lists and user pages.
+	 */
+	return (state->params.agg_features & RMNET_SG_AGG) &&
+	       (skb->dev->features & NETIF_F_SG) &&
+	       skb->ip_summed != CHECKSUM_PARTIAL &&
+	       !skb_has_frag_list(skb) && !skb_zcopy(skb) &&
+	       skb_headlen(skb) <= PAGE_SIZE &&
+	       skb_shinfo(skb)->nr_frags < MAX_SKB_FRAGS;
+}
+
+/* Add skb to an SG aggregate. The linear part of skb, which holds its MAP
+ * header, is copied into the header page @hdr and the page frags of skb are
+ * referenced, so skb itself can be freed even if it is a clone.
+ */
+static void rmnet_map_agg_sg_add(struct sk_buff *agg_skb, struct page *hdr,
+				 struct sk_buff *skb)
+{
+	struct rmnet_map_agg_sg_cb *cb = RMNET_MAP_AGG_SG_CB(agg_skb);
+	struct skb_shared_info *shinfo = skb_shinfo(skb);
+	unsigned int hlen = skb_headlen(skb);
+	int i, n = skb_shinfo(agg_skb)->nr_frags;
+
+	/* The first header frag takes over the reference from the allocation */
+	if (n)
+		get_page(hdr);
+
+	memcpy(page_address(hdr) + cb->hdr_off, skb->data, hlen);
+	skb_fill_page_desc(agg_skb, n++, hdr, cb->hdr_off, hlen);
+	cb->hdr_off += hlen;
+
+	for (i = 0; i < shinfo->nr_frags; i++) {
+		skb_frag_ref(skb, i);
+		skb_shinfo(agg_skb)->frags[n++] = shinfo->frags[i];
+	}
+
+	skb_shinfo(agg_skb)->nr_frags = n;
+	agg_skb->len += skb->len;
+	agg_skb->data_len += skb->len;
+	agg_skb->truesize += skb->data_len;
+}
+
+/* Start a new aggregate with skb. In SG mode the aggregate is a dedicated
+ * skb with no linear data whose frags alternate between its header page and
+ * the payload pages of each packet. Otherwise skb is copied into a page
+ * backed buffer. Either way skb is freed.
+ */
+static struct sk_buff *
+rmnet_map_agg_start(struct rmnet_aggregation_state *state,
+		    struct sk_buff *skb)
+{
+	struct sk_buff *agg_skb;
+	struct page *hdr;
+
+	if (rmnet_map_agg_use_sg(state, skb)) {
+		agg_skb = alloc_skb(0, GFP_ATOMIC);
+		if (!agg_skb)
+			return NULL;
+
+		hdr = alloc_page(GFP_ATOMIC);
+		if (!hdr) {
+			kfree_skb(agg_skb);
+			return NULL;
+		}
+
+		RMNET_MAP_AGG_SG_CB(agg_skb)->hdr_off = 0;
+		agg_skb->truesize += PAGE_SIZE;
+		rmnet_map_agg_sg_add(agg_skb, hdr, skb);
+		state->stats->ul_agg_sg++;
+	} else {
+		agg_skb = rmnet_map_build_skb(state);
+		if (!agg_skb)
+			return NULL;
+
+		rmnet_map_linearize_copy(agg_skb, skb);
+	}
+
+	agg_skb->dev = skb->dev;
+	agg_skb->protocol = htons(ETH_P_MAP);
+	dev_kfree_skb_any(skb);
+	return agg_skb;
+}
+
+static bool rmnet_map_agg_fits(struct rmnet_aggregation_state *state,
+			       struct sk_buff *agg_skb, struct sk_buff *skb)
+{
+	bool sg = skb_shinfo(agg_skb)->nr_frags;
+
+	/* Don't mix SG and copied packets in one aggregate */
+	if (sg != rmnet_map_agg_use_sg(state, skb))
+		return false;
+
+	if (!sg)
+		return skb->len <= skb_tailroom(agg_skb);
+
+	return agg_skb->len + skb->len <= state->params.agg_size &&
+	       skb_shinfo(agg_skb)->nr_frags + 1 +
+	       skb_shinfo(skb)->nr_frags <= MAX_SKB_FRAGS &&
+	       RMNET_MAP_AGG_SG_CB(agg_skb)->hdr_off + skb_headlen(skb) <=
+	       PAGE_SIZE;
+}
+
+/* Add skb to the aggregate, either by referencing its pages or by copying
+ * it into the buffer, and free it.
+ */
+static void rmnet_map_agg_append(struct rmnet_aggregation_state *state,
+				 struct sk_buff *agg_skb, struct sk_buff *skb)
+{
+	if (skb_shinfo(agg_skb)->nr_frags) {
+		rmnet_map_agg_sg_add(agg_skb,
+				     skb_frag_page(&skb_shinfo(agg_skb)->frags[0]),
+				     skb);
+		state->stats->ul_agg_sg++;
+	} else {
+		rmnet_map_linearize_copy(agg_skb, skb);
+	}
+
+	dev_kfree_skb_any(skb);
+}
+
 void rmnet_map_send_agg_skb(struct rmnet_aggregation_state *state)
 {
 	struct sk_buff *agg_skb;
@@ -1447,6 +1866,7 @@ void rmnet_map_send_agg_skb(struct rmnet_aggregation_state *state)
 	}
 
 	agg_skb = state->agg_skb;
+	rmnet_map_agg_ctl_flush(state, &state->ctl, state->agg_count);
 	/* Reset the aggregation state */
 	state->agg_skb = NULL;
 	state->agg_count = 0;
@@ -1457,20 +1877,151 @@ void rmnet_map_send_agg_skb(struct rmnet_aggregation_state *state)
 	hrtimer_cancel(&state->hrtimer);
 }
 
+/* Aggregate into the local CPU's buffer. Only the buffer allocation takes
+ * the shared agg_lock; the copy into the buffer is done under the per-CPU
+ * lock, which is contended only when another CPU flushes it.
+ */
+static void rmnet_map_pcpu_aggregate(struct sk_buff *skb,
+				     struct rmnet_aggregation_state *state)
+{
+	struct rmnet_agg_pcpu *pcpu;
+	struct sk_buff *flushed = NULL;
+	struct timespec64 diff, last;
+	int cpu, reason = -1;
+	u32 bucket, gen;
+
+	bucket = rmnet_map_pcpu_flow_bucket(skb);
+	local_bh_disable();
+	cpu = smp_processor_id();
+	rmnet_map_pcpu_claim_flow(state, bucket, cpu);
+	pcpu = this_cpu_ptr(state->pcpu);
+
+	spin_lock(&pcpu->lock);
+	memcpy(&last, &pcpu->agg_last, sizeof(last));
+	ktime_get_real_ts64(&pcpu->agg_last);
+	rmnet_map_agg_ctl_sample(state, &pcpu->ctl, &pcpu->agg_last, &last);
+
+	if (pcpu->agg_skb) {
+		diff = timespec64_sub(pcpu->agg_last, pcpu->agg_time);
+		if (!rmnet_map_agg_fits(state, pcpu->agg_skb, skb))
+			reason = RMNET_AGG_FLUSH_SIZE;
+		else if (pcpu->agg_count >=
+			 rmnet_map_agg_count(state, &pcpu->ctl))
+			reason = RMNET_AGG_FLUSH_COUNT;
+		else if (diff.tv_sec > 0 ||
+			 diff.tv_nsec > rmnet_map_agg_time_limit(state,
+								 &pcpu->ctl))
+			reason = RMNET_AGG_FLUSH_TIME;
+
+		if (reason >= 0)
+			flushed = __rmnet_map_pcpu_detach(state, pcpu, reason,
+							  &gen);
+	}
+
+	if (!pcpu->agg_skb) {
+		struct sk_buff *agg_skb;
+
+		/* Same sparse traffic check as the shared buffer */
+		diff = timespec64_sub(pcpu->agg_last, last);
+		if (diff.tv_sec > 0 || diff.tv_nsec > rmnet_agg_bypass_time ||
+		    skb->len >= state->params.agg_size)
+			goto send;
+
+		spin_lock(&state->agg_lock);
+		agg_skb = rmnet_map_agg_start(state, skb);
+		spin_unlock(&state->agg_lock);
+		if (!agg_skb)
+			goto send;
+
+		pcpu->agg_skb = agg_skb;
+		pcpu->agg_count = 1;
+		memcpy(&pcpu->agg_time, &pcpu->agg_last, sizeof(last));
+	} else {
+		rmnet_map_agg_append(state, pcpu->agg_skb, skb);
+		pcpu->agg_count++;
+	}
+
+	rmnet_map_pcpu_own_flow(state, pcpu, bucket, cpu);
+	spin_unlock(&pcpu->lock);
+
+	if (flushed)
+		rmnet_map_pcpu_send(state, pcpu, flushed, gen);
+
+	if (!test_and_set_bit(0, &state->pcpu_timer_armed))
+		hrtimer_start(&state->hrtimer,
+			      ns_to_ktime(rmnet_map_agg_time(state,
+							     &pcpu->ctl)),
+			      HRTIMER_MODE_REL);
+
+	local_bh_enable();
+	return;
+
+send:
+	if (!flushed)
+		gen = pcpu->flush_gen;
+	spin_unlock(&pcpu->lock);
+
+	/* The packet goes out after any buffer of this CPU still being sent */
+	rmnet_map_pcpu_send(state, pcpu, flushed, gen);
+
+	skb->protocol = htons(ETH_P_MAP);
+	state->send_agg_skb(skb);
+	local_bh_enable();
+}
+
+/* Send out any aggregated packets that must precede skb */
+void rmnet_map_tx_agg_flush(struct rmnet_aggregation_state *state,
+			    struct sk_buff *skb)
+{
+	if (rmnet_map_agg_pcpu(state)) {
+		u32 bucket = rmnet_map_pcpu_flow_bucket(skb);
+		int cpu;
+
+		local_bh_disable();
+		cpu = smp_processor_id();
+		rmnet_map_pcpu_claim_flow(state, bucket, cpu);
+		rmnet_map_pcpu_flush_cpu(state, cpu, RMNET_AGG_FLUSH_BYPASS);
+		local_bh_enable();
+		return;
+	}
+
+	spin_lock_bh(&state->agg_lock);
+	rmnet_map_send_agg_skb(state);
+}
+
 void rmnet_map_tx_aggregate(struct sk_buff *skb, struct rmnet_port *port,
 			    bool low_latency)
 {
 	struct rmnet_aggregation_state *state;
 	struct timespec64 diff, last;
+	bool sampled = false;
 	int size;
 
 	state = &port->agg_state[(low_latency) ? RMNET_LL_AGG_STATE :
 						 RMNET_DEFAULT_AGG_STATE];
 
+	if (rmnet_map_agg_pcpu(state)) {
+		if ((port->data_format & RMNET_EGRESS_FORMAT_PRIORITY) &&
+		    (RMNET_LLM(skb->priority) || RMNET_APS_LLB(skb->priority))) {
+			rmnet_map_tx_agg_flush(state, skb);
+			skb->protocol = htons(ETH_P_MAP);
+			state->send_agg_skb(skb);
+			return;
+		}
+
+		rmnet_map_pcpu_aggregate(skb, state);
+		return;
+	}
+
 new_packet:
 	spin_lock_bh(&state->agg_lock);
 	memcpy(&last, &state->agg_last, sizeof(last));
 	ktime_get_real_ts64(&state->agg_last);
+	if (!sampled) {
+		rmnet_map_agg_ctl_sample(state, &state->ctl, &state->agg_last,
+					 &last);
+		sampled = true;
+	}
 
 	if ((port->data_format & RMNET_EGRESS_FORMAT_PRIORITY) &&
 	    (RMNET_LLM(skb->priority) || RMNET_APS_LLB(skb->priority))) {
@@ -1497,7 +2048,7 @@ new_packet:
 			return;
 		}
 
-		state->agg_skb = rmnet_map_build_skb(state);
+		state->agg_skb = rmnet_map_agg_start(state, skb);
 		if (!state->agg_skb) {
 			state->agg_skb = NULL;
 			state->agg_count = 0;
@@ -1508,33 +2059,29 @@ new_packet:
 			return;
 		}
 
-		rmnet_map_linearize_copy(state->agg_skb, skb);
-		state->agg_skb->dev = skb->dev;
-		state->agg_skb->protocol = htons(ETH_P_MAP);
 		state->agg_count = 1;
 		ktime_get_real_ts64(&state->agg_time);
-		dev_kfree_skb_any(skb);
 		goto schedule;
 	}
 	diff = timespec64_sub(state->agg_last, state->agg_time);
-	size = skb_tailroom(state->agg_skb);
 
-	if (skb->len > size ||
-	    state->agg_count >= state->params.agg_count ||
-	    diff.tv_sec > 0 || diff.tv_nsec > rmnet_agg_time_limit) {
+	if (!rmnet_map_agg_fits(state, state->agg_skb, skb) ||
+	    state->agg_count >= rmnet_map_agg_count(state, &state->ctl) ||
+	    diff.tv_sec > 0 ||
+	    diff.tv_nsec > rmnet_map_agg_time_limit(state, &state->ctl)) {
 		rmnet_map_send_agg_skb(state);
 		goto new_packet;
 	}
 
-	rmnet_map_linearize_copy(state->agg_skb, skb);
+	rmnet_map_agg_append(state, state->agg_skb, skb);
 	state->agg_count++;
-	dev_kfree_skb_any(skb);
 
 schedule:
 	if (state->agg_state != -EINPROGRESS) {
 		state->agg_state = -EINPROGRESS;
 		hrtimer_start(&state->hrtimer,
-			      ns_to_ktime(state->params.agg_time),
+			      ns_to_ktime(rmnet_map_agg_time(state,
+							     &state->ctl)),
 			      HRTIMER_MODE_REL);
 	}
 	spin_unlock_bh(&state->agg_lock);
@@ -1543,12 +2090,23 @@ schedule:
 void rmnet_map_update_ul_agg_config(struct rmnet_aggregation_state *state,
 				    u16 size, u8 count, u8 features, u32 time)
 {
+	int cpu;
+
+	/* SG aggregates need a netdev that takes page frags. The LL channel
+	 * may queue only the linear buffer.
+	 */
+	if (state->send_agg_skb != dev_queue_xmit)
+		features &= ~RMNET_SG_AGG;
+
+	/* Per-CPU buffers were built with the old parameters */
+	rmnet_map_pcpu_flush_all(state, RMNET_AGG_FLUSH_BYPASS);
+
 	spin_lock_bh(&state->agg_lock);
 	state->params.agg_count = count;
 	state->params.agg_time = time;
 	state->params.agg_size = size;
 	state->params.agg_features = features;
-
+	rmnet_map_agg_ctl_reset(state, &state->ctl);
 	rmnet_free_agg_pages(state);
 
 	/* This effectively disables recycling in case the UL aggregation
@@ -1563,22 +2121,48 @@ void rmnet_map_update_ul_agg_config(struct rmnet_aggregation_state *state,
 	size -= SKB_DATA_ALIGN(sizeof(struct skb_shared_info));
 	state->params.agg_size = size;
 
-	if (state->params.agg_features == RMNET_PAGE_RECYCLE)
+	if (state->params.agg_features & RMNET_PAGE_RECYCLE)
 		rmnet_alloc_agg_pages(state);
 
 done:
 	spin_unlock_bh(&state->agg_lock);
+
+	/* Not under agg_lock: the aggregation path takes agg_lock while
+	 * holding pcpu->lock, so the per-CPU locks are never nested inside it.
+	 */
+	if (!state->pcpu)
+		return;
+
+	for_each_possible_cpu(cpu) {
+		struct rmnet_agg_pcpu *pcpu = per_cpu_ptr(state->pcpu, cpu);
+
+		spin_lock_bh(&pcpu->lock);
+		rmnet_map_agg_ctl_reset(state, &pcpu->ctl);
+		spin_unlock_bh(&pcpu->lock);
+	}
 }
 
 void rmnet_map_tx_aggregate_init(struct rmnet_port *port)
 {
 	unsigned int i;
-
+	int cpu;
 
 	for (i = RMNET_DEFAULT_AGG_STATE; i < RMNET_MAX_AGG_STATE; i++) {
 		struct rmnet_aggregation_state *state = &port->agg_state[i];
 
 		spin_lock_init(&state->agg_lock);
+
+		/* Per-CPU aggregation stays off if this fails or if CPU ids
+		 * do not fit in the flow ownership table.
+		 */
+		if (nr_cpu_ids < 0xFF)
+			state->pcpu = alloc_percpu(struct rmnet_agg_pcpu);
+		if (state->pcpu) {
+			for_each_possible_cpu(cpu)
+				spin_lock_init(&per_cpu_ptr(state->pcpu,
+							    cpu)->lock);
+		}
+
 		INIT_LIST_HEAD(&state->agg_list);
 		hrtimer_init(&state->hrtimer, CLOCK_MONOTONIC,
 			     HRTIMER_MODE_REL);
@@ -1603,6 +2187,7 @@ void rmnet_map_tx_aggregate_init(struct rmnet_port *port)
 void rmnet_map_tx_aggregate_exit(struct rmnet_port *port)
 {
 	unsigned int i;
+	int cpu;
 
 	for (i = RMNET_DEFAULT_AGG_STATE; i < RMNET_MAX_AGG_STATE; i++) {
 		struct rmnet_aggregation_state *state = &port->agg_state[i];
@@ -1629,6 +2214,75 @@ void rmnet_map_tx_aggregate_exit(struct rmnet_port *port)
 
 		rmnet_free_agg_pages(state);
 		spin_unlock_bh(&state->agg_lock);
+
+		if (state->pcpu) {
+			for_each_possible_cpu(cpu) {
+				struct rmnet_agg_pcpu *pcpu;
+
+				pcpu = per_cpu_ptr(state->pcpu, cpu);
+				kfree_skb(pcpu->agg_skb);
+				pcpu->agg_skb = NULL;
+			}
+
+			free_percpu(state->pcpu);
+			state->pcpu = NULL;
+		}
+	}
+}
+
+/* @fill gets the fill level of each CPU's buffer, nr_cpu_ids entries */
+void rmnet_map_tx_agg_get_pcpu_stats(struct rmnet_port *port,
+				     struct rmnet_agg_pcpu_stats *stats,
+				     u64 *fill)
+{
+	unsigned int i, j;
+	int cpu;
+
+	memset(stats, 0, sizeof(*stats));
+	memset(fill, 0, nr_cpu_ids * sizeof(*fill));
+	for (i = RMNET_DEFAULT_AGG_STATE; i < RMNET_MAX_AGG_STATE; i++) {
+		struct rmnet_aggregation_state *state = &port->agg_state[i];
+
+		if (!state->pcpu)
+			continue;
+
+		for_each_possible_cpu(cpu) {
+			struct rmnet_agg_pcpu *pcpu;
+			struct sk_buff *agg_skb;
+
+			pcpu = per_cpu_ptr(state->pcpu, cpu);
+			for (j = 0; j < RMNET_AGG_FLUSH_MAX; j++)
+				stats->flush[j] += pcpu->flush[j];
+
+			/* Fill level is only a snapshot of the default state */
+			if (i != RMNET_DEFAULT_AGG_STATE)
+				continue;
+
+			spin_lock_bh(&pcpu->lock);
+			agg_skb = pcpu->agg_skb;
+			fill[cpu] = agg_skb ? agg_skb->len : 0;
+			spin_unlock_bh(&pcpu->lock);
+		}
+	}
+}
+
+void rmnet_map_tx_agg_reset_pcpu_stats(struct rmnet_port *port)
+{
+	unsigned int i;
+	int cpu;
+
+	for (i = RMNET_DEFAULT_AGG_STATE; i < RMNET_MAX_AGG_STATE; i++) {
+		struct rmnet_aggregation_state *state = &port->agg_state[i];
+
+		if (!state->pcpu)
+			continue;
+
+		for_each_possible_cpu(cpu) {
+			struct rmnet_agg_pcpu *pcpu;
+
+			pcpu = per_cpu_ptr(state->pcpu, cpu);
+			memset(pcpu->flush, 0, sizeof(pcpu->flush));
+		}
 	}
 }
 
@@ -1654,6 +2308,11 @@ void rmnet_map_tx_qmap_cmd(struct sk_buff *qmap_skb, u8 ch, bool flush)
 	if (!(port->data_format & RMNET_EGRESS_FORMAT_AGGREGATION))
 		goto send;
 
+	if (rmnet_map_agg_pcpu(state)) {
+		rmnet_map_pcpu_flush_all(state, RMNET_AGG_FLUSH_BYPASS);
+		goto send;
+	}
+
 	spin_lock_bh(&state->agg_lock);
 	if (state->agg_skb) {
 		agg_skb = state->agg_skb;
@@ -29,6 +29,7 @@ enum {
 	RMNET_MODULE_HOOK_APS_PRE_QUEUE,
 	RMNET_MODULE_HOOK_APS_POST_QUEUE,
 	RMNET_MODULE_HOOK_WLAN_FLOW_MATCH,
+	RMNET_MODULE_HOOK_SHS_SKB_LIST_ENTRY,
 	__RMNET_MODULE_NUM_HOOKS,
 };
 
@@ -39,8 +39,14 @@ RMNET_INGRESS_FORMAT_DL_MARKER_V2)
 #define RMNET_INGRESS_FORMAT_PS                 BIT(27)
 #define RMNET_FORMAT_PS_NOTIF                   BIT(26)
 
+/* Batched list delivery from the frag ingress path */
+#define RMNET_INGRESS_FORMAT_LIST_RX            BIT(25)
+
 /* UL Aggregation parameters */
 #define RMNET_PAGE_RECYCLE                      BIT(0)
+#define RMNET_PCPU_AGG                          BIT(1)
+#define RMNET_SG_AGG                            BIT(2)
+#define RMNET_ADAPTIVE_AGG                      BIT(3)
 
 /* Replace skb->dev to a virtual rmnet device and pass up the stack */
 #define RMNET_EPMODE_VND (1)
@@ -35,6 +35,7 @@
 #include "rmnet_genl.h"
 #include "rmnet_ll.h"
 #include "rmnet_ctl.h"
+#include "rmnet_descriptor.h"
 
 #include "qmi_rmnet.h"
 #include "rmnet_qmi.h"
@@ -562,6 +563,7 @@ static const char rmnet_port_gstrings_stats[][ETH_GSTRING_LEN] = {
 	"DL trailer pkts received",
 	"UL agg reuse",
 	"UL agg alloc",
+	"UL agg SG",
 	"DL chaining [0-10)",
 	"DL chaining [10-20)",
 	"DL chaining [20-30)",
@@ -575,6 +577,25 @@ static const char rmnet_port_gstrings_stats[][ETH_GSTRING_LEN] = {
 	"DL chaining frags [8-11]",
 	"DL chaining frags [12-15]",
 	"DL chaining frags = 16",
+	"DL desc cache hits",
+	"DL desc cache refills",
+	"DL desc cache flushes",
+	"DL desc cache allocs",
+	"DL frag cache hits",
+	"DL frag cache refills",
+	"DL frag cache flushes",
+	"DL frag cache allocs",
+	"UL agg pcpu flush size",
+	"UL agg pcpu flush count",
+	"UL agg pcpu flush time",
+	"UL agg pcpu flush timer",
+	"UL agg pcpu flush flow order",
+	"UL agg pcpu flush bypass",
+	"DL list batches",
+	"DL list packets",
+	"DL list flow groups",
+	"DL list flow overflows",
+	"DL list SHS batches",
 };
 
 static const char rmnet_ll_gstrings_stats[][ETH_GSTRING_LEN] = {
@@ -607,6 +628,7 @@ static const char rmnet_qmap_gstrings_stats[][ETH_GSTRING_LEN] = {
 static void rmnet_get_strings(struct net_device *dev, u32 stringset, u8 *buf)
 {
 	size_t off = 0;
+	unsigned int cpu;
 
 	switch (stringset) {
 	case ETH_SS_STATS:
@@ -622,6 +644,12 @@ static void rmnet_get_strings(struct net_device *dev, u32 stringset, u8 *buf)
 		off += sizeof(rmnet_ll_gstrings_stats);
 		memcpy(buf + off, &rmnet_qmap_gstrings_stats,
 		       sizeof(rmnet_qmap_gstrings_stats));
+		off += sizeof(rmnet_qmap_gstrings_stats);
+		for (cpu = 0; cpu < nr_cpu_ids; cpu++) {
+			snprintf(buf + off, ETH_GSTRING_LEN,
+				 "UL agg pcpu CPU%u fill bytes", cpu);
+			off += ETH_GSTRING_LEN;
+		}
 		break;
 	}
 }
@@ -633,7 +661,8 @@ static int rmnet_get_sset_count(struct net_device *dev, int sset)
 		return ARRAY_SIZE(rmnet_gstrings_stats) +
 		       ARRAY_SIZE(rmnet_port_gstrings_stats) +
 		       ARRAY_SIZE(rmnet_ll_gstrings_stats) +
-		       ARRAY_SIZE(rmnet_qmap_gstrings_stats);
+		       ARRAY_SIZE(rmnet_qmap_gstrings_stats) +
+		       nr_cpu_ids;
 	default:
 		return -EOPNOTSUPP;
 	}
@@ -656,6 +685,13 @@ static void rmnet_get_ethtool_stats(struct net_device *dev,
 		return;
 
 	stp = &port->stats;
+	rmnet_descriptor_get_cache_stats(port, &stp->desc_cache,
+					 &stp->frag_cache);
+	/* Per-CPU buffer fill levels go last, one per CPU id */
+	rmnet_map_tx_agg_get_pcpu_stats(port, &stp->agg_pcpu,
+					data + rmnet_get_sset_count(dev,
+								    ETH_SS_STATS) -
+					nr_cpu_ids);
 	llp = rmnet_ll_get_stats();
 
 	memcpy(data, st, ARRAY_SIZE(rmnet_gstrings_stats) * sizeof(u64));
@@ -687,6 +723,8 @@ static int rmnet_stats_reset(struct net_device *dev)
 	stp = &port->stats;
 
 	memset(stp, 0, sizeof(*stp));
+	rmnet_descriptor_reset_cache_stats(port);
+	rmnet_map_tx_agg_reset_pcpu_stats(port);
 
 	st = &priv->stats;
 
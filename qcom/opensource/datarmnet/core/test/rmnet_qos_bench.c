@@ -0,0 +1,424 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * RMNET select_queue benchmark
+ *
+ * Activates QoS flows through qmi_rmnet_change_link() in DFC SA mode and
+ * times qmi_rmnet_get_queue() against the number of flows. Each lookup is
+ * also run through the flow list walk under qos_lock that select_queue used
+ * before the RCU hash, for comparison.
+ */
+
+#include <getopt.h>
+
+#include "qmi_rmnet_i.h"
+#include "qmi_rmnet.h"
+#include "rmnet_qmi.h"
+
+#define NLMSG_FLOW_ACTIVATE 1
+
+#define RMNET_QOS_BENCH_POOL 1024
+#define RMNET_QOS_BENCH_BEARERS 8
+#define RMNET_QOS_BENCH_TXQS (MAX_MQ_NUM * 2)
+#define RMNET_QOS_BENCH_HLEN (sizeof(struct ipv6hdr) + sizeof(struct tcphdr))
+
+/* The rest of rmnet_core and the DFC/WDA clients, as seen by qmi_rmnet.c */
+static struct qos_info *rmnet_qos_bench_qos;
+static struct qmi_info rmnet_qos_bench_qmi;
+static int rmnet_qos_bench_client;
+
+void *rmnet_get_qos_pt(struct net_device *dev)
+{
+	return rmnet_qos_bench_qos;
+}
+
+void *rmnet_get_qmi_pt(void *port)
+{
+	return &rmnet_qos_bench_qmi;
+}
+
+void rmnet_init_qmi_pt(void *port, void *qmi) { }
+void rmnet_reset_qmi_pt(void *port) { }
+void rmnet_enable_all_flows(void *port) { }
+bool rmnet_all_flows_enabled(void *port) { return true; }
+void rmnet_set_powersave_format(void *port) { }
+void rmnet_clear_powersave_format(void *port) { }
+void rmnet_get_packets(void *port, u64 *rx, u64 *tx) { *rx = *tx = 0; }
+int rmnet_get_powersave_notif(void *port) { return 0; }
+void rmnet_prepare_ps_bearers(void *port, u8 *num_bearers, u8 *bearer_id)
+{
+	*num_bearers = 0;
+}
+
+void rmnet_ll_guard_fn(struct timer_list *t) { }
+int rmnet_ll_switch(struct net_device *dev, struct tcmsg *tcm, int attrlen)
+{
+	return -EINVAL;
+}
+void rmnet_ll_wq_init(void) { }
+void rmnet_ll_wq_exit(void) { }
+
+int dfc_qmi_client_init(void *port, int index, struct svc_info *psvc,
+			struct qmi_info *qmi)
+{
+	return -EINVAL;
+}
+void dfc_qmi_client_exit(void *dfc_data) { }
+int dfc_qmap_client_init(void *port, int index, struct svc_info *psvc,
+			 struct qmi_info *qmi)
+{
+	return -EINVAL;
+}
+void dfc_qmap_client_exit(void *dfc_data) { }
+void dfc_qmi_burst_check(struct net_device *dev, struct qos_info *qos,
+			 int ip_type, u32 mark, unsigned int len) { }
+int dfc_bearer_flow_ctl(struct net_device *dev,
+			struct rmnet_bearer_map *bearer,
+			struct qos_info *qos)
+{
+	return 0;
+}
+void dfc_qmi_query_flow(void *dfc_data) { }
+int dfc_qmap_set_powersave(u8 enable, u8 num_bearers, u8 *bearer_id)
+{
+	return 0;
+}
+
+int wda_qmi_client_init(void *port, struct svc_info *psvc,
+			struct qmi_info *qmi)
+{
+	return -EINVAL;
+}
+void wda_qmi_client_exit(void *wda_data) { }
+void wda_qmi_client_release(void *wda_data) { }
+int wda_set_powersave_mode(void *wda_data, u8 enable, u8 num_bearers,
+			   u8 *bearer_id)
+{
+	return 0;
+}
+
+/* select_queue as it was before the RCU hash: the flow list is walked under
+ * qos_lock. The ack check is the same as in qmi_rmnet.c.
+ */
+static bool rmnet_qos_bench_is_tcp_ack(struct sk_buff *skb)
+{
+	struct tcphdr *th;
+	int ip_hdr_len;
+	int ip_payload_len;
+
+	if (skb->protocol == htons(ETH_P_IP) &&
+	    ip_hdr(skb)->protocol == IPPROTO_TCP) {
+		ip_hdr_len = ip_hdr(skb)->ihl << 2;
+		ip_payload_len = ntohs(ip_hdr(skb)->tot_len) - ip_hdr_len;
+	} else if (skb->protocol == htons(ETH_P_IPV6) &&
+		   ipv6_hdr(skb)->nexthdr == IPPROTO_TCP) {
+		ip_hdr_len = sizeof(struct ipv6hdr);
+		ip_payload_len = ntohs(ipv6_hdr(skb)->payload_len);
+	} else {
+		return false;
+	}
+
+	th = (struct tcphdr *)(skb->data + ip_hdr_len);
+	return ip_payload_len == th->doff << 2;
+}
+
+static int rmnet_qos_bench_list_queue(struct net_device *dev,
+				      struct sk_buff *skb)
+{
+	struct qos_info *qos = rmnet_get_qos_pt(dev);
+	struct rmnet_flow_map *itm;
+	int ip_type;
+	int txq = DEFAULT_MQ_NUM;
+
+	if (!qos)
+		return 0;
+
+	/* Put NDP in default mq */
+	if (skb->protocol == htons(ETH_P_IPV6) &&
+	    ipv6_hdr(skb)->nexthdr == IPPROTO_ICMPV6 &&
+	    icmp6_hdr(skb)->icmp6_type >= 133 &&
+	    icmp6_hdr(skb)->icmp6_type <= 137) {
+		return DEFAULT_MQ_NUM;
+	}
+
+	ip_type = (skb->protocol == htons(ETH_P_IPV6)) ? AF_INET6 : AF_INET;
+
+	spin_lock_bh(&qos->qos_lock);
+
+	list_for_each_entry(itm, &qos->flow_head, list) {
+		if (itm->flow_id == skb->mark && itm->ip_type == ip_type)
+			break;
+	}
+
+	if (unlikely(&itm->list == &qos->flow_head))
+		goto done;
+
+	if (likely(itm->bearer) && rmnet_qos_bench_is_tcp_ack(skb))
+		txq = itm->bearer->ack_mq_idx;
+	else
+		txq = itm->mq_idx;
+
+done:
+	spin_unlock_bh(&qos->qos_lock);
+	return txq;
+}
+
+static u32 rmnet_qos_bench_seed = 1;
+
+static u32 rmnet_qos_bench_rand(void)
+{
+	/* xorshift32, reproducible across hosts */
+	rmnet_qos_bench_seed ^= rmnet_qos_bench_seed << 13;
+	rmnet_qos_bench_seed ^= rmnet_qos_bench_seed >> 17;
+	rmnet_qos_bench_seed ^= rmnet_qos_bench_seed << 5;
+	return rmnet_qos_bench_seed;
+}
+
+static int rmnet_qos_bench_ip_type(u32 flow)
+{
+	return (flow & 1) ? AF_INET6 : AF_INET;
+}
+
+static u8 rmnet_qos_bench_mq(u32 flow)
+{
+	/* mq 0 is the default queue, and is not bound to a bearer */
+	return flow % RMNET_QOS_BENCH_BEARERS + 1;
+}
+
+static int rmnet_qos_bench_activate(struct net_device *dev, u32 flows)
+{
+	struct tcmsg tcm;
+	u32 i;
+
+	for (i = 0; i < flows; i++) {
+		memset(&tcm, 0, sizeof(tcm));
+		tcm.tcm_family = NLMSG_FLOW_ACTIVATE;
+		tcm.tcm__pad1 = rmnet_qos_bench_mq(i);
+		tcm.tcm_parent = i + 1;
+		tcm.tcm_ifindex = rmnet_qos_bench_ip_type(i);
+		tcm.tcm_handle = rmnet_qos_bench_mq(i);
+		qmi_rmnet_change_link(dev, NULL, &tcm, sizeof(tcm));
+	}
+
+	return qmi_rmnet_get_flow_map(rmnet_qos_bench_qos, flows,
+				      rmnet_qos_bench_ip_type(flows - 1)) ?
+	       0 : -ENOMEM;
+}
+
+/* A TCP packet on flow @flow, or on a mark with no flow for flow == flows,
+ * carrying @payload bytes. Returns the queue select_queue must pick.
+ */
+static int rmnet_qos_bench_mkskb(struct sk_buff *skb, u32 flow, u32 flows,
+				 u32 payload)
+{
+	struct tcphdr *th;
+	u32 len;
+
+	skb_put(skb, RMNET_QOS_BENCH_HLEN + payload);
+	skb->mark = flow + 1;
+	skb_reset_network_header(skb);
+	if (rmnet_qos_bench_ip_type(flow) == AF_INET6) {
+		struct ipv6hdr *ip6h = ipv6_hdr(skb);
+
+		skb->protocol = htons(ETH_P_IPV6);
+		ip6h->version = 6;
+		ip6h->nexthdr = IPPROTO_TCP;
+		ip6h->payload_len = htons(sizeof(*th) + payload);
+		len = sizeof(*ip6h);
+	} else {
+		struct iphdr *iph = ip_hdr(skb);
+
+		skb->protocol = htons(ETH_P_IP);
+		iph->version = 4;
+		iph->ihl = sizeof(*iph) >> 2;
+		iph->protocol = IPPROTO_TCP;
+		iph->tot_len = htons(sizeof(*iph) + sizeof(*th) + payload);
+		len = sizeof(*iph);
+	}
+
+	skb_set_transport_header(skb, len);
+	th = tcp_hdr(skb);
+	th->doff = sizeof(*th) >> 2;
+	th->ack = 1;
+
+	if (flow == flows)
+		return DEFAULT_MQ_NUM;
+
+	return rmnet_qos_bench_mq(flow) + (payload ? 0 : ACK_MQ_OFFSET);
+}
+
+struct rmnet_qos_bench_cfg {
+	u32 max_flows;
+	u32 miss_pct;
+	u32 ack_pct;
+	u32 rounds;
+	u64 iters;
+};
+
+struct rmnet_qos_bench_result {
+	/* Fastest round of each implementation */
+	u64 hash_ns;
+	u64 list_ns;
+	u64 errors;
+};
+
+static u64 rmnet_qos_bench_time(struct net_device *dev,
+				struct sk_buff **pool, u64 iters,
+				int (*get_queue)(struct net_device *dev,
+						 struct sk_buff *skb))
+{
+	volatile int sink = 0;
+	u64 done, start;
+
+	start = ktime_get_ns();
+	for (done = 0; done < iters; done++)
+		sink += get_queue(dev, pool[done % RMNET_QOS_BENCH_POOL]);
+
+	return ktime_get_ns() - start;
+}
+
+static int rmnet_qos_bench_run(struct rmnet_qos_bench_cfg *cfg, u32 flows,
+			       struct rmnet_qos_bench_result *res)
+{
+	struct sk_buff *pool[RMNET_QOS_BENCH_POOL] = { NULL };
+	struct netdev_queue txq[RMNET_QOS_BENCH_TXQS];
+	struct net_device dev = {
+		.name = "rmnet_data0",
+		.num_tx_queues = RMNET_QOS_BENCH_TXQS,
+		._tx = txq,
+	};
+	u32 i, flow, payload;
+	int rc, expect;
+	u64 ns;
+
+	memset(res, 0, sizeof(*res));
+	memset(txq, 0, sizeof(txq));
+	rmnet_qos_bench_qos = qmi_rmnet_qos_init(&dev, &dev, 1);
+	if (!rmnet_qos_bench_qos)
+		return -ENOMEM;
+
+	rc = rmnet_qos_bench_activate(&dev, flows);
+	if (rc)
+		goto out;
+
+	for (i = 0; i < RMNET_QOS_BENCH_POOL; i++) {
+		pool[i] = alloc_skb(RMNET_QOS_BENCH_HLEN + 64, GFP_KERNEL);
+		if (!pool[i]) {
+			rc = -ENOMEM;
+			goto out;
+		}
+
+		if (rmnet_qos_bench_rand() % 100 < cfg->miss_pct)
+			flow = flows;
+		else
+			flow = rmnet_qos_bench_rand() % flows;
+
+		payload = rmnet_qos_bench_rand() % 100 < cfg->ack_pct ? 0 : 64;
+		pool[i]->dev = &dev;
+		expect = rmnet_qos_bench_mkskb(pool[i], flow, flows, payload);
+		if (qmi_rmnet_get_queue(&dev, pool[i]) != expect ||
+		    rmnet_qos_bench_list_queue(&dev, pool[i]) != expect)
+			res->errors++;
+	}
+
+	res->hash_ns = res->list_ns = U64_MAX;
+	for (i = 0; i < cfg->rounds; i++) {
+		ns = rmnet_qos_bench_time(&dev, pool, cfg->iters,
+					  qmi_rmnet_get_queue);
+		res->hash_ns = min(res->hash_ns, ns);
+		ns = rmnet_qos_bench_time(&dev, pool, cfg->iters,
+					  rmnet_qos_bench_list_queue);
+		res->list_ns = min(res->list_ns, ns);
+	}
+
+out:
+	for (i = 0; i < RMNET_QOS_BENCH_POOL; i++)
+		if (pool[i])
+			kfree_skb(pool[i]);
+
+	qmi_rmnet_qos_exit_pre(rmnet_qos_bench_qos);
+	qmi_rmnet_qos_exit_post();
+	rmnet_qos_bench_qos = NULL;
+	return rc;
+}
+
+static void rmnet_qos_bench_usage(const char *prog)
+{
+	fprintf(stderr,
+		"usage: %s [options]\n"
+		"  -f count   largest number of flows, doubling from 1 (64)\n"
+		"  -n count   lookups per round (1000000)\n"
+		"  -r count   rounds per flow count, fastest reported (5)\n"
+		"  -m pct     packets on a mark with no flow (0)\n"
+		"  -a pct     pure TCP acks, sent to the ack queue (0)\n"
+		"  -S seed    generator seed (1)\n",
+		prog);
+}
+
+int main(int argc, char **argv)
+{
+	struct rmnet_qos_bench_cfg cfg = {
+		.max_flows = 64,
+		.rounds = 5,
+		.iters = 1000000,
+	};
+	struct rmnet_qos_bench_result res;
+	int opt, rc, errors = 0;
+	u32 flows;
+
+	while ((opt = getopt(argc, argv, "f:n:r:m:a:S:h")) != -1) {
+		switch (opt) {
+		case 'f':
+			cfg.max_flows = strtoul(optarg, NULL, 0);
+			break;
+		case 'n':
+			cfg.iters = strtoull(optarg, NULL, 0);
+			break;
+		case 'r':
+			cfg.rounds = strtoul(optarg, NULL, 0);
+			break;
+		case 'm':
+			cfg.miss_pct = strtoul(optarg, NULL, 0);
+			break;
+		case 'a':
+			cfg.ack_pct = strtoul(optarg, NULL, 0);
+			break;
+		case 'S':
+			rmnet_qos_bench_seed = strtoul(optarg, NULL, 0) ?: 1;
+			break;
+		default:
+			rmnet_qos_bench_usage(argv[0]);
+			return opt == 'h' ? 0 : 2;
+		}
+	}
+
+	if (!cfg.max_flows || !cfg.iters || !cfg.rounds ||
+	    cfg.miss_pct > 100 || cfg.ack_pct > 100) {
+		rmnet_qos_bench_usage(argv[0]);
+		return 2;
+	}
+
+	rmnet_qos_bench_qmi.flag = DFC_MODE_SA;
+	rmnet_qos_bench_qmi.dfc_clients[0] = &rmnet_qos_bench_client;
+	dfc_mode = DFC_MODE_SA;
+
+	printf("%8s %12s %12s\n", "flows", "hash ns/pkt", "list ns/pkt");
+	for (flows = 1; flows <= cfg.max_flows; flows <<= 1) {
+		rc = rmnet_qos_bench_run(&cfg, flows, &res);
+		if (rc) {
+			fprintf(stderr, "%u flows: setup failed: %d\n", flows,
+				rc);
+			return 1;
+		}
+
+		printf("%8u %12.2f %12.2f\n", flows,
+		       (double)res.hash_ns / cfg.iters,
+		       (double)res.list_ns / cfg.iters);
+		if (res.errors) {
+			fprintf(stderr, "%u flows: %llu packets on the wrong queue\n",
+				flows, (unsigned long long)res.errors);
+			errors++;
+		}
+	}
+
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,842 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * RMNET host replay harness
+ *
+ * Replays synthetic or captured QMAPv5 downlink buffers through the frag
+ * descriptor (rmnet_frag_ingress_handler) and linear skb
+ * (rmnet_map_deaggregate) ingress paths, and reports the cost per packet.
+ */
+
+#include <getopt.h>
+#include <malloc.h>
+#include <unistd.h>
+
+#include <linux/ip.h>
+#include <linux/ipv6.h>
+#include "rmnet_config.h"
+#include "rmnet_descriptor.h"
+#include "rmnet_map.h"
+#include "rmnet_private.h"
+#include "rmnet_replay.h"
+
+#define RMNET_REPLAY_MAGIC "RMNETRPL"
+#define RMNET_REPLAY_VERSION 1
+#define RMNET_REPLAY_MAX_BUF 65536
+#define RMNET_REPLAY_BATCH 32
+#define RMNET_REPLAY_TCP_HLEN 32
+#define RMNET_REPLAY_NLO_STEP 16
+
+enum {
+	RMNET_REPLAY_TCP4,
+	RMNET_REPLAY_TCP6,
+	RMNET_REPLAY_UDP4,
+	RMNET_REPLAY_UDP6,
+	RMNET_REPLAY_FLOW_MAX,
+};
+
+static const char * const rmnet_replay_flow_names[RMNET_REPLAY_FLOW_MAX] = {
+	"tcp4", "tcp6", "udp4", "udp6",
+};
+
+enum {
+	RMNET_REPLAY_FRAG,
+	RMNET_REPLAY_SKB,
+	RMNET_REPLAY_MODE_MAX,
+};
+
+static const char * const rmnet_replay_mode_names[RMNET_REPLAY_MODE_MAX] = {
+	"frag", "skb",
+};
+
+/* One buffer as delivered by the IPA driver. The expected counts are 0 for
+ * captures, which disables the corresponding checks.
+ */
+struct rmnet_replay_buf {
+	u8 *data;
+	u32 len;
+	u32 segs;
+	u32 csum_errs;
+};
+
+struct rmnet_replay_cfg {
+	u32 flows;
+	u32 seg_size;
+	u32 segs;
+	u32 nlos;
+	u32 err_pct;
+	u32 buggy_pct;
+	u32 offload_pct;
+	u32 pool;
+	u64 iters;
+	u64 warmup;
+	u32 seed;
+	bool sw_csum;
+	bool no_gro;
+	bool list_rx;
+	bool verify;
+	bool modes[RMNET_REPLAY_MODE_MAX];
+	const char *read_file;
+	const char *write_file;
+};
+
+struct rmnet_replay_result {
+	struct rmnet_replay_sink sink;
+	struct rmnet_coal_stats coal;
+	u64 ns;
+	u64 bufs;
+	u64 allocs;
+	u64 skb_allocs;
+	u64 cache_misses;
+	u64 exp_segs;
+	u64 exp_csum_errs;
+	bool exp_valid;
+	bool have_misses;
+};
+
+static u32 rmnet_replay_seed;
+
+static u32 rmnet_replay_rand(void)
+{
+	/* xorshift32, reproducible across hosts */
+	rmnet_replay_seed ^= rmnet_replay_seed << 13;
+	rmnet_replay_seed ^= rmnet_replay_seed >> 17;
+	rmnet_replay_seed ^= rmnet_replay_seed << 5;
+	return rmnet_replay_seed;
+}
+
+static bool rmnet_replay_chance(u32 pct)
+{
+	return pct && rmnet_replay_rand() % 100 < pct;
+}
+
+static u64 rmnet_replay_now(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (u64)ts.tv_sec * NSEC_PER_SEC + ts.tv_nsec;
+}
+
+/* Write the IP and transport headers for a packet carrying 'payload' bytes
+ * and return the header length.
+ */
+static u16 rmnet_replay_put_hdrs(u8 *p, int flow, u32 payload, u32 seq,
+				 u16 ip_id)
+{
+	bool v4 = flow == RMNET_REPLAY_TCP4 || flow == RMNET_REPLAY_UDP4;
+	bool tcp = flow == RMNET_REPLAY_TCP4 || flow == RMNET_REPLAY_TCP6;
+	u16 ip_len = v4 ? sizeof(struct iphdr) : sizeof(struct ipv6hdr);
+	u16 trans_len = tcp ? RMNET_REPLAY_TCP_HLEN : sizeof(struct udphdr);
+	u32 l4_len = trans_len + payload;
+
+	memset(p, 0, ip_len + trans_len);
+	if (v4) {
+		struct iphdr *iph = (struct iphdr *)p;
+
+		iph->version = 4;
+		iph->ihl = 5;
+		iph->tot_len = htons(ip_len + l4_len);
+		iph->id = htons(ip_id);
+		iph->frag_off = htons(IP_DF);
+		iph->ttl = 64;
+		iph->protocol = tcp ? IPPROTO_TCP : IPPROTO_UDP;
+		iph->saddr = htonl(0x0A000001);
+		iph->daddr = htonl(0xC0A80102);
+		iph->check = ip_fast_csum(iph, iph->ihl);
+	} else {
+		struct ipv6hdr *ip6h = (struct ipv6hdr *)p;
+
+		ip6h->version = 6;
+		ip6h->payload_len = htons(l4_len);
+		ip6h->nexthdr = tcp ? IPPROTO_TCP : IPPROTO_UDP;
+		ip6h->hop_limit = 64;
+		ip6h->saddr.s6_addr32[0] = htonl(0x20010db8);
+		ip6h->saddr.s6_addr32[3] = htonl(1);
+		ip6h->daddr.s6_addr32[0] = htonl(0x20010db8);
+		ip6h->daddr.s6_addr32[3] = htonl(2);
+	}
+
+	if (tcp) {
+		struct tcphdr *th = (struct tcphdr *)(p + ip_len);
+		u8 *opt = (u8 *)(th + 1);
+
+		th->source = htons(443);
+		th->dest = htons(40000);
+		th->seq = htonl(seq);
+		th->ack_seq = htonl(1);
+		th->doff = RMNET_REPLAY_TCP_HLEN / 4;
+		th->ack = 1;
+		th->window = htons(0xFFFF);
+		/* NOP, NOP, timestamp */
+		opt[0] = 1;
+		opt[1] = 1;
+		opt[2] = 8;
+		opt[3] = 10;
+	} else {
+		struct udphdr *uh = (struct udphdr *)(p + ip_len);
+
+		uh->source = htons(443);
+		uh->dest = htons(40000);
+		uh->len = htons(l4_len);
+	}
+
+	return ip_len + trans_len;
+}
+
+/* Fill in the transport checksum over the 'len' byte packet at p */
+static void rmnet_replay_set_csum(u8 *p, u32 len, bool corrupt)
+{
+	bool v4 = (p[0] & 0xF0) == 0x40;
+	u16 ip_len = v4 ? sizeof(struct iphdr) : sizeof(struct ipv6hdr);
+	u8 proto = v4 ? ((struct iphdr *)p)->protocol :
+			((struct ipv6hdr *)p)->nexthdr;
+	__sum16 *check;
+	__wsum csum;
+
+	if (proto == IPPROTO_TCP)
+		check = &((struct tcphdr *)(p + ip_len))->check;
+	else
+		check = &((struct udphdr *)(p + ip_len))->check;
+
+	*check = 0;
+	csum = csum_partial(p + ip_len, len - ip_len, 0);
+	if (v4) {
+		struct iphdr *iph = (struct iphdr *)p;
+
+		*check = csum_tcpudp_magic(iph->saddr, iph->daddr,
+					   len - ip_len, proto, csum);
+	} else {
+		struct ipv6hdr *ip6h = (struct ipv6hdr *)p;
+
+		*check = csum_ipv6_magic(&ip6h->saddr, &ip6h->daddr,
+					 len - ip_len, proto, csum);
+	}
+
+	/* Zero means "no checksum" for UDP over IPv4 */
+	if (!*check)
+		*check = 0xFFFF;
+
+	if (corrupt)
+		*check = csum16_add(*check, htons(1)) ?: htons(1);
+}
+
+static int rmnet_replay_pick_flow(struct rmnet_replay_cfg *cfg)
+{
+	int flow;
+
+	do {
+		flow = rmnet_replay_rand() % RMNET_REPLAY_FLOW_MAX;
+	} while (!(cfg->flows & BIT(flow)));
+
+	return flow;
+}
+
+/* Build one coalesced frame: MAP header, coalescing header, then a single
+ * set of headers followed by the payload of every segment.
+ */
+static void rmnet_replay_gen_coal(struct rmnet_replay_cfg *cfg,
+				  struct rmnet_replay_buf *buf, u32 *seg_id)
+{
+	struct rmnet_map_v5_coal_header *coal;
+	struct rmnet_map_header *maph;
+	int flow = rmnet_replay_pick_flow(cfg);
+	bool buggy = rmnet_replay_chance(cfg->buggy_pct);
+	u32 nlos = buggy ? 1 : cfg->nlos;
+	u32 segs = buggy ? 1 : cfg->segs;
+	u32 seg_size[RMNET_MAP_V5_MAX_NLOS];
+	u32 nlo_pkts[RMNET_MAP_V5_MAX_NLOS];
+	u32 first_payload, payload = 0;
+	u64 err_mask = 0;
+	u16 hlen;
+	u8 *p;
+	u32 i, j, pkt;
+
+	/* Each NLO needs its own segment size. Step down from the configured
+	 * size, or up when it is too small to do so.
+	 */
+	for (i = 0; i < nlos; i++) {
+		if (cfg->seg_size >= RMNET_REPLAY_MIN_PAYLOAD +
+				     RMNET_REPLAY_NLO_STEP *
+				     (RMNET_MAP_V5_MAX_NLOS - 1))
+			seg_size[i] = cfg->seg_size - i * RMNET_REPLAY_NLO_STEP;
+		else
+			seg_size[i] = cfg->seg_size + i * RMNET_REPLAY_NLO_STEP;
+		nlo_pkts[i] = segs / nlos + (i < segs % nlos);
+		payload += seg_size[i] * nlo_pkts[i];
+	}
+
+	first_payload = seg_size[0];
+	maph = (struct rmnet_map_header *)buf->data;
+	coal = (struct rmnet_map_v5_coal_header *)(maph + 1);
+	p = (u8 *)(coal + 1);
+	memset(maph, 0, sizeof(*maph) + sizeof(*coal));
+
+	hlen = rmnet_replay_put_hdrs(p, flow, first_payload,
+				     rmnet_replay_rand(), rmnet_replay_rand());
+	for (i = 0, pkt = 0, j = hlen; i < nlos; i++) {
+		u32 k;
+
+		for (k = 0; k < nlo_pkts[i]; k++, pkt++) {
+			rmnet_replay_fill(p + j, seg_size[i], (*seg_id)++);
+			j += seg_size[i];
+			if (!buggy && rmnet_replay_chance(cfg->err_pct))
+				err_mask |= 1ULL << pkt;
+		}
+
+		coal->nl_pairs[i].pkt_len = htons(hlen + seg_size[i]);
+		coal->nl_pairs[i].num_packets = nlo_pkts[i];
+	}
+
+	/* The headers describe the first segment only. A lone packet hitting
+	 * the erratum is validated in software, so it can really be bad.
+	 */
+	if (buggy && rmnet_replay_chance(cfg->err_pct)) {
+		rmnet_replay_set_csum(p, hlen + first_payload, true);
+		buf->csum_errs++;
+	} else {
+		rmnet_replay_set_csum(p, hlen + first_payload, false);
+	}
+
+	/* The bitmaps form one mask indexed by packet number in the frame */
+	for (i = 0; i < RMNET_MAP_V5_MAX_NLOS; i++)
+		coal->nl_pairs[i].csum_error_bitmap = err_mask >> (8 * i);
+
+	buf->csum_errs += __builtin_popcountll(err_mask);
+	coal->header_type = RMNET_MAP_HEADER_TYPE_COALESCING;
+	coal->num_nlos = nlos;
+	coal->csum_valid = !err_mask;
+	coal->close_type = buggy ? RMNET_MAP_COAL_CLOSE_COAL :
+				   RMNET_MAP_COAL_CLOSE_HW;
+	coal->close_value = RMNET_MAP_COAL_CLOSE_HW_NL;
+	maph->next_hdr = 1;
+	maph->mux_id = RMNET_REPLAY_MUX_ID;
+	maph->pkt_len = htons(hlen + payload);
+
+	buf->len = sizeof(*maph) + sizeof(*coal) + hlen + payload;
+	buf->segs = segs;
+}
+
+/* Build an aggregate of individually checksum offloaded QMAPv5 packets */
+static void rmnet_replay_gen_offload(struct rmnet_replay_cfg *cfg,
+				     struct rmnet_replay_buf *buf,
+				     u32 *seg_id)
+{
+	u32 off = 0, i;
+
+	for (i = 0; i < cfg->segs; i++) {
+		struct rmnet_map_v5_csum_header *csum;
+		struct rmnet_map_header *maph;
+		int flow = rmnet_replay_pick_flow(cfg);
+		u32 pkt_len, pad;
+		u16 hlen;
+		u8 *p;
+
+		maph = (struct rmnet_map_header *)(buf->data + off);
+		csum = (struct rmnet_map_v5_csum_header *)(maph + 1);
+		p = (u8 *)(csum + 1);
+		hlen = rmnet_replay_put_hdrs(p, flow, cfg->seg_size,
+					     rmnet_replay_rand(),
+					     rmnet_replay_rand());
+		rmnet_replay_fill(p + hlen, cfg->seg_size, (*seg_id)++);
+		pkt_len = hlen + cfg->seg_size;
+		rmnet_replay_set_csum(p, pkt_len, false);
+
+		pad = ALIGN(pkt_len, 4) - pkt_len;
+		memset(p + pkt_len, 0, pad);
+		memset(maph, 0, sizeof(*maph) + sizeof(*csum));
+		maph->next_hdr = 1;
+		maph->pad_len = pad;
+		maph->mux_id = RMNET_REPLAY_MUX_ID;
+		maph->pkt_len = htons(pkt_len + pad);
+		csum->header_type = RMNET_MAP_HEADER_TYPE_CSUM_OFFLOAD;
+		csum->csum_valid_required = !cfg->sw_csum;
+
+		off += sizeof(*maph) + sizeof(*csum) + pkt_len + pad;
+	}
+
+	buf->len = off;
+	buf->segs = cfg->segs;
+}
+
+static int rmnet_replay_generate(struct rmnet_replay_cfg *cfg,
+				 struct rmnet_replay_buf *bufs)
+{
+	u32 seg_id = 0, i;
+
+	for (i = 0; i < cfg->pool; i++) {
+		struct rmnet_replay_buf *buf = &bufs[i];
+
+		buf->data = calloc(1, RMNET_REPLAY_MAX_BUF);
+		if (!buf->data)
+			return -ENOMEM;
+
+		if (rmnet_replay_chance(cfg->offload_pct))
+			rmnet_replay_gen_offload(cfg, buf, &seg_id);
+		else
+			rmnet_replay_gen_coal(cfg, buf, &seg_id);
+	}
+
+	return 0;
+}
+
+/* Trace file: the magic and a u32 version, then for each buffer a u32
+ * length, u32 expected packet count, u32 expected checksum errors and the
+ * raw buffer. Expected counts of 0 mean unknown.
+ */
+static int rmnet_replay_write(const char *file, struct rmnet_replay_buf *bufs,
+			      u32 count)
+{
+	u32 version = RMNET_REPLAY_VERSION, i;
+	FILE *f;
+
+	f = fopen(file, "wb");
+	if (!f)
+		return -errno;
+
+	fwrite(RMNET_REPLAY_MAGIC, 1, 8, f);
+	fwrite(&version, sizeof(version), 1, f);
+	for (i = 0; i < count; i++) {
+		fwrite(&bufs[i].len, sizeof(u32), 1, f);
+		fwrite(&bufs[i].segs, sizeof(u32), 1, f);
+		fwrite(&bufs[i].csum_errs, sizeof(u32), 1, f);
+		fwrite(bufs[i].data, 1, bufs[i].len, f);
+	}
+
+	return fclose(f) ? -errno : 0;
+}
+
+static int rmnet_replay_read(const char *file, struct rmnet_replay_buf **out,
+			     u32 *count)
+{
+	struct rmnet_replay_buf *bufs = NULL;
+	char magic[8];
+	u32 version, n = 0;
+	int rc = -EINVAL;
+	FILE *f;
+
+	f = fopen(file, "rb");
+	if (!f)
+		return -errno;
+
+	if (fread(magic, 1, 8, f) != 8 ||
+	    memcmp(magic, RMNET_REPLAY_MAGIC, 8) ||
+	    fread(&version, sizeof(version), 1, f) != 1 ||
+	    version != RMNET_REPLAY_VERSION)
+		goto out;
+
+	for (;;) {
+		struct rmnet_replay_buf buf, *tmp;
+		u32 hdr[3];
+
+		if (fread(hdr, sizeof(u32), 3, f) != 3)
+			break;
+
+		if (!hdr[0] || hdr[0] > RMNET_REPLAY_MAX_BUF)
+			goto out;
+
+		buf.len = hdr[0];
+		buf.segs = hdr[1];
+		buf.csum_errs = hdr[2];
+		buf.data = malloc(buf.len);
+		if (!buf.data || fread(buf.data, 1, buf.len, f) != buf.len) {
+			free(buf.data);
+			goto out;
+		}
+
+		tmp = realloc(bufs, (n + 1) * sizeof(*bufs));
+		if (!tmp) {
+			free(buf.data);
+			goto out;
+		}
+
+		bufs = tmp;
+		bufs[n++] = buf;
+	}
+
+	rc = n ? 0 : -EINVAL;
+out:
+	fclose(f);
+	*out = bufs;
+	*count = n;
+	return rc;
+}
+
+/* Wrap a buffer the way the IPA driver hands it to rmnet */
+static struct sk_buff *rmnet_replay_mkskb(struct rmnet_replay_env *env,
+					  struct rmnet_replay_buf *buf,
+					  int mode)
+{
+	struct sk_buff *skb;
+
+	if (mode == RMNET_REPLAY_FRAG) {
+		unsigned int order = get_order(buf->len);
+		struct page *page;
+
+		skb = alloc_skb(0, GFP_ATOMIC);
+		page = alloc_pages(GFP_ATOMIC, order);
+		if (!skb || !page)
+			abort();
+
+		memcpy(page_address(page), buf->data, buf->len);
+		skb_add_rx_frag(skb, 0, page, 0, buf->len,
+				PAGE_SIZE << order);
+	} else {
+		skb = alloc_skb(buf->len, GFP_ATOMIC);
+		if (!skb)
+			abort();
+
+		skb_put_data(skb, buf->data, buf->len);
+	}
+
+	skb->dev = &env->real_dev;
+	skb->protocol = htons(ETH_P_MAP);
+	return skb;
+}
+
+static void rmnet_replay_ingress(struct rmnet_replay_env *env,
+				 struct sk_buff *skb, int mode)
+{
+	if (mode == RMNET_REPLAY_FRAG)
+		rmnet_frag_ingress_handler(skb, &env->port);
+	else
+		rmnet_replay_skb_ingress(skb, &env->port);
+}
+
+static int rmnet_replay_run(struct rmnet_replay_cfg *cfg,
+			    struct rmnet_replay_buf *bufs, u32 count, int mode,
+			    int perf_fd, struct rmnet_replay_result *res)
+{
+	struct sk_buff *batch[RMNET_REPLAY_BATCH];
+	struct rmnet_replay_env env;
+	u32 data_format, next = 0;
+	netdev_features_t features = NETIF_F_RXCSUM;
+	u64 done;
+	int rc, i, n;
+
+	memset(res, 0, sizeof(*res));
+	data_format = RMNET_FLAGS_INGRESS_DEAGGREGATION |
+		      RMNET_FLAGS_INGRESS_COALESCE |
+		      RMNET_PRIV_FLAGS_INGRESS_MAP_CKSUMV5;
+	if (!cfg->no_gro)
+		features |= NETIF_F_GRO_HW;
+
+	if (cfg->list_rx)
+		data_format |= RMNET_INGRESS_FORMAT_LIST_RX;
+
+	rc = rmnet_replay_env_init(&env, data_format, features);
+	if (rc)
+		return rc;
+
+	for (done = 0; done < cfg->warmup; done++) {
+		rmnet_replay_ingress(&env, rmnet_replay_mkskb(&env, &bufs[next],
+							      mode), mode);
+		next = (next + 1) % count;
+	}
+
+	memset(&env.sink, 0, sizeof(env.sink));
+	memset(&env.priv.stats, 0, sizeof(env.priv.stats));
+	env.sink.verify = cfg->verify;
+	res->exp_valid = true;
+
+	for (done = 0; done < cfg->iters; done += n) {
+		struct rmnet_shim_stats before;
+		u64 start;
+
+		n = min_t(u64, RMNET_REPLAY_BATCH, cfg->iters - done);
+		for (i = 0; i < n; i++) {
+			struct rmnet_replay_buf *buf = &bufs[next];
+
+			batch[i] = rmnet_replay_mkskb(&env, buf, mode);
+			if (!buf->segs)
+				res->exp_valid = false;
+
+			res->exp_segs += buf->segs;
+			res->exp_csum_errs += buf->csum_errs;
+			next = (next + 1) % count;
+		}
+
+		before = rmnet_shim_stats;
+		rmnet_replay_perf_enable(perf_fd, 1);
+
+		start = rmnet_replay_now();
+		for (i = 0; i < n; i++)
+			rmnet_replay_ingress(&env, batch[i], mode);
+
+		res->ns += rmnet_replay_now() - start;
+		rmnet_replay_perf_enable(perf_fd, 0);
+
+		res->allocs += (rmnet_shim_stats.kmalloc - before.kmalloc) +
+			       (rmnet_shim_stats.page_alloc -
+				before.page_alloc);
+		res->skb_allocs += rmnet_shim_stats.skb_alloc -
+				   before.skb_alloc;
+	}
+
+	res->have_misses = !rmnet_replay_perf_read(perf_fd,
+						   &res->cache_misses);
+
+	res->bufs = cfg->iters;
+	res->sink = env.sink;
+	res->coal = env.priv.stats.coal;
+	rmnet_replay_env_exit(&env);
+	return 0;
+}
+
+static double rmnet_replay_per(u64 val, u64 pkts)
+{
+	return pkts ? (double)val / pkts : 0;
+}
+
+static int rmnet_replay_report(struct rmnet_replay_cfg *cfg, int mode,
+			       struct rmnet_replay_result *res)
+{
+	struct rmnet_replay_sink *sink = &res->sink;
+	u64 pkts = sink->segs;
+	int errors = 0;
+
+	printf("%s path: %llu buffers, %llu skbs, %llu packets, %llu bytes\n",
+	       rmnet_replay_mode_names[mode], (unsigned long long)res->bufs,
+	       (unsigned long long)sink->skbs, (unsigned long long)pkts,
+	       (unsigned long long)sink->bytes);
+	printf("  %.1f ns/packet, %.1f ns/buffer, %.1f Mpps\n",
+	       rmnet_replay_per(res->ns, pkts),
+	       rmnet_replay_per(res->ns, res->bufs),
+	       res->ns ? (double)pkts * 1000 / res->ns : 0);
+	printf("  %.3f allocs/packet, %.3f skb allocs/packet\n",
+	       rmnet_replay_per(res->allocs, pkts),
+	       rmnet_replay_per(res->skb_allocs, pkts));
+	if (res->have_misses)
+		printf("  %.2f cache misses/packet\n",
+		       rmnet_replay_per(res->cache_misses, pkts));
+	else
+		printf("  cache misses: n/a (perf events unavailable)\n");
+
+	printf("  csum none %llu unnecessary %llu partial %llu, gso skbs %llu\n",
+	       (unsigned long long)sink->ip_summed[CHECKSUM_NONE],
+	       (unsigned long long)sink->ip_summed[CHECKSUM_UNNECESSARY],
+	       (unsigned long long)sink->ip_summed[CHECKSUM_PARTIAL],
+	       (unsigned long long)sink->gso_skbs);
+	printf("  coal rx %llu pkts %llu reconstruct %llu csum err %llu\n",
+	       (unsigned long long)res->coal.coal_rx,
+	       (unsigned long long)res->coal.coal_pkts,
+	       (unsigned long long)res->coal.coal_reconstruct,
+	       (unsigned long long)res->coal.coal_csum_err);
+
+	if (res->exp_valid && pkts != res->exp_segs) {
+		printf("  FAIL: expected %llu packets\n",
+		       (unsigned long long)res->exp_segs);
+		errors++;
+	}
+
+	if (!cfg->verify)
+		return errors;
+
+	printf("  verify: bad %llu, csum bad %llu, csum mismatch %llu\n",
+	       (unsigned long long)sink->bad_pkts,
+	       (unsigned long long)sink->csum_bad,
+	       (unsigned long long)sink->csum_mismatch);
+	if (sink->bad_pkts || sink->csum_mismatch) {
+		printf("  FAIL: malformed packets delivered\n");
+		errors++;
+	}
+
+	if (res->exp_valid && sink->csum_bad != res->exp_csum_errs) {
+		printf("  FAIL: expected %llu bad checksums\n",
+		       (unsigned long long)res->exp_csum_errs);
+		errors++;
+	}
+
+	return errors;
+}
+
+static u32 rmnet_replay_parse_flows(const char *arg)
+{
+	char *dup = strdup(arg), *tok, *save;
+	u32 flows = 0;
+	int i;
+
+	for (tok = strtok_r(dup, ",", &save); tok;
+	     tok = strtok_r(NULL, ",", &save)) {
+		for (i = 0; i < RMNET_REPLAY_FLOW_MAX; i++)
+			if (!strcmp(tok, rmnet_replay_flow_names[i]))
+				flows |= BIT(i);
+	}
+
+	free(dup);
+	return flows;
+}
+
+static void rmnet_replay_usage(const char *prog)
+{
+	fprintf(stderr,
+		"usage: %s [options]\n"
+		"  -m frag|skb|both  ingress path(s) to replay (both)\n"
+		"  -n count          buffers to replay (200000)\n"
+		"  -W count          warmup buffers (1024)\n"
+		"  -N count          distinct synthetic buffers (512)\n"
+		"  -p flows          tcp4,tcp6,udp4,udp6 (all)\n"
+		"  -s bytes          payload per packet (1360)\n"
+		"  -k count          packets per frame or aggregate (16)\n"
+		"  -l count          NLOs per coalesced frame, 1-6 (1)\n"
+		"  -e pct            packets with checksum errors (0)\n"
+		"  -b pct            single packet frames hitting the HW\n"
+		"                    checksum erratum (0)\n"
+		"  -o pct            csum offload aggregates instead of\n"
+		"                    coalesced frames (0)\n"
+		"  -u                offload packets need SW validation\n"
+		"  -g                disable NETIF_F_GRO_HW\n"
+		"  -L                batched list delivery on the frag path\n"
+		"  -c                verify every delivered packet\n"
+		"  -S seed           generator seed (1)\n"
+		"  -r file           replay buffers from a trace file\n"
+		"  -w file           save the buffers replayed to a trace file\n",
+		prog);
+}
+
+int main(int argc, char **argv)
+{
+	struct rmnet_replay_cfg cfg = {
+		.flows = BIT(RMNET_REPLAY_FLOW_MAX) - 1,
+		.seg_size = 1360,
+		.segs = 16,
+		.nlos = 1,
+		.pool = 512,
+		.iters = 200000,
+		.warmup = 1024,
+		.seed = 1,
+		.modes = { true, true },
+	};
+	struct rmnet_replay_result res;
+	struct rmnet_replay_buf *bufs = NULL;
+	u32 count = 0, i;
+	int perf_fd, opt, rc, errors = 0;
+
+	while ((opt = getopt(argc, argv, "m:n:W:N:p:s:k:l:e:b:o:ugLcS:r:w:h"))
+	       != -1) {
+		switch (opt) {
+		case 'm':
+			cfg.modes[RMNET_REPLAY_FRAG] = strcmp(optarg, "skb");
+			cfg.modes[RMNET_REPLAY_SKB] = strcmp(optarg, "frag");
+			break;
+		case 'n':
+			cfg.iters = strtoull(optarg, NULL, 0);
+			break;
+		case 'W':
+			cfg.warmup = strtoull(optarg, NULL, 0);
+			break;
+		case 'N':
+			cfg.pool = strtoul(optarg, NULL, 0);
+			break;
+		case 'p':
+			cfg.flows = rmnet_replay_parse_flows(optarg);
+			break;
+		case 's':
+			cfg.seg_size = strtoul(optarg, NULL, 0);
+			break;
+		case 'k':
+			cfg.segs = strtoul(optarg, NULL, 0);
+			break;
+		case 'l':
+			cfg.nlos = strtoul(optarg, NULL, 0);
+			break;
+		case 'e':
+			cfg.err_pct = strtoul(optarg, NULL, 0);
+			break;
+		case 'b':
+			cfg.buggy_pct = strtoul(optarg, NULL, 0);
+			break;
+		case 'o':
+			cfg.offload_pct = strtoul(optarg, NULL, 0);
+			break;
+		case 'u':
+			cfg.sw_csum = true;
+			break;
+		case 'g':
+			cfg.no_gro = true;
+			break;
+		case 'L':
+			cfg.list_rx = true;
+			break;
+		case 'c':
+			cfg.verify = true;
+			break;
+		case 'S':
+			cfg.seed = strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			cfg.read_file = optarg;
+			break;
+		case 'w':
+			cfg.write_file = optarg;
+			break;
+		default:
+			rmnet_replay_usage(argv[0]);
+			return opt == 'h' ? 0 : 2;
+		}
+	}
+
+	if (!cfg.flows || !cfg.pool || !cfg.segs ||
+	    cfg.segs > RMNET_MAP_V5_MAX_PACKETS ||
+	    !cfg.nlos || cfg.nlos > RMNET_MAP_V5_MAX_NLOS ||
+	    cfg.nlos > cfg.segs || cfg.seg_size < RMNET_REPLAY_MIN_PAYLOAD ||
+	    cfg.segs * (cfg.seg_size + RMNET_REPLAY_NLO_STEP *
+			RMNET_MAP_V5_MAX_NLOS) + 128 > RMNET_REPLAY_MAX_BUF) {
+		rmnet_replay_usage(argv[0]);
+		return 2;
+	}
+
+	/* Keep freed buffers in the heap so the timed region never pays for
+	 * returning memory to the OS and faulting it back in.
+	 */
+	mallopt(M_MMAP_THRESHOLD, 64 * 1024 * 1024);
+	mallopt(M_TRIM_THRESHOLD, 256 * 1024 * 1024);
+	rmnet_replay_seed = cfg.seed ?: 1;
+	if (cfg.read_file) {
+		rc = rmnet_replay_read(cfg.read_file, &bufs, &count);
+		if (rc) {
+			fprintf(stderr, "%s: bad trace file: %s\n",
+				cfg.read_file, strerror(-rc));
+			return 1;
+		}
+	} else {
+		count = cfg.pool;
+		bufs = calloc(count, sizeof(*bufs));
+		if (!bufs || rmnet_replay_generate(&cfg, bufs)) {
+			fprintf(stderr, "out of memory\n");
+			return 1;
+		}
+	}
+
+	if (cfg.write_file) {
+		rc = rmnet_replay_write(cfg.write_file, bufs, count);
+		if (rc) {
+			fprintf(stderr, "%s: %s\n", cfg.write_file,
+				strerror(-rc));
+			return 1;
+		}
+	}
+
+	perf_fd = rmnet_replay_perf_open();
+	for (i = 0; i < RMNET_REPLAY_MODE_MAX; i++) {
+		if (!cfg.modes[i])
+			continue;
+
+		rc = rmnet_replay_run(&cfg, bufs, count, i, perf_fd, &res);
+		if (rc) {
+			fprintf(stderr, "%s path setup failed: %d\n",
+				rmnet_replay_mode_names[i], rc);
+			return 1;
+		}
+
+		errors += rmnet_replay_report(&cfg, i, &res);
+	}
+
+	if (perf_fd >= 0)
+		close(perf_fd);
+
+	for (i = 0; i < count; i++)
+		free(bufs[i].data);
+
+	free(bufs);
+	return errors ? 1 : 0;
+}
@@ -0,0 +1,83 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * RMNET host replay harness
+ */
+
+#ifndef _RMNET_REPLAY_H_
+#define _RMNET_REPLAY_H_
+
+#include <linux/skbuff.h>
+#include "rmnet_config.h"
+
+#define RMNET_REPLAY_MUX_ID 1
+
+/* Everything handed to the network stack by the code under test */
+struct rmnet_replay_sink {
+	u64 skbs;
+	/* Packets on the wire, counting each GSO segment */
+	u64 segs;
+	u64 bytes;
+	u64 gso_skbs;
+	u64 ip_summed[4];
+	/* With verify set: CHECKSUM_NONE packets that really are bad */
+	u64 csum_bad;
+	/* CHECKSUM_UNNECESSARY packets that are not */
+	u64 csum_mismatch;
+	/* Malformed headers or payload */
+	u64 bad_pkts;
+	bool verify;
+};
+
+/* Every generated segment payload starts with its segment number followed by
+ * a pattern derived from it, so any mis-cut or misplaced data is detected.
+ */
+#define RMNET_REPLAY_MIN_PAYLOAD 8
+
+static inline u8 rmnet_replay_pattern(u32 id, u32 i)
+{
+	return (u8)(id * 31 + i * 7 + (i >> 8));
+}
+
+static inline void rmnet_replay_fill(u8 *buf, u32 len, u32 id)
+{
+	u32 i;
+
+	memcpy(buf, &id, sizeof(id));
+	for (i = sizeof(id); i < len; i++)
+		buf[i] = rmnet_replay_pattern(id, i);
+}
+
+static inline bool rmnet_replay_check(const u8 *buf, u32 len)
+{
+	u32 id, i;
+
+	if (len < sizeof(id))
+		return false;
+
+	memcpy(&id, buf, sizeof(id));
+	for (i = sizeof(id); i < len; i++)
+		if (buf[i] != rmnet_replay_pattern(id, i))
+			return false;
+
+	return true;
+}
+
+struct rmnet_replay_env {
+	struct net_device real_dev;
+	struct net_device vnd_dev;
+	struct rmnet_priv priv;
+	struct rmnet_endpoint ep;
+	struct rmnet_port port;
+	struct rmnet_replay_sink sink;
+};
+
+int rmnet_replay_env_init(struct rmnet_replay_env *env, u32 data_format,
+			  netdev_features_t features);
+void rmnet_replay_env_exit(struct rmnet_replay_env *env);
+void rmnet_replay_skb_ingress(struct sk_buff *skb, struct rmnet_port *port);
+
+int rmnet_replay_perf_open(void);
+void rmnet_replay_perf_enable(int fd, int enable);
+int rmnet_replay_perf_read(int fd, u64 *count);
+
+#endif /* _RMNET_REPLAY_H_ */
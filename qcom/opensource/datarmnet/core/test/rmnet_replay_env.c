@@ -0,0 +1,325 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * RMNET host replay harness: stand-ins for the rest of rmnet_core
+ *
+ * Provides the single port, endpoint and VND the parsers run against, and
+ * a network stack sink that accounts for (and optionally verifies) every
+ * packet delivered to it.
+ */
+
+#include <linux/ip.h>
+#include <linux/ipv6.h>
+#include "rmnet_config.h"
+#include "rmnet_descriptor.h"
+#include "rmnet_handlers.h"
+#include "rmnet_map.h"
+#include "rmnet_private.h"
+#include "rmnet_vnd.h"
+#include "rmnet_ll.h"
+#include "rmnet_genl.h"
+#include "qmi_rmnet.h"
+#include "rmnet_replay.h"
+
+static struct rmnet_replay_env *rmnet_replay_env;
+
+/* Largest packet the sink will verify */
+#define RMNET_REPLAY_MAX_PKT 65536
+
+static bool rmnet_replay_l4_csum_ok(const u8 *pkt, u32 len, u16 ip_len,
+				    u8 ip_proto, u8 proto)
+{
+	__wsum csum = csum_partial(pkt + ip_len, len - ip_len, 0);
+
+	if (ip_proto == 4) {
+		const struct iphdr *iph = (const struct iphdr *)pkt;
+
+		return !csum_tcpudp_magic(iph->saddr, iph->daddr,
+					  len - ip_len, proto, csum);
+	}
+
+	return !csum_ipv6_magic(&((const struct ipv6hdr *)pkt)->saddr,
+				&((const struct ipv6hdr *)pkt)->daddr,
+				len - ip_len, proto, csum);
+}
+
+/* Check the headers and payload pattern of a delivered packet, and that its
+ * checksum state matches its contents.
+ */
+static void rmnet_replay_verify(struct rmnet_replay_sink *sink,
+				struct sk_buff *skb)
+{
+	static u8 pkt[RMNET_REPLAY_MAX_PKT];
+	struct skb_shared_info *shinfo = skb_shinfo(skb);
+	u32 len = skb->len, off, seg, payload;
+	u16 ip_len, trans_len;
+	u8 ip_proto, proto;
+
+	if (len > sizeof(pkt) || skb_copy_bits(skb, 0, pkt, len))
+		goto bad;
+
+	if ((pkt[0] & 0xF0) == 0x40) {
+		struct iphdr *iph = (struct iphdr *)pkt;
+
+		ip_proto = 4;
+		ip_len = iph->ihl * 4;
+		proto = iph->protocol;
+		if (ip_fast_csum(iph, iph->ihl) || ntohs(iph->tot_len) != len)
+			goto bad;
+	} else if ((pkt[0] & 0xF0) == 0x60) {
+		struct ipv6hdr *ip6h = (struct ipv6hdr *)pkt;
+
+		ip_proto = 6;
+		ip_len = sizeof(*ip6h);
+		proto = ip6h->nexthdr;
+		if (ntohs(ip6h->payload_len) != len - ip_len)
+			goto bad;
+	} else {
+		goto bad;
+	}
+
+	if (proto == IPPROTO_TCP) {
+		trans_len = ((struct tcphdr *)(pkt + ip_len))->doff * 4;
+	} else if (proto == IPPROTO_UDP) {
+		trans_len = sizeof(struct udphdr);
+		if (ntohs(((struct udphdr *)(pkt + ip_len))->len) !=
+		    len - ip_len)
+			goto bad;
+	} else {
+		goto bad;
+	}
+
+	if (len < ip_len + trans_len)
+		goto bad;
+
+	payload = len - ip_len - trans_len;
+	seg = (shinfo->gso_segs > 1) ? shinfo->gso_size : payload;
+	for (off = 0; off < payload; off += seg)
+		if (!rmnet_replay_check(pkt + ip_len + trans_len + off,
+					min_t(u32, seg, payload - off)))
+			goto bad;
+
+	if (shinfo->gso_segs > 1)
+		return;
+
+	if (skb->ip_summed == CHECKSUM_UNNECESSARY &&
+	    !rmnet_replay_l4_csum_ok(pkt, len, ip_len, ip_proto, proto))
+		sink->csum_mismatch++;
+	else if (skb->ip_summed == CHECKSUM_NONE &&
+		 !rmnet_replay_l4_csum_ok(pkt, len, ip_len, ip_proto, proto))
+		sink->csum_bad++;
+
+	return;
+
+bad:
+	sink->bad_pkts++;
+}
+
+static void rmnet_replay_sink_skb(struct sk_buff *skb)
+{
+	struct rmnet_replay_sink *sink = &rmnet_replay_env->sink;
+	struct skb_shared_info *shinfo = skb_shinfo(skb);
+
+	sink->skbs++;
+	sink->segs += max_t(u32, shinfo->gso_segs, 1);
+	sink->bytes += skb->len;
+	sink->ip_summed[skb->ip_summed]++;
+	if (shinfo->gso_segs > 1)
+		sink->gso_skbs++;
+
+	if (sink->verify)
+		rmnet_replay_verify(sink, skb);
+
+	kfree_skb(skb);
+}
+
+void rmnet_deliver_skb(struct sk_buff *skb, struct rmnet_port *port)
+{
+	rmnet_replay_sink_skb(skb);
+}
+
+void rmnet_set_skb_proto(struct sk_buff *skb)
+{
+	switch (rmnet_map_data_ptr(skb)[0] & 0xF0) {
+	case 0x40:
+		skb->protocol = htons(ETH_P_IP);
+		break;
+	case 0x60:
+		skb->protocol = htons(ETH_P_IPV6);
+		break;
+	default:
+		skb->protocol = htons(ETH_P_MAP);
+		break;
+	}
+}
+
+void rmnet_deliver_skb_batch(struct sk_buff_head *head,
+			     struct rmnet_port *port)
+{
+	struct sk_buff *skb;
+
+	if (skb_queue_empty(head))
+		return;
+
+	port->stats.rx_batch.batches++;
+	port->stats.rx_batch.pkts += skb_queue_len(head);
+	while ((skb = __skb_dequeue(head)))
+		rmnet_replay_sink_skb(skb);
+}
+
+struct rmnet_endpoint *rmnet_get_endpoint(struct rmnet_port *port, u8 mux_id)
+{
+	struct rmnet_endpoint *ep;
+
+	hlist_for_each_entry_rcu(ep, &port->muxed_ep[mux_id], hlnode) {
+		if (ep->mux_id == mux_id)
+			return ep;
+	}
+
+	return NULL;
+}
+
+struct rmnet_port *rmnet_get_port(struct net_device *real_dev)
+{
+	return &rmnet_replay_env->port;
+}
+
+int rmnet_vnd_do_flow_control(struct net_device *dev, int enable)
+{
+	return 0;
+}
+
+void rmnet_map_dl_hdr_notify_v2(struct rmnet_port *port,
+				struct rmnet_map_dl_ind_hdr *dl_hdr,
+				struct rmnet_map_control_command_header *qcmd)
+{
+}
+
+void rmnet_map_dl_trl_notify_v2(struct rmnet_port *port,
+				struct rmnet_map_dl_ind_trl *dltrl,
+				struct rmnet_map_control_command_header *qcmd)
+{
+}
+
+void qmi_rmnet_set_dl_msg_active(void *port)
+{
+}
+
+void qmi_rmnet_work_maybe_restart(void *port)
+{
+}
+
+int rmnet_ll_send_skb(struct sk_buff *skb)
+{
+	kfree_skb(skb);
+	return 0;
+}
+
+void rmnet_core_genl_agg_ctl_record(struct rmnet_core_agg_ctl_info *info)
+{
+}
+
+/* Mirrors __rmnet_map_ingress_handler() for the linear skb path, minus the
+ * MAP command handling the replay never exercises.
+ */
+static void __rmnet_replay_skb_ingress(struct sk_buff *skb,
+				       struct rmnet_port *port)
+{
+	struct rmnet_map_header *qmap;
+	struct rmnet_endpoint *ep;
+	struct sk_buff_head list;
+	struct sk_buff *skbn;
+	u16 len, pad;
+
+	__skb_queue_head_init(&list);
+
+	qmap = (struct rmnet_map_header *)rmnet_map_data_ptr(skb);
+	if (qmap->cd_bit)
+		goto free_skb;
+
+	pad = qmap->pad_len;
+	len = ntohs(qmap->pkt_len) - pad;
+	ep = rmnet_get_endpoint(port, qmap->mux_id);
+	if (!ep)
+		goto free_skb;
+
+	skb->dev = ep->egress_dev;
+	if (qmap->next_hdr &&
+	    (port->data_format & (RMNET_FLAGS_INGRESS_COALESCE |
+				  RMNET_PRIV_FLAGS_INGRESS_MAP_CKSUMV5))) {
+		if (rmnet_map_process_next_hdr_packet(skb, &list, len))
+			goto free_skb;
+	} else {
+		pskb_pull(skb, sizeof(*qmap));
+		rmnet_set_skb_proto(skb);
+		pskb_trim(skb, len);
+		__skb_queue_tail(&list, skb);
+	}
+
+	while ((skbn = __skb_dequeue(&list)) != NULL)
+		rmnet_replay_sink_skb(skbn);
+
+	return;
+
+free_skb:
+	kfree_skb(skb);
+}
+
+/* Mirrors the deaggregation loop of rmnet_map_ingress_handler() */
+void rmnet_replay_skb_ingress(struct sk_buff *skb, struct rmnet_port *port)
+{
+	struct sk_buff *skbn;
+
+	while (skb) {
+		struct sk_buff *skb_frag = skb_shinfo(skb)->frag_list;
+
+		skb_shinfo(skb)->frag_list = NULL;
+		while ((skbn = rmnet_map_deaggregate(skb, port)) != NULL) {
+			__rmnet_replay_skb_ingress(skbn, port);
+
+			if (skbn == skb)
+				goto next_skb;
+		}
+
+		consume_skb(skb);
+next_skb:
+		skb = skb_frag;
+	}
+}
+
+int rmnet_replay_env_init(struct rmnet_replay_env *env, u32 data_format,
+			  netdev_features_t features)
+{
+	struct rmnet_port *port = &env->port;
+
+	memset(env, 0, sizeof(*env));
+	rmnet_replay_env = env;
+
+	strcpy(env->real_dev.name, "rmnet_ipa0");
+	env->real_dev.type = ARPHRD_RAWIP;
+	env->real_dev.features = features;
+
+	strcpy(env->vnd_dev.name, "rmnet_data0");
+	env->vnd_dev.type = ARPHRD_RAWIP;
+	env->vnd_dev.features = features;
+	env->vnd_dev.priv = &env->priv;
+	env->priv.mux_id = RMNET_REPLAY_MUX_ID;
+	env->priv.real_dev = &env->real_dev;
+
+	port->dev = &env->real_dev;
+	port->data_format = data_format;
+	port->nr_rmnet_devs = 1;
+	INIT_LIST_HEAD(&port->dl_list);
+
+	env->ep.mux_id = RMNET_REPLAY_MUX_ID;
+	env->ep.egress_dev = &env->vnd_dev;
+	hlist_add_head(&env->ep.hlnode, &port->muxed_ep[RMNET_REPLAY_MUX_ID]);
+
+	return rmnet_descriptor_init(port);
+}
+
+void rmnet_replay_env_exit(struct rmnet_replay_env *env)
+{
+	rmnet_descriptor_deinit(&env->port);
+	rmnet_descriptor_exit();
+	rmnet_replay_env = NULL;
+}
@@ -0,0 +1,44 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * RMNET host replay harness: cache miss counter
+ *
+ * Built against the host UAPI headers rather than the kernel API shim.
+ */
+
+#include <stdint.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/perf_event.h>
+
+int rmnet_replay_perf_open(void)
+{
+	struct perf_event_attr attr;
+
+	memset(&attr, 0, sizeof(attr));
+	attr.size = sizeof(attr);
+	attr.type = PERF_TYPE_HARDWARE;
+	attr.config = PERF_COUNT_HW_CACHE_MISSES;
+	attr.disabled = 1;
+	attr.exclude_kernel = 1;
+	attr.exclude_hv = 1;
+	return syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+void rmnet_replay_perf_enable(int fd, int enable)
+{
+	if (fd >= 0)
+		ioctl(fd, enable ? PERF_EVENT_IOC_ENABLE :
+				   PERF_EVENT_IOC_DISABLE, 0);
+}
+
+/* Return the count so far and restart from zero */
+int rmnet_replay_perf_read(int fd, uint64_t *count)
+{
+	if (fd < 0 || read(fd, count, sizeof(*count)) != sizeof(*count))
+		return -1;
+
+	ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+	return 0;
+}
@@ -0,0 +1,9 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/* RMNET host replay harness: see rmnet_shim.h */
+
+#ifndef _RMNET_SHIM_LINUX_IPV6_H_
+#define _RMNET_SHIM_LINUX_IPV6_H_
+
+#include "../rmnet_shim.h"
+
+#endif /* _RMNET_SHIM_LINUX_IPV6_H_ */
@@ -0,0 +1,24 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/* RMNET host replay harness: tracepoints compile to empty inlines */
+
+#ifndef _RMNET_SHIM_TRACEPOINT_H_
+#define _RMNET_SHIM_TRACEPOINT_H_
+
+#include "../rmnet_shim.h"
+
+#define PARAMS(args...) args
+#define TP_PROTO(args...) args
+#define TP_ARGS(args...) args
+#define TP_CONDITION(args...) args
+
+#define DECLARE_TRACE(name, proto, args) \
+	static inline void trace_##name(proto) { } \
+	static inline bool trace_##name##_enabled(void) { return false; }
+
+#define TRACE_EVENT(name, proto, args, tstruct, assign, print) \
+	DECLARE_TRACE(name, PARAMS(proto), PARAMS(args))
+#define DECLARE_EVENT_CLASS(name, proto, args, tstruct, assign, print)
+#define DEFINE_EVENT(template, name, proto, args) \
+	DECLARE_TRACE(name, PARAMS(proto), PARAMS(args))
+
+#endif /* _RMNET_SHIM_TRACEPOINT_H_ */
@@ -0,0 +1,538 @@
+// SPDX-License-Identifier: GPL-2.0-only
+/*
+ * RMNET host replay harness: out of line kernel API shim
+ */
+
+#include "rmnet_shim.h"
+
+struct rmnet_shim_stats rmnet_shim_stats;
+
+void *kmalloc(size_t size, gfp_t gfp)
+{
+	void *p = malloc(size);
+
+	if (p)
+		rmnet_shim_stats.kmalloc++;
+
+	return p;
+}
+
+void *kzalloc(size_t size, gfp_t gfp)
+{
+	void *p = calloc(1, size);
+
+	if (p)
+		rmnet_shim_stats.kmalloc++;
+
+	return p;
+}
+
+void *kcalloc(size_t n, size_t size, gfp_t gfp)
+{
+	void *p = calloc(n, size);
+
+	if (p)
+		rmnet_shim_stats.kmalloc++;
+
+	return p;
+}
+
+void kfree(const void *p)
+{
+	if (!p)
+		return;
+
+	rmnet_shim_stats.kfree++;
+	free((void *)p);
+}
+
+void ktime_get_real_ts64(struct timespec64 *ts)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	ts->tv_sec = now.tv_sec;
+	ts->tv_nsec = now.tv_nsec;
+}
+
+ktime_t ktime_get(void)
+{
+	struct timespec now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return (ktime_t)now.tv_sec * NSEC_PER_SEC + now.tv_nsec;
+}
+
+struct page *alloc_pages(gfp_t gfp, unsigned int order)
+{
+	struct page *page;
+
+	page = malloc(sizeof(*page));
+	if (!page)
+		return NULL;
+
+	page->addr = aligned_alloc(PAGE_SIZE, PAGE_SIZE << order);
+	if (!page->addr) {
+		free(page);
+		return NULL;
+	}
+
+	page->refcount = 1;
+	page->order = order;
+	rmnet_shim_stats.page_alloc++;
+	return page;
+}
+
+void __free_pages(struct page *page, unsigned int order)
+{
+	put_page(page);
+}
+
+void put_page(struct page *page)
+{
+	if (--page->refcount)
+		return;
+
+	rmnet_shim_stats.page_free++;
+	free(page->addr);
+	free(page);
+}
+
+/* Generic byte-order independent one's complement sum. Equivalent to the
+ * lib/checksum.c do_csum() result for any buffer alignment.
+ */
+static u32 rmnet_shim_do_csum(const u8 *buff, int len)
+{
+	u64 sum = 0;
+	int i;
+
+	for (i = 0; i + 1 < len; i += 2)
+		sum += (u32)buff[i] | ((u32)buff[i + 1] << 8);
+
+	if (len & 1)
+		sum += buff[len - 1];
+
+	while (sum >> 16)
+		sum = (sum & 0xffff) + (sum >> 16);
+
+	return (u32)sum;
+}
+
+__wsum csum_partial(const void *buff, int len, __wsum wsum)
+{
+	u32 sum = (u32)wsum;
+	u32 result = rmnet_shim_do_csum(buff, len);
+
+	result += sum;
+	if (sum > result)
+		result += 1;
+
+	return (__wsum)result;
+}
+
+static u32 rmnet_shim_from64to32(u64 x)
+{
+	x = (x & 0xffffffff) + (x >> 32);
+	x = (x & 0xffffffff) + (x >> 32);
+	return (u32)x;
+}
+
+__wsum csum_tcpudp_nofold(__be32 saddr, __be32 daddr, u32 len, u8 proto,
+			  __wsum sum)
+{
+	u64 s = (u32)sum;
+
+	s += (u32)saddr;
+	s += (u32)daddr;
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	s += proto + len;
+#else
+	s += (proto + len) << 8;
+#endif
+	return (__wsum)rmnet_shim_from64to32(s);
+}
+
+__sum16 csum_ipv6_magic(const struct in6_addr *saddr,
+			const struct in6_addr *daddr, u32 len, u8 proto,
+			__wsum csum)
+{
+	u64 sum = (u32)csum;
+	int i;
+
+	for (i = 0; i < 4; i++) {
+		sum += saddr->s6_addr32[i];
+		sum += daddr->s6_addr32[i];
+	}
+
+	sum += htonl(len);
+	sum += htonl(proto);
+	return csum_fold((__wsum)rmnet_shim_from64to32(sum));
+}
+
+struct sk_buff *alloc_skb(unsigned int size, gfp_t gfp)
+{
+	struct sk_buff *skb;
+	u8 *data;
+
+	size = SKB_DATA_ALIGN(size);
+	skb = calloc(1, sizeof(*skb));
+	if (!skb)
+		return NULL;
+
+	data = aligned_alloc(SMP_CACHE_BYTES,
+			     size + SKB_DATA_ALIGN(sizeof(struct skb_shared_info)));
+	if (!data) {
+		free(skb);
+		return NULL;
+	}
+
+	skb->head = data;
+	skb->data = data;
+	skb->tail = data;
+	skb->end = data + size;
+	skb->truesize = size + sizeof(*skb);
+	memset(skb_shinfo(skb), 0, sizeof(struct skb_shared_info));
+	rmnet_shim_stats.skb_alloc++;
+	return skb;
+}
+
+void kfree_skb(struct sk_buff *skb)
+{
+	struct skb_shared_info *shinfo;
+	int i;
+
+	if (!skb)
+		return;
+
+	shinfo = skb_shinfo(skb);
+	for (i = 0; i < shinfo->nr_frags; i++)
+		put_page(skb_frag_page(&shinfo->frags[i]));
+
+	kfree_skb_list(shinfo->frag_list);
+	rmnet_shim_stats.skb_free++;
+	free(skb->head);
+	free(skb);
+}
+
+int pskb_expand_head(struct sk_buff *skb, int nhead, int ntail, gfp_t gfp)
+{
+	unsigned int size = SKB_DATA_ALIGN((skb->end - skb->head) + nhead +
+					   ntail);
+	long off;
+	u8 *data;
+
+	data = aligned_alloc(SMP_CACHE_BYTES,
+			     size + SKB_DATA_ALIGN(sizeof(struct skb_shared_info)));
+	if (!data)
+		return -ENOMEM;
+
+	memcpy(data + nhead, skb->head, skb->tail - skb->head);
+	memcpy(data + size, skb_shinfo(skb), sizeof(struct skb_shared_info));
+	off = (data + nhead) - skb->head;
+	free(skb->head);
+
+	skb->head = data;
+	skb->data += off;
+	skb->tail += off;
+	skb->end = data + size;
+	skb->network_header += nhead;
+	skb->transport_header += nhead;
+	skb->mac_header += nhead;
+	skb->csum_start += nhead;
+	return 0;
+}
+
+struct sk_buff *skb_copy_expand(const struct sk_buff *skb, int newheadroom,
+				int newtailroom, gfp_t gfp)
+{
+	struct sk_buff *n;
+
+	n = alloc_skb(newheadroom + skb->len + newtailroom, gfp);
+	if (!n)
+		return NULL;
+
+	skb_reserve(n, newheadroom);
+	skb_put(n, skb->len);
+	if (skb_copy_bits(skb, 0, n->data, skb->len)) {
+		kfree_skb(n);
+		return NULL;
+	}
+
+	n->dev = skb->dev;
+	n->priority = skb->priority;
+	n->protocol = skb->protocol;
+	n->ip_summed = skb->ip_summed;
+	memcpy(n->cb, skb->cb, sizeof(n->cb));
+	return n;
+}
+
+/* Move 'delta' bytes from the page fragments into the linear area. Only the
+ * frags array is consulted; the harness never pulls across a frag_list.
+ */
+void *__pskb_pull_tail(struct sk_buff *skb, int delta)
+{
+	struct skb_shared_info *shinfo = skb_shinfo(skb);
+	int eat = delta;
+	int i, k;
+
+	if (skb->end - skb->tail < delta &&
+	    pskb_expand_head(skb, 0, delta + 128, GFP_ATOMIC))
+		return NULL;
+
+	shinfo = skb_shinfo(skb);
+	if (skb_copy_bits(skb, skb_headlen(skb), skb->tail, delta))
+		return NULL;
+
+	for (i = 0, k = 0; i < shinfo->nr_frags; i++) {
+		skb_frag_t *frag = &shinfo->frags[i];
+		int size = skb_frag_size(frag);
+
+		if (size <= eat) {
+			put_page(skb_frag_page(frag));
+			eat -= size;
+			continue;
+		}
+
+		shinfo->frags[k] = *frag;
+		if (eat) {
+			skb_frag_off_add(&shinfo->frags[k], eat);
+			skb_frag_size_sub(&shinfo->frags[k], eat);
+			eat = 0;
+		}
+
+		k++;
+	}
+
+	shinfo->nr_frags = k;
+	skb->tail += delta;
+	skb->data_len -= delta;
+	return skb->tail;
+}
+
+int ___pskb_trim(struct sk_buff *skb, unsigned int len)
+{
+	struct skb_shared_info *shinfo = skb_shinfo(skb);
+	unsigned int offset = skb_headlen(skb);
+	int i, nfrags = shinfo->nr_frags;
+
+	if (offset >= len) {
+		for (i = 0; i < nfrags; i++)
+			put_page(skb_frag_page(&shinfo->frags[i]));
+
+		shinfo->nr_frags = 0;
+		skb->data_len = 0;
+		skb->len = len;
+		skb->tail = skb->data + len;
+		return 0;
+	}
+
+	for (i = 0; i < nfrags; i++) {
+		unsigned int end = offset + skb_frag_size(&shinfo->frags[i]);
+
+		if (end < len) {
+			offset = end;
+			continue;
+		}
+
+		skb_frag_size_set(&shinfo->frags[i++], len - offset);
+		break;
+	}
+
+	for (nfrags = i; i < shinfo->nr_frags; i++)
+		put_page(skb_frag_page(&shinfo->frags[i]));
+
+	shinfo->nr_frags = nfrags;
+	skb->data_len -= skb->len - len;
+	skb->len = len;
+	return 0;
+}
+
+/* Walk the linear area, the frags and the frag_list calling 'fn' on each
+ * contiguous chunk in [offset, offset + len).
+ */
+static int rmnet_shim_skb_walk(const struct sk_buff *skb, int offset, int len,
+			       void (*fn)(const u8 *buf, int len, int pos,
+					  void *arg),
+			       void *arg)
+{
+	const struct skb_shared_info *shinfo = skb_shinfo(skb);
+	const struct sk_buff *frag_iter;
+	int start = skb_headlen(skb);
+	int pos = 0;
+	int copy, i;
+
+	if (offset < 0 || offset + len > (int)skb->len)
+		return -EFAULT;
+
+	copy = start - offset;
+	if (copy > 0) {
+		if (copy > len)
+			copy = len;
+
+		fn(skb->data + offset, copy, pos, arg);
+		len -= copy;
+		offset += copy;
+		pos += copy;
+		if (!len)
+			return 0;
+	}
+
+	for (i = 0; i < shinfo->nr_frags; i++) {
+		const skb_frag_t *frag = &shinfo->frags[i];
+		int end = start + skb_frag_size(frag);
+
+		copy = end - offset;
+		if (copy > 0) {
+			if (copy > len)
+				copy = len;
+
+			fn((u8 *)skb_frag_address(frag) + offset - start,
+			   copy, pos, arg);
+			len -= copy;
+			offset += copy;
+			pos += copy;
+			if (!len)
+				return 0;
+		}
+
+		start = end;
+	}
+
+	skb_walk_frags(skb, frag_iter) {
+		int end = start + frag_iter->len;
+
+		copy = end - offset;
+		if (copy > 0) {
+			int rc;
+
+			if (copy > len)
+				copy = len;
+
+			rc = rmnet_shim_skb_walk(frag_iter, offset - start,
+						 copy, fn, arg);
+			if (rc)
+				return rc;
+
+			len -= copy;
+			offset += copy;
+			pos += copy;
+			if (!len)
+				return 0;
+		}
+
+		start = end;
+	}
+
+	return len ? -EFAULT : 0;
+}
+
+static void rmnet_shim_copy_chunk(const u8 *buf, int len, int pos, void *arg)
+{
+	memcpy((u8 *)arg + pos, buf, len);
+}
+
+int skb_copy_bits(const struct sk_buff *skb, int offset, void *to, int len)
+{
+	return rmnet_shim_skb_walk(skb, offset, len, rmnet_shim_copy_chunk,
+				   to);
+}
+
+static void rmnet_shim_csum_chunk(const u8 *buf, int len, int pos, void *arg)
+{
+	__wsum *csum = arg;
+
+	*csum = csum_block_add(*csum, csum_partial(buf, len, 0), pos);
+}
+
+__wsum skb_checksum(const struct sk_buff *skb, int offset, int len,
+		    __wsum csum)
+{
+	__wsum sum = 0;
+
+	if (rmnet_shim_skb_walk(skb, offset, len, rmnet_shim_csum_chunk, &sum))
+		return csum;
+
+	return csum_add(csum, sum);
+}
+
+int skb_append_pagefrags(struct sk_buff *skb, struct page *page, int offset,
+			 size_t size)
+{
+	struct skb_shared_info *shinfo = skb_shinfo(skb);
+	int i = shinfo->nr_frags;
+
+	if (i && skb_frag_page(&shinfo->frags[i - 1]) == page &&
+	    skb_frag_off(&shinfo->frags[i - 1]) +
+	    skb_frag_size(&shinfo->frags[i - 1]) == (unsigned int)offset) {
+		skb_frag_size_add(&shinfo->frags[i - 1], size);
+	} else if (i < MAX_SKB_FRAGS) {
+		get_page(page);
+		skb_fill_page_desc(skb, i, page, offset, size);
+	} else {
+		return -EMSGSIZE;
+	}
+
+	return 0;
+}
+
+int skb_linearize(struct sk_buff *skb)
+{
+	if (!skb_is_nonlinear(skb))
+		return 0;
+
+	return __pskb_pull_tail(skb, skb->data_len) ? 0 : -ENOMEM;
+}
+
+int ipv6_skip_exthdr(const struct sk_buff *skb, int start, u8 *nexthdrp,
+		     __be16 *frag_offp)
+{
+	u8 nexthdr = *nexthdrp;
+
+	*frag_offp = 0;
+
+	while (ipv6_ext_hdr(nexthdr)) {
+		struct ipv6_opt_hdr _hdr, *hp;
+		int hdrlen;
+
+		if (nexthdr == NEXTHDR_NONE)
+			return -1;
+
+		hp = skb_header_pointer(skb, start, sizeof(_hdr), &_hdr);
+		if (!hp)
+			return -1;
+
+		if (nexthdr == NEXTHDR_FRAGMENT) {
+			__be16 _frag_off, *fp;
+
+			fp = skb_header_pointer(skb,
+						start +
+						offsetof(struct frag_hdr,
+							 frag_off),
+						sizeof(_frag_off), &_frag_off);
+			if (!fp)
+				return -1;
+
+			*frag_offp = *fp;
+			if (ntohs(*frag_offp) & ~0x7)
+				break;
+
+			hdrlen = 8;
+		} else if (nexthdr == NEXTHDR_AUTH) {
+			hdrlen = ipv6_authlen(hp);
+		} else {
+			hdrlen = ipv6_optlen(hp);
+		}
+
+		nexthdr = hp->nexthdr;
+		start += hdrlen;
+	}
+
+	*nexthdrp = nexthdr;
+	return start;
+}
+
+int dev_queue_xmit(struct sk_buff *skb)
+{
+	kfree_skb(skb);
+	return 0;
+}
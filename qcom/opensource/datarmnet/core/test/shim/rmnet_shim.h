@@ -0,0 +1,1462 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/*
+ * RMNET host replay harness: minimal kernel API shim
+ *
+ * Just enough of the skb, page, list, checksum and locking APIs to build
+ * the rmnet ingress parsers and qmi_rmnet.c as single-threaded userspace
+ * programs. Every kernel header pulled in by those files resolves to this
+ * one.
+ */
+
+#ifndef _RMNET_SHIM_H_
+#define _RMNET_SHIM_H_
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <limits.h>
+#include <time.h>
+
+/* Basic types */
+typedef uint8_t u8;
+typedef uint16_t u16;
+typedef uint32_t u32;
+typedef uint64_t u64;
+typedef int8_t s8;
+typedef int16_t s16;
+typedef int32_t s32;
+typedef int64_t s64;
+typedef u8 __u8;
+typedef u16 __u16;
+typedef u32 __u32;
+typedef u64 __u64;
+typedef u16 __be16;
+typedef u32 __be32;
+typedef u64 __be64;
+typedef u16 __le16;
+typedef u32 __le32;
+typedef u16 __sum16;
+typedef u32 __wsum;
+typedef unsigned int gfp_t;
+typedef u64 netdev_features_t;
+typedef s64 ktime_t;
+
+#define U64_MAX ((u64)~0ULL)
+
+#define __rcu
+#define __force
+#define __percpu
+#define __read_mostly
+#define __aligned(x) __attribute__((aligned(x)))
+#define __packed __attribute__((packed))
+#define __maybe_unused __attribute__((unused))
+#define likely(x) __builtin_expect(!!(x), 1)
+#define unlikely(x) __builtin_expect(!!(x), 0)
+#define READ_ONCE(x) (*(volatile __typeof__(x) *)&(x))
+#define WRITE_ONCE(x, v) (*(volatile __typeof__(x) *)&(x) = (v))
+#define barrier() __asm__ __volatile__("" ::: "memory")
+#define smp_mb() __sync_synchronize()
+#define smp_wmb() __sync_synchronize()
+#define smp_rmb() __sync_synchronize()
+#define smp_load_acquire(p) __atomic_load_n(p, __ATOMIC_ACQUIRE)
+#define smp_store_release(p, v) __atomic_store_n(p, v, __ATOMIC_RELEASE)
+#define cpu_relax() barrier()
+
+#define EXPORT_SYMBOL(x)
+#define EXPORT_SYMBOL_GPL(x)
+#define MODULE_LICENSE(x)
+#define module_param(n, t, p)
+#define MODULE_PARM_DESC(n, d)
+
+#define BIT(n) (1UL << (n))
+#define BITS_PER_LONG 64
+#define ARRAY_SIZE(a) (sizeof(a) / sizeof((a)[0]))
+#define ALIGN(x, a) (((x) + (a) - 1) & ~((__typeof__(x))(a) - 1))
+#define DIV_ROUND_UP(n, d) (((n) + (d) - 1) / (d))
+#define min(a, b) ((a) < (b) ? (a) : (b))
+#define max(a, b) ((a) > (b) ? (a) : (b))
+#define min_t(t, a, b) ((t)(a) < (t)(b) ? (t)(a) : (t)(b))
+#define max_t(t, a, b) ((t)(a) > (t)(b) ? (t)(a) : (t)(b))
+#define clamp_t(t, v, lo, hi) min_t(t, max_t(t, v, lo), hi)
+#define container_of(ptr, type, member) \
+	((type *)((char *)(ptr) - offsetof(type, member)))
+#define do_div(n, base) ({ u32 __rem = (n) % (base); (n) /= (base); __rem; })
+#define div_u64(n, d) ((u64)(n) / (d))
+#define div64_u64(n, d) ((u64)(n) / (d))
+#define BUILD_BUG_ON(c) _Static_assert(!(c), #c)
+#define WARN_ON(c) ({ int __c = !!(c); if (__c) \
+	fprintf(stderr, "WARN_ON %s:%d\n", __FILE__, __LINE__); __c; })
+#define WARN_ON_ONCE(c) WARN_ON(c)
+#define BUG_ON(c) do { if (c) abort(); } while (0)
+#define IS_ENABLED(x) 1
+#define CONFIG_IPV6 1
+
+#define pr_err(fmt, ...) fprintf(stderr, fmt, ##__VA_ARGS__)
+#define pr_info(fmt, ...) do { } while (0)
+#define pr_debug(fmt, ...) do { } while (0)
+#define printk(fmt, ...) do { } while (0)
+#define netdev_err(dev, fmt, ...) fprintf(stderr, fmt, ##__VA_ARGS__)
+
+#define LINUX_VERSION_CODE KERNEL_VERSION(5, 15, 0)
+#define KERNEL_VERSION(a, b, c) (((a) << 16) + ((b) << 8) + (c))
+
+static inline u32 ror32(u32 word, unsigned int shift)
+{
+	return (word >> (shift & 31)) | (word << ((-shift) & 31));
+}
+
+static inline unsigned long find_first_bit(const unsigned long *addr,
+					   unsigned long size)
+{
+	unsigned long i;
+
+	for (i = 0; i < size; i++)
+		if (addr[i / BITS_PER_LONG] & BIT(i % BITS_PER_LONG))
+			return i;
+	return size;
+}
+
+static inline bool test_and_set_bit(long nr, unsigned long *addr)
+{
+	bool old = *addr & BIT(nr);
+
+	*addr |= BIT(nr);
+	return old;
+}
+
+static inline bool test_and_clear_bit(long nr, unsigned long *addr)
+{
+	bool old = *addr & BIT(nr);
+
+	*addr &= ~BIT(nr);
+	return old;
+}
+
+static inline void set_bit(long nr, unsigned long *addr)
+{
+	*addr |= BIT(nr);
+}
+
+static inline void clear_bit(long nr, unsigned long *addr)
+{
+	*addr &= ~BIT(nr);
+}
+
+static inline bool test_bit(long nr, const unsigned long *addr)
+{
+	return *addr & BIT(nr);
+}
+
+/* Allocation accounting, reported per packet by the replay tool */
+struct rmnet_shim_stats {
+	u64 kmalloc;
+	u64 kfree;
+	u64 skb_alloc;
+	u64 skb_free;
+	u64 page_alloc;
+	u64 page_free;
+};
+
+extern struct rmnet_shim_stats rmnet_shim_stats;
+
+#define GFP_ATOMIC 0x1U
+#define GFP_KERNEL 0x2U
+#define __GFP_NOWARN 0x4U
+#define __GFP_NOMEMALLOC 0x8U
+#define __GFP_COMP 0x10U
+#define __GFP_ZERO 0x20U
+
+void *kmalloc(size_t size, gfp_t gfp);
+void *kzalloc(size_t size, gfp_t gfp);
+void *kcalloc(size_t n, size_t size, gfp_t gfp);
+void kfree(const void *p);
+#define kfree_rcu(p, f) kfree(p)
+#define vmalloc(s) kmalloc(s, GFP_KERNEL)
+#define vfree(p) kfree(p)
+
+/* Lists */
+struct list_head {
+	struct list_head *next, *prev;
+};
+
+struct hlist_head {
+	struct hlist_node *first;
+};
+
+struct hlist_node {
+	struct hlist_node *next, **pprev;
+};
+
+#define LIST_HEAD_INIT(name) { &(name), &(name) }
+#define LIST_HEAD(name) struct list_head name = LIST_HEAD_INIT(name)
+
+static inline void INIT_LIST_HEAD(struct list_head *list)
+{
+	list->next = list;
+	list->prev = list;
+}
+
+static inline void __list_add(struct list_head *new, struct list_head *prev,
+			      struct list_head *next)
+{
+	next->prev = new;
+	new->next = next;
+	new->prev = prev;
+	prev->next = new;
+}
+
+static inline void list_add(struct list_head *new, struct list_head *head)
+{
+	__list_add(new, head, head->next);
+}
+
+static inline void list_add_tail(struct list_head *new,
+				 struct list_head *head)
+{
+	__list_add(new, head->prev, head);
+}
+
+static inline void __list_del(struct list_head *prev, struct list_head *next)
+{
+	next->prev = prev;
+	prev->next = next;
+}
+
+static inline void list_del(struct list_head *entry)
+{
+	__list_del(entry->prev, entry->next);
+	entry->next = NULL;
+	entry->prev = NULL;
+}
+
+static inline void list_del_init(struct list_head *entry)
+{
+	__list_del(entry->prev, entry->next);
+	INIT_LIST_HEAD(entry);
+}
+
+static inline int list_empty(const struct list_head *head)
+{
+	return head->next == head;
+}
+
+static inline void list_splice_tail_init(struct list_head *list,
+					 struct list_head *head)
+{
+	if (!list_empty(list)) {
+		struct list_head *first = list->next;
+		struct list_head *last = list->prev;
+		struct list_head *at = head->prev;
+
+		first->prev = at;
+		at->next = first;
+		last->next = head;
+		head->prev = last;
+		INIT_LIST_HEAD(list);
+	}
+}
+
+#define list_entry(ptr, type, member) container_of(ptr, type, member)
+#define list_first_entry(ptr, type, member) \
+	list_entry((ptr)->next, type, member)
+#define list_last_entry(ptr, type, member) \
+	list_entry((ptr)->prev, type, member)
+#define list_first_entry_or_null(ptr, type, member) \
+	(!list_empty(ptr) ? list_first_entry(ptr, type, member) : NULL)
+#define list_next_entry(pos, member) \
+	list_entry((pos)->member.next, __typeof__(*(pos)), member)
+#define list_prev_entry(pos, member) \
+	list_entry((pos)->member.prev, __typeof__(*(pos)), member)
+#define list_for_each(pos, head) \
+	for (pos = (head)->next; pos != (head); pos = pos->next)
+#define list_for_each_safe(pos, n, head) \
+	for (pos = (head)->next, n = pos->next; pos != (head); \
+	     pos = n, n = pos->next)
+#define list_for_each_entry(pos, head, member) \
+	for (pos = list_first_entry(head, __typeof__(*pos), member); \
+	     &pos->member != (head); pos = list_next_entry(pos, member))
+#define list_for_each_entry_safe(pos, n, head, member) \
+	for (pos = list_first_entry(head, __typeof__(*pos), member), \
+	     n = list_next_entry(pos, member); &pos->member != (head); \
+	     pos = n, n = list_next_entry(n, member))
+#define list_for_each_entry_safe_reverse(pos, n, head, member) \
+	for (pos = list_last_entry(head, __typeof__(*pos), member), \
+	     n = list_prev_entry(pos, member); &pos->member != (head); \
+	     pos = n, n = list_prev_entry(n, member))
+#define list_for_each_entry_rcu(pos, head, member, ...) \
+	list_for_each_entry(pos, head, member)
+#define list_add_rcu list_add
+#define list_del_rcu list_del
+
+#define hlist_entry(ptr, type, member) container_of(ptr, type, member)
+#define hlist_entry_safe(ptr, type, member) \
+	({ __typeof__(ptr) ____ptr = (ptr); \
+	   ____ptr ? hlist_entry(____ptr, type, member) : NULL; })
+#define hlist_for_each_entry(pos, head, member) \
+	for (pos = hlist_entry_safe((head)->first, __typeof__(*(pos)), \
+				    member); \
+	     pos; \
+	     pos = hlist_entry_safe((pos)->member.next, \
+				    __typeof__(*(pos)), member))
+#define hlist_for_each_entry_rcu(pos, head, member, ...) \
+	hlist_for_each_entry(pos, head, member)
+
+static inline void hlist_add_head(struct hlist_node *n, struct hlist_head *h)
+{
+	struct hlist_node *first = h->first;
+
+	n->next = first;
+	if (first)
+		first->pprev = &n->next;
+	h->first = n;
+	n->pprev = &h->first;
+}
+
+#define hlist_add_head_rcu hlist_add_head
+
+static inline void hlist_del_init(struct hlist_node *n)
+{
+	if (n->pprev) {
+		*n->pprev = n->next;
+		if (n->next)
+			n->next->pprev = n->pprev;
+	}
+	n->next = NULL;
+	n->pprev = NULL;
+}
+
+#define hlist_del_rcu hlist_del_init
+
+/* Hash tables, from linux/hashtable.h */
+#define DECLARE_HASHTABLE(name, bits) struct hlist_head name[1 << (bits)]
+#define HASH_SIZE(name) ARRAY_SIZE(name)
+#define hash_min(val, bits) ((u32)((u32)(val) * 0x61C88647U) >> (32 - (bits)))
+#define HASH_BITS(name) (__builtin_ctz(HASH_SIZE(name)))
+#define hash_init(ht) memset(ht, 0, sizeof(ht))
+#define hash_add_rcu(ht, node, key) \
+	hlist_add_head_rcu(node, &(ht)[hash_min(key, HASH_BITS(ht))])
+#define hash_del_rcu(node) hlist_del_rcu(node)
+#define hash_for_each_possible_rcu(name, obj, member, key, ...) \
+	hlist_for_each_entry(obj, &(name)[hash_min(key, HASH_BITS(name))], \
+			     member)
+
+/* Locking and RCU. The harness is single threaded. */
+typedef struct {
+	int locked;
+} spinlock_t;
+
+#define DEFINE_SPINLOCK(x) spinlock_t x = { 0 }
+#define spin_lock_init(l) ((l)->locked = 0)
+#define spin_lock(l) ((void)(l))
+#define spin_unlock(l) ((void)(l))
+#define spin_lock_bh(l) ((void)(l))
+#define spin_unlock_bh(l) ((void)(l))
+#define spin_lock_irqsave(l, f) do { (void)(l); (f) = 0; } while (0)
+#define spin_unlock_irqrestore(l, f) do { (void)(l); (void)(f); } while (0)
+#define spin_trylock(l) ((void)(l), 1)
+#define local_irq_save(f) do { (f) = 0; } while (0)
+#define local_irq_restore(f) do { (void)(f); } while (0)
+#define local_bh_disable() do { } while (0)
+#define local_bh_enable() do { } while (0)
+#define lockdep_is_held(l) 1
+#define preempt_disable() do { } while (0)
+#define preempt_enable() do { } while (0)
+
+#define rcu_read_lock() do { } while (0)
+#define rcu_read_unlock() do { } while (0)
+#define rcu_dereference(p) (p)
+#define rcu_dereference_bh(p) (p)
+#define rcu_dereference_protected(p, c) (p)
+#define rcu_assign_pointer(p, v) ((p) = (v))
+#define RCU_INIT_POINTER(p, v) ((p) = (v))
+#define synchronize_rcu() do { } while (0)
+
+struct rcu_head {
+	void *next;
+};
+
+typedef struct {
+	int counter;
+} atomic_t;
+
+#define atomic_read(v) ((v)->counter)
+#define atomic_set(v, i) ((v)->counter = (i))
+#define atomic_inc(v) ((v)->counter++)
+#define atomic_dec(v) ((v)->counter--)
+
+/* Per-CPU data: a single CPU */
+#define NR_CPUS 1
+#define nr_cpu_ids NR_CPUS
+#define DEFINE_PER_CPU(type, name) __typeof__(type) name
+#define this_cpu_ptr(p) (p)
+#define raw_cpu_ptr(p) (p)
+#define per_cpu_ptr(p, cpu) ((void)(cpu), (p))
+#define for_each_possible_cpu(cpu) for ((cpu) = 0; (cpu) < NR_CPUS; (cpu)++)
+#define for_each_online_cpu(cpu) for_each_possible_cpu(cpu)
+#define smp_processor_id() 0
+#define raw_smp_processor_id() 0
+#define get_cpu() 0
+#define put_cpu() do { } while (0)
+#define num_possible_cpus() NR_CPUS
+#define alloc_percpu(type) ((type *)kzalloc(sizeof(type), GFP_KERNEL))
+#define alloc_percpu_gfp(type, gfp) ((type *)kzalloc(sizeof(type), gfp))
+#define free_percpu(p) kfree(p)
+
+struct u64_stats_sync {
+	int seq;
+};
+
+/* Time */
+struct timespec64 {
+	s64 tv_sec;
+	long tv_nsec;
+};
+
+#define NSEC_PER_SEC 1000000000L
+#define NSEC_PER_MSEC 1000000L
+#define NSEC_PER_USEC 1000L
+
+void ktime_get_real_ts64(struct timespec64 *ts);
+ktime_t ktime_get(void);
+#define ktime_get_ns() ((u64)ktime_get())
+#define ktime_set(s, ns) ((ktime_t)(s) * NSEC_PER_SEC + (ns))
+#define ns_to_ktime(ns) ((ktime_t)(ns))
+#define ktime_to_ns(kt) ((s64)(kt))
+
+static inline struct timespec64 timespec64_sub(struct timespec64 a,
+					       struct timespec64 b)
+{
+	struct timespec64 r;
+
+	r.tv_sec = a.tv_sec - b.tv_sec;
+	r.tv_nsec = a.tv_nsec - b.tv_nsec;
+	if (r.tv_nsec < 0) {
+		r.tv_sec--;
+		r.tv_nsec += NSEC_PER_SEC;
+	}
+
+	return r;
+}
+
+static inline s64 timespec64_to_ns(const struct timespec64 *ts)
+{
+	return ts->tv_sec * NSEC_PER_SEC + ts->tv_nsec;
+}
+
+/* Deferred work. Timers never fire in the harness; work runs inline. */
+enum hrtimer_restart {
+	HRTIMER_NORESTART,
+	HRTIMER_RESTART,
+};
+
+enum hrtimer_mode {
+	HRTIMER_MODE_REL,
+	HRTIMER_MODE_ABS,
+};
+
+#define CLOCK_MONOTONIC_SHIM 1
+
+struct hrtimer {
+	enum hrtimer_restart (*function)(struct hrtimer *t);
+	int active;
+};
+
+struct work_struct;
+typedef void (*work_func_t)(struct work_struct *work);
+
+struct work_struct {
+	work_func_t func;
+};
+
+#define hrtimer_init(t, c, m) ((t)->active = 0)
+#define hrtimer_start(t, k, m) ((void)(k), (void)(m), (t)->active = 1)
+#define hrtimer_cancel(t) ((t)->active = 0)
+#define hrtimer_active(t) ((t)->active)
+#define hrtimer_is_queued(t) ((t)->active)
+#define INIT_WORK(w, f) ((w)->func = (f))
+
+static inline bool schedule_work(struct work_struct *work)
+{
+	work->func(work);
+	return true;
+}
+
+static inline bool cancel_work_sync(struct work_struct *work)
+{
+	return false;
+}
+
+#define HZ 100
+#define jiffies ((unsigned long)(ktime_get() / (NSEC_PER_SEC / HZ)))
+#define msecs_to_jiffies(m) ((unsigned long)(m) * HZ / 1000)
+
+struct timer_list {
+	void (*function)(struct timer_list *t);
+	unsigned long expires;
+	int pending;
+};
+
+#define timer_setup(t, f, fl) ((t)->function = (f), (t)->pending = 0)
+#define from_timer(var, t, field) container_of(t, __typeof__(*var), field)
+#define mod_timer(t, e) ((t)->expires = (e), (t)->pending = 1)
+#define del_timer(t) ((t)->pending = 0)
+#define del_timer_sync(t) del_timer(t)
+#define timer_pending(t) ((t)->pending)
+
+struct delayed_work {
+	struct work_struct work;
+	int pending;
+};
+
+struct workqueue_struct {
+	int unused;
+};
+
+#define WQ_UNBOUND BIT(1)
+#define WQ_CPU_INTENSIVE BIT(5)
+#define WQ_MEM_RECLAIM BIT(3)
+
+#define INIT_DELAYED_WORK(w, f) ((w)->work.func = (f), (w)->pending = 0)
+#define to_delayed_work(w) container_of(w, struct delayed_work, work)
+#define alloc_workqueue(name, flags, max, ...) \
+	((struct workqueue_struct *)kzalloc(sizeof(struct workqueue_struct), \
+					    GFP_KERNEL))
+#define destroy_workqueue(wq) kfree(wq)
+#define flush_workqueue(wq) ((void)(wq))
+
+static inline bool queue_delayed_work(struct workqueue_struct *wq,
+				      struct delayed_work *work,
+				      unsigned long delay)
+{
+	work->pending = 1;
+	return true;
+}
+
+static inline bool cancel_delayed_work_sync(struct delayed_work *work)
+{
+	work->pending = 0;
+	return false;
+}
+
+/* Pages */
+#define PAGE_SHIFT 12
+#define PAGE_SIZE (1UL << PAGE_SHIFT)
+
+struct page {
+	void *addr;
+	int refcount;
+	unsigned int order;
+};
+
+struct page *alloc_pages(gfp_t gfp, unsigned int order);
+#define __dev_alloc_pages(gfp, order) alloc_pages(gfp, order)
+#define dev_alloc_pages(order) alloc_pages(GFP_ATOMIC, order)
+#define alloc_page(gfp) alloc_pages(gfp, 0)
+void __free_pages(struct page *page, unsigned int order);
+void put_page(struct page *page);
+
+static inline void get_page(struct page *page)
+{
+	page->refcount++;
+}
+
+static inline void *page_address(const struct page *page)
+{
+	return page->addr;
+}
+
+static inline unsigned long page_size(const struct page *page)
+{
+	return PAGE_SIZE << page->order;
+}
+
+static inline unsigned long page_to_pfn(const struct page *page)
+{
+	return (unsigned long)page->addr >> PAGE_SHIFT;
+}
+
+static inline int page_ref_count(const struct page *page)
+{
+	return page->refcount;
+}
+
+static inline int get_order(unsigned long size)
+{
+	int order = 0;
+
+	size = (size - 1) >> PAGE_SHIFT;
+	while (size) {
+		order++;
+		size >>= 1;
+	}
+
+	return order;
+}
+
+#define page_ref_inc(p) get_page(p)
+#define page_count(p) page_ref_count(p)
+#define page_to_nid(p) 0
+#define numa_mem_id() 0
+#define page_is_pfmemalloc(p) false
+#define dev_page_is_reusable(p) true
+
+/* Byte order. The harness only builds on little endian hosts. */
+#if __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "rmnet replay harness requires a little endian host"
+#endif
+
+#define htons(x) ((u16)__builtin_bswap16(x))
+#define ntohs(x) ((u16)__builtin_bswap16(x))
+#define htonl(x) ((u32)__builtin_bswap32(x))
+#define ntohl(x) ((u32)__builtin_bswap32(x))
+#define cpu_to_be16(x) htons(x)
+#define cpu_to_be32(x) htonl(x)
+#define be16_to_cpu(x) ntohs(x)
+#define be32_to_cpu(x) ntohl(x)
+#define __constant_htons(x) ((u16)__builtin_bswap16(x))
+#define __constant_htonl(x) ((u32)__builtin_bswap32(x))
+#define __cpu_to_be32(x) __constant_htonl(x)
+#define __constant_cpu_to_be32(x) __constant_htonl(x)
+
+/* Network headers */
+#define ETH_P_IP 0x0800
+#define ETH_P_IPV6 0x86DD
+#define ETH_P_MAP 0x00F9
+#define ETH_HLEN 14
+#define ARPHRD_ETHER 1
+#define ARPHRD_RAWIP 519
+#define INET6_ADDRSTRLEN 48
+
+#define IPPROTO_ICMP 1
+#define IPPROTO_TCP 6
+#define IPPROTO_UDP 17
+#define IPPROTO_ICMPV6 58
+
+#define IP_CE 0x8000
+#define IP_DF 0x4000
+#define IP_MF 0x2000
+#define IP_OFFSET 0x1FFF
+
+struct iphdr {
+	u8 ihl:4,
+	   version:4;
+	u8 tos;
+	__be16 tot_len;
+	__be16 id;
+	__be16 frag_off;
+	u8 ttl;
+	u8 protocol;
+	__sum16 check;
+	__be32 saddr;
+	__be32 daddr;
+};
+
+struct in6_addr {
+	union {
+		u8 u6_addr8[16];
+		__be16 u6_addr16[8];
+		__be32 u6_addr32[4];
+	} in6_u;
+#define s6_addr in6_u.u6_addr8
+#define s6_addr16 in6_u.u6_addr16
+#define s6_addr32 in6_u.u6_addr32
+};
+
+struct ipv6hdr {
+	u8 priority:4,
+	   version:4;
+	u8 flow_lbl[3];
+	__be16 payload_len;
+	u8 nexthdr;
+	u8 hop_limit;
+	struct in6_addr saddr;
+	struct in6_addr daddr;
+};
+
+struct ipv6_opt_hdr {
+	u8 nexthdr;
+	u8 hdrlen;
+} __packed;
+
+struct frag_hdr {
+	u8 nexthdr;
+	u8 reserved;
+	__be16 frag_off;
+	__be32 identification;
+};
+
+#define NEXTHDR_HOP 0
+#define NEXTHDR_TCP 6
+#define NEXTHDR_UDP 17
+#define NEXTHDR_IPV6 41
+#define NEXTHDR_ROUTING 43
+#define NEXTHDR_FRAGMENT 44
+#define NEXTHDR_GRE 47
+#define NEXTHDR_ESP 50
+#define NEXTHDR_AUTH 51
+#define NEXTHDR_ICMP 58
+#define NEXTHDR_NONE 59
+#define NEXTHDR_DEST 60
+
+#define ipv6_optlen(p) (((p)->hdrlen + 1) << 3)
+#define ipv6_authlen(p) (((p)->hdrlen + 2) << 2)
+
+static inline bool ipv6_ext_hdr(u8 nexthdr)
+{
+	return nexthdr == NEXTHDR_HOP || nexthdr == NEXTHDR_ROUTING ||
+	       nexthdr == NEXTHDR_FRAGMENT || nexthdr == NEXTHDR_AUTH ||
+	       nexthdr == NEXTHDR_NONE || nexthdr == NEXTHDR_DEST;
+}
+
+struct tcphdr {
+	__be16 source;
+	__be16 dest;
+	__be32 seq;
+	__be32 ack_seq;
+	u16 res1:4,
+	    doff:4,
+	    fin:1,
+	    syn:1,
+	    rst:1,
+	    psh:1,
+	    ack:1,
+	    urg:1,
+	    ece:1,
+	    cwr:1;
+	__be16 window;
+	__sum16 check;
+	__be16 urg_ptr;
+};
+
+union tcp_word_hdr {
+	struct tcphdr hdr;
+	__be32 words[5];
+};
+
+#define tcp_flag_word(tp) (((union tcp_word_hdr *)(tp))->words[3])
+
+#define TCP_FLAG_CWR __constant_htonl(0x00800000)
+#define TCP_FLAG_ECE __constant_htonl(0x00400000)
+#define TCP_FLAG_URG __constant_htonl(0x00200000)
+#define TCP_FLAG_ACK __constant_htonl(0x00100000)
+#define TCP_FLAG_PSH __constant_htonl(0x00080000)
+#define TCP_FLAG_RST __constant_htonl(0x00040000)
+#define TCP_FLAG_SYN __constant_htonl(0x00020000)
+#define TCP_FLAG_FIN __constant_htonl(0x00010000)
+
+struct udphdr {
+	__be16 source;
+	__be16 dest;
+	__be16 len;
+	__sum16 check;
+};
+
+struct icmphdr {
+	u8 type;
+	u8 code;
+	__sum16 checksum;
+	__be32 un;
+};
+
+struct icmp6hdr {
+	u8 icmp6_type;
+	u8 icmp6_code;
+	__sum16 icmp6_cksum;
+	__be32 icmp6_dataun;
+};
+
+#define AF_INET 2
+#define AF_INET6 10
+
+static inline bool ip_is_fragment(const struct iphdr *iph)
+{
+	return (iph->frag_off & htons(IP_MF | IP_OFFSET)) != 0;
+}
+
+/* Checksums, matching the generic lib/checksum.c semantics */
+__wsum csum_partial(const void *buff, int len, __wsum sum);
+
+static inline __sum16 csum_fold(__wsum csum)
+{
+	u32 sum = (u32)csum;
+
+	sum = (sum & 0xffff) + (sum >> 16);
+	sum = (sum & 0xffff) + (sum >> 16);
+	return (__sum16)~sum;
+}
+
+static inline __wsum csum_unfold(__sum16 n)
+{
+	return (__wsum)n;
+}
+
+static inline __wsum csum_add(__wsum csum, __wsum addend)
+{
+	u32 res = (u32)csum;
+
+	res += (u32)addend;
+	return (__wsum)(res + (res < (u32)addend));
+}
+
+static inline __wsum csum_sub(__wsum csum, __wsum addend)
+{
+	return csum_add(csum, ~addend);
+}
+
+static inline __wsum csum_block_add(__wsum csum, __wsum csum2, int offset)
+{
+	u32 sum = (u32)csum2;
+
+	if (offset & 1)
+		sum = ror32(sum, 8);
+
+	return csum_add(csum, (__wsum)sum);
+}
+
+static inline __sum16 csum16_add(__sum16 csum, __be16 addend)
+{
+	u16 res = (u16)csum;
+
+	res += (u16)addend;
+	return (__sum16)(res + (res < (u16)addend));
+}
+
+static inline __sum16 csum16_sub(__sum16 csum, __be16 addend)
+{
+	return csum16_add(csum, ~addend);
+}
+
+static inline void csum_replace2(__sum16 *sum, __be16 old, __be16 new)
+{
+	*sum = ~csum16_add(csum16_sub(~(*sum), old), new);
+}
+
+static inline __sum16 ip_fast_csum(const void *iph, unsigned int ihl)
+{
+	return csum_fold(csum_partial(iph, ihl * 4, 0));
+}
+
+static inline __sum16 ip_compute_csum(const void *buff, int len)
+{
+	return csum_fold(csum_partial(buff, len, 0));
+}
+
+__wsum csum_tcpudp_nofold(__be32 saddr, __be32 daddr, u32 len, u8 proto,
+			  __wsum sum);
+
+static inline __sum16 csum_tcpudp_magic(__be32 saddr, __be32 daddr, u32 len,
+					u8 proto, __wsum sum)
+{
+	return csum_fold(csum_tcpudp_nofold(saddr, daddr, len, proto, sum));
+}
+
+__sum16 csum_ipv6_magic(const struct in6_addr *saddr,
+			const struct in6_addr *daddr, u32 len, u8 proto,
+			__wsum csum);
+
+/* Network devices */
+struct sk_buff;
+
+#define NETIF_F_RXCSUM BIT(0)
+#define NETIF_F_GRO_HW BIT(1)
+#define NETIF_F_SG BIT(2)
+#define NETIF_F_FRAGLIST BIT(3)
+#define NETIF_F_GSO_UDP_L4 BIT(4)
+#define NETIF_F_TSO BIT(5)
+#define NETIF_F_TSO6 BIT(6)
+#define NETIF_F_HW_CSUM BIT(7)
+#define NETIF_F_IP_CSUM BIT(8)
+#define NETIF_F_IPV6_CSUM BIT(9)
+#define NETIF_F_GSO_FRAGLIST BIT(10)
+#define NETIF_F_ALL_TSO (NETIF_F_TSO | NETIF_F_TSO6)
+#define IFNAMSIZ 16
+
+/* rmnet data format flags from uapi if_link.h */
+#define RMNET_FLAGS_INGRESS_DEAGGREGATION (1U << 0)
+#define RMNET_FLAGS_INGRESS_MAP_COMMANDS (1U << 1)
+#define RMNET_FLAGS_INGRESS_MAP_CKSUMV4 (1U << 2)
+#define RMNET_FLAGS_EGRESS_MAP_CKSUMV4 (1U << 3)
+
+struct net_device;
+
+typedef enum netdev_tx {
+	NETDEV_TX_OK = 0x00,
+	NETDEV_TX_BUSY = 0x10,
+} netdev_tx_t;
+
+struct net_device_ops {
+	netdev_tx_t (*ndo_start_xmit)(struct sk_buff *skb,
+				      struct net_device *dev);
+};
+
+struct net_device {
+	char name[IFNAMSIZ];
+	const struct net_device_ops *netdev_ops;
+	netdev_features_t features;
+	netdev_features_t hw_features;
+	unsigned short type;
+	unsigned int mtu;
+	unsigned int num_tx_queues;
+	struct netdev_queue *_tx;
+	void *priv;
+};
+
+struct netdev_queue {
+	bool stopped;
+};
+
+static inline struct netdev_queue *
+netdev_get_tx_queue(const struct net_device *dev, unsigned int index)
+{
+	return dev->_tx ? &dev->_tx[index] : NULL;
+}
+
+#define netif_tx_wake_queue(q) ((q)->stopped = false)
+#define netif_tx_stop_queue(q) ((q)->stopped = true)
+
+static inline void netif_tx_wake_all_queues(struct net_device *dev)
+{
+	unsigned int i;
+
+	for (i = 0; dev->_tx && i < dev->num_tx_queues; i++)
+		dev->_tx[i].stopped = false;
+}
+
+#define netif_tx_lock(dev) ((void)(dev))
+#define netif_tx_unlock(dev) ((void)(dev))
+
+static inline void *netdev_priv(const struct net_device *dev)
+{
+	return dev->priv;
+}
+
+typedef enum rx_handler_result {
+	RX_HANDLER_CONSUMED,
+	RX_HANDLER_ANOTHER,
+	RX_HANDLER_EXACT,
+	RX_HANDLER_PASS,
+} rx_handler_result_t;
+
+struct netlink_ext_ack;
+struct rtnl_link_ops;
+struct genl_info;
+
+struct gro_cells {
+	void *cells;
+};
+
+/* rtnetlink and QMI encoding, for the qmi_rmnet flow control path */
+struct tcmsg {
+	unsigned char tcm_family;
+	unsigned char tcm__pad1;
+	unsigned short tcm__pad2;
+	int tcm_ifindex;
+	u32 tcm_handle;
+	u32 tcm_parent;
+	u32 tcm_info;
+};
+
+#define tcm__pad tcm__pad1
+#define ASSERT_RTNL() do { } while (0)
+
+enum qmi_elem_type {
+	QMI_EOTI,
+	QMI_OPT_FLAG,
+	QMI_DATA_LEN,
+	QMI_UNSIGNED_1_BYTE,
+	QMI_UNSIGNED_2_BYTE,
+	QMI_UNSIGNED_4_BYTE,
+	QMI_UNSIGNED_8_BYTE,
+	QMI_SIGNED_2_BYTE_ENUM,
+	QMI_SIGNED_4_BYTE_ENUM,
+	QMI_STRUCT,
+	QMI_STRING,
+};
+
+enum qmi_array_type {
+	NO_ARRAY,
+	STATIC_ARRAY,
+	VAR_LEN_ARRAY,
+};
+
+#define QMI_COMMON_TLV_TYPE 0
+
+struct qmi_elem_info {
+	enum qmi_elem_type data_type;
+	u32 elem_len;
+	u32 elem_size;
+	enum qmi_array_type array_type;
+	u8 tlv_type;
+	u32 offset;
+	const struct qmi_elem_info *ei_array;
+};
+
+/* Socket buffers */
+#define MAX_SKB_FRAGS 17
+#define SMP_CACHE_BYTES 64
+#define SKB_DATA_ALIGN(x) ALIGN(x, SMP_CACHE_BYTES)
+
+#define CHECKSUM_NONE 0
+#define CHECKSUM_UNNECESSARY 1
+#define CHECKSUM_COMPLETE 2
+#define CHECKSUM_PARTIAL 3
+
+#define SKB_GSO_TCPV4 BIT(0)
+#define SKB_GSO_DODGY BIT(1)
+#define SKB_GSO_TCP_ECN BIT(2)
+#define SKB_GSO_TCP_FIXEDID BIT(3)
+#define SKB_GSO_TCPV6 BIT(4)
+#define SKB_GSO_FRAGLIST BIT(18)
+#define SKB_GSO_UDP_L4 BIT(16)
+
+typedef struct bio_vec {
+	struct page *bv_page;
+	unsigned int bv_len;
+	unsigned int bv_offset;
+} skb_frag_t;
+
+struct skb_shared_info {
+	u8 nr_frags;
+	unsigned short gso_size;
+	unsigned short gso_segs;
+	unsigned int gso_type;
+	struct sk_buff *frag_list;
+	skb_frag_t frags[MAX_SKB_FRAGS];
+};
+
+struct sk_buff {
+	struct sk_buff *next;
+	struct sk_buff *prev;
+	struct net_device *dev;
+	char cb[48] __aligned(8);
+	unsigned int len;
+	unsigned int data_len;
+	u16 mac_len;
+	u16 queue_mapping;
+	u8 ip_summed:2,
+	   sw_hash:1,
+	   l4_hash:1;
+	u32 priority;
+	u32 hash;
+	u32 mark;
+	__be16 protocol;
+	u16 transport_header;
+	u16 network_header;
+	u16 mac_header;
+	u16 csum_start;
+	u16 csum_offset;
+	unsigned int truesize;
+	unsigned char *head;
+	unsigned char *data;
+	unsigned char *tail;
+	unsigned char *end;
+};
+
+struct sk_buff_head {
+	struct sk_buff *next;
+	struct sk_buff *prev;
+	u32 qlen;
+	spinlock_t lock;
+};
+
+#define skb_shinfo(skb) ((struct skb_shared_info *)((skb)->end))
+
+struct sk_buff *alloc_skb(unsigned int size, gfp_t gfp);
+#define __netdev_alloc_skb(d, s, g) alloc_skb(s, g)
+#define netdev_alloc_skb(d, s) alloc_skb(s, GFP_ATOMIC)
+#define napi_alloc_skb(n, s) alloc_skb(s, GFP_ATOMIC)
+void kfree_skb(struct sk_buff *skb);
+#define consume_skb(skb) kfree_skb(skb)
+#define dev_kfree_skb_any(skb) kfree_skb(skb)
+#define kfree_skb_list(skb) \
+	do { struct sk_buff *__s = (skb), *__n; \
+	     while (__s) { __n = __s->next; kfree_skb(__s); __s = __n; } \
+	} while (0)
+/* Page backed TX aggregates are not modelled; callers fall back to their
+ * allocation failure path.
+ */
+#define build_skb(data, size) ((void)(data), (void)(size), (struct sk_buff *)NULL)
+struct sk_buff *skb_copy_expand(const struct sk_buff *skb, int newheadroom,
+				int newtailroom, gfp_t gfp);
+int pskb_expand_head(struct sk_buff *skb, int nhead, int ntail, gfp_t gfp);
+void *__pskb_pull_tail(struct sk_buff *skb, int delta);
+int ___pskb_trim(struct sk_buff *skb, unsigned int len);
+int skb_copy_bits(const struct sk_buff *skb, int offset, void *to, int len);
+__wsum skb_checksum(const struct sk_buff *skb, int offset, int len,
+		    __wsum csum);
+int skb_append_pagefrags(struct sk_buff *skb, struct page *page, int offset,
+			 size_t size);
+int skb_linearize(struct sk_buff *skb);
+int ipv6_skip_exthdr(const struct sk_buff *skb, int start, u8 *nexthdrp,
+		     __be16 *frag_offp);
+
+static inline bool skb_is_nonlinear(const struct sk_buff *skb)
+{
+	return skb->data_len;
+}
+
+static inline bool skb_has_frag_list(const struct sk_buff *skb)
+{
+	return skb_shinfo(skb)->frag_list != NULL;
+}
+
+#define skb_zcopy(skb) ((void)(skb), false)
+/* No locally generated TCP acks: only the forwarded ack check runs */
+#define skb_is_tcp_pure_ack(skb) ((void)(skb), false)
+
+static inline void skb_mark_not_on_list(struct sk_buff *skb)
+{
+	skb->next = NULL;
+}
+
+static inline u32 skb_get_hash(struct sk_buff *skb)
+{
+	return skb->hash;
+}
+
+static inline unsigned int skb_headlen(const struct sk_buff *skb)
+{
+	return skb->len - skb->data_len;
+}
+
+static inline unsigned int skb_headroom(const struct sk_buff *skb)
+{
+	return skb->data - skb->head;
+}
+
+static inline int skb_tailroom(const struct sk_buff *skb)
+{
+	return skb_is_nonlinear(skb) ? 0 : skb->end - skb->tail;
+}
+
+static inline unsigned char *skb_tail_pointer(const struct sk_buff *skb)
+{
+	return skb->tail;
+}
+
+static inline void skb_reserve(struct sk_buff *skb, int len)
+{
+	skb->data += len;
+	skb->tail += len;
+}
+
+static inline void *skb_put(struct sk_buff *skb, unsigned int len)
+{
+	void *tmp = skb->tail;
+
+	skb->tail += len;
+	skb->len += len;
+	if (skb->tail > skb->end)
+		abort();
+
+	return tmp;
+}
+
+static inline void *skb_put_data(struct sk_buff *skb, const void *data,
+				 unsigned int len)
+{
+	void *tmp = skb_put(skb, len);
+
+	memcpy(tmp, data, len);
+	return tmp;
+}
+
+static inline void *skb_push(struct sk_buff *skb, unsigned int len)
+{
+	skb->data -= len;
+	skb->len += len;
+	if (skb->data < skb->head)
+		abort();
+
+	return skb->data;
+}
+
+static inline void *skb_pull(struct sk_buff *skb, unsigned int len)
+{
+	if (len > skb_headlen(skb))
+		return NULL;
+
+	skb->len -= len;
+	skb->data += len;
+	return skb->data;
+}
+
+static inline void *pskb_pull(struct sk_buff *skb, unsigned int len)
+{
+	if (len > skb->len)
+		return NULL;
+
+	if (len > skb_headlen(skb) &&
+	    !__pskb_pull_tail(skb, len - skb_headlen(skb)))
+		return NULL;
+
+	skb->len -= len;
+	skb->data += len;
+	return skb->data;
+}
+
+static inline bool pskb_may_pull(struct sk_buff *skb, unsigned int len)
+{
+	if (likely(len <= skb_headlen(skb)))
+		return true;
+
+	if (unlikely(len > skb->len))
+		return false;
+
+	return __pskb_pull_tail(skb, len - skb_headlen(skb)) != NULL;
+}
+
+static inline int pskb_trim(struct sk_buff *skb, unsigned int len)
+{
+	return (len < skb->len) ? ___pskb_trim(skb, len) : 0;
+}
+
+static inline void skb_trim(struct sk_buff *skb, unsigned int len)
+{
+	if (skb->len > len && !skb->data_len) {
+		skb->len = len;
+		skb->tail = skb->data + len;
+	}
+}
+
+static inline unsigned char *skb_network_header(const struct sk_buff *skb)
+{
+	return skb->head + skb->network_header;
+}
+
+static inline unsigned char *skb_transport_header(const struct sk_buff *skb)
+{
+	return skb->head + skb->transport_header;
+}
+
+static inline void skb_reset_network_header(struct sk_buff *skb)
+{
+	skb->network_header = skb->data - skb->head;
+}
+
+static inline void skb_set_network_header(struct sk_buff *skb, int offset)
+{
+	skb->network_header = skb->data - skb->head + offset;
+}
+
+static inline void skb_reset_transport_header(struct sk_buff *skb)
+{
+	skb->transport_header = skb->data - skb->head;
+}
+
+static inline void skb_set_transport_header(struct sk_buff *skb, int offset)
+{
+	skb->transport_header = skb->data - skb->head + offset;
+}
+
+static inline void skb_reset_mac_header(struct sk_buff *skb)
+{
+	skb->mac_header = skb->data - skb->head;
+}
+
+static inline int skb_transport_offset(const struct sk_buff *skb)
+{
+	return skb_transport_header(skb) - skb->data;
+}
+
+static inline int skb_network_offset(const struct sk_buff *skb)
+{
+	return skb_network_header(skb) - skb->data;
+}
+
+static inline struct iphdr *ip_hdr(const struct sk_buff *skb)
+{
+	return (struct iphdr *)skb_network_header(skb);
+}
+
+static inline struct ipv6hdr *ipv6_hdr(const struct sk_buff *skb)
+{
+	return (struct ipv6hdr *)skb_network_header(skb);
+}
+
+static inline struct tcphdr *tcp_hdr(const struct sk_buff *skb)
+{
+	return (struct tcphdr *)skb_transport_header(skb);
+}
+
+static inline struct udphdr *udp_hdr(const struct sk_buff *skb)
+{
+	return (struct udphdr *)skb_transport_header(skb);
+}
+
+static inline struct icmp6hdr *icmp6_hdr(const struct sk_buff *skb)
+{
+	return (struct icmp6hdr *)skb_transport_header(skb);
+}
+
+static inline void *skb_header_pointer(const struct sk_buff *skb, int offset,
+				       int len, void *buffer)
+{
+	if (offset + len <= (int)skb_headlen(skb))
+		return skb->data + offset;
+
+	if (skb_copy_bits(skb, offset, buffer, len) < 0)
+		return NULL;
+
+	return buffer;
+}
+
+static inline struct page *skb_frag_page(const skb_frag_t *frag)
+{
+	return frag->bv_page;
+}
+
+static inline unsigned int skb_frag_size(const skb_frag_t *frag)
+{
+	return frag->bv_len;
+}
+
+static inline unsigned int skb_frag_off(const skb_frag_t *frag)
+{
+	return frag->bv_offset;
+}
+
+static inline void *skb_frag_address(const skb_frag_t *frag)
+{
+	return (u8 *)page_address(skb_frag_page(frag)) + skb_frag_off(frag);
+}
+
+static inline void __skb_frag_set_page(skb_frag_t *frag, struct page *page)
+{
+	frag->bv_page = page;
+}
+
+static inline void skb_frag_size_set(skb_frag_t *frag, unsigned int size)
+{
+	frag->bv_len = size;
+}
+
+static inline void skb_frag_size_add(skb_frag_t *frag, int delta)
+{
+	frag->bv_len += delta;
+}
+
+static inline void skb_frag_size_sub(skb_frag_t *frag, int delta)
+{
+	frag->bv_len -= delta;
+}
+
+static inline void skb_frag_off_set(skb_frag_t *frag, unsigned int offset)
+{
+	frag->bv_offset = offset;
+}
+
+static inline void skb_frag_off_add(skb_frag_t *frag, int delta)
+{
+	frag->bv_offset += delta;
+}
+
+static inline void __skb_fill_page_desc(struct sk_buff *skb, int i,
+					struct page *page, int off, int size)
+{
+	skb_frag_t *frag = &skb_shinfo(skb)->frags[i];
+
+	frag->bv_page = page;
+	frag->bv_offset = off;
+	frag->bv_len = size;
+}
+
+static inline void skb_fill_page_desc(struct sk_buff *skb, int i,
+				      struct page *page, int off, int size)
+{
+	__skb_fill_page_desc(skb, i, page, off, size);
+	skb_shinfo(skb)->nr_frags = i + 1;
+}
+
+static inline void skb_add_rx_frag(struct sk_buff *skb, int i,
+				   struct page *page, int off, int size,
+				   unsigned int truesize)
+{
+	skb_fill_page_desc(skb, i, page, off, size);
+	skb->len += size;
+	skb->data_len += size;
+	skb->truesize += truesize;
+}
+
+static inline void skb_frag_ref(struct sk_buff *skb, int f)
+{
+	get_page(skb_frag_page(&skb_shinfo(skb)->frags[f]));
+}
+
+#define skb_walk_frags(skb, iter) \
+	for (iter = skb_shinfo(skb)->frag_list; iter; iter = iter->next)
+
+static inline void __skb_queue_head_init(struct sk_buff_head *list)
+{
+	list->prev = list->next = (struct sk_buff *)list;
+	list->qlen = 0;
+}
+
+#define skb_queue_head_init(list) __skb_queue_head_init(list)
+
+static inline void __skb_queue_tail(struct sk_buff_head *list,
+				    struct sk_buff *newsk)
+{
+	struct sk_buff *prev = list->prev;
+
+	newsk->next = (struct sk_buff *)list;
+	newsk->prev = prev;
+	prev->next = newsk;
+	list->prev = newsk;
+	list->qlen++;
+}
+
+#define skb_queue_tail(l, s) __skb_queue_tail(l, s)
+
+static inline struct sk_buff *skb_peek(const struct sk_buff_head *list)
+{
+	struct sk_buff *skb = list->next;
+
+	if (skb == (struct sk_buff *)list)
+		skb = NULL;
+
+	return skb;
+}
+
+static inline struct sk_buff *__skb_dequeue(struct sk_buff_head *list)
+{
+	struct sk_buff *skb = skb_peek(list);
+
+	if (skb) {
+		skb->next->prev = skb->prev;
+		skb->prev->next = skb->next;
+		skb->next = skb->prev = NULL;
+		list->qlen--;
+	}
+
+	return skb;
+}
+
+#define skb_dequeue(l) __skb_dequeue(l)
+
+static inline u32 skb_queue_len(const struct sk_buff_head *list)
+{
+	return list->qlen;
+}
+
+static inline int skb_queue_empty(const struct sk_buff_head *list)
+{
+	return list->next == (const struct sk_buff *)list;
+}
+
+#define skb_queue_walk_safe(queue, skb, tmp) \
+	for (skb = (queue)->next, tmp = skb->next; \
+	     skb != (struct sk_buff *)(queue); skb = tmp, tmp = skb->next)
+
+static inline void skb_set_queue_mapping(struct sk_buff *skb, u16 q)
+{
+	skb->queue_mapping = q;
+}
+
+int dev_queue_xmit(struct sk_buff *skb);
+
+#endif /* _RMNET_SHIM_H_ */
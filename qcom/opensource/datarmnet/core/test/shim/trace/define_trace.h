@@ -0,0 +1,2 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/* RMNET host replay harness: trace events are not instantiated */
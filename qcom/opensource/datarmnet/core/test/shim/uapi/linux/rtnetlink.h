@@ -0,0 +1,9 @@
+/* SPDX-License-Identifier: GPL-2.0-only */
+/* RMNET host replay harness: see rmnet_shim.h */
+
+#ifndef _RMNET_SHIM_UAPI_LINUX_RTNETLINK_H_
+#define _RMNET_SHIM_UAPI_LINUX_RTNETLINK_H_
+
+#include "../../rmnet_shim.h"
+
+#endif /* _RMNET_SHIM_UAPI_LINUX_RTNETLINK_H_ */
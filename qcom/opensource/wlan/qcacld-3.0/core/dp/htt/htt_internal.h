@@ -639,6 +639,9 @@ htt_rx_hash_list_insert(struct htt_pdev_t *pdev,
 qdf_nbuf_t
 htt_rx_hash_list_lookup(struct htt_pdev_t *pdev, qdf_dma_addr_t paddr);
 
+qdf_nbuf_t
+htt_rx_buf_id_lookup(struct htt_pdev_t *pdev, qdf_dma_addr_t paddr);
+
 #ifdef IPA_OFFLOAD
 int
 htt_tx_ipa_uc_attach(struct htt_pdev_t *pdev,
@@ -734,6 +737,25 @@ void htt_tx_group_credit_process(struct htt_pdev_t *pdev, u_int32_t *msg_word)
 }
 #endif
 
+/**
+ * htt_display_rx_buf_id() - display the rx buffer ID counters
+ * @pdev: pdev handle
+ *
+ * Return: none
+ */
+static inline void htt_display_rx_buf_id(struct htt_pdev_t *pdev)
+{
+	static const char * const echo[] = {"unknown", "on", "off"};
+
+	if (!pdev->rx_ring.buf_id.entries)
+		return;
+
+	qdf_nofl_info("rx buf id: entries %u echo %s hash_fallback %u",
+		      pdev->rx_ring.buf_id.num,
+		      echo[pdev->rx_ring.buf_id.echo],
+		      pdev->rx_ring.buf_id.hash_fallback_cnt);
+}
+
 #ifdef DEBUG_RX_RING_BUFFER
 /**
  * htt_rx_dbg_rxbuf_init() - init debug rx buff list
@@ -797,6 +819,7 @@ static inline int htt_display_rx_buf_debug(struct htt_pdev_t *pdev)
 			      pdev->refill_retry_timer_doubles,
 			      pdev->rx_buff_debt_invoked,
 			      pdev->rx_buff_fill_n_invoked);
+		htt_display_rx_buf_id(pdev);
 	} else
 		return -EINVAL;
 	return 0;
@@ -935,6 +958,8 @@ void htt_rx_dbg_rxbuf_init(struct htt_pdev_t *pdev)
 }
 static inline int htt_display_rx_buf_debug(struct htt_pdev_t *pdev)
 {
+	if (pdev)
+		htt_display_rx_buf_id(pdev);
 	return 0;
 }
 
@@ -1004,6 +1029,13 @@ void htt_rx_dbg_rxbuf_deinit(struct htt_pdev_t *pdev)
 
 #define RX_PADDR_MAGIC_PATTERN 0xDEAD0000
 
+/*
+ * With address marking, the 11 bits between the 37 bit paddr and the
+ * magic pattern carry the ID of the rx buffer, see htt_rx_buf_id_lookup.
+ */
+#define HTT_RX_BUF_ID_SHIFT 37
+#define HTT_RX_BUF_ID_MASK 0x7FF
+
 #if HTT_PADDR64
 static inline qdf_dma_addr_t htt_paddr_trim_to_37(qdf_dma_addr_t paddr)
 {
@@ -1042,12 +1074,20 @@ htt_rx_paddr_unmark_high_bits(qdf_dma_addr_t paddr)
 			HTT_ASSERT_ALWAYS(0);
 		}
 
-		/* clear markings  for further use */
-		paddr = htt_paddr_trim_to_37(paddr);
+		/* clear the magic, the buffer ID is needed by the pop */
+		paddr &= 0xFFFFFFFFFFFFULL;
 	}
 	return paddr;
 }
 
+static inline uint32_t htt_rx_paddr_buf_id(qdf_dma_addr_t paddr)
+{
+	if (sizeof(qdf_dma_addr_t) > 4)
+		return ((uint64_t)paddr >> HTT_RX_BUF_ID_SHIFT) &
+		       HTT_RX_BUF_ID_MASK;
+	return 0;
+}
+
 static inline
 qdf_dma_addr_t htt_rx_in_ord_paddr_get(uint32_t *u32p)
 {
@@ -1066,6 +1106,11 @@ qdf_dma_addr_t htt_rx_in_ord_paddr_get(uint32_t *u32p)
 	return paddr;
 }
 #else
+static inline uint32_t htt_rx_paddr_buf_id(qdf_dma_addr_t paddr)
+{
+	return 0;
+}
+
 #if HTT_PADDR64
 static inline
 qdf_dma_addr_t htt_rx_in_ord_paddr_get(uint32_t *u32p)
@@ -1104,8 +1149,7 @@ htt_rx_in_order_netbuf_pop(htt_pdev_handle pdev, qdf_dma_addr_t paddr)
 {
 	HTT_ASSERT1(htt_rx_in_order_ring_elems(pdev) != 0);
 	qdf_atomic_dec(&pdev->rx_ring.fill_cnt);
-	paddr = htt_paddr_trim_to_37(paddr);
-	return htt_rx_hash_list_lookup(pdev, paddr);
+	return htt_rx_buf_id_lookup(pdev, paddr);
 }
 
 #else
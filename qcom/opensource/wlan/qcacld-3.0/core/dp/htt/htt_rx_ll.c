@@ -71,26 +71,119 @@
 
 #define RX_PADDR_MAGIC_PATTERN 0xDEAD0000
 
+/* Buffers to look at for a free buffer ID before falling back to the hash */
+#define HTT_RX_BUF_ID_PROBES 8
+
 #ifdef ENABLE_DEBUG_ADDRESS_MARKING
 static qdf_dma_addr_t
-htt_rx_paddr_mark_high_bits(qdf_dma_addr_t paddr)
+htt_rx_paddr_mark_high_bits(qdf_dma_addr_t paddr, uint32_t buf_id)
 {
 	if (sizeof(qdf_dma_addr_t) > 4) {
 		/* clear high bits, leave lower 37 bits (paddr) */
 		paddr &= 0x01FFFFFFFFF;
+		/* the buffer ID goes right above the paddr */
+		paddr |= ((uint64_t)buf_id) << HTT_RX_BUF_ID_SHIFT;
 		/* mark upper 16 bits of paddr */
 		paddr |= (((uint64_t)RX_PADDR_MAGIC_PATTERN) << 32);
 	}
 	return paddr;
 }
+
+/**
+ * htt_rx_buf_id_supported() - check if rx buffers can be found by ID
+ * @pdev: HTT pdev handle
+ *
+ * The ID only survives the round trip through the FW in the marking bits.
+ * The IPA SMMU map/unmap of the rx buffers walks the hash table under
+ * rx_hash_lock, so the table is not used when that can happen.
+ *
+ * Return: true if the buffer ID table can be used
+ */
+static inline bool htt_rx_buf_id_supported(struct htt_pdev_t *pdev)
+{
+	return sizeof(qdf_dma_addr_t) > 4 &&
+	       !(qdf_mem_smmu_s1_enabled(pdev->osdev) &&
+		 pdev->is_ipa_uc_enabled);
+}
 #else
 static qdf_dma_addr_t
-htt_rx_paddr_mark_high_bits(qdf_dma_addr_t paddr)
+htt_rx_paddr_mark_high_bits(qdf_dma_addr_t paddr, uint32_t buf_id)
 {
 	return paddr;
 }
+
+static inline bool htt_rx_buf_id_supported(struct htt_pdev_t *pdev)
+{
+	return false;
+}
 #endif
 
+/**
+ * htt_rx_buf_id_alloc() - give a buffer posted to the FW an ID
+ * @pdev: HTT pdev handle
+ * @paddr: physical address of the buffer, without marking bits
+ * @netbuf: the buffer
+ *
+ * Called with refill_lock held, which makes the refill the only writer of
+ * free entries. The table has room for all the buffers the ring can hold,
+ * so a free entry is normally found at the first probe. Until the FW is
+ * seen to echo the ID, the buffer goes to the hash table as well.
+ *
+ * Return: buffer ID, 0 if the buffer has to go to the hash table
+ */
+static uint32_t htt_rx_buf_id_alloc(struct htt_pdev_t *pdev,
+				    qdf_dma_addr_t paddr, qdf_nbuf_t netbuf)
+{
+	struct htt_rx_buf_id_entry *entry;
+	uint32_t id = pdev->rx_ring.buf_id.next;
+	int probe;
+
+	if (!pdev->rx_ring.buf_id.entries ||
+	    pdev->rx_ring.buf_id.echo == HTT_RX_BUF_ID_ECHO_OFF)
+		return 0;
+
+	for (probe = 0; probe < HTT_RX_BUF_ID_PROBES; probe++) {
+		if (++id >= pdev->rx_ring.buf_id.num)
+			id = 1;
+
+		entry = &pdev->rx_ring.buf_id.entries[id];
+		if (qdf_atomic_read(&entry->in_use))
+			continue;
+
+		entry->paddr = paddr;
+		entry->netbuf = netbuf;
+		entry->hashed = pdev->rx_ring.buf_id.echo !=
+				HTT_RX_BUF_ID_ECHO_ON;
+		qdf_atomic_set(&entry->in_use, 1);
+		pdev->rx_ring.buf_id.next = id;
+		return id;
+	}
+
+	pdev->rx_ring.buf_id.hash_fallback_cnt++;
+	return 0;
+}
+
+/* true if the buffer posted with this ID has to go to the hash table */
+static inline bool htt_rx_buf_id_hashed(struct htt_pdev_t *pdev,
+					uint32_t buf_id)
+{
+	return !buf_id || pdev->rx_ring.buf_id.entries[buf_id].hashed;
+}
+
+/* undo htt_rx_buf_id_alloc() for a buffer that could not be posted */
+static void htt_rx_buf_id_free(struct htt_pdev_t *pdev, uint32_t buf_id)
+{
+	struct htt_rx_buf_id_entry *entry;
+
+	if (!buf_id)
+		return;
+
+	entry = &pdev->rx_ring.buf_id.entries[buf_id];
+	entry->netbuf = NULL;
+	entry->hashed = false;
+	qdf_atomic_set(&entry->in_use, 0);
+}
+
 /**
  * htt_get_first_packet_after_wow_wakeup() - get first packet after wow wakeup
  * @msg_word: pointer to rx indication message word
@@ -408,6 +501,7 @@ moretofill:
 	while (num > 0) {
 		qdf_dma_addr_t paddr, paddr_marked;
 		qdf_nbuf_t rx_netbuf;
+		uint32_t buf_id = 0;
 		int headroom;
 
 		rx_netbuf = htt_rx_ring_buf_attach(pdev);
@@ -466,13 +560,17 @@ moretofill:
 		}
 
 		paddr = qdf_nbuf_get_frag_paddr(rx_netbuf, 0);
-		paddr_marked = htt_rx_paddr_mark_high_bits(paddr);
+		if (pdev->cfg.is_full_reorder_offload)
+			buf_id = htt_rx_buf_id_alloc(pdev, paddr, rx_netbuf);
+		paddr_marked = htt_rx_paddr_mark_high_bits(paddr, buf_id);
 		if (pdev->cfg.is_full_reorder_offload) {
-			if (qdf_unlikely(htt_rx_hash_list_insert(
+			if (htt_rx_buf_id_hashed(pdev, buf_id) &&
+			    qdf_unlikely(htt_rx_hash_list_insert(
 					pdev, paddr_marked, rx_netbuf))) {
 				QDF_TRACE(QDF_MODULE_ID_HTT,
 					  QDF_TRACE_LEVEL_ERROR,
 					  "%s: hash insert failed!", __func__);
+				htt_rx_buf_id_free(pdev, buf_id);
 #ifdef DEBUG_DMA_DONE
 				qdf_nbuf_unmap(pdev->osdev, rx_netbuf,
 					       QDF_DMA_BIDIRECTIONAL);
@@ -1260,6 +1358,125 @@ qdf_nbuf_t htt_rx_hash_list_lookup(struct htt_pdev_t *pdev,
 	return netbuf;
 }
 
+/**
+ * htt_rx_buf_id_echo() - learn if the FW echoes the buffer ID bits
+ * @pdev: HTT pdev handle
+ * @id: buffer ID of the first buffer the FW hands back
+ *
+ * All the buffers posted before the first in-order indication got an ID,
+ * the table being empty, so a buffer handed back without one means the FW
+ * clears the bits. The table is not used from then on. The buffers posted
+ * so far are in the hash table as well.
+ *
+ * Return: none
+ */
+static void htt_rx_buf_id_echo(struct htt_pdev_t *pdev, uint32_t id)
+{
+	pdev->rx_ring.buf_id.echo = id ? HTT_RX_BUF_ID_ECHO_ON :
+					 HTT_RX_BUF_ID_ECHO_OFF;
+	qdf_print("rx buf id %s echoed by the FW\n", id ? "is" : "is not");
+}
+
+/**
+ * htt_rx_buf_id_lookup() - find the rx buffer of an in-order indication
+ * @pdev: HTT pdev handle
+ * @paddr: paddr from the FW, with the buffer ID bits still in place
+ *
+ * An O(1) table access without any lock for buffers posted with an ID,
+ * the hash table for the others.
+ *
+ * Return: the buffer, NULL if it was not found
+ */
+qdf_nbuf_t htt_rx_buf_id_lookup(struct htt_pdev_t *pdev, qdf_dma_addr_t paddr)
+{
+	struct htt_rx_buf_id_entry *entry;
+	uint32_t id = htt_rx_paddr_buf_id(paddr);
+	qdf_nbuf_t netbuf;
+	bool hashed;
+
+	if (qdf_unlikely(pdev->rx_ring.buf_id.echo ==
+			 HTT_RX_BUF_ID_ECHO_UNKNOWN) &&
+	    pdev->rx_ring.buf_id.entries)
+		htt_rx_buf_id_echo(pdev, id);
+
+	paddr = htt_paddr_trim_to_37(paddr);
+	if (!id || id >= pdev->rx_ring.buf_id.num)
+		return htt_rx_hash_list_lookup(pdev, paddr);
+
+	entry = &pdev->rx_ring.buf_id.entries[id];
+	if (qdf_unlikely(!qdf_atomic_read(&entry->in_use) ||
+			 entry->paddr != paddr)) {
+		qdf_print("rx buf id %u: no entry found for %llx!\n",
+			  id, (unsigned long long)paddr);
+		cds_trigger_recovery(QDF_RX_HASH_NO_ENTRY_FOUND);
+		return NULL;
+	}
+
+	netbuf = entry->netbuf;
+	hashed = entry->hashed;
+	entry->netbuf = NULL;
+	/* orders the reads above before the refill may reuse the entry */
+	qdf_atomic_dec_and_test(&entry->in_use);
+	if (qdf_unlikely(hashed))
+		return htt_rx_hash_list_lookup(pdev, paddr);
+	htt_rx_dbg_rxbuf_reset(pdev, netbuf);
+
+	return netbuf;
+}
+
+static void htt_rx_buf_id_init(struct htt_pdev_t *pdev)
+{
+	uint32_t num;
+
+	if (!htt_rx_buf_id_supported(pdev))
+		return;
+
+	/* one more than the ring holds, ID 0 is not used */
+	num = QDF_MIN((uint32_t)pdev->rx_ring.size + 1,
+		      (uint32_t)HTT_RX_BUF_ID_MASK + 1);
+	pdev->rx_ring.buf_id.entries =
+		qdf_mem_malloc(num * sizeof(struct htt_rx_buf_id_entry));
+	if (!pdev->rx_ring.buf_id.entries)
+		return;
+
+	pdev->rx_ring.buf_id.num = num;
+	pdev->rx_ring.buf_id.next = 0;
+	pdev->rx_ring.buf_id.hash_fallback_cnt = 0;
+	pdev->rx_ring.buf_id.echo = HTT_RX_BUF_ID_ECHO_UNKNOWN;
+}
+
+static void htt_rx_buf_id_deinit(struct htt_pdev_t *pdev)
+{
+	struct htt_rx_buf_id_entry *entry;
+	uint32_t i;
+
+	if (!pdev->rx_ring.buf_id.entries)
+		return;
+
+	for (i = 1; i < pdev->rx_ring.buf_id.num; i++) {
+		entry = &pdev->rx_ring.buf_id.entries[i];
+		/* the hash table deinit frees the hashed ones */
+		if (!qdf_atomic_read(&entry->in_use) || !entry->netbuf ||
+		    entry->hashed)
+			continue;
+
+#ifdef DEBUG_DMA_DONE
+		qdf_nbuf_unmap(pdev->osdev, entry->netbuf,
+			       QDF_DMA_BIDIRECTIONAL);
+#else
+		qdf_nbuf_unmap(pdev->osdev, entry->netbuf,
+			       QDF_DMA_FROM_DEVICE);
+#endif
+		qdf_nbuf_free(entry->netbuf);
+		entry->netbuf = NULL;
+		qdf_atomic_set(&entry->in_use, 0);
+	}
+
+	qdf_mem_free(pdev->rx_ring.buf_id.entries);
+	pdev->rx_ring.buf_id.entries = NULL;
+	pdev->rx_ring.buf_id.num = 0;
+}
+
 /*
  * Initialization function of the rx buffer hash table. This function will
  * allocate a hash table of a certain pre-determined size and initialize all
@@ -1334,6 +1551,9 @@ static int htt_rx_hash_init(struct htt_pdev_t *pdev)
 hi_end:
 	qdf_spin_unlock_bh(&pdev->rx_ring.rx_hash_lock);
 
+	if (!rc)
+		htt_rx_buf_id_init(pdev);
+
 	return rc;
 }
 
@@ -1352,6 +1572,8 @@ static void htt_rx_hash_deinit(struct htt_pdev_t *pdev)
 	if (!pdev->rx_ring.hash_table)
 		return;
 
+	htt_rx_buf_id_deinit(pdev);
+
 	qdf_spin_lock_bh(&pdev->rx_ring.rx_hash_lock);
 	ipa_smmu = htt_rx_ring_smmu_mapped(pdev);
 	hash_table = pdev->rx_ring.hash_table;
@@ -112,6 +112,30 @@ struct htt_rx_hash_bucket {
 #endif
 };
 
+/*
+ * Rx buffer posted to the FW, found by the buffer ID the FW echoes back
+ * in the marking bits of the paddr. in_use is set by the refill, which
+ * is serialized by refill_lock, and cleared by the in-order pop. hashed
+ * is set for buffers also put in the hash table, see htt_rx_buf_id_echo.
+ */
+struct htt_rx_buf_id_entry {
+	qdf_dma_addr_t paddr;
+	qdf_nbuf_t netbuf;
+	qdf_atomic_t in_use;
+	bool hashed;
+};
+
+/*
+ * Whether the FW echoes the buffer ID bits. Not every FW keeps them, so
+ * buffers go to both the table and the hash table until the first in-order
+ * indication tells.
+ */
+enum htt_rx_buf_id_echo {
+	HTT_RX_BUF_ID_ECHO_UNKNOWN,
+	HTT_RX_BUF_ID_ECHO_ON,
+	HTT_RX_BUF_ID_ECHO_OFF,
+};
+
 /*
  * Micro controller datapath offload
  * WLAN TX resources
@@ -371,6 +395,22 @@ struct htt_pdev_t {
 		struct htt_rx_hash_bucket **hash_table;
 		uint32_t listnode_offset;
 		bool smmu_map;
+
+		/*
+		 * buf_id -
+		 * Lock-free table of the posted rx buffers, indexed by buffer
+		 * ID. ID 0 is never handed out, buffers posted with it are
+		 * in the hash table. entries is NULL when the paddr echoed by
+		 * the FW can't carry the ID, the hash table is used then, as
+		 * it is once echo is HTT_RX_BUF_ID_ECHO_OFF.
+		 */
+		struct {
+			struct htt_rx_buf_id_entry *entries;
+			uint32_t num;
+			uint32_t next;
+			uint32_t hash_fallback_cnt;
+			enum htt_rx_buf_id_echo echo;
+		} buf_id;
 	} rx_ring;
 
 #ifndef CONFIG_HL_SUPPORT
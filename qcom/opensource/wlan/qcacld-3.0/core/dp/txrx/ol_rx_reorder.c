@@ -70,15 +70,6 @@ static char g_log2ceil[] = {
 
 /*---*/
 
-/* reorder array elements are known to be non-NULL */
-#define OL_RX_REORDER_LIST_APPEND(head_msdu, tail_msdu, rx_reorder_array_elem) \
-	do {								\
-		if (tail_msdu) {					\
-			qdf_nbuf_set_next(tail_msdu,			\
-					  rx_reorder_array_elem->head); \
-		}							\
-	} while (0)
-
 /* functions called by txrx components */
 
 void ol_rx_reorder_init(struct ol_rx_reorder_t *rx_reorder, uint8_t tid)
@@ -87,6 +78,7 @@ void ol_rx_reorder_init(struct ol_rx_reorder_t *rx_reorder, uint8_t tid)
 	rx_reorder->win_sz_mask = 0;
 	rx_reorder->array = &rx_reorder->base;
 	rx_reorder->base.head = rx_reorder->base.tail = NULL;
+	rx_reorder->occupied = 0;
 	rx_reorder->tid = tid;
 	rx_reorder->defrag_timeout_ms = 0;
 
@@ -225,20 +217,103 @@ ol_rx_reorder_store(struct ol_txrx_pdev_t *pdev,
 		qdf_nbuf_set_next(rx_reorder_array_elem->tail, head_msdu);
 	} else {
 		rx_reorder_array_elem->head = head_msdu;
+		OL_RX_REORDER_SLOT_SET(&peer->tids_rx_reorder[tid], idx);
 		OL_RX_REORDER_MPDU_CNT_INCR(&peer->tids_rx_reorder[tid], 1);
 	}
 	rx_reorder_array_elem->tail = tail_msdu;
 }
 
+/**
+ * ol_rx_reorder_unlink() - take the MPDUs out of a range of reorder slots
+ * @rx_reorder: rx reorder state of the TID
+ * @idx_start: first slot of the range
+ * @idx_end: slot following the range. If equal to @idx_start, the range
+ *	is the whole array.
+ * @head_msdu: returns the first MSDU of the range, NULL if it is empty
+ *
+ * Only the occupied slots are visited, by way of the occupancy bitmap.
+ * A fully occupied range, the common in-order case, is walked slot by slot
+ * without scanning the bitmap. The MSDUs of all MPDUs in the range are
+ * chained in slot order, and the slots are left empty.
+ *
+ * Return: last MSDU of the range, or NULL if it is empty
+ */
+static qdf_nbuf_t
+ol_rx_reorder_unlink(struct ol_rx_reorder_t *rx_reorder,
+		     unsigned int idx_start, unsigned int idx_end,
+		     qdf_nbuf_t *head_msdu)
+{
+	struct ol_rx_reorder_array_elem_t *array = rx_reorder->array;
+	struct ol_rx_reorder_array_elem_t *rx_reorder_array_elem;
+	unsigned int win_sz_mask = rx_reorder->win_sz_mask;
+	unsigned int idx, num;
+	uint64_t occupied, range, cleared = 0;
+	qdf_nbuf_t head = NULL;
+	qdf_nbuf_t tail_msdu = NULL;
+
+	idx_start &= win_sz_mask;
+	idx_end &= win_sz_mask;
+	num = (idx_end - idx_start) & win_sz_mask;
+	if (!num)
+		num = win_sz_mask + 1;
+
+	range = num < 64 ? (1ULL << num) - 1 : ~0ULL;
+	occupied = ol_rx_reorder_occupied(rx_reorder, idx_start, num);
+	if (occupied == range) {
+		rx_reorder_array_elem = &array[idx_start];
+		OL_RX_REORDER_MPDU_CNT_DECR(rx_reorder, num);
+		head = rx_reorder_array_elem->head;
+		tail_msdu = rx_reorder_array_elem->tail;
+		rx_reorder_array_elem->head = rx_reorder_array_elem->tail =
+						      NULL;
+		for (idx = (idx_start + 1) & win_sz_mask; idx != idx_end;
+		     idx = (idx + 1) & win_sz_mask) {
+			rx_reorder_array_elem = &array[idx];
+			qdf_nbuf_set_next(tail_msdu,
+					  rx_reorder_array_elem->head);
+			tail_msdu = rx_reorder_array_elem->tail;
+			rx_reorder_array_elem->head =
+				rx_reorder_array_elem->tail = NULL;
+		}
+
+		cleared = range << idx_start;
+		if (idx_start)
+			cleared |= range >> (win_sz_mask + 1 - idx_start);
+		rx_reorder->occupied &= ~cleared;
+		*head_msdu = head;
+
+		return tail_msdu;
+	}
+
+	while (occupied) {
+		idx = (idx_start + ol_rx_reorder_first_slot(occupied)) &
+		      win_sz_mask;
+		occupied &= occupied - 1;
+
+		rx_reorder_array_elem = &array[idx];
+		OL_RX_REORDER_MPDU_CNT_DECR(rx_reorder, 1);
+		if (!head)
+			head = rx_reorder_array_elem->head;
+		else
+			qdf_nbuf_set_next(tail_msdu,
+					  rx_reorder_array_elem->head);
+		tail_msdu = rx_reorder_array_elem->tail;
+		rx_reorder_array_elem->head = rx_reorder_array_elem->tail =
+						      NULL;
+		cleared |= 1ULL << idx;
+	}
+	rx_reorder->occupied &= ~cleared;
+	*head_msdu = head;
+
+	return tail_msdu;
+}
+
 void
 ol_rx_reorder_release(struct ol_txrx_vdev_t *vdev,
 		      struct ol_txrx_peer_t *peer,
 		      unsigned int tid, unsigned int idx_start,
 		      unsigned int idx_end)
 {
-	unsigned int idx;
-	unsigned int win_sz, win_sz_mask;
-	struct ol_rx_reorder_array_elem_t *rx_reorder_array_elem;
 	qdf_nbuf_t head_msdu;
 	qdf_nbuf_t tail_msdu;
 
@@ -246,34 +321,8 @@ ol_rx_reorder_release(struct ol_txrx_vdev_t *vdev,
 	/* may get reset below */
 	peer->tids_next_rel_idx[tid] = (uint16_t) idx_end;
 
-	win_sz = peer->tids_rx_reorder[tid].win_sz;
-	win_sz_mask = peer->tids_rx_reorder[tid].win_sz_mask;
-	idx_start &= win_sz_mask;
-	idx_end &= win_sz_mask;
-	rx_reorder_array_elem = &peer->tids_rx_reorder[tid].array[idx_start];
-
-	head_msdu = rx_reorder_array_elem->head;
-	tail_msdu = rx_reorder_array_elem->tail;
-	rx_reorder_array_elem->head = rx_reorder_array_elem->tail = NULL;
-	if (head_msdu)
-		OL_RX_REORDER_MPDU_CNT_DECR(&peer->tids_rx_reorder[tid], 1);
-
-	idx = (idx_start + 1);
-	OL_RX_REORDER_IDX_WRAP(idx, win_sz, win_sz_mask);
-	while (idx != idx_end) {
-		rx_reorder_array_elem = &peer->tids_rx_reorder[tid].array[idx];
-		if (rx_reorder_array_elem->head) {
-			OL_RX_REORDER_MPDU_CNT_DECR(&peer->tids_rx_reorder[tid],
-						    1);
-			OL_RX_REORDER_LIST_APPEND(head_msdu, tail_msdu,
-						  rx_reorder_array_elem);
-			tail_msdu = rx_reorder_array_elem->tail;
-		}
-		rx_reorder_array_elem->head = rx_reorder_array_elem->tail =
-						      NULL;
-		idx++;
-		OL_RX_REORDER_IDX_WRAP(idx, win_sz, win_sz_mask);
-	}
+	tail_msdu = ol_rx_reorder_unlink(&peer->tids_rx_reorder[tid],
+					 idx_start, idx_end, &head_msdu);
 	if (head_msdu) {
 		uint16_t seq_num;
 		htt_pdev_handle htt_pdev = vdev->pdev->htt_pdev;
@@ -316,15 +365,11 @@ ol_rx_reorder_flush(struct ol_txrx_vdev_t *vdev,
 		    unsigned int idx_end, enum htt_rx_flush_action action)
 {
 	struct ol_txrx_pdev_t *pdev;
-	unsigned int win_sz;
-	uint8_t win_sz_mask;
-	struct ol_rx_reorder_array_elem_t *rx_reorder_array_elem;
-	qdf_nbuf_t head_msdu = NULL;
-	qdf_nbuf_t tail_msdu = NULL;
+	struct ol_rx_reorder_t *rx_reorder = &peer->tids_rx_reorder[tid];
+	qdf_nbuf_t head_msdu;
+	qdf_nbuf_t tail_msdu;
 
 	pdev = vdev->pdev;
-	win_sz = peer->tids_rx_reorder[tid].win_sz;
-	win_sz_mask = peer->tids_rx_reorder[tid].win_sz_mask;
 
 	OL_RX_REORDER_IDX_START_SELF_SELECT(peer, tid, &idx_start);
 	/* a idx_end value of 0xffff means to flush the entire array */
@@ -339,37 +384,14 @@ ol_rx_reorder_flush(struct ol_txrx_vdev_t *vdev,
 		 * reset the "next release index".
 		 */
 		peer->tids_next_rel_idx[tid] =
-			OL_RX_REORDER_IDX_INIT(0 /*n/a */, win_sz, win_sz_mask);
+			OL_RX_REORDER_IDX_INIT(0 /*n/a */, rx_reorder->win_sz,
+					       rx_reorder->win_sz_mask);
 	} else {
 		peer->tids_next_rel_idx[tid] = (uint16_t) idx_end;
 	}
 
-	idx_start &= win_sz_mask;
-	idx_end &= win_sz_mask;
-
-	do {
-		rx_reorder_array_elem =
-			&peer->tids_rx_reorder[tid].array[idx_start];
-		idx_start = (idx_start + 1);
-		OL_RX_REORDER_IDX_WRAP(idx_start, win_sz, win_sz_mask);
-
-		if (rx_reorder_array_elem->head) {
-			OL_RX_REORDER_MPDU_CNT_DECR(&peer->tids_rx_reorder[tid],
-						    1);
-			if (!head_msdu) {
-				head_msdu = rx_reorder_array_elem->head;
-				tail_msdu = rx_reorder_array_elem->tail;
-				rx_reorder_array_elem->head = NULL;
-				rx_reorder_array_elem->tail = NULL;
-				continue;
-			}
-			qdf_nbuf_set_next(tail_msdu,
-					  rx_reorder_array_elem->head);
-			tail_msdu = rx_reorder_array_elem->tail;
-			rx_reorder_array_elem->head =
-				rx_reorder_array_elem->tail = NULL;
-		}
-	} while (idx_start != idx_end);
+	tail_msdu = ol_rx_reorder_unlink(rx_reorder, idx_start, idx_end,
+					 &head_msdu);
 
 	ol_rx_defrag_waitlist_remove(peer, tid);
 
@@ -401,7 +423,7 @@ ol_rx_reorder_flush(struct ol_txrx_vdev_t *vdev,
 	 * it is likely that a BAR or a sequence number shift caused the
 	 * sequence number to jump, so the old last_seq value is not relevant.
 	 */
-	if (OL_RX_REORDER_NO_HOLES(&peer->tids_rx_reorder[tid]))
+	if (OL_RX_REORDER_NO_HOLES(rx_reorder))
 		peer->tids_last_seq[tid] = IEEE80211_SEQ_MAX;   /* invalid */
 
 	OL_RX_REORDER_TIMEOUT_REMOVE(peer, tid);
@@ -411,27 +433,27 @@ void
 ol_rx_reorder_first_hole(struct ol_txrx_peer_t *peer,
 			 unsigned int tid, unsigned int *idx_end)
 {
-	unsigned int win_sz, win_sz_mask;
+	struct ol_rx_reorder_t *rx_reorder = &peer->tids_rx_reorder[tid];
+	unsigned int win_sz_mask = rx_reorder->win_sz_mask;
 	unsigned int idx_start = 0, tmp_idx = 0;
-
-	win_sz = peer->tids_rx_reorder[tid].win_sz;
-	win_sz_mask = peer->tids_rx_reorder[tid].win_sz_mask;
+	uint64_t occupied;
 
 	OL_RX_REORDER_IDX_START_SELF_SELECT(peer, tid, &idx_start);
-	tmp_idx++;
-	OL_RX_REORDER_IDX_WRAP(tmp_idx, win_sz, win_sz_mask);
-	/* bypass the initial hole */
-	while (tmp_idx != idx_start &&
-	       !peer->tids_rx_reorder[tid].array[tmp_idx].head) {
-		tmp_idx++;
-		OL_RX_REORDER_IDX_WRAP(tmp_idx, win_sz, win_sz_mask);
-	}
-	/* bypass the present frames following the initial hole */
-	while (tmp_idx != idx_start &&
-	       peer->tids_rx_reorder[tid].array[tmp_idx].head) {
-		tmp_idx++;
-		OL_RX_REORDER_IDX_WRAP(tmp_idx, win_sz, win_sz_mask);
+	/* the slots after idx_start, up to and excluding idx_start */
+	occupied = win_sz_mask ?
+		ol_rx_reorder_occupied(rx_reorder,
+				       (idx_start + 1) & win_sz_mask,
+				       win_sz_mask) : 0;
+	if (occupied) {
+		/* bypass the initial hole */
+		tmp_idx = ol_rx_reorder_first_slot(occupied);
+		/* bypass the present frames following the initial hole */
+		occupied = ~(occupied >> tmp_idx);
+		tmp_idx += ol_rx_reorder_first_slot(occupied);
+	} else {
+		tmp_idx = win_sz_mask;
 	}
+	tmp_idx = (idx_start + 1 + tmp_idx) & win_sz_mask;
 	/*
 	 * idx_end is exclusive rather than inclusive.
 	 * In other words, it is the index of the first slot of the second
@@ -570,6 +592,7 @@ ol_rx_addba_handler(ol_txrx_pdev_handle pdev,
 
 	rx_reorder->win_sz_mask = round_pwr2_win_sz - 1;
 	rx_reorder->num_mpdus = 0;
+	rx_reorder->occupied = 0;
 
 	peer->tids_next_rel_idx[tid] =
 		OL_RX_REORDER_IDX_INIT(start_seq_num, rx_reorder->win_sz,
@@ -684,7 +707,9 @@ ol_rx_pn_ind_handler(ol_txrx_pdev_handle pdev,
 	void *rx_desc;
 	struct ol_txrx_peer_t *peer;
 	struct ol_rx_reorder_array_elem_t *rx_reorder_array_elem;
-	unsigned int win_sz_mask;
+	struct ol_rx_reorder_t *rx_reorder;
+	unsigned int win_sz_mask, num;
+	uint64_t occupied;
 	qdf_nbuf_t head_msdu = NULL;
 	qdf_nbuf_t tail_msdu = NULL;
 	htt_pdev_handle htt_pdev = pdev->htt_pdev;
@@ -714,14 +739,20 @@ ol_rx_pn_ind_handler(ol_txrx_pdev_handle pdev,
 
 	qdf_atomic_set(&peer->fw_pn_check, 1);
 	/*TODO: Fragmentation case */
-	win_sz_mask = peer->tids_rx_reorder[tid].win_sz_mask;
+	rx_reorder = &peer->tids_rx_reorder[tid];
+	win_sz_mask = rx_reorder->win_sz_mask;
 	seq_num_start &= win_sz_mask;
 	seq_num_end &= win_sz_mask;
-	seq_num = seq_num_start;
+	num = (seq_num_end - seq_num_start) & win_sz_mask;
+	if (!num)
+		num = win_sz_mask + 1;
 
-	do {
-		rx_reorder_array_elem =
-			&peer->tids_rx_reorder[tid].array[seq_num];
+	occupied = ol_rx_reorder_occupied(rx_reorder, seq_num_start, num);
+	while (occupied) {
+		seq_num = (seq_num_start + ol_rx_reorder_first_slot(occupied)) &
+			  win_sz_mask;
+		occupied &= occupied - 1;
+		rx_reorder_array_elem = &rx_reorder->array[seq_num];
 
 		if (rx_reorder_array_elem->head) {
 			if (pn_ie_cnt && seq_num == (int)(pn_ie[i])) {
@@ -813,9 +844,9 @@ ol_rx_pn_ind_handler(ol_txrx_pdev_handle pdev,
 			}
 			rx_reorder_array_elem->head = NULL;
 			rx_reorder_array_elem->tail = NULL;
+			OL_RX_REORDER_SLOT_CLEAR(rx_reorder, seq_num);
 		}
-		seq_num = (seq_num + 1) & win_sz_mask;
-	} while (seq_num != seq_num_end);
+	}
 
 	if (head_msdu) {
 		/* rx_opt_proc takes a NULL-terminated list of msdu netbufs */
@@ -64,6 +64,52 @@ ol_rx_reorder_peer_cleanup(struct ol_txrx_vdev_t *vdev,
 
 void ol_rx_reorder_init(struct ol_rx_reorder_t *rx_reorder, uint8_t tid);
 
+/*
+ * Every store into and removal from the reorder array must update the
+ * occupancy bitmap, which release, flush and hole detection rely on.
+ */
+#define OL_RX_REORDER_SLOT_SET(rx_reorder, idx) \
+	((rx_reorder)->occupied |= 1ULL << (idx))
+#define OL_RX_REORDER_SLOT_CLEAR(rx_reorder, idx) \
+	((rx_reorder)->occupied &= ~(1ULL << (idx)))
+
+/**
+ * ol_rx_reorder_occupied() - occupancy of a range of reorder array slots
+ * @rx_reorder: rx reorder state of the TID
+ * @idx_start: first slot of the range
+ * @num: number of slots in the range, from 1 up to the window size
+ *
+ * The range may wrap around the end of the array.
+ *
+ * Return: bitmap with bit n set if slot idx_start + n holds an MPDU
+ */
+static inline uint64_t
+ol_rx_reorder_occupied(struct ol_rx_reorder_t *rx_reorder,
+		       unsigned int idx_start, unsigned int num)
+{
+	unsigned int win_sz = rx_reorder->win_sz_mask + 1;
+	uint64_t occupied = rx_reorder->occupied;
+
+	if (idx_start)
+		occupied = (occupied >> idx_start) |
+			   (occupied << (win_sz - idx_start));
+	if (num < 64)
+		occupied &= (1ULL << num) - 1;
+
+	return occupied;
+}
+
+/**
+ * ol_rx_reorder_first_slot() - offset of the first occupied slot
+ * @occupied: non-zero bitmap from ol_rx_reorder_occupied()
+ *
+ * Return: index of the lowest set bit
+ */
+static inline unsigned int ol_rx_reorder_first_slot(uint64_t occupied)
+{
+	return __ffs64(occupied);
+}
+
 enum htt_rx_status
 ol_rx_seq_num_check(struct ol_txrx_pdev_t *pdev,
 			    struct ol_txrx_peer_t *peer,
@@ -1377,6 +1377,8 @@ struct ol_rx_reorder_t {
 	uint8_t win_sz_mask;
 	uint8_t num_mpdus;
 	struct ol_rx_reorder_array_elem_t *array;
+	/* occupancy of array - bit n is set while array[n].head is non-NULL */
+	uint64_t occupied;
 	/* base - single rx reorder element used for non-aggr cases */
 	struct ol_rx_reorder_array_elem_t base;
 #if defined(QCA_SUPPORT_OL_RX_REORDER_TIMEOUT)
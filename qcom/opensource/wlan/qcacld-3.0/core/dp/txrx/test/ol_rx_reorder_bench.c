@@ -0,0 +1,471 @@
+/* SPDX-License-Identifier: ISC */
+
+/*
+ * Rx reorder release benchmark
+ *
+ * Runs generated store/release patterns through ol_rx_reorder.c and through
+ * the slot by slot reference in ol_rx_reorder_ref.c. Checks that both
+ * deliver exactly the stored MPDUs in sequence number order, then times
+ * them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <ol_txrx_htt_api.h>
+#include <ol_rx_reorder.h>
+#include "ol_rx_reorder_bench.h"
+
+#define BENCH_TID 0
+#define BENCH_MAX_WIN 64
+/* MSDUs per MPDU: 2 for every third sequence number, 1 otherwise */
+#define BENCH_MAX_MSDUS 2
+
+enum bench_pattern {
+	BENCH_DENSE,
+	BENCH_LOSS,
+	BENCH_SPARSE,
+	BENCH_HOLE,
+	BENCH_NUM_PATTERNS
+};
+
+static const char * const bench_pattern_name[BENCH_NUM_PATTERNS] = {
+	"dense", "loss", "sparse", "hole"
+};
+
+/**
+ * struct bench_op - one step of a pattern
+ * @base: sequence number of the first slot
+ * @num: slots from @base the step covers
+ * @present: bit n is set if the MPDU with sequence number @base + n is
+ *	stored
+ *
+ * dense and loss store and then release [@base, @base + @num). sparse
+ * stores and then flushes the whole array. hole stores, looks up the first
+ * hole and discards the whole array.
+ */
+struct bench_op {
+	uint16_t base;
+	uint8_t num;
+	uint64_t present;
+};
+
+struct bench_impl {
+	const char *name;
+	void (*store)(struct ol_txrx_pdev_t *pdev, struct ol_txrx_peer_t *peer,
+		      unsigned int tid, unsigned int idx,
+		      qdf_nbuf_t head_msdu, qdf_nbuf_t tail_msdu);
+	void (*release)(struct ol_txrx_vdev_t *vdev,
+			struct ol_txrx_peer_t *peer, unsigned int tid,
+			unsigned int idx_start, unsigned int idx_end);
+	void (*flush)(struct ol_txrx_vdev_t *vdev, struct ol_txrx_peer_t *peer,
+		      unsigned int tid, unsigned int idx_start,
+		      unsigned int idx_end, enum htt_rx_flush_action action);
+	void (*first_hole)(struct ol_txrx_peer_t *peer, unsigned int tid,
+			   unsigned int *idx_end);
+};
+
+static const struct bench_impl bench_impl[2] = {
+	{
+		.name = "bitmap",
+		.store = ol_rx_reorder_store,
+		.release = ol_rx_reorder_release,
+		.flush = ol_rx_reorder_flush,
+		.first_hole = ol_rx_reorder_first_hole,
+	},
+	{
+		.name = "linear",
+		.store = ol_rx_reorder_ref_store,
+		.release = ol_rx_reorder_ref_release,
+		.flush = ol_rx_reorder_ref_flush,
+		.first_hole = ol_rx_reorder_ref_first_hole,
+	},
+};
+
+/* sequence numbers delivered to rx_opt_proc by the current step */
+static struct {
+	uint16_t seq[BENCH_MAX_WIN * BENCH_MAX_MSDUS];
+	unsigned int num;
+} bench_sink;
+
+static struct ol_txrx_pdev_t bench_pdev;
+static struct ol_txrx_vdev_t bench_vdev = { .pdev = &bench_pdev };
+static struct ol_txrx_peer_t bench_peer = { .vdev = &bench_vdev };
+static struct qdf_nbuf bench_nbuf[BENCH_MAX_WIN][BENCH_MAX_MSDUS];
+
+static uint32_t bench_rand(uint32_t *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return (*seed >> 16) & 0x7fff;
+}
+
+static unsigned int bench_msdus(uint16_t seq_num)
+{
+	return seq_num % 3 ? 1 : 2;
+}
+
+static void bench_rx_opt_proc(struct ol_txrx_vdev_t *vdev,
+			      struct ol_txrx_peer_t *peer,
+			      unsigned int tid, qdf_nbuf_t msdu_list)
+{
+	for (; msdu_list; msdu_list = qdf_nbuf_next(msdu_list)) {
+		if (bench_sink.num < BENCH_MAX_WIN * BENCH_MAX_MSDUS)
+			bench_sink.seq[bench_sink.num] = msdu_list->seq_num;
+		bench_sink.num++;
+	}
+}
+
+/**
+ * bench_gen() - generate the steps of a pattern
+ * @op: returns the steps
+ * @num_ops: number of steps
+ * @pattern: pattern to generate
+ * @win_sz: block ack window size
+ * @seed: random seed
+ *
+ * Return: number of MPDUs stored over all steps
+ */
+static unsigned long bench_gen(struct bench_op *op, unsigned int num_ops,
+			       enum bench_pattern pattern, unsigned int win_sz,
+			       uint32_t seed)
+{
+	/* per mille of the slots that are stored */
+	static const unsigned int density[BENCH_NUM_PATTERNS] = {
+		1000, 900, 50, 500
+	};
+	unsigned long mpdus = 0;
+	uint16_t base = bench_rand(&seed) % IEEE80211_SEQ_MAX;
+	unsigned int i, n;
+
+	for (i = 0; i < num_ops; i++) {
+		if (pattern == BENCH_DENSE || pattern == BENCH_LOSS)
+			op[i].num = 1 + bench_rand(&seed) % win_sz;
+		else
+			op[i].num = win_sz;
+		op[i].base = base;
+		op[i].present = 0;
+		for (n = 0; n < op[i].num; n++) {
+			if (bench_rand(&seed) % 1000 < density[pattern])
+				op[i].present |= 1ULL << n;
+		}
+		/* the firmware releases from a present MPDU */
+		if (pattern == BENCH_DENSE || pattern == BENCH_LOSS)
+			op[i].present |= 1;
+		mpdus += __builtin_popcountll(op[i].present);
+		base = (base + op[i].num) % IEEE80211_SEQ_MAX;
+	}
+
+	return mpdus;
+}
+
+static void bench_store(const struct bench_impl *impl,
+			const struct bench_op *op)
+{
+	unsigned int win_sz_mask =
+		bench_peer.tids_rx_reorder[BENCH_TID].win_sz_mask;
+	uint64_t present = op->present;
+
+	while (present) {
+		uint16_t seq_num = (op->base + __builtin_ctzll(present)) %
+				   IEEE80211_SEQ_MAX;
+		struct qdf_nbuf *msdu = bench_nbuf[seq_num & win_sz_mask];
+		unsigned int last = bench_msdus(seq_num) - 1;
+
+		present &= present - 1;
+		msdu[0].seq_num = msdu[last].seq_num = seq_num;
+		msdu[0].next = last ? &msdu[last] : NULL;
+		msdu[last].next = NULL;
+		impl->store(&bench_pdev, &bench_peer, BENCH_TID, seq_num,
+			    &msdu[0], &msdu[last]);
+	}
+}
+
+/* Run one step. Return: first hole for BENCH_HOLE, 0 otherwise */
+static unsigned int bench_step(const struct bench_impl *impl,
+			       enum bench_pattern pattern,
+			       const struct bench_op *op)
+{
+	unsigned int idx_end = 0;
+
+	bench_store(impl, op);
+	switch (pattern) {
+	case BENCH_DENSE:
+	case BENCH_LOSS:
+		impl->release(&bench_vdev, &bench_peer, BENCH_TID, op->base,
+			      op->base + op->num);
+		break;
+	case BENCH_SPARSE:
+		impl->flush(&bench_vdev, &bench_peer, BENCH_TID, op->base,
+			    0xffff, htt_rx_flush_release);
+		break;
+	default:
+		impl->first_hole(&bench_peer, BENCH_TID, &idx_end);
+		impl->flush(&bench_vdev, &bench_peer, BENCH_TID, 0, 0xffff,
+			    htt_rx_flush_discard);
+		break;
+	}
+
+	return idx_end;
+}
+
+/* Check what a step delivered and freed against what it stored */
+static int bench_check_step(const struct bench_impl *impl,
+			    enum bench_pattern pattern,
+			    const struct bench_op *op, unsigned int i,
+			    unsigned long freed)
+{
+	uint64_t present = op->present;
+	unsigned int n = 0, msdus;
+
+	while (present) {
+		uint16_t seq_num = (op->base + __builtin_ctzll(present)) %
+				   IEEE80211_SEQ_MAX;
+
+		present &= present - 1;
+		for (msdus = bench_msdus(seq_num); msdus; msdus--, n++) {
+			if (pattern == BENCH_HOLE)
+				continue;
+			if (n >= bench_sink.num || bench_sink.seq[n] != seq_num) {
+				fprintf(stderr,
+					"%s %s step %u: MSDU %u is seq %d, expected %u\n",
+					impl->name, bench_pattern_name[pattern],
+					i, n,
+					n < bench_sink.num ?
+					bench_sink.seq[n] : -1, seq_num);
+				return 1;
+			}
+		}
+	}
+
+	if (pattern == BENCH_HOLE ? freed != n || bench_sink.num :
+	    bench_sink.num != n || freed) {
+		fprintf(stderr,
+			"%s %s step %u: %u MSDUs delivered, %lu freed, %u stored\n",
+			impl->name, bench_pattern_name[pattern], i,
+			bench_sink.num, freed, n);
+		return 1;
+	}
+	if (bench_peer.tids_rx_reorder[BENCH_TID].occupied) {
+		fprintf(stderr, "%s %s step %u: occupancy 0x%llx left over\n",
+			impl->name, bench_pattern_name[pattern], i,
+			(unsigned long long)
+			bench_peer.tids_rx_reorder[BENCH_TID].occupied);
+		return 1;
+	}
+
+	return 0;
+}
+
+/**
+ * bench_check() - check both implementations step by step
+ * @pattern: pattern of the steps
+ * @op: the steps
+ * @num_ops: number of steps
+ *
+ * Return: number of failed steps
+ */
+static unsigned int bench_check(enum bench_pattern pattern,
+				const struct bench_op *op,
+				unsigned int num_ops)
+{
+	unsigned int i, j, hole[2], failed = 0;
+	unsigned long freed;
+
+	for (i = 0; i < num_ops; i++) {
+		for (j = 0; j < 2; j++) {
+			bench_sink.num = 0;
+			freed = ol_txrx_shim_freed;
+			hole[j] = bench_step(&bench_impl[j], pattern, &op[i]);
+			failed += bench_check_step(&bench_impl[j], pattern,
+						   &op[i], i,
+						   ol_txrx_shim_freed - freed);
+		}
+		if (hole[0] != hole[1]) {
+			fprintf(stderr,
+				"%s step %u: first hole %u, reference %u\n",
+				bench_pattern_name[pattern], i, hole[0],
+				hole[1]);
+			failed++;
+		}
+	}
+
+	return failed;
+}
+
+/* Check ol_rx_pn_ind_handler() with one MPDU failing the PN check */
+static unsigned int bench_check_pn_ind(const struct bench_op *op,
+				       unsigned int num_ops)
+{
+	unsigned int win_sz_mask =
+		bench_peer.tids_rx_reorder[BENCH_TID].win_sz_mask;
+	unsigned int i, n, failed = 0;
+	unsigned long freed, expected;
+	uint8_t pn_ie;
+
+	for (i = 0; i < num_ops; i++) {
+		uint16_t seq_num = op[i].base;
+
+		bench_store(&bench_impl[0], &op[i]);
+		bench_sink.num = 0;
+		freed = ol_txrx_shim_freed;
+		pn_ie = seq_num & win_sz_mask;
+		ol_rx_pn_ind_handler(&bench_pdev, 0, BENCH_TID, op[i].base,
+				     op[i].base + op[i].num, 1, &pn_ie);
+
+		expected = 0;
+		for (n = 0; n < op[i].num; n++) {
+			if (op[i].present & 1ULL << n)
+				expected += bench_msdus((seq_num + n) %
+							IEEE80211_SEQ_MAX);
+		}
+		expected -= bench_msdus(seq_num);
+		if (bench_sink.num != expected ||
+		    ol_txrx_shim_freed - freed != bench_msdus(seq_num) ||
+		    bench_peer.tids_rx_reorder[BENCH_TID].occupied) {
+			fprintf(stderr,
+				"pn_ind step %u: %u MSDUs delivered, %lu expected\n",
+				i, bench_sink.num, expected);
+			failed++;
+		}
+	}
+
+	return failed;
+}
+
+static double bench_now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static double bench_time(const struct bench_impl *impl,
+			 enum bench_pattern pattern,
+			 const struct bench_op *op, unsigned int num_ops)
+{
+	double start;
+	unsigned int i;
+
+	start = bench_now_ns();
+	for (i = 0; i < num_ops; i++)
+		bench_step(impl, pattern, &op[i]);
+
+	return bench_now_ns() - start;
+}
+
+static void bench_usage(const char *prog)
+{
+	fprintf(stderr,
+		"usage: %s [options]\n"
+		"  -w win     block ack window size, 1 to %u (default 64)\n"
+		"  -n ops     steps per pattern (default 10000)\n"
+		"  -r rounds  timed runs of each implementation per pattern, the\n"
+		"             fastest is reported (default 20)\n"
+		"  -s seed    random seed (default 1)\n"
+		"  -c         check only, skip the timing\n",
+		prog, BENCH_MAX_WIN);
+}
+
+int main(int argc, char **argv)
+{
+	unsigned int win_sz = 64, num_ops = 10000, rounds = 20;
+	unsigned int failed = 0, pattern, j;
+	unsigned long mpdus[BENCH_NUM_PATTERNS];
+	struct bench_op *op[BENCH_NUM_PATTERNS];
+	uint32_t seed = 1;
+	bool check_only = false;
+	int opt;
+
+	while ((opt = getopt(argc, argv, "w:n:r:s:ch")) != -1) {
+		switch (opt) {
+		case 'w':
+			win_sz = strtoul(optarg, NULL, 0);
+			if (!win_sz || win_sz > BENCH_MAX_WIN) {
+				fprintf(stderr, "bad window size %s\n",
+					optarg);
+				return 1;
+			}
+			break;
+		case 'n':
+			num_ops = strtoul(optarg, NULL, 0);
+			break;
+		case 'r':
+			rounds = strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			seed = strtoul(optarg, NULL, 0);
+			break;
+		case 'c':
+			check_only = true;
+			break;
+		default:
+			bench_usage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+	if (!num_ops)
+		num_ops = 1;
+
+	bench_pdev.rx_pn[htt_sec_type_none].len = 0;
+	bench_peer.rx_opt_proc = bench_rx_opt_proc;
+	ol_txrx_shim_peer = &bench_peer;
+	ol_rx_reorder_init(&bench_peer.tids_rx_reorder[BENCH_TID], BENCH_TID);
+	ol_rx_addba_handler(&bench_pdev, 0, BENCH_TID, win_sz, 0, 0);
+
+	/* the slots are reused once the window moves on */
+	win_sz = bench_peer.tids_rx_reorder[BENCH_TID].win_sz_mask + 1;
+	printf("window %u slots, %u steps per pattern\n", win_sz, num_ops);
+
+	for (pattern = 0; pattern < BENCH_NUM_PATTERNS; pattern++) {
+		op[pattern] = calloc(num_ops, sizeof(*op[pattern]));
+		if (!op[pattern]) {
+			fprintf(stderr, "out of memory\n");
+			return 1;
+		}
+		mpdus[pattern] = bench_gen(op[pattern], num_ops, pattern,
+					   win_sz, seed + pattern);
+		failed += bench_check(pattern, op[pattern], num_ops);
+	}
+	failed += bench_check_pn_ind(op[BENCH_LOSS], num_ops);
+	if (failed) {
+		fprintf(stderr, "%u steps failed\n", failed);
+		return 1;
+	}
+	printf("check passed\n");
+	if (check_only)
+		return 0;
+
+	printf("%-8s %-8s %10s %10s %8s\n", "pattern", "impl", "ns/step",
+	       "ns/MPDU", "speedup");
+	for (pattern = 0; pattern < BENCH_NUM_PATTERNS; pattern++) {
+		double ns[2] = { 0 }, t;
+		unsigned int r;
+
+		/* alternate the two so that they see the same conditions */
+		for (r = 0; r < rounds; r++) {
+			for (j = 0; j < 2; j++) {
+				t = bench_time(&bench_impl[j], pattern,
+					       op[pattern], num_ops);
+				if (!r || t < ns[j])
+					ns[j] = t;
+			}
+		}
+		for (j = 0; j < 2; j++) {
+			printf("%-8s %-8s %10.1f %10.2f",
+			       bench_pattern_name[pattern], bench_impl[j].name,
+			       ns[j] / num_ops,
+			       mpdus[pattern] ? ns[j] / mpdus[pattern] : 0);
+			if (j)
+				printf(" %7.2fx", ns[1] / ns[0]);
+			printf("\n");
+		}
+	}
+
+
+	for (pattern = 0; pattern < BENCH_NUM_PATTERNS; pattern++)
+		free(op[pattern]);
+
+	return 0;
+}
@@ -0,0 +1,33 @@
+/* SPDX-License-Identifier: ISC */
+
+#ifndef _OL_RX_REORDER_BENCH_H_
+#define _OL_RX_REORDER_BENCH_H_
+
+#include <ol_txrx_types.h>
+
+/*
+ * Reference implementation: the slot by slot walks the driver used before
+ * the occupancy bitmap, in ol_rx_reorder_ref.c. They ignore
+ * ol_rx_reorder_t.occupied.
+ */
+
+void ol_rx_reorder_ref_store(struct ol_txrx_pdev_t *pdev,
+			     struct ol_txrx_peer_t *peer,
+			     unsigned int tid, unsigned int idx,
+			     qdf_nbuf_t head_msdu, qdf_nbuf_t tail_msdu);
+
+void ol_rx_reorder_ref_release(struct ol_txrx_vdev_t *vdev,
+			       struct ol_txrx_peer_t *peer,
+			       unsigned int tid, unsigned int idx_start,
+			       unsigned int idx_end);
+
+void ol_rx_reorder_ref_flush(struct ol_txrx_vdev_t *vdev,
+			     struct ol_txrx_peer_t *peer,
+			     unsigned int tid, unsigned int idx_start,
+			     unsigned int idx_end,
+			     enum htt_rx_flush_action action);
+
+void ol_rx_reorder_ref_first_hole(struct ol_txrx_peer_t *peer,
+				  unsigned int tid, unsigned int *idx_end);
+
+#endif /* _OL_RX_REORDER_BENCH_H_ */
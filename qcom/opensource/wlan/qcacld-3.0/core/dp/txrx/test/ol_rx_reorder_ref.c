@@ -0,0 +1,153 @@
+/* SPDX-License-Identifier: ISC */
+
+/*
+ * Reference rx reorder release: ol_rx_reorder_store/release/flush/first_hole
+ * as they were before the occupancy bitmap, which visit every slot of the
+ * range. They keep the last_seq update and the defrag waitlist removal
+ * the driver does around the walk, so that only the walks differ. The rx
+ * reorder timeout and mpdu count are compiled out for both.
+ */
+
+#include "ol_rx_reorder_bench.h"
+
+static void ol_rx_reorder_ref_last_seq(struct ol_txrx_vdev_t *vdev,
+				       struct ol_txrx_peer_t *peer,
+				       unsigned int tid, qdf_nbuf_t head_msdu)
+{
+	htt_pdev_handle htt_pdev = vdev->pdev->htt_pdev;
+
+	peer->tids_last_seq[tid] = htt_rx_mpdu_desc_seq_num(
+		htt_pdev, htt_rx_msdu_desc_retrieve(htt_pdev, head_msdu),
+		false);
+}
+
+void ol_rx_reorder_ref_store(struct ol_txrx_pdev_t *pdev,
+			     struct ol_txrx_peer_t *peer,
+			     unsigned int tid, unsigned int idx,
+			     qdf_nbuf_t head_msdu, qdf_nbuf_t tail_msdu)
+{
+	struct ol_rx_reorder_array_elem_t *rx_reorder_array_elem;
+
+	idx &= peer->tids_rx_reorder[tid].win_sz_mask;
+	rx_reorder_array_elem = &peer->tids_rx_reorder[tid].array[idx];
+	if (rx_reorder_array_elem->head)
+		qdf_nbuf_set_next(rx_reorder_array_elem->tail, head_msdu);
+	else
+		rx_reorder_array_elem->head = head_msdu;
+	rx_reorder_array_elem->tail = tail_msdu;
+}
+
+void ol_rx_reorder_ref_release(struct ol_txrx_vdev_t *vdev,
+			       struct ol_txrx_peer_t *peer,
+			       unsigned int tid, unsigned int idx_start,
+			       unsigned int idx_end)
+{
+	unsigned int idx;
+	unsigned int win_sz_mask;
+	struct ol_rx_reorder_array_elem_t *rx_reorder_array_elem;
+	qdf_nbuf_t head_msdu;
+	qdf_nbuf_t tail_msdu;
+
+	win_sz_mask = peer->tids_rx_reorder[tid].win_sz_mask;
+	idx_start &= win_sz_mask;
+	idx_end &= win_sz_mask;
+	rx_reorder_array_elem = &peer->tids_rx_reorder[tid].array[idx_start];
+
+	head_msdu = rx_reorder_array_elem->head;
+	tail_msdu = rx_reorder_array_elem->tail;
+	rx_reorder_array_elem->head = rx_reorder_array_elem->tail = NULL;
+
+	idx = (idx_start + 1) & win_sz_mask;
+	while (idx != idx_end) {
+		rx_reorder_array_elem = &peer->tids_rx_reorder[tid].array[idx];
+		if (rx_reorder_array_elem->head) {
+			if (tail_msdu)
+				qdf_nbuf_set_next(tail_msdu,
+						  rx_reorder_array_elem->head);
+			tail_msdu = rx_reorder_array_elem->tail;
+		}
+		rx_reorder_array_elem->head = rx_reorder_array_elem->tail =
+						      NULL;
+		idx = (idx + 1) & win_sz_mask;
+	}
+	if (head_msdu) {
+		ol_rx_reorder_ref_last_seq(vdev, peer, tid, head_msdu);
+		qdf_nbuf_set_next(tail_msdu, NULL);
+		peer->rx_opt_proc(vdev, peer, tid, head_msdu);
+	}
+}
+
+void ol_rx_reorder_ref_flush(struct ol_txrx_vdev_t *vdev,
+			     struct ol_txrx_peer_t *peer,
+			     unsigned int tid, unsigned int idx_start,
+			     unsigned int idx_end,
+			     enum htt_rx_flush_action action)
+{
+	unsigned int win_sz_mask;
+	struct ol_rx_reorder_array_elem_t *rx_reorder_array_elem;
+	qdf_nbuf_t head_msdu = NULL;
+	qdf_nbuf_t tail_msdu = NULL;
+
+	win_sz_mask = peer->tids_rx_reorder[tid].win_sz_mask;
+	if (idx_end == 0xffff)
+		idx_end = idx_start;
+	idx_start &= win_sz_mask;
+	idx_end &= win_sz_mask;
+
+	do {
+		rx_reorder_array_elem =
+			&peer->tids_rx_reorder[tid].array[idx_start];
+		idx_start = (idx_start + 1) & win_sz_mask;
+
+		if (rx_reorder_array_elem->head) {
+			if (!head_msdu)
+				head_msdu = rx_reorder_array_elem->head;
+			else
+				qdf_nbuf_set_next(tail_msdu,
+						  rx_reorder_array_elem->head);
+			tail_msdu = rx_reorder_array_elem->tail;
+			rx_reorder_array_elem->head =
+				rx_reorder_array_elem->tail = NULL;
+		}
+	} while (idx_start != idx_end);
+
+	ol_rx_defrag_waitlist_remove(peer, tid);
+
+	if (head_msdu) {
+		ol_rx_reorder_ref_last_seq(vdev, peer, tid, head_msdu);
+		qdf_nbuf_set_next(tail_msdu, NULL);
+		if (action == htt_rx_flush_release) {
+			peer->rx_opt_proc(vdev, peer, tid, head_msdu);
+		} else {
+			do {
+				qdf_nbuf_t next;
+
+				next = qdf_nbuf_next(head_msdu);
+				htt_rx_desc_frame_free(vdev->pdev->htt_pdev,
+						       head_msdu);
+				head_msdu = next;
+			} while (head_msdu);
+		}
+	}
+}
+
+void ol_rx_reorder_ref_first_hole(struct ol_txrx_peer_t *peer,
+				  unsigned int tid, unsigned int *idx_end)
+{
+	unsigned int win_sz_mask;
+	unsigned int idx_start = 0, tmp_idx;
+
+	win_sz_mask = peer->tids_rx_reorder[tid].win_sz_mask;
+
+	tmp_idx = 1 & win_sz_mask;
+	/* bypass the initial hole */
+	while (tmp_idx != idx_start &&
+	       !peer->tids_rx_reorder[tid].array[tmp_idx].head)
+		tmp_idx = (tmp_idx + 1) & win_sz_mask;
+	/* bypass the present frames following the initial hole */
+	while (tmp_idx != idx_start &&
+	       peer->tids_rx_reorder[tid].array[tmp_idx].head)
+		tmp_idx = (tmp_idx + 1) & win_sz_mask;
+
+	*idx_end = tmp_idx;
+}
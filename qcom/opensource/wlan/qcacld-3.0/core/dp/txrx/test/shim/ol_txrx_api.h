@@ -0,0 +1,9 @@
+/* SPDX-License-Identifier: ISC */
+/* Host build shim: see ol_txrx_shim.h */
+
+#ifndef _OL_TXRX_SHIM_OL_TXRX_API_H_
+#define _OL_TXRX_SHIM_OL_TXRX_API_H_
+
+#include "ol_txrx_shim.h"
+
+#endif /* _OL_TXRX_SHIM_OL_TXRX_API_H_ */
@@ -0,0 +1,91 @@
+/* SPDX-License-Identifier: ISC */
+
+/*
+ * Host build shim: stand-ins for the HTT, control path and defrag functions
+ * ol_rx_reorder.c calls.
+ */
+
+#include "ol_txrx_shim.h"
+
+struct ol_txrx_peer_t *ol_txrx_shim_peer;
+unsigned long ol_txrx_shim_freed;
+
+uint16_t htt_rx_mpdu_desc_seq_num(htt_pdev_handle pdev, void *mpdu_desc,
+				  bool update_seq_num)
+{
+	return ((qdf_nbuf_t)mpdu_desc)->seq_num;
+}
+
+void *htt_rx_msdu_desc_retrieve(htt_pdev_handle pdev, qdf_nbuf_t msdu)
+{
+	return msdu;
+}
+
+void htt_rx_desc_frame_free(htt_pdev_handle htt_pdev, qdf_nbuf_t msdu)
+{
+	ol_txrx_shim_freed++;
+}
+
+uint16_t htt_rx_mpdu_desc_tid(htt_pdev_handle pdev, void *mpdu_desc)
+{
+	return 0;
+}
+
+bool htt_rx_mpdu_desc_retry(htt_pdev_handle pdev, void *mpdu_desc)
+{
+	return false;
+}
+
+uint32_t htt_rx_mpdu_desc_tsf32(htt_pdev_handle pdev, void *mpdu_desc)
+{
+	return 0;
+}
+
+void htt_rx_mpdu_desc_pn(htt_pdev_handle pdev, void *mpdu_desc,
+			 union htt_rx_pn_t *pn, int pn_len_bits)
+{
+}
+
+int htt_rx_msdu_is_frag(htt_pdev_handle pdev, void *msdu_desc)
+{
+	return 0;
+}
+
+int htt_rx_msdu_is_wlan_mcast(htt_pdev_handle pdev, void *msdu_desc)
+{
+	return 0;
+}
+
+struct ol_txrx_peer_t *ol_txrx_peer_find_by_id(struct ol_txrx_pdev_t *pdev,
+					       uint16_t peer_id)
+{
+	return ol_txrx_shim_peer;
+}
+
+bool ol_txrx_get_ocb_peer(struct ol_txrx_pdev_t *pdev,
+			  struct ol_txrx_peer_t **peer)
+{
+	return false;
+}
+
+void ol_ctrl_rx_addba_complete(ol_pdev_handle pdev, uint8_t *peer_mac_addr,
+			       int tid, int failed)
+{
+}
+
+void ol_rx_err(ol_pdev_handle pdev, uint8_t vdev_id, uint8_t *peer_mac_addr,
+	       int tid, uint32_t tsf32, enum ol_rx_err_type err_type,
+	       qdf_nbuf_t rx_frame, uint64_t *pn, uint8_t key_id)
+{
+}
+
+void ol_rx_defrag_waitlist_remove(struct ol_txrx_peer_t *peer,
+				  unsigned int tid)
+{
+}
+
+void ol_rx_reorder_flush_frag(htt_pdev_handle htt_pdev,
+			      struct ol_txrx_peer_t *peer,
+			      unsigned int tid, uint16_t seq_num)
+{
+}
@@ -0,0 +1,255 @@
+/* SPDX-License-Identifier: ISC */
+
+/*
+ * Host build shim: the qdf, HTT and txrx definitions ol_rx_reorder.c uses.
+ *
+ * The other headers in this directory shadow the driver headers of the same
+ * name and only include this one. The txrx structures keep just the fields
+ * the rx reorder code touches, under their driver names.
+ */
+
+#ifndef _OL_TXRX_SHIM_H_
+#define _OL_TXRX_SHIM_H_
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <sys/queue.h>
+
+/* qdf */
+
+#define qdf_likely(x) __builtin_expect(!!(x), 1)
+#define qdf_unlikely(x) __builtin_expect(!!(x), 0)
+
+/* linux/bitops.h, which the qdf headers include on the target */
+static inline unsigned long __ffs64(uint64_t word)
+{
+	return __builtin_ctzll(word);
+}
+
+/**
+ * struct qdf_nbuf - rx netbuf
+ * @next: next netbuf of the list
+ * @seq_num: 802.11 sequence number of the MPDU, read back through
+ *	htt_rx_mpdu_desc_seq_num(). The netbuf doubles as its rx descriptor.
+ */
+struct qdf_nbuf {
+	struct qdf_nbuf *next;
+	uint16_t seq_num;
+};
+
+typedef struct qdf_nbuf *qdf_nbuf_t;
+
+static inline qdf_nbuf_t qdf_nbuf_next(qdf_nbuf_t buf)
+{
+	return buf->next;
+}
+
+static inline void qdf_nbuf_set_next(qdf_nbuf_t buf, qdf_nbuf_t next)
+{
+	buf->next = next;
+}
+
+static inline void *qdf_mem_malloc(size_t size)
+{
+	return calloc(1, size);
+}
+
+static inline void qdf_mem_free(void *ptr)
+{
+	free(ptr);
+}
+
+typedef struct {
+	int counter;
+} qdf_atomic_t;
+
+static inline void qdf_atomic_set(qdf_atomic_t *v, int i)
+{
+	v->counter = i;
+}
+
+static inline unsigned long qdf_system_ticks(void)
+{
+	return 0;
+}
+
+static inline uint32_t qdf_system_ticks_to_msecs(unsigned long ticks)
+{
+	return ticks;
+}
+
+#define WARN_ON(condition) ((void)(condition))
+
+#define QDF_MAC_ADDR_FMT "%02x:%02x:%02x:%02x:%02x:%02x"
+#define QDF_MAC_ADDR_REF(a) (a)[0], (a)[1], (a)[2], (a)[3], (a)[4], (a)[5]
+
+static inline void ol_txrx_shim_log(const char *fmt, ...)
+{
+}
+
+#define ol_txrx_err ol_txrx_shim_log
+#define ol_txrx_warn ol_txrx_shim_log
+#define ol_txrx_info ol_txrx_shim_log
+#define ol_txrx_dbg ol_txrx_shim_log
+
+/* txrx */
+
+#define TXRX_ASSERT1(condition) assert(condition)
+#define TXRX_ASSERT2(condition) assert(condition)
+#define TXRX_STATS_INCR(pdev, field) /* no-op */
+
+#define OL_TXRX_NUM_EXT_TIDS 19
+#define OL_RX_MCAST_TID 18
+#define IEEE80211_SEQ_MAX 4096
+#define INVALID_REORDER_INDEX 0xFFFF
+#define TXRX_PN_CHECK_FAILURE_PRINT_PERIOD_MS 1000
+
+enum htt_rx_status {
+	htt_rx_status_unknown = 0x0,
+	htt_rx_status_ok,
+	htt_rx_status_err_fcs,
+	htt_rx_status_err_dup,
+	htt_rx_status_err_replay,
+	htt_rx_status_err_inv_peer,
+};
+
+enum htt_rx_flush_action {
+	htt_rx_flush_release,
+	htt_rx_flush_discard,
+};
+
+enum htt_sec_type {
+	htt_sec_type_none,
+	htt_num_sec_types = 8,
+};
+
+enum ol_rx_err_type {
+	OL_RX_ERR_PN = 2,
+};
+
+enum {
+	txrx_sec_mcast = 0,
+	txrx_sec_ucast
+};
+
+union htt_rx_pn_t {
+	uint64_t pn128[2];
+};
+
+struct htt_pdev_t;
+struct ol_pdev_t;
+typedef struct htt_pdev_t *htt_pdev_handle;
+typedef struct ol_pdev_t *ol_pdev_handle;
+
+struct ol_rx_reorder_array_elem_t {
+	qdf_nbuf_t head;
+	qdf_nbuf_t tail;
+};
+
+struct ol_rx_reorder_t {
+	uint8_t win_sz;
+	uint8_t win_sz_mask;
+	uint8_t num_mpdus;
+	struct ol_rx_reorder_array_elem_t *array;
+	uint64_t occupied;
+	/* base - single rx reorder element used for non-aggr cases */
+	struct ol_rx_reorder_array_elem_t base;
+	/* only used for defrag right now */
+	TAILQ_ENTRY(ol_rx_reorder_t) defrag_waitlist_elem;
+	uint32_t defrag_timeout_ms;
+	/* get back to parent ol_txrx_peer_t when ol_rx_reorder_t is in a
+	 * waitlist
+	 */
+	uint16_t tid;
+};
+
+struct ol_txrx_pdev_t {
+	htt_pdev_handle htt_pdev;
+	ol_pdev_handle ctrl_pdev;
+	struct {
+		int host_addba;
+	} cfg;
+	struct {
+		struct {
+			uint8_t dup_check;
+		} flags;
+	} rx;
+	struct {
+		int len;
+	} rx_pn[htt_num_sec_types];
+};
+
+typedef struct ol_txrx_pdev_t *ol_txrx_pdev_handle;
+
+struct ol_txrx_vdev_t {
+	struct ol_txrx_pdev_t *pdev;
+	uint8_t vdev_id;
+};
+
+struct ol_txrx_peer_t {
+	struct ol_txrx_vdev_t *vdev;
+	union {
+		uint8_t raw[6];
+	} mac_addr;
+	struct {
+		enum htt_sec_type sec_type;
+	} security[2];
+	qdf_atomic_t fw_pn_check;
+	struct ol_rx_reorder_t tids_rx_reorder[OL_TXRX_NUM_EXT_TIDS];
+	uint16_t tids_last_seq[OL_TXRX_NUM_EXT_TIDS];
+	uint16_t tids_next_rel_idx[OL_TXRX_NUM_EXT_TIDS];
+	uint16_t tids_mcast_last_seq[OL_TXRX_NUM_EXT_TIDS];
+	void (*rx_opt_proc)(struct ol_txrx_vdev_t *vdev,
+			    struct ol_txrx_peer_t *peer,
+			    unsigned int tid, qdf_nbuf_t msdu_list);
+};
+
+/* ol_txrx_htt_api.h */
+
+void ol_rx_addba_handler(ol_txrx_pdev_handle pdev, uint16_t peer_id,
+			 uint8_t tid, uint8_t win_sz, uint16_t start_seq_num,
+			 uint8_t failed);
+void ol_rx_pn_ind_handler(ol_txrx_pdev_handle pdev, uint16_t peer_id,
+			  uint8_t tid, uint16_t seq_num_start,
+			  uint16_t seq_num_end, uint8_t pn_ie_cnt,
+			  uint8_t *pn_ie);
+
+/* shim/ol_txrx_shim.c */
+
+/* the peer ol_txrx_peer_find_by_id() finds, for any peer ID */
+extern struct ol_txrx_peer_t *ol_txrx_shim_peer;
+/* netbufs freed through htt_rx_desc_frame_free() */
+extern unsigned long ol_txrx_shim_freed;
+
+uint16_t htt_rx_mpdu_desc_seq_num(htt_pdev_handle pdev, void *mpdu_desc,
+				  bool update_seq_num);
+void *htt_rx_msdu_desc_retrieve(htt_pdev_handle pdev, qdf_nbuf_t msdu);
+void htt_rx_desc_frame_free(htt_pdev_handle htt_pdev, qdf_nbuf_t msdu);
+uint16_t htt_rx_mpdu_desc_tid(htt_pdev_handle pdev, void *mpdu_desc);
+bool htt_rx_mpdu_desc_retry(htt_pdev_handle pdev, void *mpdu_desc);
+uint32_t htt_rx_mpdu_desc_tsf32(htt_pdev_handle pdev, void *mpdu_desc);
+void htt_rx_mpdu_desc_pn(htt_pdev_handle pdev, void *mpdu_desc,
+			 union htt_rx_pn_t *pn, int pn_len_bits);
+int htt_rx_msdu_is_frag(htt_pdev_handle pdev, void *msdu_desc);
+int htt_rx_msdu_is_wlan_mcast(htt_pdev_handle pdev, void *msdu_desc);
+
+struct ol_txrx_peer_t *ol_txrx_peer_find_by_id(struct ol_txrx_pdev_t *pdev,
+					       uint16_t peer_id);
+bool ol_txrx_get_ocb_peer(struct ol_txrx_pdev_t *pdev,
+			  struct ol_txrx_peer_t **peer);
+void ol_ctrl_rx_addba_complete(ol_pdev_handle pdev, uint8_t *peer_mac_addr,
+			       int tid, int failed);
+void ol_rx_err(ol_pdev_handle pdev, uint8_t vdev_id, uint8_t *peer_mac_addr,
+	       int tid, uint32_t tsf32, enum ol_rx_err_type err_type,
+	       qdf_nbuf_t rx_frame, uint64_t *pn, uint8_t key_id);
+
+void ol_rx_defrag_waitlist_remove(struct ol_txrx_peer_t *peer,
+				  unsigned int tid);
+void ol_rx_reorder_flush_frag(htt_pdev_handle htt_pdev,
+			      struct ol_txrx_peer_t *peer,
+			      unsigned int tid, uint16_t seq_num);
+
+#endif /* _OL_TXRX_SHIM_H_ */
@@ -38,6 +38,15 @@
 #define DP_RX_THREAD_YIELD_PKT_CNT 20000
 #endif
 
+/* queued nbuf_lists above which an idle rx_thread may steal a flow bucket */
+#define DP_RX_TM_FLOW_STEAL_QLEN 16
+
+/* time a flow bucket stays with its rx_thread before it can be stolen again */
+#define DP_RX_TM_FLOW_STEAL_HOLD_MS 100
+
+/* flow buckets a single nbuf_list is split into before it is enqueued */
+#define DP_RX_TM_FLOW_MAX_SPLIT 8
+
 #define DP_RX_TM_DEBUG 0
 #if DP_RX_TM_DEBUG
 /**
@@ -146,10 +155,10 @@ static void dp_rx_tm_thread_dump_stats(struct dp_rx_thread *rx_thread)
 				     "reo[%u]:%u ", reo_ring_num, temp);
 	}
 
-	if (!total_queued)
+	if (!total_queued && !rx_thread->stats.steal_in_batches)
 		return;
 
-	dp_info("thread:%u - qlen:%u queued:(total:%u %s) dequeued:%u stack:%u gro_flushes: %u gro_flushes_by_vdev_del: %u rx_flushes: %u max_len:%u invalid(peer:%u vdev:%u rx-handle:%u others:%u enq fail:%u)",
+	dp_info("thread:%u - qlen:%u queued:(total:%u %s) dequeued:%u stack:%u gro_flushes: %u gro_flushes_by_vdev_del: %u rx_flushes: %u max_len:%u invalid(peer:%u vdev:%u rx-handle:%u others:%u enq fail:%u) steal(in:%u/%u out:%u/%u buckets:%u)",
 		rx_thread->id,
 		qdf_nbuf_queue_head_qlen(&rx_thread->nbuf_queue),
 		total_queued,
@@ -164,13 +173,42 @@ static void dp_rx_tm_thread_dump_stats(struct dp_rx_thread *rx_thread)
 		rx_thread->stats.dropped_invalid_vdev,
 		rx_thread->stats.dropped_invalid_os_rx_handles,
 		rx_thread->stats.dropped_others,
-		rx_thread->stats.dropped_enq_fail);
+		rx_thread->stats.dropped_enq_fail,
+		rx_thread->stats.steal_in_batches,
+		rx_thread->stats.steal_in_nbufs,
+		rx_thread->stats.steal_out_batches,
+		rx_thread->stats.steal_out_nbufs,
+		rx_thread->stats.steal_buckets);
+}
+
+/**
+ * dp_rx_tm_dump_flow_owners() - display the rx_thread owning each flow bucket
+ * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread
+ *            infrastructure
+ *
+ * Returns: None
+ */
+static void dp_rx_tm_dump_flow_owners(struct dp_rx_tm_handle *rx_tm_hdl)
+{
+	char owner_string[DP_RX_TM_FLOW_BUCKETS + 1];
+	int i;
+
+	if (!rx_tm_hdl->flow_steer)
+		return;
+
+	for (i = 0; i < DP_RX_TM_FLOW_BUCKETS; i++)
+		owner_string[i] = '0' + rx_tm_hdl->bucket_owner[i];
+	owner_string[DP_RX_TM_FLOW_BUCKETS] = '\0';
+
+	dp_info("flow bucket owners: %s", owner_string);
 }
 
 QDF_STATUS dp_rx_tm_dump_stats(struct dp_rx_tm_handle *rx_tm_hdl)
 {
 	int i;
 
+	dp_rx_tm_dump_flow_owners(rx_tm_hdl);
+
 	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
 		if (!rx_tm_hdl->rx_thread[i])
 			continue;
@@ -430,6 +468,250 @@ static qdf_nbuf_t dp_rx_tm_thread_dequeue(struct dp_rx_thread *rx_thread)
 	return head;
 }
 
+/**
+ * dp_rx_thread_gro_flush() - flush GRO packets for the RX thread
+ * @rx_thread: rx_thread to be processed
+ * @gro_flush_code: flush code to differentiating flushes
+ *
+ * Return: void
+ */
+static void dp_rx_thread_gro_flush(struct dp_rx_thread *rx_thread,
+				   enum dp_rx_gro_flush_code gro_flush_code)
+{
+	dp_debug("flushing packets for thread %u", rx_thread->id);
+
+	local_bh_disable();
+	dp_rx_napi_gro_flush(&rx_thread->napi, gro_flush_code);
+	local_bh_enable();
+
+	rx_thread->stats.gro_flushes++;
+}
+
+/**
+ * dp_rx_thread_flow_steer() - check if packets are steered by flow hash
+ * @rx_thread: rx_thread pointer
+ *
+ * Returns: true if the rx_threads are selected by flow hash
+ */
+static inline bool dp_rx_thread_flow_steer(struct dp_rx_thread *rx_thread)
+{
+	struct dp_rx_tm_handle *rx_tm_hdl =
+		(struct dp_rx_tm_handle *)rx_thread->rtm_handle_cmn;
+
+	return rx_tm_hdl->flow_steer;
+}
+
+/**
+ * dp_rx_tm_flow_bucket() - get the flow hash bucket of a nbuf
+ * @nbuf: nbuf
+ *
+ * Returns: flow hash bucket
+ */
+static inline uint8_t dp_rx_tm_flow_bucket(qdf_nbuf_t nbuf)
+{
+	uint32_t flow_id = QDF_NBUF_CB_RX_FLOW_ID(nbuf);
+
+	/* No flow hash, keep the packet with the rest of its REO ring */
+	if (!flow_id)
+		flow_id = QDF_NBUF_CB_RX_CTX_ID(nbuf);
+
+	return flow_id & (DP_RX_TM_FLOW_BUCKETS - 1);
+}
+
+/**
+ * dp_rx_thread_flow_lock_pair() - take the flow_lock of two rx_threads
+ * @rx_thread_a: first rx_thread
+ * @rx_thread_b: second rx_thread
+ *
+ * The locks are always taken in rx_thread id order.
+ *
+ * Returns: None
+ */
+static void dp_rx_thread_flow_lock_pair(struct dp_rx_thread *rx_thread_a,
+					struct dp_rx_thread *rx_thread_b)
+{
+	if (rx_thread_a->id > rx_thread_b->id) {
+		qdf_spin_lock_bh(&rx_thread_b->flow_lock);
+		qdf_spin_lock_bh(&rx_thread_a->flow_lock);
+	} else {
+		qdf_spin_lock_bh(&rx_thread_a->flow_lock);
+		qdf_spin_lock_bh(&rx_thread_b->flow_lock);
+	}
+}
+
+/**
+ * dp_rx_thread_flow_unlock_pair() - release the flow_lock of two rx_threads
+ * @rx_thread_a: first rx_thread
+ * @rx_thread_b: second rx_thread
+ *
+ * Returns: None
+ */
+static void dp_rx_thread_flow_unlock_pair(struct dp_rx_thread *rx_thread_a,
+					  struct dp_rx_thread *rx_thread_b)
+{
+	qdf_spin_unlock_bh(&rx_thread_b->flow_lock);
+	qdf_spin_unlock_bh(&rx_thread_a->flow_lock);
+}
+
+/**
+ * dp_rx_thread_flow_find_idle() - find an idle rx_thread to steal work
+ * @rx_thread: busy rx_thread
+ *
+ * Returns: idle rx_thread with an empty queue, NULL if there is none
+ */
+static struct dp_rx_thread *
+dp_rx_thread_flow_find_idle(struct dp_rx_thread *rx_thread)
+{
+	struct dp_rx_tm_handle *rx_tm_hdl =
+		(struct dp_rx_tm_handle *)rx_thread->rtm_handle_cmn;
+	struct dp_rx_thread *idle_thread;
+	int i;
+
+	for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
+		idle_thread = rx_tm_hdl->rx_thread[i];
+		if (!idle_thread || idle_thread == rx_thread)
+			continue;
+		if (qdf_atomic_read(&idle_thread->idle) &&
+		    !qdf_nbuf_queue_head_qlen(&idle_thread->nbuf_queue))
+			return idle_thread;
+	}
+
+	return NULL;
+}
+
+/**
+ * dp_rx_thread_flow_pick() - pick the flow bucket an idle rx_thread steals
+ * @rx_thread: busy rx_thread, with its nbuf queue locked
+ *
+ * The bucket of the nbuf list @rx_thread last delivered is kept, as is a
+ * bucket which changed owner less than DP_RX_TM_FLOW_STEAL_HOLD_MS ago, so
+ * that a heavy flow does not bounce between threads. The queue must also
+ * hold another bucket, which stays with @rx_thread.
+ *
+ * Returns: flow bucket to steal, -1 if there is none
+ */
+static int dp_rx_thread_flow_pick(struct dp_rx_thread *rx_thread)
+{
+	struct dp_rx_tm_handle *rx_tm_hdl =
+		(struct dp_rx_tm_handle *)rx_thread->rtm_handle_cmn;
+	unsigned long hold = qdf_system_msecs_to_ticks(
+					DP_RX_TM_FLOW_STEAL_HOLD_MS);
+	unsigned long now = qdf_system_ticks();
+	qdf_nbuf_t nbuf_list, tmp_nbuf_list;
+	int first = -1, bucket = -1;
+	int cur;
+
+	QDF_NBUF_QUEUE_WALK_SAFE(&rx_thread->nbuf_queue, nbuf_list,
+				 tmp_nbuf_list) {
+		cur = dp_rx_tm_flow_bucket(nbuf_list);
+		if (first < 0)
+			first = cur;
+		if (bucket < 0 && cur != rx_thread->last_bucket &&
+		    now - rx_tm_hdl->bucket_moved[cur] >= hold)
+			bucket = cur;
+		if (bucket >= 0 && cur != first)
+			return bucket;
+	}
+
+	return -1;
+}
+
+/**
+ * dp_rx_thread_flow_steal() - let an idle rx_thread steal a flow bucket
+ * @rx_thread: rx_thread about to dequeue its next nbuf list
+ *
+ * If the queue of @rx_thread is backed up and another rx_thread is idle,
+ * a bucket picked by dp_rx_thread_flow_pick() is moved to the idle thread
+ * together with every nbuf list of that bucket still queued.
+ *
+ * This runs on @rx_thread between two nbuf lists, so no packet of the
+ * bucket is being delivered. Its GRO is flushed first, so none is held
+ * back in the napi either, and the idle thread cannot deliver newer
+ * packets of a flow ahead of older ones.
+ *
+ * Returns: None
+ */
+static void dp_rx_thread_flow_steal(struct dp_rx_thread *rx_thread)
+{
+	struct dp_rx_tm_handle *rx_tm_hdl =
+		(struct dp_rx_tm_handle *)rx_thread->rtm_handle_cmn;
+	struct dp_rx_thread *idle_thread;
+	qdf_nbuf_t nbuf_list, tmp_nbuf_list;
+	qdf_nbuf_t nbuf_list_head = NULL, nbuf_list_tail = NULL;
+	uint32_t num_list_elements;
+	int bucket;
+
+	if (qdf_nbuf_queue_head_qlen(&rx_thread->nbuf_queue) <
+	    DP_RX_TM_FLOW_STEAL_QLEN)
+		return;
+
+	idle_thread = dp_rx_thread_flow_find_idle(rx_thread);
+	if (!idle_thread)
+		return;
+
+	/* the queue only grows at its tail, so a pick stays valid */
+	qdf_nbuf_queue_head_lock(&rx_thread->nbuf_queue);
+	bucket = dp_rx_thread_flow_pick(rx_thread);
+	qdf_nbuf_queue_head_unlock(&rx_thread->nbuf_queue);
+	if (bucket < 0)
+		return;
+
+	dp_rx_thread_gro_flush(rx_thread, DP_RX_GRO_NORMAL_FLUSH);
+
+	dp_rx_thread_flow_lock_pair(rx_thread, idle_thread);
+
+	qdf_nbuf_queue_head_lock(&rx_thread->nbuf_queue);
+	bucket = dp_rx_thread_flow_pick(rx_thread);
+	QDF_NBUF_QUEUE_WALK_SAFE(&rx_thread->nbuf_queue, nbuf_list,
+				 tmp_nbuf_list) {
+		if (dp_rx_tm_flow_bucket(nbuf_list) != bucket)
+			continue;
+		qdf_nbuf_unlink_no_lock(nbuf_list, &rx_thread->nbuf_queue);
+		if (nbuf_list_tail)
+			qdf_nbuf_set_next(nbuf_list_tail, nbuf_list);
+		else
+			nbuf_list_head = nbuf_list;
+		nbuf_list_tail = nbuf_list;
+	}
+	qdf_nbuf_queue_head_unlock(&rx_thread->nbuf_queue);
+
+	if (bucket < 0) {
+		dp_rx_thread_flow_unlock_pair(rx_thread, idle_thread);
+		return;
+	}
+
+	rx_tm_hdl->bucket_owner[bucket] = idle_thread->id;
+	rx_tm_hdl->bucket_moved[bucket] = qdf_system_ticks();
+	qdf_nbuf_set_next(nbuf_list_tail, NULL);
+
+	while (nbuf_list_head) {
+		nbuf_list = nbuf_list_head;
+		nbuf_list_head = qdf_nbuf_next(nbuf_list);
+		qdf_nbuf_set_next(nbuf_list, NULL);
+
+		num_list_elements =
+			QDF_NBUF_CB_RX_NUM_ELEMENTS_IN_LIST(nbuf_list);
+		num_list_elements += qdf_nbuf_get_gso_segs(nbuf_list);
+		rx_thread->stats.steal_out_batches++;
+		rx_thread->stats.steal_out_nbufs += num_list_elements;
+		idle_thread->stats.steal_in_batches++;
+		idle_thread->stats.steal_in_nbufs += num_list_elements;
+
+		qdf_nbuf_queue_head_enqueue_tail(&idle_thread->nbuf_queue,
+						 nbuf_list);
+	}
+	rx_thread->stats.steal_buckets++;
+
+	dp_rx_thread_flow_unlock_pair(rx_thread, idle_thread);
+
+	dp_debug("thread %u: bucket %d stolen by thread %u", rx_thread->id,
+		 bucket, idle_thread->id);
+
+	qdf_atomic_set(&idle_thread->idle, 0);
+	qdf_set_bit(RX_POST_EVENT, &idle_thread->event_flag);
+	qdf_wake_up_interruptible(&idle_thread->wait_q);
+}
+
 #ifdef CONFIG_SLUB_DEBUG_ON
 /**
  * dp_rx_thread_should_yield() - check whether rx loop should yield
@@ -468,6 +750,7 @@ static int dp_rx_thread_process_nbufq(struct dp_rx_thread *rx_thread)
 	ol_txrx_soc_handle soc;
 	uint32_t num_list_elements = 0;
 	uint32_t iterates = 0;
+	bool flow_steer = dp_rx_thread_flow_steer(rx_thread);
 
 	struct dp_txrx_handle_cmn *txrx_handle_cmn;
 
@@ -484,6 +767,8 @@ static int dp_rx_thread_process_nbufq(struct dp_rx_thread *rx_thread)
 	dp_debug("enter: qlen  %u",
 		 qdf_nbuf_queue_head_qlen(&rx_thread->nbuf_queue));
 
+	if (flow_steer)
+		dp_rx_thread_flow_steal(rx_thread);
 	nbuf_list = dp_rx_tm_thread_dequeue(rx_thread);
 	while (nbuf_list) {
 		num_list_elements =
@@ -498,6 +783,8 @@ static int dp_rx_thread_process_nbufq(struct dp_rx_thread *rx_thread)
 						&osif_vdev);
 		dp_debug("rx_thread %pK sending packet %pK to stack",
 			 rx_thread, nbuf_list);
+		if (flow_steer)
+			rx_thread->last_bucket = dp_rx_tm_flow_bucket(nbuf_list);
 		if (!stack_fn || !osif_vdev ||
 		    QDF_STATUS_SUCCESS != stack_fn(osif_vdev, nbuf_list)) {
 			rx_thread->stats.dropped_invalid_os_rx_handles +=
@@ -512,6 +799,8 @@ static int dp_rx_thread_process_nbufq(struct dp_rx_thread *rx_thread)
 			rx_thread->stats.rx_nbufq_loop_yield++;
 			break;
 		}
+		if (flow_steer)
+			dp_rx_thread_flow_steal(rx_thread);
 		nbuf_list = dp_rx_tm_thread_dequeue(rx_thread);
 	}
 
@@ -521,25 +810,6 @@ static int dp_rx_thread_process_nbufq(struct dp_rx_thread *rx_thread)
 	return 0;
 }
 
-/**
- * dp_rx_thread_gro_flush() - flush GRO packets for the RX thread
- * @rx_thread: rx_thread to be processed
- * @gro_flush_code: flush code to differentiating flushes
- *
- * Return: void
- */
-static void dp_rx_thread_gro_flush(struct dp_rx_thread *rx_thread,
-				   enum dp_rx_gro_flush_code gro_flush_code)
-{
-	dp_debug("flushing packets for thread %u", rx_thread->id);
-
-	local_bh_disable();
-	dp_rx_napi_gro_flush(&rx_thread->napi, gro_flush_code);
-	local_bh_enable();
-
-	rx_thread->stats.gro_flushes++;
-}
-
 /**
  * dp_rx_should_flush() - Determines whether the RX thread should be flushed.
  * @rx_thread: rx_thread to be processed
@@ -591,6 +861,13 @@ static int dp_rx_thread_sub_loop(struct dp_rx_thread *rx_thread, bool *shutdown)
 		dp_rx_thread_process_nbufq(rx_thread);
 
 		gro_flush_code = dp_rx_should_flush(rx_thread);
+		/* The flush indication of a REO ring only reaches the thread
+		 * the ring maps to, but with flow steering the packets of the
+		 * ring can be in any thread. Flush whenever the queue drains.
+		 */
+		if (gro_flush_code == DP_RX_GRO_NOT_FLUSH &&
+		    dp_rx_thread_flow_steer(rx_thread))
+			gro_flush_code = DP_RX_GRO_NORMAL_FLUSH;
 		/* Only flush when gro_flush_code is either
 		 * DP_RX_GRO_NORMAL_FLUSH or DP_RX_GRO_LOW_TPUT_FLUSH
 		 */
@@ -652,6 +929,7 @@ static int dp_rx_thread_loop(void *arg)
 	while (!shutdown) {
 		/* This implements the execution model algorithm */
 		dp_debug("sleeping");
+		qdf_atomic_set(&rx_thread->idle, 1);
 		status =
 		    qdf_wait_queue_interruptible
 				(rx_thread->wait_q,
@@ -662,6 +940,7 @@ static int dp_rx_thread_loop(void *arg)
 				 qdf_atomic_test_bit(RX_VDEV_DEL_EVENT,
 						     &rx_thread->event_flag));
 		dp_debug("woken up");
+		qdf_atomic_set(&rx_thread->idle, 0);
 
 		if (status == -ERESTARTSYS) {
 			QDF_DEBUG_PANIC("wait_event_interruptible returned -ERESTARTSYS");
@@ -830,6 +1109,9 @@ static QDF_STATUS dp_rx_tm_thread_init(struct dp_rx_thread *rx_thread,
 	qdf_event_create(&rx_thread->shutdown_event);
 	qdf_event_create(&rx_thread->vdev_del_event);
 	qdf_atomic_init(&rx_thread->gro_flush_ind);
+	qdf_spinlock_create(&rx_thread->flow_lock);
+	qdf_atomic_init(&rx_thread->idle);
+	rx_thread->last_bucket = -1;
 	qdf_init_waitqueue_head(&rx_thread->wait_q);
 	qdf_scnprintf(thread_name, sizeof(thread_name), "dp_rx_thread_%u", id);
 	dp_info("%s %u", thread_name, id);
@@ -869,6 +1151,7 @@ static QDF_STATUS dp_rx_tm_thread_deinit(struct dp_rx_thread *rx_thread)
 	qdf_event_destroy(&rx_thread->resume_event);
 	qdf_event_destroy(&rx_thread->shutdown_event);
 	qdf_event_destroy(&rx_thread->vdev_del_event);
+	qdf_spinlock_destroy(&rx_thread->flow_lock);
 
 	if (cdp_cfg_get(dp_rx_tm_get_soc_handle(rx_thread->rtm_handle_cmn),
 			cfg_dp_gro_enable))
@@ -948,7 +1231,13 @@ QDF_STATUS dp_rx_tm_init(struct dp_rx_tm_handle *rx_tm_hdl,
 	rx_tm_hdl->num_dp_rx_threads = num_dp_rx_threads;
 	rx_tm_hdl->state = DP_RX_THREADS_INVALID;
 
-	dp_info("initializing %u threads", num_dp_rx_threads);
+	if (num_dp_rx_threads < 2)
+		rx_tm_hdl->flow_steer = false;
+	for (i = 0; i < DP_RX_TM_FLOW_BUCKETS; i++)
+		rx_tm_hdl->bucket_owner[i] = i % num_dp_rx_threads;
+
+	dp_info("initializing %u threads flow_steer %u", num_dp_rx_threads,
+		rx_tm_hdl->flow_steer);
 
 	/* allocate an array to contain the DP RX thread pointers */
 	rx_tm_hdl->rx_thread = qdf_mem_malloc(num_dp_rx_threads *
@@ -1371,11 +1660,109 @@ static uint8_t dp_rx_tm_select_thread(struct dp_rx_tm_handle *rx_tm_hdl,
 	return selected_rx_thread;
 }
 
+/**
+ * struct dp_rx_tm_flow_batch - packets of one flow bucket to be enqueued
+ * @head: first nbuf of the list
+ * @tail: last nbuf of the list
+ * @bucket: flow hash bucket of the packets
+ */
+struct dp_rx_tm_flow_batch {
+	qdf_nbuf_t head;
+	qdf_nbuf_t tail;
+	uint8_t bucket;
+};
+
+/**
+ * dp_rx_tm_flow_enqueue() - enqueue a flow batch into its owner rx_thread
+ * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread
+ *            infrastructure
+ * @batch: nbuf list of a single flow bucket
+ *
+ * The owner is checked again under its flow_lock, as the bucket may have
+ * been stolen by another thread in the meantime.
+ *
+ * Return: None
+ */
+static void dp_rx_tm_flow_enqueue(struct dp_rx_tm_handle *rx_tm_hdl,
+				  struct dp_rx_tm_flow_batch *batch)
+{
+	struct dp_rx_thread *rx_thread;
+	uint8_t owner;
+
+	while (true) {
+		owner = rx_tm_hdl->bucket_owner[batch->bucket];
+		rx_thread = rx_tm_hdl->rx_thread[owner];
+		qdf_spin_lock_bh(&rx_thread->flow_lock);
+		if (qdf_likely(rx_tm_hdl->bucket_owner[batch->bucket] == owner))
+			break;
+		qdf_spin_unlock_bh(&rx_thread->flow_lock);
+	}
+
+	dp_rx_tm_thread_enqueue(rx_thread, batch->head);
+	qdf_spin_unlock_bh(&rx_thread->flow_lock);
+}
+
+/**
+ * dp_rx_tm_flow_enqueue_pkt() - enqueue an nbuf list by flow hash
+ * @rx_tm_hdl: dp_rx_tm_handle containing the overall thread
+ *            infrastructure
+ * @nbuf_list: nbuf list reaped from a REO ring
+ *
+ * The list is split by flow bucket, keeping the order of the packets of
+ * each bucket, and every part is enqueued to the thread owning the bucket.
+ *
+ * Return: QDF_STATUS_SUCCESS
+ */
+static QDF_STATUS dp_rx_tm_flow_enqueue_pkt(struct dp_rx_tm_handle *rx_tm_hdl,
+					    qdf_nbuf_t nbuf_list)
+{
+	struct dp_rx_tm_flow_batch batch[DP_RX_TM_FLOW_MAX_SPLIT];
+	uint8_t num_batch = 0;
+	uint8_t bucket, i;
+	qdf_nbuf_t nbuf, next;
+
+	for (nbuf = nbuf_list; nbuf; nbuf = next) {
+		next = qdf_nbuf_next(nbuf);
+		bucket = dp_rx_tm_flow_bucket(nbuf);
+
+		for (i = 0; i < num_batch; i++) {
+			if (batch[i].bucket == bucket)
+				break;
+		}
+
+		if (i == num_batch) {
+			/* Order only matters within a bucket, so the batches
+			 * collected so far can go ahead of the rest.
+			 */
+			if (num_batch == DP_RX_TM_FLOW_MAX_SPLIT) {
+				for (i = 0; i < num_batch; i++)
+					dp_rx_tm_flow_enqueue(rx_tm_hdl,
+							      &batch[i]);
+				num_batch = 0;
+				i = 0;
+			}
+			batch[i].head = NULL;
+			batch[i].bucket = bucket;
+			num_batch++;
+		}
+
+		DP_RX_LIST_APPEND(batch[i].head, batch[i].tail, nbuf);
+	}
+
+	for (i = 0; i < num_batch; i++)
+		dp_rx_tm_flow_enqueue(rx_tm_hdl, &batch[i]);
+
+	return QDF_STATUS_SUCCESS;
+}
+
 QDF_STATUS dp_rx_tm_enqueue_pkt(struct dp_rx_tm_handle *rx_tm_hdl,
 				qdf_nbuf_t nbuf_list)
 {
 	uint8_t selected_thread_id;
 
+	if (rx_tm_hdl->flow_steer)
+		return dp_rx_tm_flow_enqueue_pkt(rx_tm_hdl, nbuf_list);
+
 	selected_thread_id =
 		dp_rx_tm_select_thread(rx_tm_hdl,
 				       QDF_NBUF_CB_RX_CTX_ID(nbuf_list));
@@ -1401,6 +1788,20 @@ struct napi_struct *dp_rx_tm_get_napi_context(struct dp_rx_tm_handle *rx_tm_hdl,
 					      uint8_t rx_ctx_id)
 {
 	uint8_t selected_thread_id;
+	int i;
+
+	/*
+	 * With flow steering the packets of a REO ring are spread over all
+	 * rx_threads, each delivering through its own napi.
+	 */
+	if (rx_tm_hdl->flow_steer) {
+		for (i = 0; i < rx_tm_hdl->num_dp_rx_threads; i++) {
+			if (rx_tm_hdl->rx_thread[i] &&
+			    rx_tm_hdl->rx_thread[i]->task ==
+			    qdf_get_current_task())
+				return &rx_tm_hdl->rx_thread[i]->napi;
+		}
+	}
 
 	selected_thread_id = dp_rx_tm_select_thread(rx_tm_hdl, rx_ctx_id);
 
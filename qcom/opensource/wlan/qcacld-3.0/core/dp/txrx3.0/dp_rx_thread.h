@@ -30,6 +30,8 @@
 #define DP_RX_TM_MAX_REO_RINGS WLAN_CFG_NUM_REO_DEST_RING
 /* Number of DP RX threads supported */
 #define DP_MAX_RX_THREADS WLAN_CFG_NUM_REO_DEST_RING
+/* Number of flow hash buckets used to steer packets to RX threads */
+#define DP_RX_TM_FLOW_BUCKETS 64
 
 /*
  * struct dp_rx_tm_handle_cmn - Opaque handle for rx_threads to store
@@ -55,6 +57,11 @@ struct dp_rx_tm_handle_cmn;
  * @dropped_others: packets dropped due to other reasons
  * @dropped_enq_fail: packets dropped due to pending queue full
  * @rx_nbufq_loop_yield: rx loop yield counter
+ * @steal_in_batches: nbuf_lists taken over from other threads
+ * @steal_in_nbufs: packets taken over from other threads
+ * @steal_out_batches: nbuf_lists handed over to idle threads
+ * @steal_out_nbufs: packets handed over to idle threads
+ * @steal_buckets: flow buckets handed over to idle threads
  */
 struct dp_rx_thread_stats {
 	unsigned int nbuf_queued[DP_RX_TM_MAX_REO_RINGS];
@@ -71,6 +78,11 @@ struct dp_rx_thread_stats {
 	unsigned int dropped_others;
 	unsigned int dropped_enq_fail;
 	unsigned int rx_nbufq_loop_yield;
+	unsigned int steal_in_batches;
+	unsigned int steal_in_nbufs;
+	unsigned int steal_out_batches;
+	unsigned int steal_out_nbufs;
+	unsigned int steal_buckets;
 };
 
 /**
@@ -107,6 +119,11 @@ enum dp_rx_refill_thread_state {
  *		    structures via APIs.
  * @napi: napi to deliver packet to stack via GRO
  * @netdev: dummy netdev to initialize the napi structure with
+ * @flow_lock: held while enqueueing into the thread in flow steering mode,
+ *	       and while moving a flow bucket to or from the thread
+ * @idle: thread is waiting for work and may take over flow buckets
+ * @last_bucket: flow bucket of the last nbuf list the thread delivered,
+ *		 -1 if none
  */
 struct dp_rx_thread {
 	uint8_t id;
@@ -125,6 +142,9 @@ struct dp_rx_thread {
 	struct napi_struct napi;
 	qdf_wait_queue_head_t wait_q;
 	struct net_device netdev;
+	qdf_spinlock_t flow_lock;
+	qdf_atomic_t idle;
+	int last_bucket;
 };
 
 /**
@@ -175,6 +195,11 @@ enum dp_rx_thread_state {
  * @state: state of the rx_threads. All of them should be in the same state.
  * @rx_thread: array of pointers of type struct dp_rx_thread
  * @allow_dropping: flag to indicate frame dropping is enabled
+ * @flow_steer: select the rx_thread by flow hash instead of by REO ring
+ * @bucket_owner: rx_thread id owning each flow hash bucket. Only changed
+ *		  with the flow_lock of both the old and the new owner held.
+ * @bucket_moved: time in ticks each flow hash bucket last changed owner,
+ *		  changed along with @bucket_owner
  */
 struct dp_rx_tm_handle {
 	uint8_t num_dp_rx_threads;
@@ -182,6 +207,9 @@ struct dp_rx_tm_handle {
 	enum dp_rx_thread_state state;
 	struct dp_rx_thread **rx_thread;
 	qdf_atomic_t allow_dropping;
+	bool flow_steer;
+	uint8_t bucket_owner[DP_RX_TM_FLOW_BUCKETS];
+	unsigned long bucket_moved[DP_RX_TM_FLOW_BUCKETS];
 };
 
 /**
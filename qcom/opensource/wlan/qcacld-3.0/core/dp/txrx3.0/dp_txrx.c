@@ -122,6 +122,8 @@ QDF_STATUS dp_txrx_init(ol_txrx_soc_handle soc, uint8_t pdev_id,
 	dp_info("%d RX threads in use", num_dp_rx_threads);
 
 	if (dp_ext_hdl->config.enable_rx_threads) {
+		dp_ext_hdl->rx_tm_hdl.flow_steer =
+			dp_ext_hdl->config.rx_thread_flow_steer;
 		qdf_status = dp_rx_tm_init(&dp_ext_hdl->rx_tm_hdl,
 					   num_dp_rx_threads);
 	}
@@ -29,9 +29,11 @@
 /**
  * struct dp_txrx_config - dp txrx configuration passed to dp txrx modules
  * @enable_dp_rx_threads: enable DP rx threads or not
+ * @rx_thread_flow_steer: select the DP rx thread by flow hash
  */
 struct dp_txrx_config {
 	bool enable_rx_threads;
+	bool rx_thread_flow_steer;
 };
 
 struct dp_txrx_handle_cmn;
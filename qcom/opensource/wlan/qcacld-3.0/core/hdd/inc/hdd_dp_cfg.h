@@ -596,6 +596,106 @@
 		CFG_VALUE_OR_DEFAULT, \
 		"Bus bandwidth compute interval")
 
+/*
+ * <ini>
+ * gBusBandwidthPredictive - use the predictive bus bandwidth governor
+ * @Default: false
+ *
+ * This ini selects how the throughput level is picked from the packet
+ * count of each bus bandwidth compute interval. When false the level is
+ * looked up from the bus bandwidth thresholds alone. When true sharp
+ * rises and falls between intervals are acted on at once, and small dips
+ * to the level below are acted on after gBusBandwidthDownHold intervals.
+ *
+ * Related: gBusBandwidthRampUpPercent, gBusBandwidthRampDownPercent,
+ * gBusBandwidthDownHold
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_BUS_BANDWIDTH_PREDICTIVE \
+		CFG_INI_BOOL( \
+		"gBusBandwidthPredictive", \
+		false, \
+		"Use the predictive bus bandwidth governor")
+
+/*
+ * <ini>
+ * gBusBandwidthRampUpPercent - rise treated as a throughput ramp
+ *
+ * @Min: 0
+ * @Max: 10000
+ * @Default: 100
+ *
+ * This ini specifies the rise in packet count over the previous interval,
+ * in percent, above which the predictive governor votes for the level of
+ * the extrapolated next interval. 0 disables ramp prediction.
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_BUS_BANDWIDTH_RAMP_UP_PERCENT \
+		CFG_INI_UINT( \
+		"gBusBandwidthRampUpPercent", \
+		0, \
+		10000, \
+		100, \
+		CFG_VALUE_OR_DEFAULT, \
+		"Bus bandwidth ramp up percent")
+
+/*
+ * <ini>
+ * gBusBandwidthRampDownPercent - fall treated as traffic stopping
+ *
+ * @Min: 0
+ * @Max: 100
+ * @Default: 25
+ *
+ * This ini specifies the fall in packet count from the previous interval,
+ * in percent, above which the predictive governor drops the vote without
+ * waiting for gBusBandwidthDownHold intervals. 0 disables it.
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_BUS_BANDWIDTH_RAMP_DOWN_PERCENT \
+		CFG_INI_UINT( \
+		"gBusBandwidthRampDownPercent", \
+		0, \
+		100, \
+		25, \
+		CFG_VALUE_OR_DEFAULT, \
+		"Bus bandwidth ramp down percent")
+
+/*
+ * <ini>
+ * gBusBandwidthDownHold - intervals before the vote is lowered
+ *
+ * @Min: 0
+ * @Max: 100
+ * @Default: 3
+ *
+ * This ini specifies how many consecutive compute intervals the predictive
+ * governor must see the throughput level below the current one, with a
+ * fall smaller than gBusBandwidthRampDownPercent, before it lowers the
+ * vote. Larger falls lower the vote at once.
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_BUS_BANDWIDTH_DOWN_HOLD \
+		CFG_INI_UINT( \
+		"gBusBandwidthDownHold", \
+		0, \
+		100, \
+		3, \
+		CFG_VALUE_OR_DEFAULT, \
+		"Bus bandwidth down hold intervals")
+
 /*
  * <ini>
  * gTcpLimitOutputEnable - Control to enable TCP limit output byte
@@ -1269,6 +1369,29 @@
 	1, 4, 1, CFG_VALUE_OR_DEFAULT, \
 	"Control to set the number of dp rx threads")
 
+/*
+ * <ini>
+ * dp_rx_thread_flow_steer - Select the dp rx thread by flow hash
+ *
+ * @Min: 0
+ * @Max: 1
+ * @Default: 0
+ *
+ * By default all packets of a REO ring are processed by the same dp rx
+ * thread. When enabled, the thread is selected by the flow hash of the
+ * packet instead, keeping the packets of each flow in order, and idle
+ * threads take over flows from backed up ones. Needs num_dp_rx_threads
+ * greater than 1.
+ *
+ * Usage: Internal
+ *
+ * </ini>
+ */
+#define CFG_DP_RX_THREAD_FLOW_STEER \
+	CFG_INI_BOOL("dp_rx_thread_flow_steer", \
+	false, \
+	"Select the dp rx thread by flow hash")
+
 /*
  * <ini>
  * ce_service_max_rx_ind_flush - Maximum number of HTT messages
@@ -1556,6 +1679,10 @@
 	CFG(CFG_DP_BUS_BANDWIDTH_MEDIUM_THRESHOLD) \
 	CFG(CFG_DP_BUS_BANDWIDTH_LOW_THRESHOLD) \
 	CFG(CFG_DP_BUS_BANDWIDTH_COMPUTE_INTERVAL) \
+	CFG(CFG_DP_BUS_BANDWIDTH_PREDICTIVE) \
+	CFG(CFG_DP_BUS_BANDWIDTH_RAMP_UP_PERCENT) \
+	CFG(CFG_DP_BUS_BANDWIDTH_RAMP_DOWN_PERCENT) \
+	CFG(CFG_DP_BUS_BANDWIDTH_DOWN_HOLD) \
 	CFG(CFG_DP_ENABLE_TCP_LIMIT_OUTPUT) \
 	CFG(CFG_DP_ENABLE_TCP_ADV_WIN_SCALE) \
 	CFG(CFG_DP_ENABLE_TCP_DELACK) \
@@ -1636,6 +1763,7 @@
 	CFG(CFG_DP_FILTER_MULTICAST_REPLAY) \
 	CFG(CFG_DP_RX_WAKELOCK_TIMEOUT) \
 	CFG(CFG_DP_NUM_DP_RX_THREADS) \
+	CFG(CFG_DP_RX_THREAD_FLOW_STEER) \
 	CFG(CFG_DP_HTC_WMI_CREDIT_CNT) \
 	CFG(CFG_DP_ICMP_REQ_TO_FW_MARK_INTERVAL) \
 	CFG_MSCS_FEATURE_ALL \
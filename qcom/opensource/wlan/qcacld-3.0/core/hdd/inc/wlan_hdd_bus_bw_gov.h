@@ -0,0 +1,102 @@
+/* SPDX-License-Identifier: ISC */
+
+#if !defined(WLAN_HDD_BUS_BW_GOV_H)
+#define WLAN_HDD_BUS_BW_GOV_H
+
+/**
+ * DOC: wlan_hdd_bus_bw_gov.h
+ *
+ * Bus bandwidth governor: picks a throughput level from the packet count
+ * of each bus bandwidth compute interval.
+ *
+ * Levels are indices into an ascending threshold table: level 0 is below
+ * thresh[0] and level n is above thresh[n - 1]. HDD maps them on to
+ * enum tput_level. The governor has no driver dependencies, so it is also
+ * built on the host by the trace simulator in core/hdd/test.
+ */
+
+#include <qdf_types.h>
+
+#define HDD_BUS_BW_GOV_MAX_THRESH 6
+
+/**
+ * struct hdd_bus_bw_gov_cfg - bus bandwidth governor configuration
+ * @thresh: ascending packet count thresholds, one per level above 0
+ * @num_thresh: valid entries in @thresh
+ * @predictive: use the predictive governor instead of the plain threshold
+ *	lookup
+ * @up_pct: rise over the previous interval, in percent, that is treated as
+ *	a ramp if the previous interval was above level 0. The level is then
+ *	picked for the extrapolated next interval. 0 disables ramp
+ *	prediction.
+ * @down_pct: fall from the previous interval, in percent, that is treated
+ *	as traffic stopping. The level then drops without waiting for
+ *	@down_hold. 0 disables it.
+ * @down_hold: consecutive intervals the level one below the current one
+ *	must be seen before the governor steps down to it
+ */
+struct hdd_bus_bw_gov_cfg {
+	uint32_t thresh[HDD_BUS_BW_GOV_MAX_THRESH];
+	uint8_t num_thresh;
+	bool predictive;
+	uint32_t up_pct;
+	uint32_t down_pct;
+	uint32_t down_hold;
+};
+
+/**
+ * struct hdd_bus_bw_gov - bus bandwidth governor state
+ * @cfg: configuration
+ * @prev_pkts: packet count of the previous interval
+ * @level: current level
+ * @hold: intervals a lower level has been seen in a row
+ */
+struct hdd_bus_bw_gov {
+	struct hdd_bus_bw_gov_cfg cfg;
+	uint64_t prev_pkts;
+	uint8_t level;
+	uint32_t hold;
+};
+
+/**
+ * hdd_bus_bw_gov_level() - level of a packet count by threshold alone
+ * @cfg: governor configuration
+ * @pkts: packets in the interval
+ *
+ * Return: highest level whose threshold @pkts exceeds
+ */
+uint8_t hdd_bus_bw_gov_level(const struct hdd_bus_bw_gov_cfg *cfg,
+			     uint64_t pkts);
+
+/**
+ * hdd_bus_bw_gov_init() - reset the governor
+ * @gov: governor
+ * @cfg: configuration to use
+ *
+ * Called whenever the bus bandwidth work is (re)started, so that a ramp is
+ * not measured against traffic from before the restart.
+ *
+ * Return: None
+ */
+void hdd_bus_bw_gov_init(struct hdd_bus_bw_gov *gov,
+			 const struct hdd_bus_bw_gov_cfg *cfg);
+
+/**
+ * hdd_bus_bw_gov_update() - feed the packet count of an interval
+ * @gov: governor
+ * @pkts: packets in the interval, scaled to the configured interval
+ *
+ * Without cfg.predictive this is hdd_bus_bw_gov_level(). Otherwise:
+ *  - a ramp by at least up_pct from above level 0 votes for the level of
+ *    the next interval extrapolated from the last two, instead of waiting
+ *    for it;
+ *  - higher levels are taken at once;
+ *  - a fall by at least down_pct, or by more than one level, is taken at
+ *    once;
+ *  - a smaller dip to the level below is taken after down_hold intervals.
+ *
+ * Return: level to vote for
+ */
+uint8_t hdd_bus_bw_gov_update(struct hdd_bus_bw_gov *gov, uint64_t pkts);
+
+#endif /* WLAN_HDD_BUS_BW_GOV_H */
@@ -170,6 +170,11 @@ struct hdd_config {
 	/* bandwidth threshold for low bandwidth */
 	uint32_t bus_bw_low_threshold;
 	uint32_t bus_bw_compute_interval;
+	/* predictive bus bandwidth governor */
+	bool bus_bw_predictive;
+	uint32_t bus_bw_ramp_up_pct;
+	uint32_t bus_bw_ramp_down_pct;
+	uint32_t bus_bw_down_hold;
 	uint32_t enable_tcp_delack;
 	bool     enable_tcp_limit_output;
 	uint32_t enable_tcp_adv_win_scale;
@@ -214,6 +219,7 @@ struct hdd_config {
 	bool multicast_replay_filter;
 	uint32_t rx_wakelock_timeout;
 	uint8_t num_dp_rx_threads;
+	bool dp_rx_thread_flow_steer;
 #ifdef CONFIG_DP_TRACE
 	bool enable_dp_trace;
 	uint8_t dp_trace_config[DP_TRACE_CONFIG_STRING_LENGTH];
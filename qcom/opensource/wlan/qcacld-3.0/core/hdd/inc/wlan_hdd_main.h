@@ -119,6 +119,7 @@
 
 #include "wlan_hdd_sta_info.h"
 #include "wlan_hdd_bus_bandwidth.h"
+#include "wlan_hdd_bus_bw_gov.h"
 #include <wlan_hdd_cm_api.h>
 #include "wlan_hdd_mlo.h"
 
@@ -588,6 +589,8 @@ struct hdd_tx_rx_stats {
 		__u32    tx_called;
 		__u32    tx_dropped;
 		__u32    tx_orphaned;
+		/* log timestamp cycles spent in hdd_pkt_classify() */
+		uint64_t tx_classify_cycles;
 		__u32    tx_classified_ac[WLAN_MAX_AC];
 		__u32    tx_dropped_ac[WLAN_MAX_AC];
 #ifdef TX_MULTIQ_PER_AC
@@ -605,6 +608,7 @@ struct hdd_tx_rx_stats {
 		__u32 rx_dropped;
 		__u32 rx_delivered;
 		__u32 rx_refused;
+		uint64_t rx_classify_cycles;
 	} per_cpu[NUM_CPUS];
 
 	qdf_atomic_t rx_usolict_arp_n_mcast_drp;
@@ -1997,6 +2001,7 @@ struct hdd_rtpm_tput_policy_context {
  * @iftype_data_5g: Interface data for 5g band
  * @num_latency_critical_clients: Number of latency critical clients connected
  * @bus_bw_work: work for periodically computing DDR bus bandwidth requirements
+ * @bus_bw_gov: governor picking the throughput level of each bus_bw_work run
  * @g_event_flags: a bitmap of hdd_driver_flags
  * @psoc_idle_timeout_work: delayed work for psoc idle shutdown
  * @sar_flag: SAR flags supported by firmware
@@ -2100,6 +2105,7 @@ struct hdd_context {
 
 #ifdef WLAN_FEATURE_DP_BUS_BANDWIDTH
 	struct qdf_periodic_work bus_bw_work;
+	struct hdd_bus_bw_gov bus_bw_gov;
 	int cur_vote_level;
 	qdf_spinlock_t bus_bw_lock;
 	int cur_rx_level;
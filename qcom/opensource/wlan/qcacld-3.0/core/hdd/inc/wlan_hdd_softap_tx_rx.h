@@ -27,6 +27,7 @@
  */
 
 #include <wlan_hdd_hostapd.h>
+#include <wlan_hdd_tx_rx.h>
 #include <cdp_txrx_peer_ops.h>
 
 #define hdd_sapd_alert(params...) \
@@ -269,6 +270,7 @@ int hdd_post_dhcp_ind(struct hdd_adapter *adapter,
  * hdd_softap_inspect_dhcp_packet() - Inspect DHCP packet
  * @adapter: pointer to hdd adapter
  * @skb: pointer to OS packet (sk_buff)
+ * @cls: class of the packet
  * @dir: direction
  *
  * Inspect the Tx/Rx frame, and send DHCP START/STOP notification to the FW
@@ -294,6 +296,7 @@ int hdd_post_dhcp_ind(struct hdd_adapter *adapter,
  */
 int hdd_softap_inspect_dhcp_packet(struct hdd_adapter *adapter,
 				   struct sk_buff *skb,
+				   const struct hdd_pkt_class *cls,
 				   enum qdf_proto_dir dir);
 #else
 static inline
@@ -306,6 +309,7 @@ int hdd_post_dhcp_ind(struct hdd_adapter *adapter,
 static inline
 int hdd_softap_inspect_dhcp_packet(struct hdd_adapter *adapter,
 				   struct sk_buff *skb,
+				   const struct hdd_pkt_class *cls,
 				   enum qdf_proto_dir dir)
 {
 	return 0;
@@ -331,11 +335,13 @@ void hdd_softap_check_wait_for_tx_eap_pkt(struct hdd_adapter *adapter,
  * hdd_skb_orphan() - skb_unshare a cloned packed else skb_orphan
  * @adapter: pointer to HDD adapter
  * @skb: pointer to skb data packet
+ * @cls: class of the packet
  *
  * Return: pointer to skb structure
  */
 static inline struct sk_buff *hdd_skb_orphan(struct hdd_adapter *adapter,
-					     struct sk_buff *skb)
+					     struct sk_buff *skb,
+					     const struct hdd_pkt_class *cls)
 {
 	struct hdd_context *hdd_ctx = WLAN_HDD_GET_CTX(adapter);
 
@@ -363,7 +369,8 @@ static inline struct sk_buff *hdd_skb_orphan(struct hdd_adapter *adapter,
 }
 #else
 static inline struct sk_buff *hdd_skb_orphan(struct hdd_adapter *adapter,
-					     struct sk_buff *skb)
+					     struct sk_buff *skb,
+					     const struct hdd_pkt_class *cls)
 {
 	struct sk_buff *nskb;
 
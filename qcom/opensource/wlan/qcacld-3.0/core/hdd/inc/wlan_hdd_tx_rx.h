@@ -425,7 +425,57 @@ void hdd_adapter_set_rps(uint8_t vdev_id, bool enable)
 }
 #endif
 
-void wlan_hdd_classify_pkt(struct sk_buff *skb);
+/*
+ * Protocols found in a packet by hdd_pkt_classify(), as a bitmap so the
+ * consumers can test what they need without parsing the headers again.
+ */
+#define HDD_PKT_CLASS_IPV4	BIT(0)
+#define HDD_PKT_CLASS_IPV6	BIT(1)
+#define HDD_PKT_CLASS_ARP	BIT(2)
+#define HDD_PKT_CLASS_EAPOL	BIT(3)
+#define HDD_PKT_CLASS_WAPI	BIT(4)
+#define HDD_PKT_CLASS_TCP	BIT(5)
+#define HDD_PKT_CLASS_UDP	BIT(6)
+#define HDD_PKT_CLASS_ICMP	BIT(7)
+#define HDD_PKT_CLASS_ICMPV6	BIT(8)
+#define HDD_PKT_CLASS_DHCP	BIT(9)
+#define HDD_PKT_CLASS_DNS	BIT(10)
+
+/**
+ * struct hdd_pkt_class - result of classifying a packet once
+ * @flags: HDD_PKT_CLASS_* found in the packet
+ * @l3_off: offset of the ARP/IP header from skb->data
+ * @l4_off: offset of the TCP/UDP/ICMP header, 0 if there is none
+ * @subtype: ARP/EAPOL/DHCP/ICMP/ICMPv6 subtype, QDF_PROTO_INVALID for
+ *           other packets
+ */
+struct hdd_pkt_class {
+	uint16_t flags;
+	uint16_t l3_off;
+	uint16_t l4_off;
+	enum qdf_proto_subtype subtype;
+};
+
+/**
+ * hdd_pkt_classify() - parse the headers of a packet once
+ * @skb: packet starting with its ethernet header
+ * @cls: filled with what was found
+ *
+ * Return: None
+ */
+void hdd_pkt_classify(struct sk_buff *skb, struct hdd_pkt_class *cls);
+
+/**
+ * wlan_hdd_classify_pkt() - classify a tx packet
+ * @skb: packet to transmit
+ * @cls: filled with what was found
+ *
+ * Resets the control block and records the destination type and the
+ * packet type there for the lower layers.
+ *
+ * Return: None
+ */
+void wlan_hdd_classify_pkt(struct sk_buff *skb, struct hdd_pkt_class *cls);
 
 #ifdef WLAN_FEATURE_DP_BUS_BANDWIDTH
 void hdd_reset_tcp_delack(struct hdd_context *hdd_ctx);
@@ -459,10 +509,12 @@ static inline bool hdd_is_current_high_throughput(struct hdd_context *hdd_ctx)
 #endif
 
 #ifdef FEATURE_WLAN_DIAG_SUPPORT
-void hdd_event_eapol_log(struct sk_buff *skb, enum qdf_proto_dir dir);
+void hdd_event_eapol_log(struct sk_buff *skb, const struct hdd_pkt_class *cls,
+			 enum qdf_proto_dir dir);
 #else
 static inline
-void hdd_event_eapol_log(struct sk_buff *skb, enum qdf_proto_dir dir)
+void hdd_event_eapol_log(struct sk_buff *skb, const struct hdd_pkt_class *cls,
+			 enum qdf_proto_dir dir)
 {}
 #endif
 
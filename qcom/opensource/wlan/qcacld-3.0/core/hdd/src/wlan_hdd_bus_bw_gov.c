@@ -0,0 +1,104 @@
+/* SPDX-License-Identifier: ISC */
+
+/**
+ * DOC: wlan_hdd_bus_bw_gov.c
+ *
+ * Bus bandwidth governor implementation
+ */
+
+#include "wlan_hdd_bus_bw_gov.h"
+
+uint8_t hdd_bus_bw_gov_level(const struct hdd_bus_bw_gov_cfg *cfg,
+			     uint64_t pkts)
+{
+	uint8_t level = cfg->num_thresh;
+
+	while (level && pkts <= cfg->thresh[level - 1])
+		level--;
+
+	return level;
+}
+
+void hdd_bus_bw_gov_init(struct hdd_bus_bw_gov *gov,
+			 const struct hdd_bus_bw_gov_cfg *cfg)
+{
+	gov->cfg = *cfg;
+	if (gov->cfg.num_thresh > HDD_BUS_BW_GOV_MAX_THRESH)
+		gov->cfg.num_thresh = HDD_BUS_BW_GOV_MAX_THRESH;
+	gov->prev_pkts = 0;
+	gov->level = 0;
+	gov->hold = 0;
+}
+
+/**
+ * hdd_bus_bw_gov_is_ramp() - check for a sharp rise between two intervals
+ * @cfg: governor configuration
+ * @prev: packets in the previous interval
+ * @pkts: packets in this interval
+ *
+ * A rise from below the lowest threshold is not a ramp: extrapolating
+ * from an idle interval turns every short burst into a high vote.
+ *
+ * Return: true if @pkts is at least up_pct above a non idle @prev
+ */
+static bool hdd_bus_bw_gov_is_ramp(const struct hdd_bus_bw_gov_cfg *cfg,
+				   uint64_t prev, uint64_t pkts)
+{
+	if (!cfg->up_pct || pkts <= prev || !hdd_bus_bw_gov_level(cfg, prev))
+		return false;
+
+	return (pkts - prev) * 100 >= prev * cfg->up_pct;
+}
+
+/**
+ * hdd_bus_bw_gov_is_drop() - check for a sharp fall between two intervals
+ * @cfg: governor configuration
+ * @prev: packets in the previous interval
+ * @pkts: packets in this interval
+ *
+ * Return: true if @pkts is at least down_pct below @prev
+ */
+static bool hdd_bus_bw_gov_is_drop(const struct hdd_bus_bw_gov_cfg *cfg,
+				   uint64_t prev, uint64_t pkts)
+{
+	if (!cfg->down_pct || pkts >= prev)
+		return false;
+
+	return (prev - pkts) * 100 >= prev * cfg->down_pct;
+}
+
+uint8_t hdd_bus_bw_gov_update(struct hdd_bus_bw_gov *gov, uint64_t pkts)
+{
+	const struct hdd_bus_bw_gov_cfg *cfg = &gov->cfg;
+	uint64_t prev = gov->prev_pkts;
+	uint8_t target;
+
+	gov->prev_pkts = pkts;
+
+	if (!cfg->predictive) {
+		gov->level = hdd_bus_bw_gov_level(cfg, pkts);
+		return gov->level;
+	}
+
+	/*
+	 * The vote only takes effect for the next interval, so on a ramp
+	 * vote for where the traffic is heading rather than where it was.
+	 */
+	if (hdd_bus_bw_gov_is_ramp(cfg, prev, pkts))
+		target = hdd_bus_bw_gov_level(cfg, pkts + (pkts - prev));
+	else
+		target = hdd_bus_bw_gov_level(cfg, pkts);
+
+	/* only small dips, by one level and less than down_pct, are held */
+	if (target >= gov->level) {
+		gov->hold = 0;
+		gov->level = target;
+	} else if (target + 1 < gov->level ||
+		   hdd_bus_bw_gov_is_drop(cfg, prev, pkts) ||
+		   ++gov->hold >= cfg->down_hold) {
+		gov->hold = 0;
+		gov->level = target;
+	}
+
+	return gov->level;
+}
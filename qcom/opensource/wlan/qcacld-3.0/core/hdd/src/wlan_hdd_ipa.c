@@ -456,6 +456,7 @@ void hdd_ipa_send_nbuf_to_network(qdf_nbuf_t nbuf, qdf_netdev_t dev)
 	unsigned int cpu_index;
 	uint32_t enabled;
 	struct hdd_tx_rx_stats *stats;
+	struct hdd_pkt_class cls;
 
 	if (hdd_validate_adapter(adapter)) {
 		kfree_skb(nbuf);
@@ -469,16 +470,17 @@ void hdd_ipa_send_nbuf_to_network(qdf_nbuf_t nbuf, qdf_netdev_t dev)
 
 	stats = &adapter->hdd_stats.tx_rx_stats;
 	hdd_ipa_update_rx_mcbc_stats(adapter, nbuf);
+	hdd_pkt_classify(nbuf, &cls);
 
 	if ((adapter->device_mode == QDF_SAP_MODE) &&
-	    (qdf_nbuf_is_ipv4_dhcp_pkt(nbuf) == true)) {
+	    (cls.flags & HDD_PKT_CLASS_DHCP)) {
 		/* Send DHCP Indication to FW */
-		hdd_softap_inspect_dhcp_packet(adapter, nbuf, QDF_RX);
+		hdd_softap_inspect_dhcp_packet(adapter, nbuf, &cls, QDF_RX);
 	}
 
 	qdf_dp_trace_set_track(nbuf, QDF_RX);
 
-	hdd_event_eapol_log(nbuf, QDF_RX);
+	hdd_event_eapol_log(nbuf, &cls, QDF_RX);
 	qdf_dp_trace_log_pkt(adapter->vdev_id,
 			     nbuf, QDF_RX, QDF_TRACE_DEFAULT_PDEV_ID);
 	DPTRACE(qdf_dp_trace(nbuf,
@@ -10853,6 +10853,59 @@ bool hdd_bus_bandwidth_work_tune_tx(struct hdd_context *hdd_ctx,
 	return tx_level_change;
 }
 
+/* Throughput level and bus vote of each bus bandwidth governor level */
+static const enum tput_level
+hdd_bus_bw_gov_tput_level[HDD_BUS_BW_GOV_MAX_THRESH + 1] = {
+	TPUT_LEVEL_IDLE,
+	TPUT_LEVEL_LOW,
+	TPUT_LEVEL_MEDIUM,
+	TPUT_LEVEL_HIGH,
+	TPUT_LEVEL_VERY_HIGH,
+	TPUT_LEVEL_ULTRA_HIGH,
+	TPUT_LEVEL_SUPER_HIGH,
+};
+
+static const enum pld_bus_width_type
+hdd_bus_bw_gov_vote_level[HDD_BUS_BW_GOV_MAX_THRESH + 1] = {
+	PLD_BUS_WIDTH_IDLE,
+	PLD_BUS_WIDTH_LOW,
+	PLD_BUS_WIDTH_MEDIUM,
+	PLD_BUS_WIDTH_HIGH,
+	PLD_BUS_WIDTH_VERY_HIGH,
+	PLD_BUS_WIDTH_ULTRA_HIGH,
+	PLD_BUS_WIDTH_MAX,
+};
+
+/**
+ * hdd_bus_bw_gov_reset() - (re)initialize the bus bandwidth governor
+ * @hdd_ctx: handle to hdd context
+ *
+ * Must not race with the bus bandwidth work.
+ *
+ * Return: None
+ */
+static void hdd_bus_bw_gov_reset(struct hdd_context *hdd_ctx)
+{
+	struct hdd_config *config = hdd_ctx->config;
+	struct hdd_bus_bw_gov_cfg cfg = {
+		.thresh = {
+			config->bus_bw_low_threshold,
+			config->bus_bw_medium_threshold,
+			config->bus_bw_high_threshold,
+			config->bus_bw_very_high_threshold,
+			config->bus_bw_ultra_high_threshold,
+			config->bus_bw_super_high_threshold,
+		},
+		.num_thresh = HDD_BUS_BW_GOV_MAX_THRESH,
+		.predictive = config->bus_bw_predictive,
+		.up_pct = config->bus_bw_ramp_up_pct,
+		.down_pct = config->bus_bw_ramp_down_pct,
+		.down_hold = config->bus_bw_down_hold,
+	};
+
+	hdd_bus_bw_gov_init(&hdd_ctx->bus_bw_gov, &cfg);
+}
+
 /**
  * hdd_pld_request_bus_bandwidth() - Function to control bus bandwidth
  * @hdd_ctx: handle to hdd context
@@ -10876,6 +10929,7 @@ static void hdd_pld_request_bus_bandwidth(struct hdd_context *hdd_ctx,
 	bool tx_level_change;
 	bool dptrace_high_tput_req;
 	u64 total_pkts = tx_packets + rx_packets;
+	uint8_t gov_level;
 	enum pld_bus_width_type next_vote_level = PLD_BUS_WIDTH_IDLE;
 	static enum wlan_tp_level next_rx_level = WLAN_SVC_TP_NONE;
 	enum wlan_tp_level next_tx_level = WLAN_SVC_TP_NONE;
@@ -10893,30 +10947,15 @@ static void hdd_pld_request_bus_bandwidth(struct hdd_context *hdd_ctx,
 	if (!soc)
 		return;
 
+	/* keep the governor fed even while the level is forced */
+	gov_level = hdd_bus_bw_gov_update(&hdd_ctx->bus_bw_gov, total_pkts);
+
 	if (hdd_ctx->high_bus_bw_request) {
 		next_vote_level = PLD_BUS_WIDTH_VERY_HIGH;
 		tput_level = TPUT_LEVEL_VERY_HIGH;
-	} else if (total_pkts > hdd_ctx->config->bus_bw_super_high_threshold) {
-		next_vote_level = PLD_BUS_WIDTH_MAX;
-		tput_level = TPUT_LEVEL_SUPER_HIGH;
-	} else if (total_pkts > hdd_ctx->config->bus_bw_ultra_high_threshold) {
-		next_vote_level = PLD_BUS_WIDTH_ULTRA_HIGH;
-		tput_level = TPUT_LEVEL_ULTRA_HIGH;
-	} else if (total_pkts > hdd_ctx->config->bus_bw_very_high_threshold) {
-		next_vote_level = PLD_BUS_WIDTH_VERY_HIGH;
-		tput_level = TPUT_LEVEL_VERY_HIGH;
-	} else if (total_pkts > hdd_ctx->config->bus_bw_high_threshold) {
-		next_vote_level = PLD_BUS_WIDTH_HIGH;
-		tput_level = TPUT_LEVEL_HIGH;
-	} else if (total_pkts > hdd_ctx->config->bus_bw_medium_threshold) {
-		next_vote_level = PLD_BUS_WIDTH_MEDIUM;
-		tput_level = TPUT_LEVEL_MEDIUM;
-	} else if (total_pkts > hdd_ctx->config->bus_bw_low_threshold) {
-		next_vote_level = PLD_BUS_WIDTH_LOW;
-		tput_level = TPUT_LEVEL_LOW;
 	} else {
-		next_vote_level = PLD_BUS_WIDTH_IDLE;
-		tput_level = TPUT_LEVEL_IDLE;
+		next_vote_level = hdd_bus_bw_gov_vote_level[gov_level];
+		tput_level = hdd_bus_bw_gov_tput_level[gov_level];
 	}
 
 	/*
@@ -11554,6 +11593,8 @@ int hdd_bus_bandwidth_init(struct hdd_context *hdd_ctx)
 
 	qdf_spinlock_create(&hdd_ctx->bus_bw_lock);
 
+	hdd_bus_bw_gov_reset(hdd_ctx);
+
 	hdd_pm_qos_add_request(hdd_ctx);
 
 	wlan_hdd_init_tx_rx_histogram(hdd_ctx);
@@ -13985,6 +14026,8 @@ static inline void hdd_txrx_populate_cds_config(struct cds_config_info
 		cfg_get(hdd_ctx->psoc, CFG_DP_TX_FLOW_START_QUEUE_OFFSET);
 	/* configuration for DP RX Threads */
 	cds_cfg->enable_dp_rx_threads = hdd_ctx->enable_dp_rx_threads;
+	cds_cfg->dp_rx_thread_flow_steer =
+		hdd_ctx->config->dp_rx_thread_flow_steer;
 }
 #else
 static inline void hdd_txrx_populate_cds_config(struct cds_config_info
@@ -17264,6 +17307,7 @@ static void __hdd_bus_bw_compute_timer_stop(struct hdd_context *hdd_ctx)
 	cdp_pdev_reset_bundle_require_flag(cds_get_context(QDF_MODULE_ID_SOC),
 					   OL_TXRX_PDEV_ID);
 	hdd_ctx->bw_vote_time = 0;
+	hdd_bus_bw_gov_reset(hdd_ctx);
 
 exit:
 	/**
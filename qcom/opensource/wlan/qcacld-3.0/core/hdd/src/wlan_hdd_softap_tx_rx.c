@@ -168,7 +168,7 @@ void hdd_softap_tx_resume_cb(void *adapter_context, bool tx_resume)
 }
 
 static inline struct sk_buff *hdd_skb_orphan(struct hdd_adapter *adapter,
-		struct sk_buff *skb)
+		struct sk_buff *skb, const struct hdd_pkt_class *cls)
 {
 	struct hdd_context *hdd_ctx = WLAN_HDD_GET_CTX(adapter);
 	int need_orphan = 0;
@@ -195,8 +195,7 @@ static inline struct sk_buff *hdd_skb_orphan(struct hdd_adapter *adapter,
 			need_orphan = 1;
 #endif
 	} else if (hdd_ctx->config->tx_orphan_enable) {
-		if (qdf_nbuf_is_ipv4_tcp_pkt(skb) ||
-		    qdf_nbuf_is_ipv6_tcp_pkt(skb))
+		if (cls->flags & HDD_PKT_CLASS_TCP)
 			need_orphan = 1;
 	}
 
@@ -429,6 +428,7 @@ static void hdd_softap_notify_dhcp_ind(void *context, struct sk_buff *netbuf)
 
 int hdd_softap_inspect_dhcp_packet(struct hdd_adapter *adapter,
 				   struct sk_buff *skb,
+				   const struct hdd_pkt_class *cls,
 				   enum qdf_proto_dir dir)
 {
 	enum qdf_proto_subtype subtype = QDF_PROTO_INVALID;
@@ -438,14 +438,12 @@ int hdd_softap_inspect_dhcp_packet(struct hdd_adapter *adapter,
 
 	if (((adapter->device_mode == QDF_SAP_MODE) ||
 	     (adapter->device_mode == QDF_P2P_GO_MODE)) &&
-	    ((dir == QDF_TX && QDF_NBUF_CB_PACKET_TYPE_DHCP ==
-				QDF_NBUF_CB_GET_PACKET_TYPE(skb)) ||
-	     (dir == QDF_RX && qdf_nbuf_is_ipv4_dhcp_pkt(skb) == true))) {
+	    (cls->flags & HDD_PKT_CLASS_DHCP)) {
 
 		src_mac = (struct qdf_mac_addr *)(skb->data +
 						  DHCP_CLIENT_MAC_ADDR_OFFSET);
 
-		subtype = qdf_nbuf_get_dhcp_subtype(skb);
+		subtype = cls->subtype;
 		hdd_sta_info = hdd_get_sta_info_by_mac(
 					&adapter->sta_info_list,
 					src_mac->bytes,
@@ -522,10 +520,11 @@ static void hdd_softap_notify_dhcp_ind(void *context, struct sk_buff *netbuf)
 #if defined(IPA_OFFLOAD)
 static
 struct sk_buff *hdd_sap_skb_orphan(struct hdd_adapter *adapter,
-				   struct sk_buff *skb)
+				   struct sk_buff *skb,
+				   const struct hdd_pkt_class *cls)
 {
 	if (!qdf_nbuf_ipa_owned_get(skb)) {
-		skb = hdd_skb_orphan(adapter, skb);
+		skb = hdd_skb_orphan(adapter, skb, cls);
 	} else {
 		/*
 		 * Clear the IPA ownership after check it to avoid ipa_free_skb
@@ -538,9 +537,10 @@ struct sk_buff *hdd_sap_skb_orphan(struct hdd_adapter *adapter,
 #else
 static inline
 struct sk_buff *hdd_sap_skb_orphan(struct hdd_adapter *adapter,
-				   struct sk_buff *skb)
+				   struct sk_buff *skb,
+				   const struct hdd_pkt_class *cls)
 {
-	return hdd_skb_orphan(adapter, skb);
+	return hdd_skb_orphan(adapter, skb, cls);
 }
 #endif /* IPA_OFFLOAD */
 
@@ -684,6 +684,8 @@ static void __hdd_softap_hard_start_xmit(struct sk_buff *skb,
 	uint32_t num_seg;
 	struct hdd_tx_rx_stats *stats = &adapter->hdd_stats.tx_rx_stats;
 	int cpu = qdf_get_smp_processor_id();
+	struct hdd_pkt_class cls;
+	uint64_t classify_ts;
 
 	dest_mac_addr = (struct qdf_mac_addr *)skb->data;
 	++stats->per_cpu[cpu].tx_called;
@@ -692,7 +694,10 @@ static void __hdd_softap_hard_start_xmit(struct sk_buff *skb,
 	if (QDF_IS_STATUS_ERROR(hdd_softap_validate_driver_state(adapter)))
 		goto drop_pkt;
 
-	wlan_hdd_classify_pkt(skb);
+	classify_ts = qdf_get_log_timestamp();
+	wlan_hdd_classify_pkt(skb, &cls);
+	stats->per_cpu[cpu].tx_classify_cycles +=
+		qdf_get_log_timestamp() - classify_ts;
 
 	hdd_pkt_add_timestamp(adapter, QDF_PKT_TX_DRIVER_ENTRY,
 			      qdf_get_log_timestamp(), skb);
@@ -706,7 +711,7 @@ static void __hdd_softap_hard_start_xmit(struct sk_buff *skb,
 	ac = hdd_qdisc_ac_to_tl_ac[skb->queue_mapping];
 	++stats->per_cpu[cpu].tx_classified_ac[ac];
 
-	skb = hdd_sap_skb_orphan(adapter, skb);
+	skb = hdd_sap_skb_orphan(adapter, skb, &cls);
 	if (!skb)
 		goto drop_pkt_accounting;
 
@@ -727,12 +732,12 @@ static void __hdd_softap_hard_start_xmit(struct sk_buff *skb,
 
 	if (qdf_unlikely(QDF_NBUF_CB_GET_PACKET_TYPE(skb) ==
 			 QDF_NBUF_CB_PACKET_TYPE_DHCP))
-		hdd_softap_inspect_dhcp_packet(adapter, skb, QDF_TX);
+		hdd_softap_inspect_dhcp_packet(adapter, skb, &cls, QDF_TX);
 
 	if (qdf_unlikely(QDF_NBUF_CB_GET_PACKET_TYPE(skb) ==
 			 QDF_NBUF_CB_PACKET_TYPE_EAPOL)) {
 		hdd_softap_inspect_tx_eap_pkt(adapter, skb, false);
-		hdd_event_eapol_log(skb, QDF_TX);
+		hdd_event_eapol_log(skb, &cls, QDF_TX);
 	}
 
 	hdd_softap_config_tx_pkt_tracing(adapter, skb);
@@ -1089,6 +1094,8 @@ QDF_STATUS hdd_softap_rx_packet_cbk(void *adapter_context, qdf_nbuf_t rx_buf)
 	struct hdd_station_info *sta_info;
 	bool is_eapol = false;
 	struct hdd_tx_rx_stats *stats;
+	struct hdd_pkt_class cls;
+	uint64_t classify_ts;
 
 	/* Sanity check on inputs */
 	if (unlikely((!adapter_context) || (!rx_buf))) {
@@ -1139,6 +1146,11 @@ QDF_STATUS hdd_softap_rx_packet_cbk(void *adapter_context, qdf_nbuf_t rx_buf)
 		adapter->stats.rx_packets += qdf_nbuf_get_gso_segs(skb);
 		adapter->stats.rx_bytes += skb->len;
 
+		classify_ts = qdf_get_log_timestamp();
+		hdd_pkt_classify(skb, &cls);
+		stats->per_cpu[cpu_index].rx_classify_cycles +=
+			qdf_get_log_timestamp() - classify_ts;
+
 		/* Send DHCP Indication to FW */
 		src_mac = (struct qdf_mac_addr *)(skb->data +
 						  QDF_NBUF_SRC_MAC_OFFSET);
@@ -1150,14 +1162,14 @@ QDF_STATUS hdd_softap_rx_packet_cbk(void *adapter_context, qdf_nbuf_t rx_buf)
 		if (sta_info) {
 			sta_info->rx_packets++;
 			sta_info->rx_bytes += skb->len;
-			hdd_softap_inspect_dhcp_packet(adapter, skb, QDF_RX);
+			hdd_softap_inspect_dhcp_packet(adapter, skb, &cls,
+						       QDF_RX);
 			hdd_put_sta_info_ref(&adapter->sta_info_list, &sta_info,
 					     true,
 					     STA_INFO_SOFTAP_RX_PACKET_CBK);
 		}
 
-		if (qdf_nbuf_is_ipv4_eapol_pkt(skb))
-			is_eapol = true;
+		is_eapol = !!(cls.flags & HDD_PKT_CLASS_EAPOL);
 
 		if (qdf_unlikely(is_eapol &&
 		    !(hdd_nbuf_dst_addr_is_self_addr(adapter, skb) ||
@@ -1169,7 +1181,7 @@ QDF_STATUS hdd_softap_rx_packet_cbk(void *adapter_context, qdf_nbuf_t rx_buf)
 		hdd_pkt_add_timestamp(adapter, QDF_PKT_RX_DRIVER_EXIT,
 				      qdf_get_log_timestamp(), skb);
 
-		hdd_event_eapol_log(skb, QDF_RX);
+		hdd_event_eapol_log(skb, &cls, QDF_RX);
 		qdf_dp_trace_log_pkt(adapter->vdev_id,
 				     skb, QDF_RX, QDF_TRACE_DEFAULT_PDEV_ID);
 		DPTRACE(qdf_dp_trace(skb,
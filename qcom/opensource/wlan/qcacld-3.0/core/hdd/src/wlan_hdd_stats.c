@@ -7199,10 +7199,11 @@ void wlan_hdd_display_txrx_stats(struct hdd_context *ctx)
 			if (!stats->per_cpu[i].tx_called)
 				continue;
 
-			hdd_debug("Tx CPU[%d]: called %u, dropped %u, orphaned %u",
+			hdd_debug("Tx CPU[%d]: called %u, dropped %u, orphaned %u, classify cycles %llu",
 				  i, stats->per_cpu[i].tx_called,
 				  stats->per_cpu[i].tx_dropped,
-				  stats->per_cpu[i].tx_orphaned);
+				  stats->per_cpu[i].tx_orphaned,
+				  stats->per_cpu[i].tx_classify_cycles);
 		}
 
 		hdd_debug("TX - called %u, dropped %u orphan %u",
@@ -7214,11 +7215,12 @@ void wlan_hdd_display_txrx_stats(struct hdd_context *ctx)
 		for (i = 0; i < NUM_CPUS; i++) {
 			if (stats->per_cpu[i].rx_packets == 0)
 				continue;
-			hdd_debug("Rx CPU[%d]: packets %u, dropped %u, delivered %u, refused %u",
+			hdd_debug("Rx CPU[%d]: packets %u, dropped %u, delivered %u, refused %u, classify cycles %llu",
 				  i, stats->per_cpu[i].rx_packets,
 				  stats->per_cpu[i].rx_dropped,
 				  stats->per_cpu[i].rx_delivered,
-				  stats->per_cpu[i].rx_refused);
+				  stats->per_cpu[i].rx_refused,
+				  stats->per_cpu[i].rx_classify_cycles);
 		}
 
 		hdd_debug("RX - packets %u, dropped %u, unsolict_arp_n_mcast_drp %u, delivered %u, refused %u GRO - agg %u drop %u non-agg %u flush_skip %u low_tput_flush %u disabled(conc %u low-tput %u)",
@@ -56,6 +56,8 @@
 #include "wlan_hdd_cfg80211.h"
 #include <wlan_hdd_tsf.h>
 #include <net/tcp.h>
+#include <linux/ipv6.h>
+#include <linux/udp.h>
 #include "wma_api.h"
 
 #include "wlan_hdd_nud_tracking.h"
@@ -287,7 +289,7 @@ hdd_tx_resume_false(struct hdd_adapter *adapter, bool tx_resume)
 }
 
 static inline struct sk_buff *hdd_skb_orphan(struct hdd_adapter *adapter,
-		struct sk_buff *skb)
+		struct sk_buff *skb, const struct hdd_pkt_class *cls)
 {
 	struct hdd_context *hdd_ctx = WLAN_HDD_GET_CTX(adapter);
 	int need_orphan = 0;
@@ -314,8 +316,7 @@ static inline struct sk_buff *hdd_skb_orphan(struct hdd_adapter *adapter,
 			need_orphan = 1;
 #endif
 	} else if (hdd_ctx->config->tx_orphan_enable) {
-		if (qdf_nbuf_is_ipv4_tcp_pkt(skb) ||
-		    qdf_nbuf_is_ipv6_tcp_pkt(skb))
+		if (cls->flags & HDD_PKT_CLASS_TCP)
 			need_orphan = 1;
 	}
 
@@ -452,22 +453,20 @@ uint32_t hdd_txrx_get_tx_ack_count(struct hdd_adapter *adapter)
 /**
  * qdf_event_eapol_log() - send event to wlan diag
  * @skb: skb ptr
+ * @cls: class of the packet
  * @dir: direction
  * @eapol_key_info: eapol key info
  *
  * Return: None
  */
-void hdd_event_eapol_log(struct sk_buff *skb, enum qdf_proto_dir dir)
+void hdd_event_eapol_log(struct sk_buff *skb, const struct hdd_pkt_class *cls,
+			 enum qdf_proto_dir dir)
 {
 	int16_t eapol_key_info;
 
 	WLAN_HOST_DIAG_EVENT_DEF(wlan_diag_event, struct host_event_wlan_eapol);
 
-	if ((dir == QDF_TX &&
-		(QDF_NBUF_CB_PACKET_TYPE_EAPOL !=
-		 QDF_NBUF_CB_GET_PACKET_TYPE(skb))))
-		return;
-	else if (!qdf_nbuf_is_ipv4_eapol_pkt(skb))
+	if (!(cls->flags & HDD_PKT_CLASS_EAPOL))
 		return;
 
 	eapol_key_info = (uint16_t)(*(uint16_t *)
@@ -513,13 +512,130 @@ int hdd_set_udp_qos_upgrade_config(struct hdd_adapter *adapter,
 	return 0;
 }
 
+#define HDD_PKT_ETHERTYPE_WAPI	0x88b4
+#define HDD_PKT_DHCP_SRV_PORT	67
+#define HDD_PKT_DHCP_CLI_PORT	68
+#define HDD_PKT_DNS_PORT	53
+
 /**
- * wlan_hdd_classify_pkt() - classify packet
- * @skb - sk buff
+ * hdd_pkt_classify_l4() - classify the transport of an IP packet
+ * @skb: the packet
+ * @cls: class being built, with the L3 fields set
+ * @proto: IP protocol or IPv6 next header
+ * @l4_off: offset of the transport header
  *
- * Return: none
+ * Return: None
  */
-void wlan_hdd_classify_pkt(struct sk_buff *skb)
+static void hdd_pkt_classify_l4(struct sk_buff *skb, struct hdd_pkt_class *cls,
+				uint8_t proto, uint16_t l4_off)
+{
+	struct udphdr *uh;
+	uint16_t sport, dport;
+
+	switch (proto) {
+	case IPPROTO_TCP:
+		if (skb_headlen(skb) < l4_off + sizeof(struct tcphdr))
+			return;
+		cls->flags |= HDD_PKT_CLASS_TCP;
+		break;
+	case IPPROTO_UDP:
+		if (skb_headlen(skb) < l4_off + sizeof(struct udphdr))
+			return;
+		cls->flags |= HDD_PKT_CLASS_UDP;
+		uh = (struct udphdr *)(skb->data + l4_off);
+		sport = ntohs(uh->source);
+		dport = ntohs(uh->dest);
+		if ((cls->flags & HDD_PKT_CLASS_IPV4) &&
+		    ((sport == HDD_PKT_DHCP_SRV_PORT &&
+		      dport == HDD_PKT_DHCP_CLI_PORT) ||
+		     (sport == HDD_PKT_DHCP_CLI_PORT &&
+		      dport == HDD_PKT_DHCP_SRV_PORT))) {
+			cls->flags |= HDD_PKT_CLASS_DHCP;
+			cls->subtype = qdf_nbuf_get_dhcp_subtype(skb);
+		} else if (sport == HDD_PKT_DNS_PORT ||
+			   dport == HDD_PKT_DNS_PORT) {
+			cls->flags |= HDD_PKT_CLASS_DNS;
+		}
+		break;
+	case IPPROTO_ICMP:
+		if (!(cls->flags & HDD_PKT_CLASS_IPV4))
+			return;
+		cls->flags |= HDD_PKT_CLASS_ICMP;
+		cls->subtype = qdf_nbuf_get_icmp_subtype(skb);
+		break;
+	case IPPROTO_ICMPV6:
+		if (!(cls->flags & HDD_PKT_CLASS_IPV6))
+			return;
+		cls->flags |= HDD_PKT_CLASS_ICMPV6;
+		cls->subtype = qdf_nbuf_get_icmpv6_subtype(skb);
+		break;
+	default:
+		return;
+	}
+
+	cls->l4_off = l4_off;
+}
+
+void hdd_pkt_classify(struct sk_buff *skb, struct hdd_pkt_class *cls)
+{
+	struct ethhdr *eh = (struct ethhdr *)skb->data;
+	uint16_t l3_off = ETH_HLEN;
+	struct ipv6hdr *ip6h;
+	struct iphdr *iph;
+
+	cls->flags = 0;
+	cls->l3_off = 0;
+	cls->l4_off = 0;
+	cls->subtype = QDF_PROTO_INVALID;
+
+	if (skb_headlen(skb) < ETH_HLEN)
+		return;
+
+	switch (ntohs(eh->h_proto)) {
+	case ETH_P_IP:
+		if (skb_headlen(skb) < l3_off + sizeof(*iph))
+			return;
+		iph = (struct iphdr *)(skb->data + l3_off);
+		cls->flags |= HDD_PKT_CLASS_IPV4;
+		cls->l3_off = l3_off;
+		/* only the first fragment has the transport header */
+		if (iph->frag_off & htons(IP_OFFSET))
+			return;
+		hdd_pkt_classify_l4(skb, cls, iph->protocol,
+				    l3_off + iph->ihl * 4);
+		break;
+	case ETH_P_IPV6:
+		if (skb_headlen(skb) < l3_off + sizeof(*ip6h))
+			return;
+		ip6h = (struct ipv6hdr *)(skb->data + l3_off);
+		cls->flags |= HDD_PKT_CLASS_IPV6;
+		cls->l3_off = l3_off;
+		hdd_pkt_classify_l4(skb, cls, ip6h->nexthdr,
+				    l3_off + sizeof(*ip6h));
+		break;
+	case ETH_P_ARP:
+		cls->flags |= HDD_PKT_CLASS_ARP;
+		cls->l3_off = l3_off;
+		if (qdf_nbuf_data_is_arp_req(skb))
+			cls->subtype = QDF_PROTO_ARP_REQ;
+		else if (qdf_nbuf_data_is_arp_rsp(skb))
+			cls->subtype = QDF_PROTO_ARP_RES;
+		break;
+	case ETH_P_PAE:
+		cls->flags |= HDD_PKT_CLASS_EAPOL;
+		cls->l3_off = l3_off;
+		cls->subtype = qdf_nbuf_get_eapol_subtype(skb);
+		break;
+	case HDD_PKT_ETHERTYPE_WAPI:
+		cls->flags |= HDD_PKT_CLASS_WAPI;
+		cls->l3_off = l3_off;
+		break;
+	default:
+		break;
+	}
+}
+
+void wlan_hdd_classify_pkt(struct sk_buff *skb, struct hdd_pkt_class *cls)
 {
 	struct ethhdr *eh = (struct ethhdr *)skb->data;
 
@@ -531,22 +647,24 @@ void wlan_hdd_classify_pkt(struct sk_buff *skb)
 	else if (is_multicast_ether_addr((uint8_t *)eh))
 		QDF_NBUF_CB_GET_IS_MCAST(skb) = true;
 
-	if (qdf_nbuf_is_ipv4_arp_pkt(skb))
+	hdd_pkt_classify(skb, cls);
+
+	if (cls->flags & HDD_PKT_CLASS_ARP)
 		QDF_NBUF_CB_GET_PACKET_TYPE(skb) =
 			QDF_NBUF_CB_PACKET_TYPE_ARP;
-	else if (qdf_nbuf_is_ipv4_dhcp_pkt(skb))
+	else if (cls->flags & HDD_PKT_CLASS_DHCP)
 		QDF_NBUF_CB_GET_PACKET_TYPE(skb) =
 			QDF_NBUF_CB_PACKET_TYPE_DHCP;
-	else if (qdf_nbuf_is_ipv4_eapol_pkt(skb))
+	else if (cls->flags & HDD_PKT_CLASS_EAPOL)
 		QDF_NBUF_CB_GET_PACKET_TYPE(skb) =
 			QDF_NBUF_CB_PACKET_TYPE_EAPOL;
-	else if (qdf_nbuf_is_ipv4_wapi_pkt(skb))
+	else if (cls->flags & HDD_PKT_CLASS_WAPI)
 		QDF_NBUF_CB_GET_PACKET_TYPE(skb) =
 			QDF_NBUF_CB_PACKET_TYPE_WAPI;
-	else if (qdf_nbuf_is_icmp_pkt(skb))
+	else if (cls->flags & HDD_PKT_CLASS_ICMP)
 		QDF_NBUF_CB_GET_PACKET_TYPE(skb) =
 			QDF_NBUF_CB_PACKET_TYPE_ICMP;
-	else if (qdf_nbuf_is_icmpv6_pkt(skb))
+	else if (cls->flags & HDD_PKT_CLASS_ICMPV6)
 		QDF_NBUF_CB_GET_PACKET_TYPE(skb) =
 			QDF_NBUF_CB_PACKET_TYPE_ICMPv6;
 }
@@ -670,21 +788,27 @@ static bool hdd_tx_rx_is_dns_domain_name_match(struct sk_buff *skb,
 		return false;
 }
 
-void hdd_tx_rx_collect_connectivity_stats_info(struct sk_buff *skb,
-			void *context,
-			enum connectivity_stats_pkt_status action,
-			uint8_t *pkt_type)
+#define HDD_PKT_CLASS_IS(cls, f) (((cls)->flags & (f)) == (f))
+
+/**
+ * hdd_collect_connectivity_stats() - collect connectivity stats of a packet
+ * @adapter: adapter the packet goes through
+ * @skb: the packet
+ * @cls: class of the packet
+ * @action: action done on the packet
+ * @pkt_type: connectivity check type of the packet, set for the request
+ *            and response actions, used by the others
+ *
+ * Return: None
+ */
+static void
+hdd_collect_connectivity_stats(struct hdd_adapter *adapter,
+			       struct sk_buff *skb,
+			       const struct hdd_pkt_class *cls,
+			       enum connectivity_stats_pkt_status action,
+			       uint8_t *pkt_type)
 {
 	uint32_t pkt_type_bitmap;
-	struct hdd_adapter *adapter = NULL;
-
-	adapter = (struct hdd_adapter *)context;
-	if (unlikely(adapter->magic != WLAN_HDD_ADAPTER_MAGIC)) {
-		QDF_TRACE(QDF_MODULE_ID_HDD_DATA, QDF_TRACE_LEVEL_ERROR,
-			  "Magic cookie(%x) for adapter sanity verification is invalid",
-			  adapter->magic);
-		return;
-	}
 
 	/* ARP tracking is done already. */
 	pkt_type_bitmap = adapter->pkt_type_bitmap;
@@ -696,8 +820,8 @@ void hdd_tx_rx_collect_connectivity_stats_info(struct sk_buff *skb,
 	switch (action) {
 	case PKT_TYPE_REQ:
 	case PKT_TYPE_TX_HOST_FW_SENT:
-		if (qdf_nbuf_is_icmp_pkt(skb)) {
-			if (qdf_nbuf_data_is_icmpv4_req(skb) &&
+		if (cls->flags & HDD_PKT_CLASS_ICMP) {
+			if (cls->subtype == QDF_PROTO_ICMP_REQ &&
 			    (adapter->track_dest_ipv4 ==
 					qdf_nbuf_get_icmpv4_tgt_ip(skb))) {
 				*pkt_type = CONNECTIVITY_CHECK_SET_ICMPV4;
@@ -713,7 +837,8 @@ void hdd_tx_rx_collect_connectivity_stats_info(struct sk_buff *skb,
 					++adapter->hdd_stats.hdd_icmpv4_stats.
 								tx_host_fw_sent;
 			}
-		} else if (qdf_nbuf_is_ipv4_tcp_pkt(skb)) {
+		} else if (HDD_PKT_CLASS_IS(cls, HDD_PKT_CLASS_IPV4 |
+						   HDD_PKT_CLASS_TCP)) {
 			if (qdf_nbuf_data_is_tcp_syn(skb) &&
 			    (adapter->track_dest_port ==
 					qdf_nbuf_data_get_tcp_dst_port(skb))) {
@@ -759,7 +884,8 @@ void hdd_tx_rx_collect_connectivity_stats_info(struct sk_buff *skb,
 							is_tcp_ack_sent = false;
 				}
 			}
-		} else if (qdf_nbuf_is_ipv4_udp_pkt(skb)) {
+		} else if (HDD_PKT_CLASS_IS(cls, HDD_PKT_CLASS_IPV4 |
+						   HDD_PKT_CLASS_DNS)) {
 			if (qdf_nbuf_data_is_dns_query(skb) &&
 			    hdd_tx_rx_is_dns_domain_name_match(skb, adapter)) {
 				*pkt_type = CONNECTIVITY_CHECK_SET_DNS;
@@ -779,8 +905,8 @@ void hdd_tx_rx_collect_connectivity_stats_info(struct sk_buff *skb,
 		break;
 
 	case PKT_TYPE_RSP:
-		if (qdf_nbuf_is_icmp_pkt(skb)) {
-			if (qdf_nbuf_data_is_icmpv4_rsp(skb) &&
+		if (cls->flags & HDD_PKT_CLASS_ICMP) {
+			if (cls->subtype == QDF_PROTO_ICMP_RES &&
 			    (adapter->track_dest_ipv4 ==
 					qdf_nbuf_get_icmpv4_src_ip(skb))) {
 				++adapter->hdd_stats.hdd_icmpv4_stats.
@@ -791,7 +917,8 @@ void hdd_tx_rx_collect_connectivity_stats_info(struct sk_buff *skb,
 					  QDF_TRACE_LEVEL_INFO_HIGH,
 					  "%s : ICMPv4 Res packet", __func__);
 			}
-		} else if (qdf_nbuf_is_ipv4_tcp_pkt(skb)) {
+		} else if (HDD_PKT_CLASS_IS(cls, HDD_PKT_CLASS_IPV4 |
+						   HDD_PKT_CLASS_TCP)) {
 			if (qdf_nbuf_data_is_tcp_syn_ack(skb) &&
 			    (adapter->track_dest_port ==
 					qdf_nbuf_data_get_tcp_src_port(skb))) {
@@ -805,7 +932,8 @@ void hdd_tx_rx_collect_connectivity_stats_info(struct sk_buff *skb,
 					  QDF_TRACE_LEVEL_INFO_HIGH,
 					  "%s : TCP Syn ack packet", __func__);
 			}
-		} else if (qdf_nbuf_is_ipv4_udp_pkt(skb)) {
+		} else if (HDD_PKT_CLASS_IS(cls, HDD_PKT_CLASS_IPV4 |
+						   HDD_PKT_CLASS_DNS)) {
 			if (qdf_nbuf_data_is_dns_response(skb) &&
 			    hdd_tx_rx_is_dns_domain_name_match(skb, adapter)) {
 				++adapter->hdd_stats.hdd_dns_stats.
@@ -901,6 +1029,30 @@ void hdd_tx_rx_collect_connectivity_stats_info(struct sk_buff *skb,
 	}
 }
 
+void hdd_tx_rx_collect_connectivity_stats_info(struct sk_buff *skb,
+			void *context,
+			enum connectivity_stats_pkt_status action,
+			uint8_t *pkt_type)
+{
+	struct hdd_adapter *adapter = NULL;
+	struct hdd_pkt_class cls = { .subtype = QDF_PROTO_INVALID };
+
+	adapter = (struct hdd_adapter *)context;
+	if (unlikely(adapter->magic != WLAN_HDD_ADAPTER_MAGIC)) {
+		QDF_TRACE(QDF_MODULE_ID_HDD_DATA, QDF_TRACE_LEVEL_ERROR,
+			  "Magic cookie(%x) for adapter sanity verification is invalid",
+			  adapter->magic);
+		return;
+	}
+
+	/* only the request and response actions look at the packet */
+	if (action == PKT_TYPE_REQ || action == PKT_TYPE_RSP ||
+	    action == PKT_TYPE_TX_HOST_FW_SENT)
+		hdd_pkt_classify(skb, &cls);
+
+	hdd_collect_connectivity_stats(adapter, skb, &cls, action, pkt_type);
+}
+
 /**
  * hdd_is_xmit_allowed_on_ndi() - Verify if xmit is allowed on NDI
  * @adapter: The adapter structure
@@ -1000,6 +1152,7 @@ static void wlan_hdd_fix_broadcast_eapol(struct hdd_adapter *adapter,
  *			       to be sent to the FW.
  * @hdd_ctx: Global hdd context (Caller's responsibility to validate)
  * @skb: packet to be transmitted
+ * @cls: class of the packet
  *
  * This func sets the "to_fw" flag in the packet context block, if the
  * current packet is an ICMP request packet. This marking is done at a
@@ -1009,7 +1162,8 @@ static void wlan_hdd_fix_broadcast_eapol(struct hdd_adapter *adapter,
  * Return: none
  */
 static void hdd_mark_icmp_req_to_fw(struct hdd_context *hdd_ctx,
-				    struct sk_buff *skb)
+				    struct sk_buff *skb,
+				    const struct hdd_pkt_class *cls)
 {
 	uint64_t curr_time, time_delta;
 	int time_interval_ms = hdd_ctx->config->icmp_req_to_fw_mark_interval;
@@ -1018,8 +1172,8 @@ static void hdd_mark_icmp_req_to_fw(struct hdd_context *hdd_ctx,
 	if (!hdd_ctx->config->icmp_req_to_fw_mark_interval)
 		return;
 
-	if ((qdf_nbuf_get_icmp_subtype(skb) != QDF_PROTO_ICMP_REQ) &&
-	    (qdf_nbuf_get_icmpv6_subtype(skb) != QDF_PROTO_ICMPV6_REQ))
+	if (cls->subtype != QDF_PROTO_ICMP_REQ &&
+	    cls->subtype != QDF_PROTO_ICMPV6_REQ)
 		return;
 
 	/* Mark all ICMP request to be sent to FW */
@@ -1036,7 +1190,8 @@ static void hdd_mark_icmp_req_to_fw(struct hdd_context *hdd_ctx,
 }
 #else
 static void hdd_mark_icmp_req_to_fw(struct hdd_context *hdd_ctx,
-				    struct sk_buff *skb)
+				    struct sk_buff *skb,
+				    const struct hdd_pkt_class *cls)
 {
 }
 #endif
@@ -1086,6 +1241,8 @@ static void __hdd_hard_start_xmit(struct sk_buff *skb,
 	bool is_dhcp = false;
 	struct hdd_tx_rx_stats *stats = &adapter->hdd_stats.tx_rx_stats;
 	int cpu = qdf_get_smp_processor_id();
+	struct hdd_pkt_class cls;
+	uint64_t classify_ts;
 
 #ifdef QCA_WIFI_FTM
 	if (hdd_get_conparam() == QDF_GLOBAL_FTM_MODE) {
@@ -1111,12 +1268,15 @@ static void __hdd_hard_start_xmit(struct sk_buff *skb,
 		goto drop_pkt;
 	}
 
-	wlan_hdd_classify_pkt(skb);
+	classify_ts = qdf_get_log_timestamp();
+	wlan_hdd_classify_pkt(skb, &cls);
+	stats->per_cpu[cpu].tx_classify_cycles +=
+		qdf_get_log_timestamp() - classify_ts;
 
 	QDF_NBUF_CB_TX_EXTRA_FRAG_FLAGS_NOTIFY_COMP(skb) = 1;
 
 	if (QDF_NBUF_CB_GET_PACKET_TYPE(skb) == QDF_NBUF_CB_PACKET_TYPE_ARP) {
-		if (qdf_nbuf_data_is_arp_req(skb) &&
+		if (cls.subtype == QDF_PROTO_ARP_REQ &&
 		    (adapter->track_arp_ip == qdf_nbuf_get_arp_tgt_ip(skb))) {
 			is_arp = true;
 			++adapter->hdd_stats.hdd_arp_stats.tx_arp_req_count;
@@ -1126,7 +1286,7 @@ static void __hdd_hard_start_xmit(struct sk_buff *skb,
 		}
 	} else if (QDF_NBUF_CB_GET_PACKET_TYPE(skb) ==
 		   QDF_NBUF_CB_PACKET_TYPE_EAPOL) {
-		subtype = qdf_nbuf_get_eapol_subtype(skb);
+		subtype = cls.subtype;
 		if (subtype == QDF_PROTO_EAPOL_M2) {
 			++adapter->hdd_stats.hdd_eapol_stats.eapol_m2_count;
 			is_eapol = true;
@@ -1136,7 +1296,7 @@ static void __hdd_hard_start_xmit(struct sk_buff *skb,
 		}
 	} else if (QDF_NBUF_CB_GET_PACKET_TYPE(skb) ==
 		   QDF_NBUF_CB_PACKET_TYPE_DHCP) {
-		subtype = qdf_nbuf_get_dhcp_subtype(skb);
+		subtype = cls.subtype;
 		if (subtype == QDF_PROTO_DHCP_DISCOVER) {
 			++adapter->hdd_stats.hdd_dhcp_stats.dhcp_dis_count;
 			is_dhcp = true;
@@ -1148,7 +1308,7 @@ static void __hdd_hard_start_xmit(struct sk_buff *skb,
 		   QDF_NBUF_CB_PACKET_TYPE_ICMP) ||
 		   (QDF_NBUF_CB_GET_PACKET_TYPE(skb) ==
 		   QDF_NBUF_CB_PACKET_TYPE_ICMPv6)) {
-		hdd_mark_icmp_req_to_fw(hdd_ctx, skb);
+		hdd_mark_icmp_req_to_fw(hdd_ctx, skb, &cls);
 	}
 
 	hdd_pkt_add_timestamp(adapter, QDF_PKT_TX_DRIVER_ENTRY,
@@ -1156,8 +1316,8 @@ static void __hdd_hard_start_xmit(struct sk_buff *skb,
 
 	/* track connectivity stats */
 	if (adapter->pkt_type_bitmap)
-		hdd_tx_rx_collect_connectivity_stats_info(skb, adapter,
-						PKT_TYPE_REQ, &pkt_type);
+		hdd_collect_connectivity_stats(adapter, skb, &cls,
+					       PKT_TYPE_REQ, &pkt_type);
 
 	hdd_get_transmit_mac_addr(adapter, skb, &mac_addr_tx_allowed);
 	if (qdf_is_macaddr_zero(&mac_addr_tx_allowed)) {
@@ -1173,7 +1333,7 @@ static void __hdd_hard_start_xmit(struct sk_buff *skb,
 	ac = hdd_qdisc_ac_to_tl_ac[skb->queue_mapping];
 
 	if (!qdf_nbuf_ipa_owned_get(skb)) {
-		skb = hdd_skb_orphan(adapter, skb);
+		skb = hdd_skb_orphan(adapter, skb, &cls);
 		if (!skb)
 			goto drop_pkt_accounting;
 	}
@@ -1269,7 +1429,7 @@ static void __hdd_hard_start_xmit(struct sk_buff *skb,
 		hdd_ctx->no_tx_offload_pkt_cnt++;
 	}
 
-	hdd_event_eapol_log(skb, QDF_TX);
+	hdd_event_eapol_log(skb, &cls, QDF_TX);
 	QDF_NBUF_CB_TX_PACKET_TRACK(skb) = QDF_NBUF_TX_PKT_DATA_TRACK;
 	QDF_NBUF_UPDATE_TX_PKT_COUNT(skb, QDF_NBUF_TX_PKT_HDD);
 
@@ -2471,6 +2631,8 @@ QDF_STATUS hdd_rx_packet_cbk(void *adapter_context,
 	bool is_eapol, send_over_nl;
 	bool is_dhcp;
 	struct hdd_tx_rx_stats *stats;
+	struct hdd_pkt_class cls;
+	uint64_t classify_ts;
 
 	/* Sanity check on inputs */
 	if (unlikely((!adapter_context) || (!rxBuf))) {
@@ -2507,8 +2669,13 @@ QDF_STATUS hdd_rx_packet_cbk(void *adapter_context,
 		is_dhcp = false;
 		send_over_nl = false;
 
-		if (qdf_nbuf_is_ipv4_arp_pkt(skb)) {
-			if (qdf_nbuf_data_is_arp_rsp(skb) &&
+		classify_ts = qdf_get_log_timestamp();
+		hdd_pkt_classify(skb, &cls);
+		stats->per_cpu[cpu_index].rx_classify_cycles +=
+			qdf_get_log_timestamp() - classify_ts;
+
+		if (cls.flags & HDD_PKT_CLASS_ARP) {
+			if (cls.subtype == QDF_PROTO_ARP_RES &&
 				(adapter->track_arp_ip ==
 			     qdf_nbuf_get_arp_src_ip(skb))) {
 				++adapter->hdd_stats.hdd_arp_stats.
@@ -2519,8 +2686,8 @@ QDF_STATUS hdd_rx_packet_cbk(void *adapter_context,
 						__func__);
 				track_arp = true;
 			}
-		} else if (qdf_nbuf_is_ipv4_eapol_pkt(skb)) {
-			subtype = qdf_nbuf_get_eapol_subtype(skb);
+		} else if (cls.flags & HDD_PKT_CLASS_EAPOL) {
+			subtype = cls.subtype;
 			send_over_nl = true;
 			if (subtype == QDF_PROTO_EAPOL_M1) {
 				++adapter->hdd_stats.hdd_eapol_stats.
@@ -2531,8 +2698,8 @@ QDF_STATUS hdd_rx_packet_cbk(void *adapter_context,
 						eapol_m3_count;
 				is_eapol = true;
 			}
-		} else if (qdf_nbuf_is_ipv4_dhcp_pkt(skb)) {
-			subtype = qdf_nbuf_get_dhcp_subtype(skb);
+		} else if (cls.flags & HDD_PKT_CLASS_DHCP) {
+			subtype = cls.subtype;
 			if (subtype == QDF_PROTO_DHCP_OFFER) {
 				++adapter->hdd_stats.hdd_dhcp_stats.
 						dhcp_off_count;
@@ -2549,8 +2716,9 @@ QDF_STATUS hdd_rx_packet_cbk(void *adapter_context,
 
 		/* track connectivity stats */
 		if (adapter->pkt_type_bitmap)
-			hdd_tx_rx_collect_connectivity_stats_info(skb, adapter,
-						PKT_TYPE_RSP, &pkt_type);
+			hdd_collect_connectivity_stats(adapter, skb, &cls,
+						       PKT_TYPE_RSP,
+						       &pkt_type);
 
 		sta_ctx = WLAN_HDD_GET_STATION_CTX_PTR(adapter);
 		if ((sta_ctx->conn_info.proxy_arp_service) &&
@@ -2563,7 +2731,7 @@ QDF_STATUS hdd_rx_packet_cbk(void *adapter_context,
 			continue;
 		}
 
-		hdd_event_eapol_log(skb, QDF_RX);
+		hdd_event_eapol_log(skb, &cls, QDF_RX);
 		qdf_dp_trace_log_pkt(adapter->vdev_id, skb, QDF_RX,
 				     QDF_TRACE_DEFAULT_PDEV_ID);
 
@@ -2660,8 +2828,8 @@ QDF_STATUS hdd_rx_packet_cbk(void *adapter_context,
 
 			/* track connectivity stats */
 			if (adapter->pkt_type_bitmap)
-				hdd_tx_rx_collect_connectivity_stats_info(
-					skb, adapter,
+				hdd_collect_connectivity_stats(
+					adapter, skb, &cls,
 					PKT_TYPE_RX_DELIVERED, &pkt_type);
 		} else {
 			++stats->per_cpu[cpu_index].rx_refused;
@@ -2677,8 +2845,8 @@ QDF_STATUS hdd_rx_packet_cbk(void *adapter_context,
 
 			/* track connectivity stats */
 			if (adapter->pkt_type_bitmap)
-				hdd_tx_rx_collect_connectivity_stats_info(
-					skb, adapter,
+				hdd_collect_connectivity_stats(
+					adapter, skb, &cls,
 					PKT_TYPE_RX_REFUSED, &pkt_type);
 		}
 	}
@@ -3600,6 +3768,14 @@ static void hdd_ini_bus_bandwidth(struct hdd_config *config,
 		cfg_get(psoc, CFG_DP_BUS_BANDWIDTH_LOW_THRESHOLD);
 	config->bus_bw_compute_interval =
 		cfg_get(psoc, CFG_DP_BUS_BANDWIDTH_COMPUTE_INTERVAL);
+	config->bus_bw_predictive =
+		cfg_get(psoc, CFG_DP_BUS_BANDWIDTH_PREDICTIVE);
+	config->bus_bw_ramp_up_pct =
+		cfg_get(psoc, CFG_DP_BUS_BANDWIDTH_RAMP_UP_PERCENT);
+	config->bus_bw_ramp_down_pct =
+		cfg_get(psoc, CFG_DP_BUS_BANDWIDTH_RAMP_DOWN_PERCENT);
+	config->bus_bw_down_hold =
+		cfg_get(psoc, CFG_DP_BUS_BANDWIDTH_DOWN_HOLD);
 	config->bus_low_cnt_threshold =
 		cfg_get(psoc, CFG_DP_BUS_LOW_BW_CNT_THRESHOLD);
 	config->enable_latency_crit_clients =
@@ -3815,6 +3991,8 @@ void hdd_dp_cfg_update(struct wlan_objmgr_psoc *psoc,
 	config->rx_wakelock_timeout =
 		cfg_get(psoc, CFG_DP_RX_WAKELOCK_TIMEOUT);
 	config->num_dp_rx_threads = cfg_get(psoc, CFG_DP_NUM_DP_RX_THREADS);
+	config->dp_rx_thread_flow_steer =
+		cfg_get(psoc, CFG_DP_RX_THREAD_FLOW_STEER);
 	config->cfg_wmi_credit_cnt = cfg_get(psoc, CFG_DP_HTC_WMI_CREDIT_CNT);
 	config->icmp_req_to_fw_mark_interval =
 		cfg_get(psoc, CFG_DP_ICMP_REQ_TO_FW_MARK_INTERVAL);
@@ -0,0 +1,381 @@
+/* SPDX-License-Identifier: ISC */
+
+/*
+ * Bus bandwidth governor trace simulator
+ *
+ * Replays per interval packet counts through wlan_hdd_bus_bw_gov.c, once
+ * with the threshold lookup the driver uses by default and once with the
+ * predictive governor, and reports how each one tracks the traffic.
+ */
+
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "wlan_hdd_bus_bw_gov.h"
+
+/* gBusBandwidth*Threshold defaults, lowest first */
+static const uint32_t sim_default_thresh[HDD_BUS_BW_GOV_MAX_THRESH] = {
+	150, 500, 2000, 9000, 12000, 22000
+};
+
+static const char * const sim_level_name[HDD_BUS_BW_GOV_MAX_THRESH + 1] = {
+	"IDLE", "LOW", "MEDIUM", "HIGH", "VERY_HIGH", "ULTRA_HIGH",
+	"SUPER_HIGH"
+};
+
+#define SIM_LEVEL_HIGH 3
+
+struct sim_trace {
+	uint64_t *pkts;
+	size_t len;
+	size_t cap;
+};
+
+struct sim_result {
+	const char *name;
+	uint8_t *vote;
+	unsigned int changes;
+	unsigned int ramps;
+	unsigned int ramp_missed;
+	unsigned long ramp_lat_sum;
+	unsigned int ramp_lat_max;
+	unsigned int high;
+	unsigned int high_excess;
+	unsigned int under;
+};
+
+static void sim_trace_add(struct sim_trace *t, uint64_t pkts)
+{
+	if (t->len == t->cap) {
+		t->cap = t->cap ? t->cap * 2 : 1024;
+		t->pkts = realloc(t->pkts, t->cap * sizeof(*t->pkts));
+		if (!t->pkts) {
+			perror("realloc");
+			exit(1);
+		}
+	}
+	t->pkts[t->len++] = pkts;
+}
+
+/* One "tx rx" pair per line, '#' starts a comment */
+static int sim_trace_read(struct sim_trace *t, const char *path)
+{
+	FILE *f = strcmp(path, "-") ? fopen(path, "r") : stdin;
+	unsigned long long tx, rx;
+	char line[256];
+	unsigned int n = 0;
+
+	if (!f) {
+		perror(path);
+		return -1;
+	}
+
+	while (fgets(line, sizeof(line), f)) {
+		char *p = line + strspn(line, " \t");
+
+		n++;
+		if (*p == '#' || *p == '\n' || !*p)
+			continue;
+		if (sscanf(p, "%llu %llu", &tx, &rx) != 2) {
+			fprintf(stderr, "%s:%u: expected \"tx rx\"\n", path, n);
+			if (f != stdin)
+				fclose(f);
+			return -1;
+		}
+		sim_trace_add(t, tx + rx);
+	}
+
+	if (f != stdin)
+		fclose(f);
+
+	return 0;
+}
+
+static uint32_t sim_rand(uint32_t *seed)
+{
+	*seed = *seed * 1103515245 + 12345;
+	return (*seed >> 16) & 0x7fff;
+}
+
+/* +/- pct percent of noise */
+static uint64_t sim_jitter(uint64_t pkts, unsigned int pct, uint32_t *seed)
+{
+	long delta = (long)(pkts * pct / 100);
+
+	if (!delta)
+		return pkts;
+
+	return pkts + (long)(sim_rand(seed) % (2 * delta + 1)) - delta;
+}
+
+/*
+ * Speed test like traffic: idle, a slow start ramp to peak, a plateau,
+ * an abrupt stop, then a few short web page bursts before the next run.
+ */
+static void sim_trace_synth(struct sim_trace *t, unsigned int runs,
+			    uint64_t peak, uint32_t seed)
+{
+	unsigned int run, i;
+	uint64_t pkts;
+
+	for (run = 0; run < runs; run++) {
+		for (i = 0; i < 20; i++)
+			sim_trace_add(t, sim_jitter(20, 50, &seed));
+
+		for (pkts = 100; pkts < peak; pkts *= 2)
+			sim_trace_add(t, sim_jitter(pkts, 10, &seed));
+
+		for (i = 0; i < 50; i++)
+			sim_trace_add(t, sim_jitter(peak, 10, &seed));
+
+		for (i = 0; i < 10; i++)
+			sim_trace_add(t, sim_jitter(30, 50, &seed));
+
+		for (i = 0; i < 4; i++) {
+			sim_trace_add(t, sim_jitter(2500, 30, &seed));
+			sim_trace_add(t, sim_jitter(1200, 30, &seed));
+			sim_trace_add(t, sim_jitter(300, 30, &seed));
+			sim_trace_add(t, sim_jitter(20, 50, &seed));
+			sim_trace_add(t, sim_jitter(20, 50, &seed));
+		}
+	}
+}
+
+/*
+ * The vote made at the end of interval i is in effect during interval
+ * i + 1. It is compared against the level interval i + 1 actually needed.
+ */
+static void sim_run(struct sim_result *res, const struct sim_trace *t,
+		    const struct hdd_bus_bw_gov_cfg *cfg, uint8_t high)
+{
+	struct hdd_bus_bw_gov gov;
+	uint8_t in_effect = 0, need, prev_need = 0;
+	size_t i, ramp_start = 0;
+	bool in_ramp = false;
+
+	hdd_bus_bw_gov_init(&gov, cfg);
+
+	for (i = 0; i < t->len; i++) {
+		need = hdd_bus_bw_gov_level(cfg, t->pkts[i]);
+
+		if (in_effect >= high)
+			res->high++;
+		if (in_effect >= high && need < high)
+			res->high_excess++;
+		if (in_effect < need)
+			res->under++;
+
+		if (need >= high && prev_need < high) {
+			if (in_ramp)
+				res->ramp_missed++;
+			in_ramp = true;
+			ramp_start = i;
+			res->ramps++;
+		}
+		if (in_ramp && in_effect >= high) {
+			unsigned int lat = i - ramp_start;
+
+			res->ramp_lat_sum += lat;
+			if (lat > res->ramp_lat_max)
+				res->ramp_lat_max = lat;
+			in_ramp = false;
+		} else if (in_ramp && need < high) {
+			res->ramp_missed++;
+			in_ramp = false;
+		}
+
+		res->vote[i] = hdd_bus_bw_gov_update(&gov, t->pkts[i]);
+		if (i && res->vote[i] != res->vote[i - 1])
+			res->changes++;
+		in_effect = res->vote[i];
+		prev_need = need;
+	}
+
+	if (in_ramp)
+		res->ramp_missed++;
+}
+
+static void sim_report(const struct sim_result *res, size_t len,
+		       unsigned int interval_ms)
+{
+	unsigned int reached = res->ramps - res->ramp_missed;
+
+	printf("%-10s ramps %u", res->name, res->ramps);
+	if (reached)
+		printf(", ramp latency avg %lu ms max %u ms",
+		       res->ramp_lat_sum * interval_ms / reached,
+		       res->ramp_lat_max * interval_ms);
+	if (res->ramp_missed)
+		printf(", %u never reached", res->ramp_missed);
+	printf("\n");
+	printf("%-10s high vote %u ms (%.1f%%), %u ms of it above need\n", "",
+	       res->high * interval_ms,
+	       len ? 100.0 * res->high / len : 0.0,
+	       res->high_excess * interval_ms);
+	printf("%-10s under voted %u ms, %u vote changes\n", "",
+	       res->under * interval_ms, res->changes);
+}
+
+static int sim_parse_thresh(const char *arg, uint32_t *thresh)
+{
+	char *end;
+	int i;
+
+	for (i = 0; i < HDD_BUS_BW_GOV_MAX_THRESH; i++) {
+		errno = 0;
+		thresh[i] = strtoul(arg, &end, 0);
+		if (errno || end == arg)
+			return -1;
+		if (i && thresh[i] < thresh[i - 1])
+			return -1;
+		if (*end != ',')
+			break;
+		arg = end + 1;
+	}
+
+	if (*end || i != HDD_BUS_BW_GOV_MAX_THRESH - 1)
+		return -1;
+
+	return 0;
+}
+
+static void sim_usage(const char *prog)
+{
+	fprintf(stderr,
+		"usage: %s [options]\n"
+		"  -r FILE   replay FILE (\"-\" for stdin) instead of synthetic traffic\n"
+		"  -i MS     compute interval of the trace [100]\n"
+		"  -t LIST   six comma separated thresholds, lowest first\n"
+		"            [150,500,2000,9000,12000,22000]\n"
+		"  -u PCT    gBusBandwidthRampUpPercent [100]\n"
+		"  -d PCT    gBusBandwidthRampDownPercent [25]\n"
+		"  -H N      gBusBandwidthDownHold [3]\n"
+		"  -L LEVEL  level counted as a high vote, 1-6 [3, HIGH]\n"
+		"  -n RUNS   synthetic speed test runs [3]\n"
+		"  -p PKTS   synthetic peak packets per interval [20000]\n"
+		"  -s SEED   synthetic traffic seed [1]\n"
+		"  -v        print the votes of every interval\n",
+		prog);
+}
+
+int main(int argc, char **argv)
+{
+	struct hdd_bus_bw_gov_cfg cfg = {
+		.num_thresh = HDD_BUS_BW_GOV_MAX_THRESH,
+		.up_pct = 100,
+		.down_pct = 25,
+		.down_hold = 3,
+	};
+	struct sim_result res[2] = {
+		{ .name = "threshold" },
+		{ .name = "predictive" },
+	};
+	struct sim_trace trace = { 0 };
+	const char *path = NULL;
+	unsigned int interval_ms = 100, runs = 3;
+	unsigned long peak = 20000;
+	uint32_t seed = 1;
+	uint8_t high = SIM_LEVEL_HIGH;
+	bool verbose = false;
+	size_t i;
+	int opt;
+
+	memcpy(cfg.thresh, sim_default_thresh, sizeof(cfg.thresh));
+
+	while ((opt = getopt(argc, argv, "r:i:t:u:d:H:L:n:p:s:vh")) != -1) {
+		switch (opt) {
+		case 'r':
+			path = optarg;
+			break;
+		case 'i':
+			interval_ms = strtoul(optarg, NULL, 0);
+			break;
+		case 't':
+			if (sim_parse_thresh(optarg, cfg.thresh)) {
+				fprintf(stderr, "bad threshold list %s\n",
+					optarg);
+				return 1;
+			}
+			break;
+		case 'u':
+			cfg.up_pct = strtoul(optarg, NULL, 0);
+			break;
+		case 'd':
+			cfg.down_pct = strtoul(optarg, NULL, 0);
+			break;
+		case 'H':
+			cfg.down_hold = strtoul(optarg, NULL, 0);
+			break;
+		case 'L':
+			high = strtoul(optarg, NULL, 0);
+			if (!high || high > HDD_BUS_BW_GOV_MAX_THRESH) {
+				fprintf(stderr, "bad level %s\n", optarg);
+				return 1;
+			}
+			break;
+		case 'n':
+			runs = strtoul(optarg, NULL, 0);
+			break;
+		case 'p':
+			peak = strtoul(optarg, NULL, 0);
+			break;
+		case 's':
+			seed = strtoul(optarg, NULL, 0);
+			break;
+		case 'v':
+			verbose = true;
+			break;
+		default:
+			sim_usage(argv[0]);
+			return opt == 'h' ? 0 : 1;
+		}
+	}
+
+	if (path) {
+		if (sim_trace_read(&trace, path))
+			return 1;
+	} else {
+		sim_trace_synth(&trace, runs, peak, seed);
+	}
+
+	if (!trace.len) {
+		fprintf(stderr, "empty trace\n");
+		return 1;
+	}
+
+	for (i = 0; i < 2; i++) {
+		res[i].vote = calloc(trace.len, 1);
+		if (!res[i].vote) {
+			perror("calloc");
+			return 1;
+		}
+		cfg.predictive = i;
+		sim_run(&res[i], &trace, &cfg, high);
+	}
+
+	if (verbose) {
+		printf("%6s %10s %-10s %-10s %-10s\n", "index", "pkts", "need",
+		       res[0].name, res[1].name);
+		for (i = 0; i < trace.len; i++)
+			printf("%6zu %10llu %-10s %-10s %-10s\n", i,
+			       (unsigned long long)trace.pkts[i],
+			       sim_level_name[hdd_bus_bw_gov_level(&cfg,
+							trace.pkts[i])],
+			       sim_level_name[res[0].vote[i]],
+			       sim_level_name[res[1].vote[i]]);
+		printf("\n");
+	}
+
+	printf("%zu intervals of %u ms, high vote is %s or above\n",
+	       trace.len, interval_ms, sim_level_name[high]);
+	for (i = 0; i < 2; i++)
+		sim_report(&res[i], trace.len, interval_ms);
+
+	for (i = 0; i < 2; i++)
+		free(res[i].vote);
+	free(trace.pkts);
+
+	return 0;
+}
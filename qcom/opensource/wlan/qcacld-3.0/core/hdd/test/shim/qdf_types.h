@@ -0,0 +1,14 @@
+/* SPDX-License-Identifier: ISC */
+
+/*
+ * Host build shim: the part of qdf_types.h the bus bandwidth governor uses.
+ */
+
+#ifndef _QDF_TYPES_H
+#define _QDF_TYPES_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#endif /* _QDF_TYPES_H */
@@ -1545,6 +1545,11 @@ _conditional_srcs = {
             "core/hdd/src/wlan_hdd_disa.c",
         ],
     },
+    "CONFIG_WLAN_FEATURE_DP_BUS_BANDWIDTH": {
+        True: [
+            "core/hdd/src/wlan_hdd_bus_bw_gov.c",
+        ],
+    },
     "CONFIG_WLAN_FEATURE_DSRC": {
         True: [
             "components/ocb/core/src/wlan_ocb_main.c",